@@ -0,0 +1,326 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef ADJACENCY_STORE_HPP
+#define ADJACENCY_STORE_HPP
+
+/// @brief The dense index of a vertex, which removals renumber, see VertexHandle in Graph.hpp for a stable reference.
+typedef std::uint32_t VertexId;
+
+/// @brief The id used for "no vertex".
+inline constexpr VertexId InvalidVertexId = std::numeric_limits<VertexId>::max();
+
+/// @brief An entry of an adjacency list.
+typedef struct neighbor {
+    /// @brief The vertex on the other end of the edge.
+    VertexId Target;
+
+    /// @brief The weight value of the edge.
+    float Weight;
+} Neighbor;
+
+/**
+ * @brief Sparse topology storage, a mutable adjacency list with a compressed sparse row (CSR) view built on demand.
+ *
+ * The store also tracks the connected components of the underlying undirected graph. Added vertices and edges merge
+ * components as they come, the smaller one relabelled into the larger, so every vertex is relabelled O(log n) times
+ * over a run of additions. Removals cannot split a component that cheaply, they mark the components out of date and
+ * the next query rebuilds them all at once in O(n + m), so a batch of deletions costs one rebuild, and so do bulk
+ * builds through AppendEdge() and Assign().
+ */
+class AdjacencyStore {
+    public:
+        /// @brief A compressed sparse row snapshot of the adjacency lists.
+        typedef struct csr {
+            /// @brief Row offsets, the neighbours of vertex v are Entries[Offsets[v]] to Entries[Offsets[v + 1]].
+            std::vector<std::size_t> Offsets;
+
+            /// @brief The neighbour entries of every row, laid out back to back.
+            std::vector<Neighbor> Entries;
+        } CSR;
+
+        /**
+         * @brief Creates an empty store.
+         * @param isDirected Is this a directed graph?
+         */
+        AdjacencyStore(bool isDirected = false);
+
+        /**
+         * @brief Add an edge, or update its weight if it already exists.
+         * @param from The first vertex of the edge.
+         * @param to The second vertex of the edge.
+         * @param weight The weight value of the edge.
+         * @return True if a new edge was added, false if an existing one was updated.
+         */
+        bool AddEdge(VertexId from, VertexId to, float weight);
+
+        /**
+         * @brief Add a vertex with no edges.
+         * @return The id of the new vertex.
+         */
+        VertexId AddVertex(void);
+
+        /**
+         * @brief Add several vertices with no edges at once.
+         * @param count The number of vertices to add.
+         * @return The id of the first new vertex.
+         */
+        VertexId AddVertices(std::size_t count);
+
+        /**
+         * @brief Add an edge without looking for an existing one, for bulk builds that call RemoveDuplicateEdges() after.
+         * @param from The first vertex of the edge.
+         * @param to The second vertex of the edge.
+         * @param weight The weight value of the edge.
+         */
+        void AppendEdge(VertexId from, VertexId to, float weight);
+
+        /**
+         * @brief Replace every adjacency list with the rows of a CSR layout, in one pass.
+         * @param offsets Row offsets, one more than the number of vertices, ascending from 0 to the entry count.
+         * @param entries The neighbour entries of every row, targets below the number of vertices and undirected
+         * edges listed from both ends.
+         */
+        void Assign(std::span<const std::uint64_t> offsets, std::span<const Neighbor> entries);
+
+        /**
+         * @brief Get the component of a vertex in O(1), once the components are up to date.
+         * @param id The vertex.
+         * @return The representative vertex of its component, the same for every vertex of the component.
+         */
+        VertexId GetComponent(VertexId id) const;
+
+        /**
+         * @brief Get the number of connected components, edge directions ignored.
+         * @return The number of components, 0 for an empty store.
+         */
+        std::size_t GetComponentCount(void) const;
+
+        /**
+         * @brief Get the number of vertices in the component of a vertex in O(1).
+         * @param id The vertex.
+         * @return The size of its component.
+         */
+        std::size_t GetComponentSize(VertexId id) const;
+
+        /**
+         * @brief Get a counter that changes whenever a vertex may have moved to another component.
+         *
+         * Adding or removing an isolated vertex last leaves it alone, every other vertex keeps its component then.
+         * @return The version, drawn from the same counter as GetVersion().
+         */
+        std::uint64_t GetComponentVersion(void) const;
+
+        /**
+         * @brief Get the CSR view, rebuilding it if the lists changed since the last call.
+         * @return A reference to the CSR view, valid until the next mutation.
+         */
+        const CSR& GetCSR(void) const;
+
+        /**
+         * @brief Get the number of edges leaving a vertex.
+         * @param id The vertex.
+         * @return The out degree, self loops count once.
+         */
+        std::size_t GetDegree(VertexId id) const;
+
+        /**
+         * @brief Build a dense adjacency matrix, O(n²) memory, only for views that really need one.
+         * @return The weight of every edge, 0 where there is none.
+         */
+        std::vector<std::vector<float>> GetDenseMatrix(void) const;
+
+        /**
+         * @brief Get the number of edges, undirected edges count once.
+         * @return The number of edges.
+         */
+        std::size_t GetEdgeCount(void) const;
+
+        /**
+         * @brief Get the adjacency list of a vertex.
+         * @param id The vertex.
+         * @return A reference to the neighbours of the vertex, in insertion order.
+         */
+        const std::vector<Neighbor>& GetNeighbors(VertexId id) const;
+
+        /**
+         * @brief Get the number of vertices.
+         * @return The number of vertices.
+         */
+        std::size_t GetVertexCount(void) const;
+
+        /**
+         * @brief Get a CSR view with every edge in both directions, the underlying undirected graph.
+         * @return A reference to the view, the same as GetCSR() for undirected stores, valid until the next mutation.
+         */
+        const CSR& GetSymmetricCSR(void) const;
+
+        /**
+         * @brief Get a counter that changes with every mutation, for caches of anything derived from the store.
+         *
+         * Versions come from one process wide counter, so they only grow and two stores never share one unless one
+         * is a copy of the other, even after a store is replaced by assignment.
+         * @return The version.
+         */
+        std::uint64_t GetVersion(void) const;
+
+        /**
+         * @brief Get the weight of an edge in O(degree).
+         * @param from The first vertex of the edge.
+         * @param to The second vertex of the edge.
+         * @return The weight of the edge, or 0 if there is none.
+         */
+        float GetWeight(VertexId from, VertexId to) const;
+
+        /**
+         * @brief Check for an edge in O(degree).
+         * @param from The first vertex of the edge.
+         * @param to The second vertex of the edge.
+         * @return True if the edge exists.
+         */
+        bool HasEdge(VertexId from, VertexId to) const;
+
+        /**
+         * @brief Insert a vertex with no edges at an id, the vertex there moves to the end, the reverse of RemoveVertex().
+         * @param id The id of the new vertex, at most the vertex count.
+         */
+        void InsertVertex(VertexId id);
+
+        /**
+         * @brief Is this store directed?
+         * @return True if edges are one way.
+         */
+        bool IsDirected(void) const;
+
+        /**
+         * @brief Remove the last vertex in O(1), it must have no edges, see RemoveVertex() for one that has.
+         */
+        void PopVertex(void);
+
+        /**
+         * @brief Merge the repeats of an edge left by AppendEdge() into its first entry with the last weight, in O(n + m).
+         */
+        void RemoveDuplicateEdges(void);
+
+        /**
+         * @brief Remove an edge in O(degree).
+         * @param from The first vertex of the edge.
+         * @param to The second vertex of the edge.
+         * @return True if the edge existed.
+         */
+        bool RemoveEdge(VertexId from, VertexId to);
+
+        /**
+         * @brief Remove a vertex and its edges, the last vertex takes its id.
+         *
+         * O(degree) work at the vertex, its neighbours and the last vertex when undirected. A directed store keeps no
+         * lists of incoming edges, so those are found by a pass over every list.
+         * @param id The vertex to remove.
+         */
+        void RemoveVertex(VertexId id);
+
+        /**
+         * @brief Reserve room for vertices ahead of a bulk build.
+         * @param vertexCount The expected number of vertices.
+         */
+        void Reserve(std::size_t vertexCount);
+
+        /**
+         * @brief Reserve room in the adjacency list of a vertex ahead of a bulk build.
+         * @param id The vertex.
+         * @param count The expected number of entries in its list.
+         */
+        void ReserveNeighbors(VertexId id, std::size_t count);
+
+        /**
+         * @brief Give back the room removals left in the adjacency lists, in O(n) plus the lists reallocated.
+         *
+         * Only lists more than half empty are reallocated, growth alone never leaves more. The edges, the lazy views
+         * and the version are unchanged.
+         */
+        void ShrinkToFit(void);
+
+    private:
+        /**
+         * @brief A helper to rebuild the components from scratch with a union-find over every edge, if out of date.
+         */
+        void buildComponents(void) const;
+
+        /**
+         * @brief A helper to recount the edges from the list sizes, self loops are listed once, other undirected edges twice.
+         */
+        void countEdges(void);
+
+        /**
+         * @brief A helper to find an entry in an adjacency list.
+         * @param from The vertex owning the list.
+         * @param to The target to look for.
+         * @return A pointer to the entry, or nullptr if none.
+         */
+        const Neighbor* findEntry(VertexId from, VertexId to) const;
+
+        /**
+         * @brief A helper to merge the components of the two ends of a new edge, relabelling the smaller one.
+         * @param from The first vertex of the edge.
+         * @param to The second vertex of the edge.
+         */
+        void joinComponents(VertexId from, VertexId to);
+
+        /**
+         * @brief A helper to mark every cached view out of date after a mutation.
+         */
+        void markDirty(void);
+
+        /**
+         * @brief A helper to give a vertex and its edges another id, whose list must be empty.
+         * @param from The id of the vertex.
+         * @param to The new id.
+         */
+        void moveVertex(VertexId from, VertexId to);
+
+        /// @brief The adjacency lists, the staging layer every mutation writes to.
+        std::vector<std::vector<Neighbor>> m_adjacency;
+
+        /// @brief The number of components.
+        mutable std::size_t m_componentCount;
+
+        /// @brief The next vertex of the same component, every component a circular list from its representative.
+        mutable std::vector<VertexId> m_componentNext;
+
+        /// @brief The representative of the component of every vertex.
+        mutable std::vector<VertexId> m_componentOf;
+
+        /// @brief The size of every component, indexed by its representative, 0 for other vertices.
+        mutable std::vector<std::uint32_t> m_componentSize;
+
+        /// @brief Are the components out of date after a removal?
+        mutable bool m_componentsDirty;
+
+        /// @brief The component counter.
+        mutable std::uint64_t m_componentVersion;
+
+        /// @brief The cached CSR view.
+        mutable CSR m_csr;
+
+        /// @brief Is the cached CSR view out of date?
+        mutable bool m_csrDirty;
+
+        /// @brief The number of edges.
+        std::size_t m_edgeCount;
+
+        /// @brief Is this store directed?
+        bool m_isDirected;
+
+        /// @brief The cached symmetric CSR view of a directed store.
+        mutable CSR m_symmetricCsr;
+
+        /// @brief Is the cached symmetric CSR view out of date?
+        mutable bool m_symmetricCsrDirty;
+
+        /// @brief The mutation counter.
+        std::uint64_t m_version;
+};
+
+#endif
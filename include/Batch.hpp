@@ -0,0 +1,120 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include "AdjacencyStore.hpp"
+
+/// @brief The headless batch analysis tool, computes invariants of every graph file in a directory and of generated graphs.
+class Batch {
+    public:
+        /**
+         * @brief Run the batch tool.
+         * @param argc The number of command line arguments.
+         * @param argv The command line arguments.
+         * @return int Exit code.
+         * @retval 0 Success.
+         * @retval 1 Some graph files could not be read or generated graphs saved.
+         * @retval 2 Bad command line.
+         */
+        static int Run(int argc, char **argv);
+
+    private:
+        /// @brief Computes one invariant of a graph and formats it as text.
+        typedef std::string (*InvariantFunction)(const AdjacencyStore& topology);
+
+        /// @brief A named invariant.
+        typedef struct invariant {
+            /// @brief The name used on the command line and in the output.
+            const char *Name;
+
+            /// @brief Computes the invariant.
+            InvariantFunction Compute;
+        } Invariant;
+
+        /// @brief The parsed command line.
+        typedef struct options {
+            /// @brief The directory holding the graph files.
+            std::filesystem::path Directory;
+
+            /// @brief The generator specifications, family:name=value,..., analysed after the files in this order.
+            std::vector<std::string> Generate;
+
+            /// @brief The invariants to compute, in output order.
+            std::vector<const Invariant*> Invariants;
+
+            /// @brief Are the graphs directed?
+            bool IsDirected;
+
+            /// @brief Where to write the results, empty for standard output.
+            std::filesystem::path OutputPath;
+
+            /// @brief Where to save every generated graph as a graph file, empty to not save them.
+            std::filesystem::path SaveDirectory;
+
+            /// @brief The seed of the random generators.
+            std::uint64_t Seed;
+
+            /// @brief The number of worker threads, 0 for one per core.
+            std::size_t Threads;
+        } Options;
+
+        /**
+         * @brief Load one graph file and compute its invariants.
+         * @param path The graph file.
+         * @param options The parsed command line.
+         * @param failed Set to true if the file could not be read.
+         * @return The result line, without a newline.
+         */
+        static std::string analyze(const std::filesystem::path& path, const Options& options, bool& failed);
+
+        /**
+         * @brief Compute the invariants of a graph and add them to its result line.
+         * @param line The result line, starting with the graph's name.
+         * @param topology The graph.
+         * @param options The parsed command line.
+         * @return The result line, without a newline.
+         */
+        static std::string describe(std::string line, const AdjacencyStore& topology, const Options& options);
+
+        /**
+         * @brief Generate one graph, save it if asked and compute its invariants.
+         * @param spec The generator specification, checked already.
+         * @param options The parsed command line.
+         * @param maxThreads The most worker threads the generator may use.
+         * @param failed Set to true if the graph could not be saved.
+         * @return The result line, without a newline.
+         */
+        static std::string generate(const std::string& spec, const Options& options, std::size_t maxThreads, bool& failed);
+
+        /**
+         * @brief Get the table of every known invariant.
+         * @return The invariants.
+         */
+        static const std::vector<Invariant>& invariants(void);
+
+        /**
+         * @brief Parse the command line.
+         * @param argc The number of command line arguments.
+         * @param argv The command line arguments.
+         * @param options The options written to.
+         * @return True if the command line is usable.
+         */
+        static bool parseArguments(int argc, char **argv, Options& options);
+
+        /**
+         * @brief Print the usage text.
+         */
+        static void printUsage(void);
+
+        /// @brief The longest a canonical labelling may search before the graph is reported as too symmetric.
+        static constexpr std::chrono::seconds CanonicalTimeLimit = std::chrono::seconds(10);
+
+        /// @brief The distance between neighbouring vertices of a saved generated graph, the one the notepad imports with.
+        static constexpr float SaveSpacing = 60.0f;
+};
+
+#endif
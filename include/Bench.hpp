@@ -0,0 +1,265 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include "Graph.hpp"
+
+/**
+ * @brief The benchmark suite, times Graph operations on families of graphs from 10 vertices up.
+ *
+ * Every operation is timed on every family at sizes growing tenfold, the time per operation and the bytes allocated
+ * per operation are written as JSON along with the exponent of a power law fitted to the times. Given a baseline
+ * written by an earlier run, any operation that became slower by more than the tolerance fails the run.
+ */
+class Bench {
+    public:
+        /**
+         * @brief Run the benchmarks.
+         * @param argc The number of command line arguments.
+         * @param argv The command line arguments.
+         * @return int Exit code.
+         * @retval 0 Success.
+         * @retval 1 Some operation regressed against the baseline.
+         * @retval 2 Bad command line, or the baseline or output could not be used.
+         */
+        static int Run(int argc, char **argv);
+
+    private:
+        /// @brief A graph to benchmark on, as positions and edges so every benchmark can build its own copy.
+        typedef struct instance {
+            /// @brief The position of every vertex.
+            std::vector<sf::Vector2f> Positions;
+
+            /// @brief The edges.
+            std::vector<std::pair<VertexId, VertexId>> Edges;
+
+            /// @brief The rectangle every vertex lies in.
+            sf::FloatRect Bounds;
+        } Instance;
+
+        /// @brief The cost of some runs of an operation.
+        typedef struct sample {
+            /// @brief The time taken, in nanoseconds.
+            double Nanoseconds;
+
+            /// @brief The bytes allocated.
+            std::uint64_t Bytes;
+
+            /// @brief The number of operations run.
+            std::size_t Operations;
+        } Sample;
+
+        /// @brief Builds what an operation needs from an instance, then times some runs of it.
+        typedef Sample (*BenchmarkFunction)(const Instance& instance, std::mt19937_64& random);
+
+        /// @brief A named operation.
+        typedef struct benchmark {
+            /// @brief The name used on the command line and in the output.
+            const char* Name;
+
+            /// @brief Times the operation.
+            BenchmarkFunction Run;
+        } Benchmark;
+
+        /// @brief Builds the instance of a family with about the given number of vertices.
+        typedef Instance (*FamilyFunction)(std::size_t vertices, std::mt19937_64& random);
+
+        /// @brief A named family of graphs.
+        typedef struct family {
+            /// @brief The name used on the command line and in the output.
+            const char* Name;
+
+            /// @brief Builds an instance.
+            FamilyFunction Build;
+
+            /// @brief The number of edges of an instance with n vertices, to skip sizes that are too large up front.
+            double (*EdgeCount)(double n);
+        } Family;
+
+        /// @brief One measured point.
+        typedef struct measurement {
+            /// @brief The operation.
+            std::string Benchmark;
+
+            /// @brief The family.
+            std::string Family;
+
+            /// @brief The number of vertices.
+            std::size_t Vertices;
+
+            /// @brief The number of edges.
+            std::size_t Edges;
+
+            /// @brief The number of operations timed.
+            std::size_t Operations;
+
+            /// @brief The time per operation, in nanoseconds.
+            double NsPerOp;
+
+            /// @brief The bytes allocated per operation.
+            double BytesPerOp;
+        } Measurement;
+
+        /// @brief The parsed command line.
+        typedef struct options {
+            /// @brief A previous result to compare against, empty for none.
+            std::filesystem::path BaselinePath;
+
+            /// @brief The operations to run.
+            std::vector<const Benchmark*> Benchmarks;
+
+            /// @brief The families to run them on.
+            std::vector<const Family*> Families;
+
+            /// @brief Sizes whose instance would have more edges are skipped.
+            std::size_t MaxEdges;
+
+            /// @brief The largest number of vertices.
+            std::size_t MaxVertices;
+
+            /// @brief A size is skipped once the operation is predicted to take longer than this, in seconds.
+            double MaxSeconds;
+
+            /// @brief Where to write the results, empty for standard output.
+            std::filesystem::path OutputPath;
+
+            /// @brief The seed of the random families and queries.
+            std::uint64_t Seed;
+
+            /// @brief The fraction an operation may slow down by before it counts as a regression.
+            double Tolerance;
+        } Options;
+
+        /**
+         * @brief A helper to join the vertices of an instance into disjoint cycles.
+         * @param instance The instance, laid out with no edges yet.
+         * @param length The number of vertices of each cycle, 2 for disjoint edges.
+         */
+        static void addCycles(Instance& instance, std::size_t length);
+
+        /**
+         * @brief Get the table of every known operation.
+         * @return The operations.
+         */
+        static const std::vector<Benchmark>& benchmarks(void);
+
+        /**
+         * @brief A helper to add every vertex and edge of an instance to a graph.
+         * @param graph An empty graph.
+         * @param instance The instance.
+         * @param withEdges Are the edges added too?
+         */
+        static void build(Graph& graph, const Instance& instance, bool withEdges);
+
+        /**
+         * @brief Compare results against a baseline and report every regression on standard error.
+         * @param results The results of this run.
+         * @param options The parsed command line.
+         * @param regressions The number of operations slower than the baseline allows.
+         * @return False if the baseline could not be read.
+         */
+        static bool compare(const std::vector<Measurement>& results, const Options& options, std::size_t& regressions);
+
+        /**
+         * @brief Get the table of every known family.
+         * @return The families.
+         */
+        static const std::vector<Family>& families(void);
+
+        /**
+         * @brief A helper to read one field of a flat JSON object.
+         * @param object The text of the object.
+         * @param key The name of the field.
+         * @return The value, without quotes for strings, empty if the field is missing.
+         */
+        static std::string_view field(std::string_view object, std::string_view key);
+
+        /**
+         * @brief A helper to fit time = c * vertices^k to the measurements of one operation on one family.
+         * @param results Every measurement.
+         * @param benchmark The operation.
+         * @param family The family.
+         * @return The exponent k, NaN with fewer than two sizes.
+         */
+        static double fitExponent(const std::vector<Measurement>& results, const std::string& benchmark, const std::string& family);
+
+        /**
+         * @brief A helper to place vertices row by row on a square grid and set the bounds to match.
+         * @param instance The instance, its positions are replaced.
+         * @param vertices The number of vertices.
+         */
+        static void layOut(Instance& instance, std::size_t vertices);
+
+        /**
+         * @brief A helper to time a piece of code and count what it allocates.
+         * @param operations The number of operations the code runs.
+         * @param body The code.
+         * @return The sample.
+         */
+        static Sample measure(std::size_t operations, const std::function<void()>& body);
+
+        /**
+         * @brief Parse the command line.
+         * @param argc The number of command line arguments.
+         * @param argv The command line arguments.
+         * @param options The options written to.
+         * @return True if the command line is usable.
+         */
+        static bool parseArguments(int argc, char **argv, Options& options);
+
+        /**
+         * @brief Print the usage text.
+         */
+        static void printUsage(void);
+
+        /**
+         * @brief A helper to resolve a comma separated list of names against a table.
+         * @param list The names.
+         * @param table The table, entries have a Name.
+         * @param chosen The entries named, in list order.
+         * @return False if a name is not in the table.
+         */
+        template <typename T>
+        static bool resolve(const std::string& list, const std::vector<T>& table, std::vector<const T*>& chosen);
+
+        /**
+         * @brief Write the results and fitted exponents as JSON.
+         * @param output The stream to write to.
+         * @param results Every measurement.
+         * @param options The parsed command line.
+         */
+        static void writeJson(std::ostream& output, const std::vector<Measurement>& results, const Options& options);
+
+        /// @brief The offscreen texture the render benchmark draws into, null if it could not be created.
+        static sf::RenderTexture* m_target;
+
+        /// @brief The number of random queries per GetVertexAt sample.
+        static constexpr std::size_t Queries = 10000;
+
+        /// @brief The most vertices removed per RemoveVertex sample.
+        static constexpr std::size_t Removals = 1000;
+
+        /// @brief The number of frames per render sample.
+        static constexpr std::size_t Frames = 10;
+
+        /// @brief The size of the offscreen texture.
+        static constexpr unsigned TargetWidth = 1280;
+
+        /// @brief The size of the offscreen texture.
+        static constexpr unsigned TargetHeight = 720;
+
+        /// @brief Every size is repeated until its samples add up to this many seconds.
+        static constexpr double MinSeconds = 0.2;
+
+        /// @brief The most samples taken of one size.
+        static constexpr std::size_t MaxSamples = 1000;
+
+        /// @brief The distance between neighbouring vertices in the laid out families.
+        static constexpr float Spacing = 40.0f;
+};
+
+#endif
@@ -0,0 +1,80 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef BIG_UNSIGNED_HPP
+#define BIG_UNSIGNED_HPP
+
+/// @brief An arbitrary precision unsigned integer, just enough arithmetic for exact graph counts.
+class BigUnsigned {
+    public:
+        /**
+         * @brief Creates a big integer from a machine word.
+         * @param value The initial value.
+         */
+        BigUnsigned(std::uint64_t value = 0);
+
+        /**
+         * @brief Add a small value in place.
+         * @param value The value to add.
+         */
+        void AddSmall(std::uint32_t value);
+
+        /**
+         * @brief Get the number of significant bits.
+         * @return The bit length, 0 for zero.
+         */
+        std::size_t BitLength(void) const;
+
+        /**
+         * @brief Is this value zero?
+         * @return True if the value is zero.
+         */
+        bool IsZero(void) const;
+
+        /**
+         * @brief Multiply by a small value in place.
+         * @param value The value to multiply by.
+         */
+        void MulSmall(std::uint32_t value);
+
+        /**
+         * @brief Get the value modulo a small number.
+         * @param modulus The modulus, must not be zero.
+         * @return The remainder.
+         */
+        std::uint32_t ModSmall(std::uint32_t modulus) const;
+
+        /**
+         * @brief Format the value in decimal.
+         * @return The decimal digits.
+         */
+        std::string ToString(void) const;
+
+        /**
+         * @brief Compare two values.
+         * @param other The value to compare with.
+         * @return True if both are equal.
+         */
+        bool operator==(const BigUnsigned& other) const;
+
+    private:
+        /**
+         * @brief A helper to drop leading zero limbs.
+         */
+        void trim(void);
+
+        /// @brief The 32 bit limbs, least significant first, no leading zeros.
+        std::vector<std::uint32_t> m_limbs;
+};
+
+/**
+ * @brief Write a big integer in decimal to a stream.
+ * @param stream The stream written to.
+ * @param value The value to write.
+ * @return The stream.
+ */
+std::ostream& operator<<(std::ostream& stream, const BigUnsigned& value);
+
+#endif
@@ -0,0 +1,79 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef BIPARTITE_HPP
+#define BIPARTITE_HPP
+
+#include "AdjacencyStore.hpp"
+#include "JobControl.hpp"
+
+/// @brief The two colouring of one connected component.
+typedef struct bipartiteComponent {
+    /// @brief Can this component be two coloured?
+    bool IsBipartite;
+
+    /// @brief The vertices of the first part, empty if the component is not bipartite.
+    std::vector<VertexId> Left;
+
+    /// @brief The vertices of the second part, empty if the component is not bipartite.
+    std::vector<VertexId> Right;
+} BipartiteComponent;
+
+/// @brief The result of a bipartite check.
+typedef struct bipartiteResult {
+    /// @brief Is every component bipartite?
+    bool IsBipartite;
+
+    /// @brief The component of each vertex, an index into Components.
+    std::vector<std::uint32_t> Component;
+
+    /// @brief The result per connected component.
+    std::vector<BipartiteComponent> Components;
+
+    /// @brief An odd cycle proving the graph is not bipartite, consecutive vertices and the last and first are adjacent.
+    std::vector<VertexId> OddCycle;
+} BipartiteResult;
+
+/// @brief Linear time bipartite checking by breadth first two colouring.
+class Bipartite {
+    public:
+        /**
+         * @brief Two colour every component of a graph, edge directions are ignored.
+         *
+         * Runs in O(n + m) over the CSR view. When a component is small enough the witness is the shortest odd
+         * cycle of the graph, otherwise it is an odd cycle closed by the first same-level edge of the breadth
+         * first search, which need not be the shortest.
+         * @param topology The graph to check.
+         * @param control Receives the fraction of vertices coloured and is checked for cancellation, may be null.
+         * @return The parts of every component and, if the graph is not bipartite, an odd cycle, partial if cancelled.
+         */
+        static BipartiteResult Check(const AdjacencyStore& topology, JobControl* control = nullptr);
+
+    private:
+        /**
+         * @brief Find the shortest odd cycle of a component with a breadth first search from every vertex.
+         * @param csr The symmetric CSR view.
+         * @param members The vertices of the component.
+         * @param distance Scratch space of one entry per vertex, all unset, left unset.
+         * @param parent Scratch space of one entry per vertex.
+         * @param control Checked for cancellation between searches, may be null.
+         * @return The vertices of the cycle, the shortest found so far if cancelled.
+         */
+        static std::vector<VertexId> shortestOddCycle(const AdjacencyStore::CSR& csr, const std::vector<VertexId>& members, std::vector<std::uint32_t>& distance, std::vector<VertexId>& parent, const JobControl* control);
+
+        /**
+         * @brief Close an odd cycle from an edge between two vertices at the same search depth.
+         * @param parent The search tree.
+         * @param first One end of the edge.
+         * @param second The other end of the edge.
+         * @return The vertices of the cycle through the lowest common ancestor of both ends.
+         */
+        static std::vector<VertexId> treeCycle(const std::vector<VertexId>& parent, VertexId first, VertexId second);
+
+        /// @brief Components up to this many vertex-edge steps get the exact shortest odd cycle.
+        static constexpr double ExactWitnessBudget = 67108864.0;
+};
+
+#endif
@@ -0,0 +1,115 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef BIT_ADJACENCY_HPP
+#define BIT_ADJACENCY_HPP
+
+#include "AdjacencyStore.hpp"
+
+/**
+ * @brief A packed bitset adjacency matrix of the underlying undirected simple graph, for dense graph kernels.
+ *
+ * Every row is a bitset over the vertices padded to whole 512 bit blocks, one bit per cell instead of the 32 of a
+ * float matrix. Rows are intersected and counted with AVX-512 or AVX2 kernels where the processor has them, picked
+ * once at run time, and a portable loop otherwise.
+ */
+class BitAdjacency {
+    public:
+        /**
+         * @brief Creates an empty matrix.
+         */
+        BitAdjacency(void);
+
+        /**
+         * @brief Rebuild the matrix from a topology, edge directions and self loops are dropped.
+         * @param topology The topology, at most VertexLimit vertices.
+         * @return False if the topology has too many vertices, the matrix is left empty then.
+         */
+        bool Assign(const AdjacencyStore& topology);
+
+        /**
+         * @brief Count the vertices adjacent to both of two vertices in O(n / 64).
+         * @param u The first vertex.
+         * @param v The second vertex.
+         * @return The number of common neighbours.
+         */
+        std::size_t CommonNeighbors(VertexId u, VertexId v) const;
+
+        /**
+         * @brief Get the degree of a vertex, counting its row.
+         * @param v The vertex.
+         * @return The number of neighbours.
+         */
+        std::size_t GetDegree(VertexId v) const;
+
+        /**
+         * @brief Get the row of a vertex.
+         * @param v The vertex.
+         * @return GetWords() words, bit u set if u and v are adjacent.
+         */
+        const std::uint64_t* GetRow(VertexId v) const;
+
+        /**
+         * @brief Get the number of vertices.
+         * @return The number of vertices.
+         */
+        std::size_t GetVertexCount(void) const;
+
+        /**
+         * @brief Get the topology version the matrix was built from.
+         * @return The version.
+         */
+        std::uint64_t GetVersion(void) const;
+
+        /**
+         * @brief Get the number of 64 bit words per row, a multiple of BlockWords.
+         * @return The number of words.
+         */
+        std::size_t GetWords(void) const;
+
+        /**
+         * @brief Check for an edge in O(1).
+         * @param u The first vertex.
+         * @param v The second vertex.
+         * @return True if u and v are adjacent.
+         */
+        bool HasEdge(VertexId u, VertexId v) const;
+
+        /**
+         * @brief Count the bits set in both of two bitsets.
+         * @param first The first bitset.
+         * @param second The second bitset.
+         * @param words The length of both in words, a multiple of BlockWords.
+         * @return The number of bits set in both.
+         */
+        static std::size_t CountAnd(const std::uint64_t* first, const std::uint64_t* second, std::size_t words);
+
+        /**
+         * @brief Get the name of the kernel CountAnd() runs on this processor.
+         * @return "AVX-512", "AVX2" or "scalar".
+         */
+        static const char* GetKernelName(void);
+
+        /// @brief The number of words in a 512 bit block, rows are padded to whole blocks so kernels need no tail.
+        static constexpr std::size_t BlockWords = 8;
+
+        /// @brief The most vertices a matrix holds, its rows take n^2 / 8 bytes, 128 MiB at the limit.
+        static constexpr std::size_t VertexLimit = 1 << 15;
+
+    private:
+        /// @brief The rows back to back, m_words words each.
+        std::vector<std::uint64_t> m_bits;
+
+        /// @brief The number of vertices.
+        std::size_t m_size;
+
+        /// @brief The topology version the matrix was built from.
+        std::uint64_t m_version;
+
+        /// @brief The number of words per row.
+        std::size_t m_words;
+};
+
+#endif
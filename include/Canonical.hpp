@@ -0,0 +1,394 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef CANONICAL_HPP
+#define CANONICAL_HPP
+
+#include "AdjacencyStore.hpp"
+#include "JobControl.hpp"
+
+/// @brief A 128 bit hash of a canonical form, equal for isomorphic graphs.
+typedef struct canonicalHash {
+    /// @brief The high 64 bits.
+    std::uint64_t High;
+
+    /// @brief The low 64 bits.
+    std::uint64_t Low;
+
+    /**
+     * @brief Compare two hashes.
+     * @param other The other hash.
+     * @return True if all 128 bits match.
+     */
+    bool operator==(const canonicalHash& other) const = default;
+
+    /**
+     * @brief Format the hash.
+     * @return 32 hexadecimal digits, high bits first.
+     */
+    std::string ToString(void) const;
+} CanonicalHash;
+
+/// @brief The canonical form of a graph, the same for every graph isomorphic to it.
+typedef struct canonicalForm {
+    /// @brief The canonical label of every vertex, a permutation of the vertex ids.
+    std::vector<VertexId> Labels;
+
+    /// @brief The edges in canonical labels, packed as first << 32 | second and sorted, undirected ones with first <= second.
+    std::vector<std::uint64_t> Edges;
+
+    /// @brief The number of vertices.
+    std::size_t VertexCount;
+
+    /// @brief Is the graph directed?
+    bool IsDirected;
+
+    /// @brief The hash of the vertex count, directedness and edges.
+    CanonicalHash Hash;
+
+    /// @brief The number of automorphisms the search found, plus one per merged twin.
+    std::size_t Generators;
+
+    /// @brief The number of search tree nodes visited.
+    std::size_t Nodes;
+
+    /// @brief Did the search finish? Otherwise the form is only the best one found and isomorphic graphs may differ.
+    bool IsExact;
+} CanonicalForm;
+
+/**
+ * @brief Canonical labelling by colour refinement and an individualisation-refinement search, after McKay's nauty.
+ *
+ * Vertices are split into an ordered partition refined until equitable, every vertex of a cell having as many
+ * neighbours in each other cell as its cellmates (one dimensional Weisfeiler-Leman), in O(m log n) with Hopcroft's
+ * smaller half trick. While cells remain, a vertex of the first non singleton cell is singled out and the partition
+ * refined again, and every discrete partition reached is a leaf labelling. Leaves are ordered by their refinement
+ * trace, the sequence of splits on the way down, then by their relabelled edge lists, and the smallest is canonical.
+ * A child whose trace falls behind the best leaf's is abandoned at the split it does, so a rigid graph, whose every
+ * child of the root is a leaf, costs about a neighbourhood per child rather than a whole refinement. Leaves that
+ * relabel the graph alike give automorphisms, which prune the children of every node to one per orbit and cut the
+ * search back to where the equivalent subtree branched off. Edge weights are ignored, self loops are kept.
+ *
+ * The search finds symmetries one leaf at a time, O(k²) nodes for a star of k leaves, so the cheap ones go first. A
+ * graph of several components, edge directions ignored, has each labelled on its own and the components ordered by
+ * their size and edges, so k copies of one component cost k small searches rather than k! leaves. Within a component
+ * trees hanging off the graph are peeled into colours of the vertices they hang from, then twins, vertices with the
+ * same neighbours and colour, merge into one vertex coloured by their number. The search runs on what is left, and
+ * the labels spread back out to twins consecutively and to the peeled trees breadth first.
+ */
+class Canonical {
+    public:
+        /**
+         * @brief Check two canonical forms for isomorphism of their graphs, in O(n + m).
+         * @param first The first form.
+         * @param second The second form.
+         * @return True if the graphs are isomorphic, exact when both forms are.
+         */
+        static bool IsIsomorphic(const CanonicalForm& first, const CanonicalForm& second);
+
+        /**
+         * @brief Compute the canonical form of a graph.
+         * @param topology The graph.
+         * @param control Checked for cancellation, may be null.
+         * @return The canonical form, not IsExact if cancelled or past MaxNodes.
+         */
+        static CanonicalForm Label(const AdjacencyStore& topology, JobControl* control = nullptr);
+
+        /**
+         * @brief Compute the canonical forms of several graphs at once, one graph per task on a work stealing pool.
+         * @param graphs The graphs.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of graphs done and is checked for cancellation, may be null.
+         * @return The form of every graph, in order.
+         */
+        static std::vector<CanonicalForm> LabelAll(const std::vector<std::shared_ptr<const AdjacencyStore>>& graphs, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /// @brief The most search tree nodes visited before settling for the best leaf so far.
+        static constexpr std::size_t MaxNodes = 1 << 20;
+
+    private:
+        /// @brief A node of the search tree on the way to the current one.
+        typedef struct frame {
+            /// @brief The start of the cell whose vertices are the node's children.
+            std::uint32_t Start;
+
+            /// @brief The length of the trail at the node, to undo its children back to.
+            std::size_t Mark;
+
+            /// @brief The children tried, first the one at the start of the cell and then by increasing vertex id.
+            std::vector<VertexId> Tried;
+
+            /// @brief The union-find parents of the vertices automorphisms fixing the path join, missing for roots.
+            std::unordered_map<VertexId, VertexId> Orbits;
+
+            /// @brief The number of generators already joined into Orbits.
+            std::size_t Applied;
+        } Frame;
+
+        /// @brief A split of a cell, enough to merge it back.
+        typedef struct split {
+            /// @brief The start of the cell, which its first part keeps.
+            std::uint32_t Start;
+
+            /// @brief The start of the second part.
+            std::uint32_t Middle;
+
+            /// @brief The end of the cell before the split.
+            std::uint32_t End;
+
+            /// @brief A hash of the cell and the size and splitter count of every part, the same under any vertex ids.
+            std::uint64_t Code;
+        } Split;
+
+        /// @brief The graph and the state of one search.
+        typedef struct search {
+            /// @brief The number of vertices.
+            std::size_t Size;
+
+            /// @brief Is the graph directed?
+            bool IsDirected;
+
+            /// @brief Row offsets into Out.
+            std::vector<std::size_t> OutOffsets;
+
+            /// @brief The sorted distinct targets of the edges leaving every vertex.
+            std::vector<VertexId> Out;
+
+            /// @brief Row offsets into In, the same as OutOffsets when undirected.
+            std::vector<std::size_t> InOffsets;
+
+            /// @brief The sorted distinct sources of the edges entering every vertex, the same as Out when undirected.
+            std::vector<VertexId> In;
+
+            /// @brief The vertices in partition order, every cell a range of positions.
+            std::vector<VertexId> Order;
+
+            /// @brief The position of every vertex in Order.
+            std::vector<std::uint32_t> Position;
+
+            /// @brief The start of the cell of every vertex.
+            std::vector<std::uint32_t> CellOf;
+
+            /// @brief The end of every cell, indexed by its start.
+            std::vector<std::uint32_t> CellEnd;
+
+            /// @brief The number of cells.
+            std::size_t CellCount;
+
+            /// @brief Every split since the start of the search, undone in reverse on backtracking.
+            std::vector<Split> Trail;
+
+            /// @brief The starts of the cells still to refine against, first in first out.
+            std::vector<std::uint32_t> Queue;
+
+            /// @brief Is the cell starting at a position in Queue?
+            std::vector<std::uint8_t> InQueue;
+
+            /// @brief The neighbours every vertex has in the current splitter, scratch for refine().
+            std::vector<std::uint32_t> Counts;
+
+            /// @brief The vertices with a neighbour in the current splitter, scratch for refine().
+            std::vector<VertexId> Touched;
+
+            /// @brief The touched vertices of every cell, indexed by its start, scratch for refine().
+            std::vector<std::uint32_t> CellTouched;
+
+            /// @brief The starts of the cells with touched vertices, scratch for refine().
+            std::vector<std::uint32_t> TouchedCells;
+
+            /// @brief The starts of the parts of the cell being split, scratch for splitCell().
+            std::vector<std::uint32_t> Bounds;
+
+            /// @brief The vertex singled out at every depth of the current node.
+            std::vector<VertexId> Path;
+
+            /// @brief Is a vertex on Path?
+            std::vector<std::uint8_t> IsFixed;
+
+            /// @brief Is a vertex the orbit representative of a child tried, scratch for choosing the next child.
+            std::vector<std::uint8_t> IsTried;
+
+            /// @brief The first leaf, the vertex at every position.
+            std::vector<VertexId> First;
+
+            /// @brief The position of every vertex in First.
+            std::vector<std::uint32_t> FirstPosition;
+
+            /// @brief The path to the first leaf.
+            std::vector<VertexId> FirstPath;
+
+            /// @brief The best leaf so far, the vertex at every position.
+            std::vector<VertexId> Best;
+
+            /// @brief The position of every vertex in Best.
+            std::vector<std::uint32_t> BestPosition;
+
+            /// @brief The path to the best leaf.
+            std::vector<VertexId> BestPath;
+
+            /// @brief The edges relabelled by the best leaf, packed and sorted.
+            std::vector<std::uint64_t> BestEdges;
+
+            /// @brief The codes of the trail at the best leaf, its refinement trace.
+            std::vector<std::uint64_t> BestTrace;
+
+            /// @brief The number of splits at the start of Trail matching BestTrace.
+            std::size_t Agreed;
+
+            /// @brief How the trail compares to BestTrace where they part, -1 before it, 1 after and 0 while they match.
+            int Standing;
+
+            /// @brief The automorphisms found, each as the pairs of a vertex it moves and its image.
+            std::vector<std::vector<std::pair<VertexId, VertexId>>> Generators;
+
+            /// @brief The number of search tree nodes visited.
+            std::size_t Nodes;
+        } Search;
+
+        /**
+         * @brief A helper to relabel the edges by a leaf.
+         * @param search The search.
+         * @param position The position of every vertex in the leaf, its label.
+         * @return The edges packed as first << 32 | second and sorted.
+         */
+        static std::vector<std::uint64_t> certificate(const Search& search, const std::vector<std::uint32_t>& position);
+
+        /**
+         * @brief A helper to replace the search's graph by the one between groups of its vertices.
+         * @param search The search.
+         * @param groupOf The group of every vertex, InvalidVertexId to leave it out.
+         * @param first A vertex of every group, whose edges stand for those of the group.
+         * @param kind The kind of every group from twins(), the edges inside it kept only when 0.
+         */
+        static void contract(Search& search, const std::vector<VertexId>& groupOf, const std::vector<VertexId>& first, const std::vector<std::uint8_t>& kind);
+
+        /**
+         * @brief A helper to check whether mapping one leaf onto the current one is an automorphism.
+         *
+         * Only the vertices the map moves and their edges are looked at, so the check is cheap for the sparse
+         * automorphisms, swapped leaves or twins, that most graphs have.
+         * @param search The search, its current partition a leaf.
+         * @param from The other leaf.
+         * @param fromPosition The position of every vertex in it.
+         * @param generator Set to the moved vertices and their images if it is one.
+         * @return True if it is an automorphism.
+         */
+        static bool isAutomorphism(const Search& search, const std::vector<VertexId>& from, const std::vector<std::uint32_t>& fromPosition, std::vector<std::pair<VertexId, VertexId>>& generator);
+
+        /**
+         * @brief A helper to add a split to the trail and compare it to the best leaf's trace.
+         * @param search The search.
+         * @param split The split.
+         */
+        static void record(Search& search, const Split& split);
+
+        /**
+         * @brief A helper to single out a vertex in its cell and refine from there.
+         * @param search The search.
+         * @param v The vertex, in a cell of two or more.
+         */
+        static void individualize(Search& search, VertexId v);
+
+        /**
+         * @brief A helper to label a connected graph, peeling its trees, merging its twins and searching what is left.
+         * @param search The search, holding only the graph's neighbour lists, and the transposed ones when directed.
+         * @param control Checked for cancellation, may be null.
+         * @return The canonical form, without its hash.
+         */
+        static CanonicalForm labelConnected(Search& search, JobControl* control);
+
+        /**
+         * @brief A helper to process the current partition once it is discrete.
+         * @param search The search.
+         * @return The depth to go back to, the current depth if the search goes on as usual.
+         */
+        static std::size_t leaf(Search& search);
+
+        /**
+         * @brief A helper to peel the trees hanging off an undirected graph, the AHU tree canonisation.
+         *
+         * Leaves are cut off a round at a time until a core of cycles and paths between them is left, or the centre
+         * of a tree. Every cut vertex gets a type, the same for two of them exactly when their subtrees are isomorphic.
+         * @param search The search, its graph the whole one.
+         * @param parent Set to the vertex every cut vertex hung from, InvalidVertexId for the core.
+         * @param colour Set to the type of every cut vertex, and of every core vertex a colour telling its self loop
+         * and the types hanging from it, or just its self loop for a directed graph, which is left whole.
+         */
+        static void peel(const Search& search, std::vector<VertexId>& parent, std::vector<std::uint32_t>& colour);
+
+        /**
+         * @brief A helper to split cells against the queued cells until the partition is equitable, or until the trail
+         * falls behind the best leaf's trace.
+         * @param search The search.
+         */
+        static void refine(Search& search);
+
+        /**
+         * @brief A helper to split a cell by the splitter counts of its touched vertices, the largest part first.
+         * @param search The search.
+         * @param start The start of the cell.
+         */
+        static void splitCell(Search& search, std::uint32_t start);
+
+        /**
+         * @brief A helper to group the vertices into twin classes, vertices with self loops always on their own.
+         * @param search The search, its graph the core from peel().
+         * @param colour The colour of every vertex, which twins share.
+         * @param classOf Set to the class of every vertex, classes numbered in order of their smallest vertex.
+         * @param kind Set to the kind of every class, 0 for a single vertex, 1 for non adjacent and 2 for adjacent twins.
+         * @return The number of classes.
+         */
+        static std::size_t twins(const Search& search, const std::vector<std::uint32_t>& colour, std::vector<VertexId>& classOf, std::vector<std::uint8_t>& kind);
+
+        /**
+         * @brief A helper to merge cells back to an earlier partition.
+         * @param search The search.
+         * @param mark The length of the trail to go back to.
+         */
+        static void undo(Search& search, std::size_t mark);
+};
+
+/// @brief Canonical hashes of graphs seen before, answering whether a graph is new in O(1).
+class CanonicalCache {
+    public:
+        /**
+         * @brief Look a graph up.
+         * @param hash The canonical hash of the graph.
+         * @return The name it was first added under, or nullptr if it was never added.
+         */
+        const std::string* Find(const CanonicalHash& hash) const;
+
+        /**
+         * @brief Add a graph, unless one isomorphic to it was added before.
+         * @param hash The canonical hash of the graph.
+         * @param name The name to remember it by.
+         * @return True if the graph was new.
+         */
+        bool Insert(const CanonicalHash& hash, const std::string& name);
+
+        /**
+         * @brief Get the number of distinct graphs added.
+         * @return The number of hashes.
+         */
+        std::size_t GetSize(void) const;
+
+    private:
+        /// @brief Hashes a canonical hash for the map, its low bits are already uniform.
+        typedef struct hasher {
+            /**
+             * @brief Hash a canonical hash.
+             * @param hash The canonical hash.
+             * @return Its low 64 bits.
+             */
+            std::size_t operator()(const CanonicalHash& hash) const {
+                return static_cast<std::size_t>(hash.Low);
+            }
+        } Hasher;
+
+        /// @brief The name every hash was first added under.
+        std::unordered_map<CanonicalHash, std::string, Hasher> m_names;
+};
+
+#endif
@@ -8,7 +8,7 @@
 
 #include "Graph.hpp"
 
-/// @brief A canvas to draw graphs and planes on.
+/// @brief A canvas to draw graphs and planes on, seen through a pan and zoom camera.
 class Canvas {
     public:
         /**
@@ -18,7 +18,48 @@ class Canvas {
          */
         static void Draw(sf::RenderWindow *window, std::vector<Graph*>& graphs);
 
+        /**
+         * @brief Move the camera, dragging with the right or middle mouse button pans and the wheel zooms at the cursor.
+         * @param window A pointer to the window being drawn on.
+         * @param event The event to handle.
+         */
+        static void HandleEvent(sf::RenderWindow *window, const sf::Event& event);
+
+        /**
+         * @brief Map a window pixel to world coordinates through the camera.
+         * @param pixel The pixel in window coordinates.
+         * @return The point in world coordinates.
+         */
+        static sf::Vector2f MapPixelToWorld(sf::Vector2i pixel);
+
     private:
+        /**
+         * @brief A helper to get the world rectangle the camera shows.
+         * @param window A pointer to the window being drawn on.
+         * @return The visible rectangle.
+         */
+        static sf::FloatRect getVisibleRect(sf::RenderWindow *window);
+
+        /// @brief Is the camera being dragged?
+        static bool m_isPanning;
+
+        /// @brief The world position of the top left corner of the window.
+        static sf::Vector2f m_origin;
+
+        /// @brief The last pixel seen while panning.
+        static sf::Vector2i m_panPixel;
+
+        /// @brief The number of world units per pixel.
+        static float m_zoom;
+
+        /// @brief The most zoomed in the camera goes.
+        static constexpr float MinZoom = 1.0f / 16.0f;
+
+        /// @brief The most zoomed out the camera goes.
+        static constexpr float MaxZoom = 1024.0f;
+
+        /// @brief The zoom factor of one wheel step.
+        static constexpr float ZoomStep = 1.1f;
 };
 
-#endif
\ No newline at end of file
+#endif
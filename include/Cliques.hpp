@@ -0,0 +1,151 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef CLIQUES_HPP
+#define CLIQUES_HPP
+
+#include "BitAdjacency.hpp"
+#include "JobControl.hpp"
+
+/// @brief The triangles of a graph and the clustering they give.
+typedef struct triangleResult {
+    /// @brief The number of triangles through every vertex.
+    std::vector<std::uint64_t> PerVertex;
+
+    /// @brief The number of triangles.
+    std::uint64_t Total;
+
+    /// @brief The local clustering coefficient of every vertex, 0 below degree 2.
+    std::vector<float> Clustering;
+
+    /// @brief The mean local clustering coefficient.
+    double AverageClustering;
+
+    /// @brief Three times the triangles over the paths of length two, the global clustering coefficient.
+    double Transitivity;
+} TriangleResult;
+
+/// @brief A clique of a graph.
+typedef struct cliqueResult {
+    /// @brief The vertices of the clique.
+    std::vector<VertexId> Vertices;
+
+    /// @brief Is the clique proven to be a largest one?
+    bool IsExact;
+} CliqueResult;
+
+/// @brief Triangles, clustering and maximum cliques, over bitset adjacency rows.
+class Cliques {
+    public:
+        /**
+         * @brief Find a maximum clique with a bit-parallel branch and bound.
+         *
+         * Vertices are renumbered in degeneracy order, the core first. At every node of the search the candidates are greedily
+         * coloured a colour class at a time with bitset operations, a clique can take at most one vertex per class,
+         * so candidates whose colour cannot beat the best clique are never branched on. The first level of the tree is
+         * split into one subproblem per vertex on a work stealing pool, all sharing the size of the best clique.
+         * @param adjacency The graph.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of subproblems searched and is checked for cancellation, may be null.
+         * @return The largest clique found, IsExact unless the search was cancelled.
+         */
+        static CliqueResult Maximum(const BitAdjacency& adjacency, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /**
+         * @brief Count the triangles through every vertex and the clustering coefficients.
+         *
+         * Every vertex intersects its row with the rows of its neighbours, each triangle is seen twice from each of
+         * its corners, in O(m n / 64) over the vector kernels. Vertices are split into chunks on a pool.
+         * @param adjacency The graph.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of vertices done and is checked for cancellation, may be null.
+         * @return The triangles and clustering, meaningless if cancelled.
+         */
+        static TriangleResult Triangles(const BitAdjacency& adjacency, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+    private:
+        /// @brief The buffers of one depth of the search.
+        typedef struct level {
+            /// @brief The candidates of the next depth.
+            std::vector<std::uint64_t> Next;
+
+            /// @brief The candidates worth branching on, in increasing colour.
+            std::vector<std::uint32_t> Order;
+
+            /// @brief The colour of each of them, from 1.
+            std::vector<std::uint32_t> Colors;
+        } Level;
+
+        /// @brief The buffers of one subproblem, sized up front so the search never allocates.
+        typedef struct workspace {
+            /// @brief The clique being grown, in search positions.
+            std::vector<std::uint32_t> Clique;
+
+            /// @brief The buffers of every depth, indexed by clique size.
+            std::vector<Level> Levels;
+
+            /// @brief The candidates not coloured yet, for colorSort().
+            std::vector<std::uint64_t> Uncolored;
+
+            /// @brief The candidates the current colour class may still take, for colorSort().
+            std::vector<std::uint64_t> Available;
+        } Workspace;
+
+        /// @brief What every subproblem of one maximum clique search shares.
+        typedef struct search {
+            /// @brief The number of vertices.
+            std::size_t Size;
+
+            /// @brief The number of 64 bit words per row.
+            std::size_t Words;
+
+            /// @brief The adjacency rows in search order, bit j of row i set if the i-th and j-th vertices are adjacent.
+            std::vector<std::uint64_t> Rows;
+
+            /// @brief The vertex id of every position in search order.
+            std::vector<VertexId> Order;
+
+            /// @brief The size of the largest clique found so far.
+            std::atomic<std::uint32_t> Best;
+
+            /// @brief The largest clique found so far, in search positions.
+            std::vector<std::uint32_t> BestClique;
+
+            /// @brief Guards BestClique.
+            std::mutex Mutex;
+
+            /// @brief Checked for cancellation, may be null.
+            JobControl* Control;
+        } Search;
+
+        /**
+         * @brief A helper to greedily colour candidates, a colour class at a time.
+         * @param search The search.
+         * @param workspace The scratch bitsets.
+         * @param candidates The candidates, one bit per search position.
+         * @param minColor Candidates with a smaller colour are left out of the result, they cannot improve the best.
+         * @param order Set to the candidates of colour at least minColor, in increasing colour.
+         * @param colors Set to the colour of each of them, from 1.
+         */
+        static void colorSort(const Search& search, Workspace& workspace, const std::uint64_t* candidates, std::uint32_t minColor, std::vector<std::uint32_t>& order, std::vector<std::uint32_t>& colors);
+
+        /**
+         * @brief A helper to search every clique that extends the workspace clique by candidates adjacent to all of it.
+         * @param search The search.
+         * @param workspace The clique, restored on return, and the buffers.
+         * @param candidates The candidates, one bit per search position, consumed.
+         * @return False once cancelled.
+         */
+        static bool expand(Search& search, Workspace& workspace, std::vector<std::uint64_t>& candidates);
+
+        /**
+         * @brief A helper to keep a clique if it is larger than the best so far.
+         * @param search The search.
+         * @param clique The clique, in search positions.
+         */
+        static void offer(Search& search, const std::vector<std::uint32_t>& clique);
+};
+
+#endif
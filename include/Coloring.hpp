@@ -0,0 +1,174 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef COLORING_HPP
+#define COLORING_HPP
+
+#include "AdjacencyStore.hpp"
+#include "JobControl.hpp"
+
+/// @brief A proper vertex colouring.
+typedef struct coloringResult {
+    /// @brief The colour of every vertex, from 1, adjacent vertices differ. Matches Vertex::VertexColor.
+    std::vector<int> Colors;
+
+    /// @brief The number of colours used.
+    std::size_t ColorCount;
+
+    /// @brief No colouring uses fewer colours than this, the size of a clique found, 0 if none was looked for.
+    std::size_t LowerBound;
+
+    /// @brief Is ColorCount proven to be the chromatic number?
+    bool IsExact;
+} ColoringResult;
+
+/// @brief Vertex colouring, greedy heuristics for large graphs and an exact chromatic number for small ones.
+class Coloring {
+    public:
+        /**
+         * @brief Colour a graph with DSATUR, always colouring next the vertex whose neighbours use the most colours.
+         *
+         * Runs in O((n + m) log n). Edge directions and self loops are ignored.
+         * @param topology The graph to colour.
+         * @param control Receives the fraction of vertices coloured and is checked for cancellation, may be null.
+         * @return The colouring, partial with 0 for the uncoloured vertices if cancelled.
+         */
+        static ColoringResult Dsatur(const AdjacencyStore& topology, JobControl* control = nullptr);
+
+        /**
+         * @brief Find the chromatic number of a graph and a colouring that attains it.
+         *
+         * The upper bound starts from DSATUR and the lower bound from the largest clique found greedily. In between
+         * a DSATUR ordered branch and bound over bitset adjacency rows searches for a colouring with fewer colours,
+         * the top of the search tree split into subproblems on a work stealing pool. Graphs with more than
+         * ExactLimit vertices only get the DSATUR colouring. Edge directions and self loops are ignored.
+         * @param topology The graph to colour.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of subproblems searched and is checked for cancellation, may be null.
+         * @return The best colouring found, IsExact unless the graph was too large or the search was cancelled.
+         */
+        static ColoringResult Exact(const AdjacencyStore& topology, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /**
+         * @brief Colour a graph first fit, the vertices in order of decreasing degree (Welsh-Powell).
+         *
+         * Runs in O(n log n + m). Edge directions and self loops are ignored.
+         * @param topology The graph to colour.
+         * @return The colouring.
+         */
+        static ColoringResult Greedy(const AdjacencyStore& topology);
+
+        /// @brief The most vertices Exact() searches, larger graphs only get DSATUR.
+        static constexpr std::size_t ExactLimit = 512;
+
+    private:
+        /// @brief A partial colouring in the branch and bound, with the bookkeeping to extend and undo it cheaply.
+        typedef struct searchState {
+            /// @brief The colour of every vertex, from 0, NoColor while uncoloured.
+            std::vector<std::uint32_t> Colors;
+
+            /// @brief For every vertex and colour, the number of coloured neighbours with that colour, row major.
+            std::vector<std::uint16_t> Counts;
+
+            /// @brief The number of distinct colours among the neighbours of every vertex.
+            std::vector<std::uint32_t> Saturation;
+
+            /// @brief The number of vertices with every colour.
+            std::vector<std::uint32_t> ClassSizes;
+
+            /// @brief The number of colours used.
+            std::uint32_t ColorCount;
+
+            /// @brief The number of vertices still uncoloured.
+            std::size_t Uncolored;
+        } SearchState;
+
+        /// @brief What every subproblem of one exact search shares.
+        typedef struct search {
+            /// @brief The number of vertices.
+            std::size_t Size;
+
+            /// @brief The number of 64 bit words per adjacency row.
+            std::size_t Words;
+
+            /// @brief The adjacency rows, bit u of row v set if u and v are adjacent.
+            std::vector<std::uint64_t> Adjacency;
+
+            /// @brief The degree of every vertex, to break saturation ties.
+            std::vector<std::uint32_t> Degree;
+
+            /// @brief The number of colour columns in SearchState::Counts, the DSATUR colour count.
+            std::size_t Palette;
+
+            /// @brief The size of the clique found, no colouring can do better.
+            std::uint32_t LowerBound;
+
+            /// @brief The fewest colours found so far.
+            std::atomic<std::uint32_t> Best;
+
+            /// @brief The colouring with Best colours.
+            std::vector<std::uint32_t> BestColors;
+
+            /// @brief Guards BestColors.
+            std::mutex Mutex;
+
+            /// @brief Checked for cancellation, may be null.
+            JobControl* Control;
+        } Search;
+
+        /**
+         * @brief A helper to colour a vertex, updating the saturation of its uncoloured neighbours.
+         * @param search The search.
+         * @param state The partial colouring.
+         * @param v The vertex.
+         * @param color The colour, at most the colour count, a new colour when equal to it.
+         */
+        static void assign(const Search& search, SearchState& state, VertexId v, std::uint32_t color);
+
+        /**
+         * @brief A helper to search every completion of a partial colouring with fewer than the best colours.
+         * @param search The search.
+         * @param state The partial colouring, restored on return.
+         */
+        static void branch(Search& search, SearchState& state);
+
+        /**
+         * @brief A helper to find a large clique greedily from every vertex.
+         * @param search The search.
+         * @return The vertices of the largest clique found.
+         */
+        static std::vector<VertexId> greedyClique(const Search& search);
+
+        /**
+         * @brief A helper to keep a complete colouring if it uses fewer colours than the best so far.
+         * @param search The search.
+         * @param state The colouring.
+         */
+        static void offer(Search& search, const SearchState& state);
+
+        /**
+         * @brief A helper to pick the vertex to branch on, the most saturated, then the highest degree.
+         * @param search The search.
+         * @param state The partial colouring, with an uncoloured vertex.
+         * @return The vertex.
+         */
+        static VertexId select(const Search& search, const SearchState& state);
+
+        /**
+         * @brief A helper to undo assign().
+         * @param search The search.
+         * @param state The partial colouring.
+         * @param v The vertex, the last one coloured.
+         */
+        static void unassign(const Search& search, SearchState& state, VertexId v);
+
+        /// @brief The colour of an uncoloured vertex in a search state.
+        static constexpr std::uint32_t NoColor = std::numeric_limits<std::uint32_t>::max();
+
+        /// @brief The top of the search tree is split until there are this many subproblems per worker.
+        static constexpr std::size_t SubproblemsPerThread = 16;
+};
+
+#endif
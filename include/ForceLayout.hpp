@@ -0,0 +1,211 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef FORCE_LAYOUT_HPP
+#define FORCE_LAYOUT_HPP
+
+#include "AdjacencyStore.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @brief A Fruchterman-Reingold force-directed layout, run a few iterations at a time.
+ *
+ * Adjacent vertices attract, every pair of vertices repels through a Barnes-Hut quadtree in O(n log n) per
+ * iteration, and gravity toward the center keeps components together. Moves are capped by a temperature that
+ * cools every iteration, the layout has settled once it is cold. Positions and forces are kept as separate float
+ * arrays so the inner loops vectorize, and forces are computed in chunks of vertices on a thread pool.
+ */
+class ForceLayout {
+    public:
+        /**
+         * @brief Creates an empty, settled layout.
+         */
+        ForceLayout(void);
+
+        /**
+         * @brief Take over the topology and positions of a graph, keeping the temperature.
+         *
+         * Vertices on top of each other are pushed slightly apart, they would otherwise never separate.
+         * @param topology The topology, directed edges pull like undirected ones.
+         * @param x The horizontal position of every vertex.
+         * @param y The vertical position of every vertex.
+         */
+        void Assign(const AdjacencyStore& topology, std::vector<float> x, std::vector<float> y);
+
+        /**
+         * @brief Get the topology version the layout was assigned from.
+         * @return The version.
+         */
+        std::uint64_t GetVersion(void) const;
+
+        /**
+         * @brief Get the horizontal positions.
+         * @return The position of every vertex, indexed by id.
+         */
+        std::span<const float> GetX(void) const;
+
+        /**
+         * @brief Get the vertical positions.
+         * @return The position of every vertex, indexed by id.
+         */
+        std::span<const float> GetY(void) const;
+
+        /**
+         * @brief Heat the layout up so vertices can travel about a tenth of the drawing again.
+         */
+        void Heat(void);
+
+        /**
+         * @brief Is the layout still moving vertices?
+         * @return False once it has cooled down.
+         */
+        bool IsRunning(void) const;
+
+        /**
+         * @brief Pin or unpin a vertex, pinned vertices are not moved but still push and pull the others.
+         * @param id The id of the vertex.
+         * @param isPinned Is the vertex pinned?
+         */
+        void SetPinned(VertexId id, bool isPinned);
+
+        /**
+         * @brief Move a vertex, such as one dragged by the user.
+         * @param id The id of the vertex.
+         * @param x The new horizontal position.
+         * @param y The new vertical position.
+         */
+        void SetPosition(VertexId id, float x, float y);
+
+        /**
+         * @brief Run some iterations.
+         * @param iterations The most iterations to run.
+         * @param pool Threads to compute forces on, or nullptr for the calling thread.
+         * @return True while the layout has not settled.
+         */
+        bool Step(std::size_t iterations, ThreadPool* pool);
+
+    private:
+        /// @brief A square of the quadtree.
+        typedef struct node {
+            /// @brief The center of mass of the vertices inside.
+            float X;
+
+            /// @brief The center of mass of the vertices inside.
+            float Y;
+
+            /// @brief The number of vertices inside.
+            float Mass;
+
+            /// @brief The side of the square.
+            float Size;
+
+            /// @brief The first vertex inside, an index into m_order.
+            std::uint32_t Begin;
+
+            /// @brief One past the last vertex inside, an index into m_order.
+            std::uint32_t End;
+
+            /// @brief The nodes of the four quadrants, 0 for an empty one, all 0 for a leaf.
+            std::array<std::uint32_t, 4> Children;
+        } Node;
+
+        /**
+         * @brief A helper to build the quadtree over a range of m_order, partitioning it by quadrant in place.
+         * @param begin The first index into m_order.
+         * @param end One past the last index into m_order.
+         * @param centerX The center of the square.
+         * @param centerY The center of the square.
+         * @param half Half the side of the square.
+         * @param depth The depth of the node.
+         * @return The index of the node in m_nodes.
+         */
+        std::uint32_t build(std::uint32_t begin, std::uint32_t end, float centerX, float centerY, float half, std::size_t depth);
+
+        /**
+         * @brief A helper to compute the forces on the vertices at a range of tree order.
+         * @param begin The first index into m_order.
+         * @param end One past the last index into m_order.
+         */
+        void computeForces(std::size_t begin, std::size_t end);
+
+        /**
+         * @brief A helper to run a body over chunks of a range, on the pool when the range is large enough.
+         * @param pool The pool, or nullptr.
+         * @param count The size of the range.
+         * @param body Called with the bounds of every chunk.
+         */
+        static void parallelFor(ThreadPool* pool, std::size_t count, const std::function<void(std::size_t, std::size_t)>& body);
+
+        /// @brief The force on every vertex, indexed by id.
+        std::vector<float> m_forceX;
+
+        /// @brief The force on every vertex, indexed by id.
+        std::vector<float> m_forceY;
+
+        /// @brief The quadtree of the current iteration, the root first.
+        std::vector<Node> m_nodes;
+
+        /// @brief Row offsets, the neighbours of vertex v are m_targets[m_offsets[v]] to m_targets[m_offsets[v + 1]].
+        std::vector<std::size_t> m_offsets;
+
+        /// @brief The vertex ids in tree order, the vertices of every node are contiguous.
+        std::vector<VertexId> m_order;
+
+        /// @brief Is every vertex pinned? Indexed by id.
+        std::vector<std::uint8_t> m_pinned;
+
+        /// @brief The positions in tree order, for the leaf loops.
+        std::vector<float> m_sortedX;
+
+        /// @brief The positions in tree order, for the leaf loops.
+        std::vector<float> m_sortedY;
+
+        /// @brief The neighbours of every vertex, laid out back to back.
+        std::vector<VertexId> m_targets;
+
+        /// @brief The furthest a vertex may move in the next iteration.
+        float m_temperature;
+
+        /// @brief The topology version the layout was assigned from.
+        std::uint64_t m_version;
+
+        /// @brief The horizontal position of every vertex, indexed by id.
+        std::vector<float> m_x;
+
+        /// @brief The vertical position of every vertex, indexed by id.
+        std::vector<float> m_y;
+
+        /// @brief The fraction of the temperature kept after every iteration.
+        static constexpr float Cooling = 0.98f;
+
+        /// @brief The pull toward the center of mass per unit of distance.
+        static constexpr float Gravity = 2.0f;
+
+        /// @brief The distance two vertices joined by an edge settle at on their own, k in the paper.
+        static constexpr float IdealLength = 50.0f;
+
+        /// @brief The number of leaf vertices handled per vector step, the accumulators are kept in this many lanes.
+        static constexpr std::size_t Lanes = 8;
+
+        /// @brief Nodes with at most this many vertices are not split.
+        static constexpr std::size_t LeafSize = 16;
+
+        /// @brief The deepest node, vertices closer than the root size over 2^MaxDepth share a leaf.
+        static constexpr std::size_t MaxDepth = 24;
+
+        /// @brief The layout has settled once the temperature is below this.
+        static constexpr float MinTemperature = 0.5f;
+
+        /// @brief Ranges shorter than this are not split across threads.
+        static constexpr std::size_t ParallelThreshold = 2048;
+
+        /// @brief Added to squared distances, so vertices that meet repel hard rather than infinitely.
+        static constexpr float Softening = 1.0f;
+
+        /// @brief A node further away than its size over Theta is treated as one body.
+        static constexpr float Theta = 0.8f;
+};
+
+#endif
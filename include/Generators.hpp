@@ -0,0 +1,272 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef GENERATORS_HPP
+#define GENERATORS_HPP
+
+#include "AdjacencyStore.hpp"
+#include "JobControl.hpp"
+#include "ThreadPool.hpp"
+
+/// @brief A generated graph and a starting position for every vertex.
+typedef struct generatedGraph {
+    /// @brief The topology, undirected and simple, with every weight 1.
+    AdjacencyStore Topology;
+
+    /// @brief The x coordinate of every vertex, in units of the gap between neighbouring grid vertices.
+    std::vector<float> X;
+
+    /// @brief The y coordinate of every vertex, in the same units.
+    std::vector<float> Y;
+} GeneratedGraph;
+
+/**
+ * @brief Generators of the classic and random graph families, for demos and for stress testing the rest of the notepad.
+ *
+ * Every generator writes its edges in fixed chunks on a pool, the random ones drawing from a stream seeded by the seed and
+ * the chunk, and the chunk sizes depend only on the parameters, so a seed gives the same graph on any number of threads.
+ * The edges are then counted, scattered and sorted per row into a CSR layout, duplicates and self loops dropped, and go
+ * into the store with a single AdjacencyStore::Assign().
+ */
+class Generators {
+    public:
+        /// @brief A numeric parameter of a family.
+        typedef struct parameter {
+            /// @brief The name, as given on the command line and shown in the sidebar.
+            const char* Name;
+
+            /// @brief The value used when none is given.
+            double Default;
+
+            /// @brief The smallest value allowed.
+            double Min;
+
+            /// @brief The largest value allowed.
+            double Max;
+
+            /// @brief Must the value be a whole number?
+            bool IsInteger;
+        } Parameter;
+
+        /// @brief A graph family, its parameters and how to build one.
+        typedef struct family {
+            /// @brief The name, as given on the command line.
+            const char* Name;
+
+            /// @brief The parameters, in the order Build takes their values.
+            std::vector<Parameter> Parameters;
+
+            /// @brief Estimates the number of edges a build makes, to refuse ones too large to hold.
+            double (*EstimateEdges)(const std::vector<double>& values);
+
+            /// @brief Builds a graph from the parameter values, a seed, a thread limit and an optional job control.
+            GeneratedGraph (*Build)(const std::vector<double>& values, std::uint64_t seed, std::size_t maxThreads, JobControl* control);
+        } Family;
+
+        /**
+         * @brief Make a complete graph, the vertices placed on a circle.
+         * @param n The number of vertices.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of the chunks done and is checked for cancellation, may be null.
+         * @return The graph, empty if cancelled.
+         */
+        static GeneratedGraph Complete(std::size_t n, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /**
+         * @brief Make a cycle, the vertices placed on a circle.
+         * @param n The number of vertices, a single edge for 2.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of the chunks done and is checked for cancellation, may be null.
+         * @return The graph, empty if cancelled.
+         */
+        static GeneratedGraph Cycle(std::size_t n, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /**
+         * @brief Make a grid, or a torus whose rows and columns wrap around.
+         * @param rows The number of rows.
+         * @param columns The number of columns.
+         * @param isTorus Do the rows and columns wrap around?
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of the chunks done and is checked for cancellation, may be null.
+         * @return The graph, vertex r * columns + c at row r and column c, empty if cancelled.
+         */
+        static GeneratedGraph Grid(std::size_t rows, std::size_t columns, bool isTorus, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /**
+         * @brief Make a hypercube, vertices joined when their numbers differ in one bit.
+         * @param dimension The dimension, 2^dimension vertices.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of the chunks done and is checked for cancellation, may be null.
+         * @return The graph, placed on a grid by the low and high halves of the bits, empty if cancelled.
+         */
+        static GeneratedGraph Hypercube(std::size_t dimension, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /**
+         * @brief Make a complete bipartite graph, the two sides placed in two columns.
+         * @param left The number of vertices on the first side, numbered first.
+         * @param right The number of vertices on the second side.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of the chunks done and is checked for cancellation, may be null.
+         * @return The graph, empty if cancelled.
+         */
+        static GeneratedGraph CompleteBipartite(std::size_t left, std::size_t right, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /**
+         * @brief Make an Erdős–Rényi G(n, p) graph, every pair joined with probability p.
+         *
+         * The pairs are walked row by row with geometric skips between the chosen ones, O(n + m) rather than a draw per
+         * pair, and the rows are cut into chunks of about the same number of pairs.
+         * @param n The number of vertices.
+         * @param p The probability of each edge.
+         * @param seed The seed.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of the chunks done and is checked for cancellation, may be null.
+         * @return The graph, placed at random, empty if cancelled.
+         */
+        static GeneratedGraph Gnp(std::size_t n, double p, std::uint64_t seed, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /**
+         * @brief Make an Erdős–Rényi G(n, m) graph, m distinct pairs chosen at random.
+         *
+         * The pairs are numbered row by row and the numbers cut into equal ranges. Each range's share of the m edges is
+         * drawn binomially in order, then each range draws its share of distinct numbers on its own.
+         * @param n The number of vertices.
+         * @param m The number of edges, at most every pair.
+         * @param seed The seed.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of the chunks done and is checked for cancellation, may be null.
+         * @return The graph, placed at random, empty if cancelled.
+         */
+        static GeneratedGraph Gnm(std::size_t n, std::size_t m, std::uint64_t seed, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /**
+         * @brief Make a Barabási–Albert preferential attachment graph.
+         *
+         * A complete graph on k + 1 vertices is grown by vertices joining k earlier ones each. The target of an edge is
+         * the endpoint at a position drawn from those of the earlier edges, which picks vertices in proportion to their
+         * degree, and the draw is a hash of the seed and the edge so every edge is resolved on its own, in parallel.
+         * A vertex drawing the same target twice keeps one edge.
+         * @param n The number of vertices.
+         * @param k The edges each new vertex brings.
+         * @param seed The seed.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of the chunks done and is checked for cancellation, may be null.
+         * @return The graph, placed at random, empty if cancelled.
+         */
+        static GeneratedGraph BarabasiAlbert(std::size_t n, std::size_t k, std::uint64_t seed, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /**
+         * @brief Make a Watts–Strogatz small world graph, a ring lattice with each edge's far end rewired with probability p.
+         *
+         * A rewired edge landing on an existing one is dropped.
+         * @param n The number of vertices.
+         * @param k The neighbours of each vertex on the ring, rounded down to an even number.
+         * @param p The probability of rewiring an edge.
+         * @param seed The seed.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of the chunks done and is checked for cancellation, may be null.
+         * @return The graph, the vertices placed on a circle, empty if cancelled.
+         */
+        static GeneratedGraph WattsStrogatz(std::size_t n, std::size_t k, double p, std::uint64_t seed, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /**
+         * @brief Make a random geometric graph, points in the unit square joined when at most a radius apart.
+         *
+         * The points are bucketed into cells at least the radius wide, so each one is only compared with those in its
+         * own and the neighbouring cells.
+         * @param n The number of vertices.
+         * @param radius The largest distance between joined points.
+         * @param seed The seed.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of the chunks done and is checked for cancellation, may be null.
+         * @return The graph, placed at its points scaled to a square of side sqrt(n), empty if cancelled.
+         */
+        static GeneratedGraph Geometric(std::size_t n, double radius, std::uint64_t seed, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /**
+         * @brief Get every family, for the sidebar and the command line.
+         * @return The families.
+         */
+        static const std::vector<Family>& GetFamilies(void);
+
+        /**
+         * @brief Check parameter values against a family's limits and the size of graph they make.
+         * @param family The family.
+         * @param values One value per parameter.
+         * @param error Set to the reason on failure.
+         * @return True if the values are usable.
+         */
+        static bool Check(const Family& family, const std::vector<double>& values, std::string& error);
+
+        /**
+         * @brief Parse a family and its parameters from a specification such as "gnp:n=1000,p=0.01".
+         * @param spec The family name, then optionally a colon and comma separated name=value pairs, others defaulted.
+         * @param values Set to one value per parameter.
+         * @param error Set to the reason on failure.
+         * @return The family, or null on failure.
+         */
+        static const Family* Parse(const std::string& spec, std::vector<double>& values, std::string& error);
+
+        /// @brief The most edges a family may be asked to make.
+        static constexpr double MaxEdges = 1 << 28;
+
+    private:
+        /// @brief The edges made by each chunk, packed with the first vertex in the high half.
+        typedef std::vector<std::vector<std::uint64_t>> EdgeChunks;
+
+        /**
+         * @brief A helper to run chunks of a generator on a pool, reporting progress and stopping on cancellation.
+         * @param pool The pool.
+         * @param chunks The number of chunks.
+         * @param control Receives the fraction of the chunks done and is checked for cancellation, may be null.
+         * @param body Runs one chunk.
+         * @return True unless cancelled.
+         */
+        static bool run(ThreadPool& pool, std::size_t chunks, JobControl* control, const std::function<void(std::size_t chunk)>& body);
+
+        /**
+         * @brief A helper to turn the edges of every chunk into the topology of a graph.
+         *
+         * The edges are partitioned from both ends into buckets of BucketVertices rows, each chunk writing to its own
+         * slice of every bucket, then each bucket is counted into rows, sorted, stripped of duplicates and compacted,
+         * all in parallel without atomics, so the order the chunks finish in does not matter.
+         * @param n The number of vertices.
+         * @param chunks The edges, freed as they are used.
+         * @param pool The pool.
+         * @param graph Receives the topology.
+         */
+        static void assemble(std::size_t n, EdgeChunks& chunks, ThreadPool& pool, GeneratedGraph& graph);
+
+        /**
+         * @brief A helper to place the vertices of a graph evenly around a circle, neighbours one unit apart.
+         * @param graph The graph.
+         * @param n The number of vertices.
+         */
+        static void placeCircle(GeneratedGraph& graph, std::size_t n);
+
+        /**
+         * @brief A helper to place the vertices of a graph on a grid, row after row.
+         * @param graph The graph.
+         * @param n The number of vertices.
+         * @param columns The number of columns.
+         */
+        static void placeGrid(GeneratedGraph& graph, std::size_t n, std::size_t columns);
+
+        /**
+         * @brief A helper to place the vertices of a graph at random in a square of side sqrt(n).
+         * @param graph The graph.
+         * @param n The number of vertices.
+         * @param seed The seed.
+         */
+        static void placeRandom(GeneratedGraph& graph, std::size_t n, std::uint64_t seed);
+
+        /// @brief The vertices whose rows assemble() lays out together, few enough for their counters to stay in cache.
+        static constexpr std::size_t BucketVertices = 1 << 14;
+
+        /// @brief The edges a chunk makes, roughly, the pairs it considers for G(n, p) and G(n, m).
+        static constexpr std::size_t ChunkEdges = 1 << 16;
+};
+
+#endif
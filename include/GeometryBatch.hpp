@@ -0,0 +1,84 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef GEOMETRY_BATCH_HPP
+#define GEOMETRY_BATCH_HPP
+
+/// @brief A list of same sized triangle primitives drawn in a single call, only dirty primitives are rebuilt and uploaded.
+class GeometryBatch {
+    public:
+        /// @brief Fills in the vertices of one primitive.
+        typedef std::function<void(std::size_t index, sf::Vertex* vertices)> Writer;
+
+        /**
+         * @brief Creates an empty batch.
+         * @param verticesPerPrimitive The number of triangle vertices of every primitive, a multiple of 3.
+         */
+        GeometryBatch(std::size_t verticesPerPrimitive);
+
+        /**
+         * @brief Rebuild the dirty primitives and draw the whole batch.
+         * @param target The target being drawn on.
+         * @param write Called once for every dirty primitive.
+         */
+        void Draw(sf::RenderTarget *target, const Writer& write);
+
+        /**
+         * @brief Get the number of primitives.
+         * @return The number of primitives.
+         */
+        std::size_t GetCount(void) const;
+
+        /**
+         * @brief Mark a primitive for a rebuild before the next draw.
+         * @param index The primitive.
+         */
+        void Invalidate(std::size_t index);
+
+        /**
+         * @brief Mark every primitive for a rebuild before the next draw.
+         */
+        void InvalidateAll(void);
+
+        /**
+         * @brief Change the number of primitives, new ones are dirty.
+         * @param count The number of primitives.
+         */
+        void Resize(std::size_t count);
+
+    private:
+        /**
+         * @brief A helper to copy staged vertices to the GPU buffer.
+         * @param first The first primitive to copy.
+         * @param last One past the last primitive to copy.
+         */
+        void upload(std::size_t first, std::size_t last);
+
+        /// @brief Is every primitive dirty?
+        bool m_allDirty;
+
+        /// @brief The GPU copy, empty when vertex buffers are unavailable.
+        sf::VertexBuffer m_buffer;
+
+        /// @brief The number of vertices the GPU buffer has room for.
+        std::size_t m_capacity;
+
+        /// @brief The number of primitives.
+        std::size_t m_count;
+
+        /// @brief The dirty primitives, may hold duplicates.
+        std::vector<std::size_t> m_dirty;
+
+        /// @brief The CPU copy of every vertex.
+        std::vector<sf::Vertex> m_staging;
+
+        /// @brief Are vertex buffers supported by the driver?
+        bool m_useBuffer;
+
+        /// @brief The number of vertices of every primitive.
+        std::size_t m_verticesPerPrimitive;
+};
+
+#endif
@@ -6,7 +6,17 @@
 #ifndef GRAPH_HPP
 #define GRAPH_HPP
 
-/// @brief A vertex of a graph.
+#include "AdjacencyStore.hpp"
+#include "BigUnsigned.hpp"
+#include "Bipartite.hpp"
+#include "Coloring.hpp"
+#include "ForceLayout.hpp"
+#include "GeometryBatch.hpp"
+#include "GraphFile.hpp"
+#include "SpatialGrid.hpp"
+#include "StringPool.hpp"
+
+/// @brief A vertex of a graph, copied out of the graph's arrays, for the undo history and for removals.
 typedef struct vertex {
     /// @brief The name of the vertex.
     std::string Name;
@@ -14,29 +24,78 @@ typedef struct vertex {
     /// @brief The position of the vertex.
     sf::Vector2f Position;
 
-    /// @brief The sprite of the vertex.
-    sf::CircleShape Sprite;
+    /// @brief Is the vertex selected on the canvas?
+    bool IsSelected;
+
+    /// @brief Is the vertex pinned, so layouts leave it where it is?
+    bool IsPinned;
 
-    /// @brief The color of the vertex for vertex coloring algorithms, not for graphics.
+    /// @brief The color of the vertex for vertex coloring algorithms, 0 when uncolored, drawn from a palette.
     int VertexColor;
 } Vertex;
 
-/// @brief An edge of a graph.
+/// @brief An edge of a graph, copied out of the graph's arrays.
 typedef struct edge {
-    /// @brief A reference to the first vertex of the edge.
-    Vertex *Vertex1;
+    /// @brief The id of the first vertex of the edge.
+    VertexId Vertex1;
 
-    /// @brief A reference to the second vertex of the edge.
-    Vertex *Vertex2;
+    /// @brief The id of the second vertex of the edge.
+    VertexId Vertex2;
 
     /// @brief The weight value of the edge.
     float Weight;
-
-    /// @brief The sprite of the edge.
-    sf::RectangleShape Sprite;
 } Edge;
 
-/// @brief A graph obj, storing vertices and edges.
+/// @brief A reference to a vertex that survives the id changes of other removals, see Graph::Resolve().
+typedef struct vertexHandle {
+    /// @brief The slot in the graph's handle table.
+    std::uint32_t Slot;
+
+    /// @brief The generation of the slot when the handle was made, it moves on when the vertex is removed.
+    std::uint32_t Generation;
+} VertexHandle;
+
+/// @brief An edit kept in a graph's undo history, with just what it takes to revert it and to make it again.
+typedef struct graphChange {
+    /// @brief The kinds of edits.
+    enum Kind {
+        AddedVertex, AddedEdge, ChangedWeight, MovedVertex, RemovedEdge, RemovedVertex
+    };
+
+    /// @brief What the edit did.
+    Kind Type;
+
+    /// @brief The vertex added, moved or removed, or the first vertex of the edge.
+    VertexId Id;
+
+    /// @brief The second vertex of the edge.
+    VertexId Other;
+
+    /// @brief The weight of the edge before the edit.
+    float OldWeight;
+
+    /// @brief The weight of the edge after the edit.
+    float NewWeight;
+
+    /// @brief The position of the moved vertex before the edit.
+    sf::Vector2f From;
+
+    /// @brief The position of the moved vertex after the edit.
+    sf::Vector2f To;
+
+    /// @brief The vertex added or removed.
+    Vertex Data;
+
+    /// @brief The edges that went with the removed vertex.
+    std::vector<Edge> Edges;
+} GraphChange;
+
+/**
+ * @brief A graph obj, storing vertices and edges.
+ *
+ * Each vertex and edge field lives in an array of its own indexed by id, so a pass over positions or endpoints reads
+ * nothing else, and the geometry drawn for them lives in the batches.
+ */
 class Graph {
     public:
         /** 
@@ -46,93 +105,714 @@ class Graph {
         Graph(bool isDirected = false);
 
         /**
-         * @brief Add a edge to the graph.
-         * @param v1 A reference to the first vertex of the edge.
-         * @param v2 A reference to the second vertex of the edge.
+         * @brief Add a edge to the graph, or update its weight if it already exists.
+         * @param v1 The id of the first vertex of the edge.
+         * @param v2 The id of the second vertex of the edge.
          * @param weight The weight value of the edge.
          */
-        void AddEdge(Vertex& v1, Vertex& v2, float weight);
+        void AddEdge(VertexId v1, VertexId v2, float weight);
 
         /**
          * @brief Adds a vertex to the graph.
          * @param name The name of the vertex.
          * @param position The position of the vertex.
+         * @return The id of the new vertex.
          */
-        void AddVertex(std::string name, sf::Vector2f position);
+        VertexId AddVertex(std::string name, sf::Vector2f position);
+
+        /**
+         * @brief Show the result of a bipartite check of the current topology.
+         *
+         * Afterwards the vertex color is 1 or 2 for the two sides of every bipartite component and 0 everywhere else,
+         * and if the graph is not bipartite the odd cycle found is highlighted.
+         * @param result The result, from a check of a snapshot with the same version as the graph.
+         */
+        void ApplyBipartite(const BipartiteResult& result);
+
+        /**
+         * @brief Show a vertex coloring, every vertex filled with the palette color of its color.
+         * @param result The coloring, from a snapshot with the same version as the graph.
+         */
+        void ApplyColoring(const ColoringResult& result);
 
         /**
          * @brief Calculate if the graph is bipartite.
-         * @return True if the graph is bipartite, false otherwise.
+         *
+         * Afterwards the vertex color is 1 or 2 for the two sides of every bipartite component and 0 everywhere else,
+         * and if the graph is not bipartite the odd cycle found is highlighted.
+         * @return The parts of every component and the odd cycle if there is one.
          */
-        bool CalculateBipartite(void);
+        BipartiteResult CalculateBipartite(void);
 
         /**
-         * @brief Calculate the number of spanning trees in the graph.
+         * @brief Calculate the exact number of spanning trees in the graph.
          * @return The number of spanning trees.
          */
-        int CalculateNumberOfSpanningTrees(void);
+        BigUnsigned CalculateNumberOfSpanningTrees(void);
+
+        /**
+         * @brief Is there an undone edit to make again?
+         * @return True if Redo() would do something.
+         */
+        bool CanRedo(void) const;
+
+        /**
+         * @brief Is there an edit to undo?
+         * @return True if Undo() would do something.
+         */
+        bool CanUndo(void) const;
+
+        /**
+         * @brief Reset every vertex color to 0, so vertices are filled with the graph color again.
+         */
+        void ClearColoring(void);
+
+        /**
+         * @brief Clear the highlighted walk.
+         */
+        void ClearHighlight(void);
+
+        /**
+         * @brief Give back the memory removals left behind, once they add up to enough of the graph.
+         *
+         * Runs on the calling thread, but only the lists and arrays left more than half empty are reallocated, and
+         * only once every CompactionRemovals or quarter of the graph's removals, so the cost is spread over them.
+         * @return True if a compaction ran.
+         */
+        bool Compact(void);
+
+        /**
+         * @brief Draw the part of the graph inside a rectangle.
+         *
+         * A graph entirely in view is drawn from its cached batches in two calls, rebuilding only the geometry edited
+         * since the last draw. Otherwise only the vertices and edges the spatial indices find in view are built, and
+         * when vertices are only a few pixels wide they become points and edges between the same screen cells are
+         * drawn once.
+         * @param target The target being drawn on, the window or an offscreen texture.
+         * @param visible The visible rectangle in world coordinates.
+         * @param pixelSize The number of world units per pixel.
+         */
+        void Draw(sf::RenderTarget *target, const sf::FloatRect& visible, float pixelSize);
+
+        /**
+         * @brief Build the dense adjacency matrix, only for views that need every cell at once.
+         * @return The weight of every edge, 0 where there is none.
+         */
+        std::vector<std::vector<float>> GetAdjacencyMatrix(void) const;
+
+        /**
+         * @brief Get the edge under a point through the edge index.
+         * @param position The point in world coordinates.
+         * @return A copy of the closest edge within a vertex radius of the point, or nothing if none.
+         */
+        std::optional<Edge> GetEdgeAt(sf::Vector2f position) const;
+
+        /**
+         * @brief Get the weight of an edge without building the matrix.
+         * @param v1 The id of the first vertex of the edge.
+         * @param v2 The id of the second vertex of the edge.
+         * @return The weight of the edge, or 0 if there is none.
+         */
+        float GetEdgeWeight(VertexId v1, VertexId v2) const;
+
+        /**
+         * @brief Get a handle to a vertex, to hold on to across edits that change ids.
+         * @param id The id of the vertex.
+         * @return The handle.
+         */
+        VertexHandle GetHandle(VertexId id) const;
+
+        /**
+         * @brief Get the position of a vertex, change it through MoveVertex().
+         * @param id The id of the vertex.
+         * @return The position in world coordinates.
+         */
+        sf::Vector2f GetPosition(VertexId id) const;
+
+        /**
+         * @brief Get a counter that changes with every edit that shows on the canvas, except the graph color.
+         *
+         * It only ever grows, an undo is a new revision rather than a return to an old one.
+         * @return The revision.
+         */
+        std::uint64_t GetRevision(void) const;
+
+        /**
+         * @brief Get an immutable copy of the topology for background jobs, shared until the next edit.
+         * @return The snapshot, its CSR views are already built so any number of threads can read it at once.
+         */
+        std::shared_ptr<const AdjacencyStore> GetSnapshot(void) const;
+
+        /**
+         * @brief Get the sparse topology of the graph.
+         * @return A reference to the adjacency store.
+         */
+        const AdjacencyStore& GetTopology(void) const;
+
+        /**
+         * @brief Get the vertex at a point through the spatial index, amortised O(1).
+         * @param position The point in world coordinates.
+         * @return The id of the closest vertex whose sprite covers the point, or InvalidVertexId if none.
+         */
+        VertexId GetVertexAt(sf::Vector2f position) const;
 
         /**
-         * @brief Draw the graph.
-         * @param window A pointer to the window being drawn on.
+         * @brief Get the vertex coloring color of a vertex.
+         * @param id The id of the vertex.
+         * @return The color, 0 when uncolored.
          */
-        void Draw(sf::RenderWindow *window);
+        int GetVertexColor(VertexId id) const;
 
         /**
-         * @brief Get the list of vertices.
-         * @return A reference to the list of vertices.
+         * @brief Get the name of a vertex.
+         * @param id The id of the vertex.
+         * @return The name, valid until the graph is replaced by Import() or Load().
          */
-        std::vector<Vertex>& GetVertices(void);
+        std::string_view GetVertexName(VertexId id) const;
 
         /**
-         * @brief Get the vertex at the mouse position.
-         * @param window A pointer to the window being drawn on.
-         * @return A pointer to the vertex at the mouse position, or nullptr if none.
+         * @brief Get every vertex inside a rectangle through the spatial index.
+         * @param rect The rectangle in world coordinates.
+         * @param ids The ids found are appended here, in no particular order.
          */
-        Vertex* GetVertexAtMouse(sf::RenderWindow *window);
+        void GetVerticesIn(const sf::FloatRect& rect, std::vector<VertexId>& ids) const;
 
         /**
-         * @brief Remove a vertex from the graph.
-         * @param n The index of the vertex to remove.
+         * @brief Replace the whole graph with a topology read from elsewhere, its vertices laid out on a grid.
+         * @param topology The topology, its directedness becomes the graph's.
+         */
+        void Import(AdjacencyStore topology);
+
+        /**
+         * @brief Replace the whole graph with a topology read from elsewhere, its vertices at given positions.
+         * @param topology The topology, its directedness becomes the graph's.
+         * @param x The x coordinate of every vertex, in units of the distance between neighbouring imported vertices.
+         * @param y The y coordinate of every vertex, in the same units.
+         */
+        void Import(AdjacencyStore topology, const std::vector<float>& x, const std::vector<float>& y);
+
+        /**
+         * @brief Replace the whole graph with a saved graph file, its log replayed, then keep logging edits to it.
+         * @param path The file to load.
+         * @param error A description of the problem if loading failed.
+         * @return True on success, on failure the graph is unchanged.
+         */
+        bool Load(const std::filesystem::path& path, std::string& error);
+
+        /**
+         * @brief Move a vertex, keeping the spatial index up to date.
+         * @param id The id of the vertex.
+         * @param position The new position in world coordinates.
+         */
+        void MoveVertex(VertexId id, sf::Vector2f position);
+
+        /**
+         * @brief Is a layout moving the vertices?
+         * @return True from StartLayout() until the layout settles or is stopped.
+         */
+        bool IsLayoutRunning(void) const;
+
+        /**
+         * @brief Is a vertex pinned, so layouts leave it where it is?
+         * @param id The id of the vertex.
+         * @return True if pinned by SetPinned().
+         */
+        bool IsPinned(VertexId id) const;
+
+        /**
+         * @brief Is a vertex selected on the canvas?
+         * @param id The id of the vertex.
+         * @return True if selected by SetSelected().
+         */
+        bool IsSelected(VertexId id) const;
+
+        /**
+         * @brief Make the last undone edit again.
+         * @return False if there was nothing to redo.
+         */
+        bool Redo(void);
+
+        /**
+         * @brief Remove an edge in O(degree).
+         * @param v1 The id of the first vertex of the edge.
+         * @param v2 The id of the second vertex of the edge.
+         * @return False if there was no such edge.
+         */
+        bool RemoveEdge(VertexId v1, VertexId v2);
+
+        /**
+         * @brief Remove a vertex and its edges in O(degree), the last vertex takes its id.
+         *
+         * Handles to every other vertex stay valid, ids held elsewhere should be resolved again through them.
+         * @param id The id of the vertex to remove.
          * @return The removed vertex.
          */
-        Vertex RemoveVertex(int n);
+        Vertex RemoveVertex(VertexId id);
+
+        /**
+         * @brief Find the current id of a vertex from a handle.
+         * @param handle The handle.
+         * @return The id, or InvalidVertexId if the vertex has been removed.
+         */
+        VertexId Resolve(VertexHandle handle) const;
+
+        /**
+         * @brief Save the graph to a graph file, compacting its log, then keep logging edits to it.
+         * @param path The file to write.
+         * @param error A description of the problem if saving failed.
+         * @return True on success.
+         */
+        bool Save(const std::filesystem::path& path, std::string& error);
+
+        /**
+         * @brief Pin or unpin a vertex, pinned vertices get a blue outline and layouts leave them where they are.
+         * @param id The id of the vertex.
+         * @param isPinned Is the vertex pinned?
+         */
+        void SetPinned(VertexId id, bool isPinned);
+
+        /**
+         * @brief Select or deselect a vertex, selected vertices get a red outline.
+         * @param id The id of the vertex.
+         * @param isSelected Is the vertex selected?
+         */
+        void SetSelected(VertexId id, bool isSelected);
+
+        /**
+         * @brief Highlight a walk of vertices on the canvas, such as a cycle or a path, until the next edit.
+         * @param vertices The vertices of the walk, consecutive ones are adjacent.
+         * @param isClosed Does the last vertex connect back to the first?
+         */
+        void SetHighlight(const std::vector<VertexId>& vertices, bool isClosed);
+
+        /**
+         * @brief Start laying the graph out by force, or heat a running layout up again, StepLayout() moves the vertices.
+         */
+        void StartLayout(void);
+
+        /**
+         * @brief Run some iterations of the layout, selected and pinned vertices stay where they are.
+         *
+         * Edits made meanwhile are taken over by the layout. Its moves are not journaled, the positions it settles
+         * on are logged to the graph file once it stops.
+         * @param iterations The most iterations to run.
+         * @param pool Threads to compute forces on, or nullptr for the calling thread.
+         * @return True while the layout has not settled, it stops by itself once it has.
+         */
+        bool StepLayout(std::size_t iterations, ThreadPool* pool);
+
+        /**
+         * @brief Stop the layout where it is and log the positions it reached to the graph file.
+         */
+        void StopLayout(void);
+
+        /**
+         * @brief Revert the last edit in O(size of the edit), consecutive moves of one vertex revert together.
+         * @return False if there was nothing to undo.
+         */
+        bool Undo(void);
 
         /// @brief Is this graph currently active?
         bool IsActive;
 
-        /// @brief The adjacency matrix of the graph.
-        std::vector<std::vector<float>> AdjacencyMatrix;
-
         /// @brief The color of the graph.
         sf::Color Color;
 
         /// @brief The name of the graph.
         std::string Name;
 
+        /// @brief Are uncolored vertices tinted by connected component?
+        bool TintComponents;
+
     private:
+        /// @brief An entry of the handle table.
+        typedef struct handleSlot {
+            /// @brief The id of the vertex the slot points at, InvalidVertexId while the slot is free.
+            VertexId Id;
+
+            /// @brief Bumped whenever the slot is freed, so the handles made before stop resolving.
+            std::uint32_t Generation;
+        } HandleSlot;
+
+        /// @brief The bits of m_vertexFlags.
+        enum VertexFlag {
+            SelectedFlag = 1, PinnedFlag = 2
+        };
+
+        /**
+         * @brief A helper to give a vertex a handle slot, reusing a freed one if there is any.
+         * @param id The id of the vertex.
+         * @return The slot.
+         */
+        std::uint32_t allocateHandle(VertexId id);
+
         /**
-         * @brief A helper to draw an edge.
-         * @param window A pointer to the window being drawn on.
-         * @param edge A reference to the edge being drawn.
+         * @brief A helper to replace the whole graph in bulk, building the edge arrays and every index once.
+         *
+         * The vertices start unnamed, uncolored, unselected and unpinned, and the names of the old graph are freed.
+         * @param topology The topology.
+         * @param positions The position of every vertex of the topology.
          */
-        void drawEdge(sf::RenderWindow *window, Edge& edge);
+        void assign(AdjacencyStore&& topology, std::vector<sf::Vector2f>&& positions);
 
         /**
-         * @brief A helper to draw a vertex.
-         * @param window A pointer to the window being drawn on.
-         * @param vertex A reference to the vertex being drawn.
+         * @brief A helper to estimate the memory held by an edit in the history.
+         * @param change The edit.
+         * @return The size in bytes.
          */
-        void drawVertex(sf::RenderWindow *window, Vertex& vertex);
+        static std::size_t changeBytes(const GraphChange& change);
 
-        /// @brief A list of edges of the graph.
-        std::vector<Edge> m_edges;
+        /**
+         * @brief A helper to build the triangles of an edge.
+         * @param index The index of the edge.
+         * @param vertices Room for EdgeVertices triangle vertices.
+         */
+        void buildEdge(std::size_t index, sf::Vertex* vertices) const;
+
+        /**
+         * @brief A helper to build the triangles of a vertex, the outline disc then the fill disc.
+         * @param id The id of the vertex.
+         * @param vertices Room for VertexVertices triangle vertices.
+         */
+        void buildVertex(VertexId id, sf::Vertex* vertices) const;
+
+        /**
+         * @brief A helper to find the edges crossing a rectangle through the edge index.
+         * @param rect The rectangle in world coordinates.
+         * @param indices The indices of the edges found, replacing its contents.
+         */
+        void collectEdges(const sf::FloatRect& rect, std::vector<VertexId>& indices) const;
+
+        /**
+         * @brief A helper to draw the visible vertices as points and the visible edges as lines, merging edges
+         * between the same screen cells.
+         * @param target The target being drawn on.
+         * @param pixelSize The number of world units per pixel.
+         */
+        void drawCoarse(sf::RenderTarget *target, float pixelSize);
+
+        /**
+         * @brief A helper to draw the full geometry of the visible vertices and edges in one call.
+         * @param target The target being drawn on.
+         */
+        void drawDetailed(sf::RenderTarget *target);
+
+        /**
+         * @brief A helper to key an edge regardless of direction.
+         * @param v1 The id of one end.
+         * @param v2 The id of the other end.
+         * @return The key.
+         */
+        static std::uint64_t edgeKey(VertexId v1, VertexId v2);
+
+        /**
+         * @brief A helper to copy an edge out of the edge arrays.
+         * @param index The index of the edge.
+         * @return The edge.
+         */
+        Edge edgeAt(std::size_t index) const;
+
+        /**
+         * @brief A helper to find an edge through the incidence lists in O(degree).
+         * @param v1 The id of the first vertex of the edge.
+         * @param v2 The id of the second vertex of the edge.
+         * @return The index of the edge, or the number of edges if none.
+         */
+        std::size_t findEdge(VertexId v1, VertexId v2) const;
+
+        /**
+         * @brief A helper to copy a vertex out of the vertex arrays.
+         * @param id The id of the vertex.
+         * @return The vertex.
+         */
+        Vertex gatherVertex(VertexId id) const;
+
+        /**
+         * @brief A helper to get the palette color of a vertex coloring color, distinct colors stay apart past the palette.
+         * @param color The color, from 1.
+         * @return The fill color.
+         */
+        static sf::Color paletteColor(int color);
+
+        /**
+         * @brief A helper to grow the bounds over a position.
+         * @param position The position of a vertex.
+         */
+        void growBounds(sf::Vector2f position);
+
+        /**
+         * @brief A helper to add an edge to the edge index at its current position.
+         * @param index The index of the edge.
+         */
+        void indexEdge(std::uint32_t index);
+
+        /**
+         * @brief A helper to put a vertex back at an id, the vertex there moves to the end, the reverse of RemoveVertex().
+         * @param id The id, at most the vertex count.
+         * @param vertex The vertex.
+         */
+        void insertVertex(VertexId id, const Vertex& vertex);
+
+        /**
+         * @brief A helper to mark the edges with a key for a rebuild.
+         * @param key The key of the edges.
+         */
+        void invalidateEdges(std::uint64_t key);
+
+        /**
+         * @brief A helper to mark a vertex and its edges for a rebuild.
+         * @param id The id of the vertex.
+         */
+        void invalidateVertex(VertexId id);
+
+        /**
+         * @brief A helper to add an edit to the undo history, dropping the oldest edits past the history limits.
+         * @param change The edit.
+         */
+        void journal(GraphChange&& change);
+
+        /**
+         * @brief A helper to rebuild the incidence lists and all geometry after the graph is replaced in bulk.
+         */
+        void reindex(void);
+
+        /**
+         * @brief A helper to move a vertex and keep the indices and geometry up to date, without logging or journaling.
+         * @param id The id of the vertex.
+         * @param position The new position in world coordinates.
+         */
+        void placeVertex(VertexId id, sf::Vector2f position);
+
+        /**
+         * @brief A helper to append an edit to the log of the file the graph was loaded from or saved to.
+         * @param entry The edit.
+         */
+        void record(const GraphFile::LogEntry& entry);
+
+        /**
+         * @brief A helper to append edits to the log of the file the graph was loaded from or saved to, in one write.
+         * @param entries The edits, in order.
+         */
+        void record(std::span<const GraphFile::LogEntry> entries);
+
+        /**
+         * @brief A helper to give a vertex the id of an empty slot, moving its edges, handle and geometry along.
+         * @param from The id of the vertex.
+         * @param to The new id, a slot without edges whose vertex is overwritten.
+         */
+        void relabelVertex(VertexId from, VertexId to);
+
+        /**
+         * @brief A helper to take an edge out of the topology, the edge list and the indices, the last edge moves into its index.
+         * @param index The index of the edge.
+         */
+        void removeEdge(std::size_t index);
+
+        /**
+         * @brief A helper to grow or shrink every vertex array together, new vertices unnamed and at the origin.
+         * @param count The number of vertices.
+         */
+        void resizeVertices(std::size_t count);
+
+        /**
+         * @brief A helper to set a vertex flag.
+         * @param id The id of the vertex.
+         * @param flag The flag.
+         * @param isSet Is the flag set?
+         */
+        void setFlag(VertexId id, VertexFlag flag, bool isSet);
+
+        /**
+         * @brief A helper to remove an edge from the edge index, before either end moves.
+         * @param index The index of the edge.
+         */
+        void unindexEdge(std::uint32_t index);
+
+        /**
+         * @brief A helper to recompute the bounds of every vertex.
+         */
+        void updateBounds(void);
+
+        /**
+         * @brief A helper to get the fill color of a vertex, the highlight, its coloring color or the graph color.
+         * @param id The id of the vertex.
+         * @return The color.
+         */
+        sf::Color vertexFill(VertexId id) const;
+
+        /// @brief The fewest removals that make a compaction worth it, a quarter of the graph once it is larger.
+        static constexpr std::size_t CompactionRemovals = 4096;
+
+        /// @brief The number of triangle vertices of an edge, a quad.
+        static constexpr std::size_t EdgeVertices = 6;
+
+        /// @brief The thickness of an edge.
+        static constexpr float EdgeThickness = 2.0f;
+
+        /// @brief The most memory the undo history may hold.
+        static constexpr std::size_t HistoryBytes = 64 << 20;
+
+        /// @brief The most edits the undo history may hold.
+        static constexpr std::size_t HistoryLimit = 4096;
+
+        /// @brief The distance between neighbouring vertices of an imported graph.
+        static constexpr float ImportSpacing = 60.0f;
+
+        /// @brief The color of highlighted vertices and edges.
+        static constexpr sf::Color HighlightColor = sf::Color(255, 140, 0);
+
+        /// @brief The outline color of pinned vertices.
+        static constexpr sf::Color PinnedColor = sf::Color(30, 144, 255);
+
+        /// @brief The fill colors of the first vertex coloring colors, every other color gets a hue of its own.
+        static constexpr std::array<sf::Color, 10> Palette = {
+            sf::Color(31, 119, 180), sf::Color(44, 160, 44), sf::Color(214, 39, 40), sf::Color(148, 103, 189), sf::Color(140, 86, 75),
+            sf::Color(227, 119, 194), sf::Color(188, 189, 34), sf::Color(23, 190, 207), sf::Color(127, 127, 127), sf::Color(174, 199, 232)
+        };
+
+        /// @brief The most positions StopLayout() logs per write, bounding the entries held at once.
+        static constexpr std::size_t LayoutLogBatch = 1 << 14;
+
+        /// @brief Edges up to this long are indexed by midpoint, so a query grown by half of it finds them.
+        static constexpr float LongEdgeLength = 256.0f;
+
+        /// @brief The number of component tints, components whose representatives are this far apart share one.
+        static constexpr VertexId TintHues = 256;
+
+        /// @brief The outline thickness of a vertex.
+        static constexpr float VertexOutline = 2.0f;
+
+        /// @brief The radius of a vertex, outline excluded.
+        static constexpr float VertexRadius = 10.0f;
+
+        /// @brief The number of triangles per disc of a vertex.
+        static constexpr std::size_t VertexSegments = 16;
+
+        /// @brief The number of triangle vertices of a vertex, two discs.
+        static constexpr std::size_t VertexVertices = VertexSegments * 6;
+
+        /// @brief A box holding every vertex position, possibly larger.
+        sf::FloatRect m_bounds;
+
+        /// @brief Does m_bounds need a recompute?
+        bool m_boundsDirty;
+
+        /// @brief The screen cell pairs already drawn by the coarse path this frame.
+        std::unordered_set<std::uint64_t> m_bundles;
+
+        /// @brief The color the batches were last built with.
+        sf::Color m_drawnColor;
+
+        /// @brief The component version the vertex batch was last tinted with, 0 when not tinted.
+        std::uint64_t m_drawnComponents;
+
+        /// @brief The triangles of every edge, indexed by edge.
+        GeometryBatch m_edgeBatch;
+
+        /// @brief The first vertex of every edge.
+        std::vector<VertexId> m_edgeFirst;
+
+        /// @brief The short edges by midpoint, for culling.
+        SpatialGrid m_edgeGrid;
+
+        /// @brief The second vertex of every edge.
+        std::vector<VertexId> m_edgeSecond;
+
+        /// @brief The weight of every edge.
+        std::vector<float> m_edgeWeights;
+
+        /// @brief The geometry built for the visible part of the graph this frame.
+        sf::VertexArray m_frameVertices;
+
+        /// @brief The freed slots of m_handles, reused last freed first.
+        std::vector<std::uint32_t> m_freeHandles;
+
+        /// @brief The spatial index of vertex positions, for hit testing.
+        SpatialGrid m_grid;
+
+        /// @brief The handle table, handles index into it and it points at the current ids.
+        std::vector<HandleSlot> m_handles;
+
+        /// @brief The keys of the highlighted edges.
+        std::unordered_set<std::uint64_t> m_highlightedEdges;
+
+        /// @brief The ids of the highlighted vertices.
+        std::unordered_set<VertexId> m_highlightedVertices;
+
+        /// @brief The edits that can be undone, oldest first.
+        std::deque<GraphChange> m_history;
+
+        /// @brief The memory held by m_history, estimated by changeBytes().
+        std::size_t m_historyBytes;
+
+        /// @brief The memory of the incidence lists, kept in pools of same sized blocks rather than one allocation per list.
+        std::pmr::unsynchronized_pool_resource m_incidencePool;
+
+        /// @brief The indices of the edges at every vertex, self loops once, allocated from m_incidencePool.
+        std::pmr::vector<std::pmr::vector<std::uint32_t>> m_incidentEdges;
 
         /// @brief Is this graph directed?
         bool m_isDirected;
 
-        /// @brief A list of vertices of the graph.
-        std::vector<Vertex> m_vertices;
+        /// @brief Is an undo or redo being carried out, so its edits stay out of the history?
+        bool m_isReplaying;
+
+        /// @brief The edges longer than LongEdgeLength, tested one by one when culling.
+        std::unordered_set<std::uint32_t> m_longEdges;
+
+        /// @brief The running layout, nullptr when none is.
+        std::unique_ptr<ForceLayout> m_layout;
+
+        /// @brief The vertex names, interned.
+        StringPool m_names;
+
+        /// @brief The file edits are logged to, empty before the first load or save.
+        std::filesystem::path m_path;
+
+        /// @brief The position of every vertex, indexed by id.
+        std::vector<sf::Vector2f> m_positions;
+
+        /// @brief The undone edits that can be made again, the next one last.
+        std::vector<GraphChange> m_redo;
+
+        /// @brief The vertices and edges removed since the last compaction.
+        std::size_t m_removals;
+
+        /// @brief The sparse topology, vertex ids index into it and the vertex arrays alike.
+        AdjacencyStore m_topology;
+
+        /// @brief The edit counter.
+        std::uint64_t m_revision;
+
+        /// @brief The last snapshot handed out, reused while its version matches.
+        mutable std::shared_ptr<const AdjacencyStore> m_snapshot;
+
+        /// @brief The triangles of every vertex, indexed by id.
+        GeometryBatch m_vertexBatch;
+
+        /// @brief The vertex coloring color of every vertex, 0 when uncolored.
+        std::vector<int> m_vertexColors;
+
+        /// @brief The VertexFlag bits of every vertex.
+        std::vector<std::uint8_t> m_vertexFlags;
+
+        /// @brief The handle slot of every vertex, indexed by id.
+        std::vector<std::uint32_t> m_vertexHandles;
+
+        /// @brief The name of every vertex, in m_names.
+        std::vector<StringId> m_vertexNames;
+
+        /// @brief The edges found in view this frame.
+        std::vector<VertexId> m_visibleEdges;
+
+        /// @brief The vertices found in view this frame.
+        std::vector<VertexId> m_visibleVertices;
+
+        /// @brief The width in pixels of the screen cells coarse edges are merged by.
+        static constexpr float BundleCell = 4.0f;
+
+        /// @brief The on screen radius in pixels below which vertices are drawn as points.
+        static constexpr float CoarseRadius = 3.0f;
 };
 
 #endif
\ No newline at end of file
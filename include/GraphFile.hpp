@@ -0,0 +1,275 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef GRAPH_FILE_HPP
+#define GRAPH_FILE_HPP
+
+#include "AdjacencyStore.hpp"
+#include "MappedFile.hpp"
+
+/**
+ * @brief The binary graph file format, read in place through a memory mapping.
+ *
+ * A file is a fixed header followed by 8 byte aligned sections: the CSR row offsets, the CSR entries (target and
+ * weight), the vertex positions, the vertex colors, the name offsets and the name characters. Edits made after a
+ * save are appended to the end of the file as log records and folded back into the sections by the next save.
+ * Numbers are stored in the byte order of the machine that wrote them, a file from the other byte order is refused.
+ */
+class GraphFile {
+    public:
+        /// @brief The kinds of edits in the append log.
+        enum LogKind : std::uint32_t {
+            LogAddVertex = 1, LogAddEdge, LogMoveVertex, LogRemoveVertex, LogInsertVertex, LogRemoveEdge
+        };
+
+        /// @brief An edit from the append log.
+        typedef struct logEntry {
+            /// @brief What the edit does.
+            LogKind Kind;
+
+            /// @brief The vertex moved, inserted or removed, or the first vertex of the edge.
+            VertexId First;
+
+            /// @brief The second vertex of the edge.
+            VertexId Second;
+
+            /// @brief The weight of the edge.
+            float Weight;
+
+            /// @brief The position of the added, inserted or moved vertex.
+            float X;
+
+            /// @brief The position of the added, inserted or moved vertex.
+            float Y;
+
+            /// @brief The name of the added or inserted vertex.
+            std::string Name;
+        } LogEntry;
+
+        /// @brief The attributes stored for a vertex.
+        typedef struct vertexRecord {
+            /// @brief The name of the vertex, pointing into the mapping or the caller's vertex.
+            std::string_view Name;
+
+            /// @brief The position of the vertex.
+            float X;
+
+            /// @brief The position of the vertex.
+            float Y;
+
+            /// @brief The vertex coloring color, 0 when uncolored.
+            std::int32_t Color;
+        } VertexRecord;
+
+        /// @brief Supplies the attributes of a vertex while saving.
+        typedef std::function<VertexRecord(VertexId id)> VertexSource;
+
+        /**
+         * @brief Creates a reader with no file open.
+         */
+        GraphFile(void);
+
+        /**
+         * @brief Append an edit to the log at the end of a saved file.
+         * @param path The file.
+         * @param entry The edit.
+         * @param error A description of the problem if writing failed.
+         * @return True on success.
+         */
+        static bool Append(const std::filesystem::path& path, const LogEntry& entry, std::string& error);
+
+        /**
+         * @brief Append edits to the log at the end of a saved file, opening and flushing it once for all of them.
+         * @param path The file.
+         * @param entries The edits, in order.
+         * @param error A description of the problem if writing failed.
+         * @return True on success.
+         */
+        static bool Append(const std::filesystem::path& path, std::span<const LogEntry> entries, std::string& error);
+
+        /**
+         * @brief Get the color of the graph.
+         * @return The color as RGBA, one byte each, red highest.
+         */
+        std::uint32_t GetColor(void) const;
+
+        /**
+         * @brief Get the number of edges, undirected edges count once.
+         * @return The number of edges as saved, before the log.
+         */
+        std::size_t GetEdgeCount(void) const;
+
+        /**
+         * @brief Get the CSR entries, straight from the mapping.
+         * @return The entries of every row, laid out back to back.
+         */
+        std::span<const Neighbor> GetEntries(void) const;
+
+        /**
+         * @brief Read the edits appended since the last save, a record cut short by a crash ends the log.
+         * @return The edits in the order they were made.
+         */
+        std::vector<LogEntry> GetLog(void) const;
+
+        /**
+         * @brief Get the CSR row offsets, straight from the mapping.
+         * @return The offsets, the neighbours of vertex v are entries Offsets[v] to Offsets[v + 1].
+         */
+        std::span<const std::uint64_t> GetOffsets(void) const;
+
+        /**
+         * @brief Get the attributes of a vertex, reading only the pages they live on.
+         * @param id The vertex.
+         * @return The attributes, the name points into the mapping.
+         */
+        VertexRecord GetVertex(VertexId id) const;
+
+        /**
+         * @brief Get the number of vertices.
+         * @return The number of vertices as saved, before the log.
+         */
+        std::size_t GetVertexCount(void) const;
+
+        /**
+         * @brief Is the graph directed?
+         * @return True if edges are one way.
+         */
+        bool IsDirected(void) const;
+
+        /**
+         * @brief Build a store from the saved sections in one pass, without the log.
+         * @param topology The store to replace, it takes the directedness of the file.
+         * @param error A description of the problem if the sections are inconsistent.
+         * @return True on success.
+         */
+        bool Load(AdjacencyStore& topology, std::string& error) const;
+
+        /**
+         * @brief Map a file and check its header, the sections are not read until used.
+         * @param path The file to open.
+         * @param error A description of the problem if opening failed.
+         * @return True on success.
+         */
+        bool Open(const std::filesystem::path& path, std::string& error);
+
+        /**
+         * @brief Apply the topology part of an edit to a store, moves change nothing.
+         * @param entry The edit.
+         * @param topology The store.
+         * @return False if the edit names a vertex the store does not have.
+         */
+        static bool Replay(const LogEntry& entry, AdjacencyStore& topology);
+
+        /**
+         * @brief Write a graph, streaming every section straight from the store, then replace the file with it.
+         *
+         * The file is written next to the target and renamed over it once complete, so a failed save leaves the
+         * old file and its log intact. The new file has an empty log.
+         * @param path The file to write.
+         * @param topology The topology.
+         * @param color The color of the graph as RGBA, red highest.
+         * @param vertices The attributes of every vertex.
+         * @param error A description of the problem if writing failed.
+         * @return True on success.
+         */
+        static bool Save(const std::filesystem::path& path, const AdjacencyStore& topology, std::uint32_t color, const VertexSource& vertices, std::string& error);
+
+    private:
+        /// @brief The sections of a file, in the order they are written.
+        enum Section {
+            OffsetsSection, EntriesSection, PositionsSection, ColorsSection, NameOffsetsSection, NamesSection, SectionCount
+        };
+
+        /// @brief The fixed header at the start of a file.
+        typedef struct header {
+            /// @brief Always "GTNGRAPH".
+            char Magic[8];
+
+            /// @brief The format version.
+            std::uint32_t Version;
+
+            /// @brief The value ByteOrderMark as the writer stored it.
+            std::uint32_t ByteOrder;
+
+            /// @brief The number of vertices.
+            std::uint64_t VertexCount;
+
+            /// @brief The number of edges, undirected edges count once.
+            std::uint64_t EdgeCount;
+
+            /// @brief The number of CSR entries.
+            std::uint64_t EntryCount;
+
+            /// @brief The number of name characters.
+            std::uint64_t NameBytes;
+
+            /// @brief The byte offset of every section.
+            std::uint64_t Sections[SectionCount];
+
+            /// @brief The byte offset of the append log, the end of the sections.
+            std::uint64_t LogOffset;
+
+            /// @brief The color of the graph as RGBA.
+            std::uint32_t Color;
+
+            /// @brief Bit 0 is set for directed graphs.
+            std::uint32_t Flags;
+        } Header;
+
+        /// @brief An append log record as stored, followed by NameLength name characters.
+        typedef struct logRecord {
+            /// @brief The LogKind.
+            std::uint32_t Kind;
+
+            /// @brief The first vertex.
+            std::uint32_t First;
+
+            /// @brief The second vertex.
+            std::uint32_t Second;
+
+            /// @brief The weight of the edge.
+            float Weight;
+
+            /// @brief The position.
+            float X;
+
+            /// @brief The position.
+            float Y;
+
+            /// @brief The number of name characters that follow.
+            std::uint32_t NameLength;
+        } LogRecord;
+
+        /**
+         * @brief A helper to get a section of the mapping as an array.
+         * @param section The section.
+         * @return A pointer to the first element.
+         */
+        template <typename T>
+        const T* section(Section section) const;
+
+        /// @brief The header, pointing into the mapping.
+        const Header* m_header;
+
+        /// @brief The mapped file.
+        MappedFile m_file;
+
+        /// @brief The bits of Header::Flags.
+        static constexpr std::uint32_t DirectedFlag = 1;
+
+        /// @brief Stored natively, reads back differently on a machine of the other byte order.
+        static constexpr std::uint32_t ByteOrderMark = 0x01020304;
+
+        /// @brief The current format version, 2 since a logged vertex removal moves the last vertex into the gap.
+        static constexpr std::uint32_t FormatVersion = 2;
+
+        /// @brief The identifying first bytes of a file.
+        static constexpr char Magic[8] = { 'G', 'T', 'N', 'G', 'R', 'A', 'P', 'H' };
+
+        /// @brief The alignment of every section.
+        static constexpr std::size_t SectionAlignment = 8;
+};
+
+#endif
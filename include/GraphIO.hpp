@@ -0,0 +1,216 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef GRAPH_IO_HPP
+#define GRAPH_IO_HPP
+
+#include "AdjacencyStore.hpp"
+#include "JobControl.hpp"
+
+/// @brief Reading graphs from the text formats of other tools.
+class GraphIO {
+    public:
+        /// @brief The text formats a graph can be read from.
+        enum Format {
+            EdgeList, Dimacs, MatrixMarket, GraphML
+        };
+
+        /**
+         * @brief Guess the format of a file from its extension.
+         * @param path The file.
+         * @return The format, EdgeList for any extension not recognised.
+         */
+        static Format DetectFormat(const std::filesystem::path& path);
+
+        /**
+         * @brief Read a graph, parsing the file in chunks on several threads and adding the edges in bulk.
+         *
+         * - EdgeList: one "source target [weight]" line per edge with 0 based ids, lines starting with # or % are
+         *   skipped and the vertex count is one more than the largest id.
+         * - Dimacs: a "p <problem> <vertices> <edges>" line, then "a" or "e" lines "source target [weight]" with
+         *   1 based ids, other lines are skipped.
+         * - MatrixMarket: a coordinate matrix, every entry is an edge from its 1 based row to its column, pattern
+         *   entries weigh 1 and symmetric matrices list each edge once.
+         * - GraphML: node and edge elements, vertices are numbered in the order their nodes appear and the weight
+         *   comes from the edge data whose key is named "weight".
+         *
+         * A missing weight is 1 and a repeated edge keeps the last weight read. The file is memory mapped and only a
+         * few chunks per thread are parsed ahead of the store, so memory beyond the graph itself stays bounded.
+         * Ids and declared vertex counts are limited to the larger of MinVertexLimit and the file size in bytes, so a
+         * single stray id such as 3000000000 is an error rather than billions of empty vertices.
+         * @param path The file to read.
+         * @param format The format of the file.
+         * @param topology An empty store to fill, its directedness decides how the edges are read.
+         * @param error A description of the problem if reading failed.
+         * @param maxThreads The most threads to parse on, 0 for one per core.
+         * @param control Receives the fraction of the file read and is checked for cancellation, or nullptr.
+         * @return True on success.
+         */
+        static bool Read(const std::filesystem::path& path, Format format, AdjacencyStore& topology, std::string& error, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+    private:
+        /// @brief An edge between numbered vertices, as parsed.
+        typedef struct parsedEdge {
+            /// @brief The first vertex.
+            VertexId From;
+
+            /// @brief The second vertex.
+            VertexId To;
+
+            /// @brief The weight value of the edge.
+            float Weight;
+        } ParsedEdge;
+
+        /// @brief An edge between named GraphML nodes, as parsed, the names point into the mapped file.
+        typedef struct namedEdge {
+            /// @brief The id of the first node.
+            std::string_view Source;
+
+            /// @brief The id of the second node.
+            std::string_view Target;
+
+            /// @brief The weight value of the edge.
+            float Weight;
+        } NamedEdge;
+
+        /// @brief What the header of a file says about its body.
+        typedef struct layout {
+            /// @brief The offset of the first byte after the header.
+            std::size_t BodyOffset;
+
+            /// @brief The number of lines in the header.
+            std::size_t BodyLine;
+
+            /// @brief The vertex count declared by the header, 0 if it comes from the largest id.
+            std::size_t VertexCount;
+
+            /// @brief The most vertices the file may make, ids from it on are rejected.
+            std::size_t VertexLimit;
+
+            /// @brief Are ids counted from 1?
+            bool IsOneBased;
+
+            /// @brief Does every entry off the diagonal stand for both directions?
+            bool IsSymmetric;
+
+            /// @brief Is the reverse of an entry negated, for skew symmetric matrices?
+            bool IsSkew;
+
+            /// @brief Do entries carry a weight, false for pattern matrices?
+            bool HasWeights;
+
+            /// @brief The GraphML data key holding edge weights.
+            std::string WeightKey;
+        } Layout;
+
+        /// @brief A piece of the file parsed by one thread, cut at a line or element boundary.
+        typedef struct chunk {
+            /// @brief The first byte of the piece.
+            const char* Begin;
+
+            /// @brief One past the last byte of the piece.
+            const char* End;
+
+            /// @brief The edges of a line based format.
+            std::vector<ParsedEdge> Edges;
+
+            /// @brief The number of vertices the edges need, one more than the largest id.
+            std::size_t VertexCount;
+
+            /// @brief The GraphML node ids in document order.
+            std::vector<std::string_view> Nodes;
+
+            /// @brief The GraphML edges.
+            std::vector<NamedEdge> NamedEdges;
+
+            /// @brief The number of lines in the piece.
+            std::size_t Lines;
+
+            /// @brief A description of the first problem found, empty if none.
+            std::string Error;
+
+            /// @brief The line of the problem within the piece, counted from 1.
+            std::size_t ErrorLine;
+        } Chunk;
+
+        /**
+         * @brief A helper to read a GraphML attribute from a tag.
+         * @param tag The first byte of the tag.
+         * @param tagEnd The closing > of the tag.
+         * @param name The attribute name.
+         * @return The value between the quotes, empty if the attribute is missing.
+         */
+        static std::string_view attribute(const char* tag, const char* tagEnd, std::string_view name);
+
+        /**
+         * @brief A helper to find the next GraphML node or edge element.
+         * @param cursor Where to start looking.
+         * @param end The end of the text.
+         * @return The < of the element, or end if there is none.
+         */
+        static const char* findElement(const char* cursor, const char* end);
+
+        /**
+         * @brief A helper to parse a GraphML chunk into node ids and named edges.
+         * @param chunk The chunk.
+         * @param layout The header of the file.
+         */
+        static void parseElements(Chunk& chunk, const Layout& layout);
+
+        /**
+         * @brief A helper to parse a chunk of a line based format into numbered edges.
+         * @param chunk The chunk.
+         * @param layout The header of the file.
+         * @param format The format of the file.
+         */
+        static void parseLines(Chunk& chunk, const Layout& layout, Format format);
+
+        /**
+         * @brief A helper to read the "p" line of a DIMACS file.
+         * @param begin The first byte of the file.
+         * @param end One past the last byte.
+         * @param layout The layout found.
+         * @param error A description of the problem if there is no problem line.
+         * @return True on success.
+         */
+        static bool readDimacsHeader(const char* begin, const char* end, Layout& layout, std::string& error);
+
+        /**
+         * @brief A helper to read the weight key declared before the first GraphML node or edge.
+         * @param begin The first byte of the file.
+         * @param end One past the last byte.
+         * @param layout The layout found.
+         */
+        static void readGraphMLHeader(const char* begin, const char* end, Layout& layout);
+
+        /**
+         * @brief A helper to read the banner and size line of a Matrix Market file.
+         * @param begin The first byte of the file.
+         * @param end One past the last byte.
+         * @param layout The layout found.
+         * @param error A description of the problem if the header is bad.
+         * @return True on success.
+         */
+        static bool readMatrixMarketHeader(const char* begin, const char* end, Layout& layout, std::string& error);
+
+        /**
+         * @brief A helper to skip spaces, tabs and carriage returns.
+         * @param cursor The first byte to look at.
+         * @param end The end of the text.
+         * @return The first other byte, or end.
+         */
+        static const char* skipSpaces(const char* cursor, const char* end);
+
+        /// @brief The size a chunk is cut at, before moving to the next boundary.
+        static constexpr std::size_t ChunkBytes = 4 << 20;
+
+        /// @brief The number of chunks parsed ahead per thread.
+        static constexpr std::size_t ChunksPerThread = 2;
+
+        /// @brief The fewest vertices any file may make, however small.
+        static constexpr std::size_t MinVertexLimit = 1 << 20;
+};
+
+#endif
@@ -0,0 +1,57 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef JOB_CONTROL_HPP
+#define JOB_CONTROL_HPP
+
+/// @brief Shared between a running algorithm and whoever started it, for progress and cooperative cancellation.
+class JobControl {
+    public:
+        /**
+         * @brief Creates a control with no progress that is not cancelled.
+         */
+        JobControl(void);
+
+        /**
+         * @brief Ask the algorithm to stop at its next check, any thread.
+         */
+        void Cancel(void);
+
+        /**
+         * @brief Get the progress last reported.
+         * @return The fraction done, from 0 to 1.
+         */
+        float GetProgress(void) const;
+
+        /**
+         * @brief Has the algorithm been asked to stop?
+         * @return True once Cancel() was called or the deadline has passed.
+         */
+        bool IsCancelled(void) const;
+
+        /**
+         * @brief Stop the algorithm at its first check after a point in time, as if Cancel() was called then.
+         * @param deadline The time to stop at.
+         */
+        void SetDeadline(std::chrono::steady_clock::time_point deadline);
+
+        /**
+         * @brief Report progress, called by the algorithm.
+         * @param progress The fraction done, from 0 to 1.
+         */
+        void SetProgress(float progress);
+
+    private:
+        /// @brief Has Cancel() been called?
+        std::atomic<bool> m_cancelled;
+
+        /// @brief The deadline in ticks of the steady clock, 0 for none.
+        std::atomic<std::chrono::steady_clock::rep> m_deadline;
+
+        /// @brief The fraction done.
+        std::atomic<float> m_progress;
+};
+
+#endif
@@ -0,0 +1,112 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef JOB_SCHEDULER_HPP
+#define JOB_SCHEDULER_HPP
+
+#include "JobControl.hpp"
+#include "ThreadPool.hpp"
+
+/// @brief A job that has been submitted and not yet collected.
+typedef struct jobInfo {
+    /// @brief The id of the job.
+    std::uint64_t Id;
+
+    /// @brief The name shown for the job.
+    std::string Name;
+
+    /// @brief The progress and cancellation of the job.
+    std::shared_ptr<JobControl> Control;
+} JobInfo;
+
+/// @brief Runs jobs on a work stealing pool and hands their results back to the thread that polls it.
+class JobScheduler {
+    public:
+        /// @brief Applies a job's result, run on the polling thread.
+        typedef std::function<void()> Completion;
+
+        /// @brief The body of a job, run on a worker, returns what to apply on the polling thread.
+        typedef std::function<Completion(JobControl& control)> Work;
+
+        /**
+         * @brief Creates a scheduler and its pool.
+         * @param threadCount The number of workers, 0 for one per core.
+         */
+        JobScheduler(std::size_t threadCount = 0);
+
+        /**
+         * @brief Cancels every job and waits for the workers to stop, uncollected results are dropped.
+         */
+        ~JobScheduler();
+
+        JobScheduler(const JobScheduler&) = delete;
+        JobScheduler& operator=(const JobScheduler&) = delete;
+
+        /**
+         * @brief Ask a job to stop, it is still collected by Poll() once it returns.
+         * @param id The id of the job.
+         */
+        void Cancel(std::uint64_t id);
+
+        /**
+         * @brief Ask every job to stop.
+         */
+        void CancelAll(void);
+
+        /**
+         * @brief Get the jobs submitted and not yet collected, polling thread only.
+         * @return The jobs in submission order.
+         */
+        const std::vector<JobInfo>& GetJobs(void) const;
+
+        /**
+         * @brief Get why the last job that threw failed, polling thread only.
+         * @return The job's name and the exception's message, empty if no job has failed.
+         */
+        const std::string& GetLastError(void) const;
+
+        /**
+         * @brief Are there jobs that have not been collected yet?
+         * @return True if GetJobs() is not empty.
+         */
+        bool IsBusy(void) const;
+
+        /**
+         * @brief Collect the finished jobs, running their completions on the calling thread.
+         * @return The number of jobs collected.
+         */
+        std::size_t Poll(void);
+
+        /**
+         * @brief Start a job.
+         *
+         * A job that throws is collected like any other, its completion replaced by one that sets GetLastError().
+         * @param name The name shown for the job.
+         * @param work The body of the job, it should check its control for cancellation now and then.
+         * @return The id of the job.
+         */
+        std::uint64_t Submit(std::string name, Work work);
+
+    private:
+        /// @brief The finished jobs and their completions, guarded by m_mutex.
+        std::vector<std::pair<std::uint64_t, Completion>> m_finished;
+
+        /// @brief The jobs not yet collected.
+        std::vector<JobInfo> m_jobs;
+
+        /// @brief The failure of the last job that threw, set by its completion.
+        std::string m_lastError;
+
+        /// @brief Guards m_finished.
+        std::mutex m_mutex;
+
+        /// @brief The id of the next job.
+        std::uint64_t m_nextId;
+
+        /// @brief The workers, declared last so they stop before anything they touch goes away.
+        ThreadPool m_pool;
+};
+
+#endif
@@ -0,0 +1,73 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+// The lowest level compiled in: 0 debug, 1 info, 2 warning, 3 error, 4 nothing.
+#ifndef NOTEPAD_LOG_LEVEL
+#define NOTEPAD_LOG_LEVEL 1
+#endif
+
+/**
+ * @brief A leveled logger that hands messages to a background thread for writing.
+ *
+ * Callers only format the message and queue it, the writer drains the queue in batches and flushes once per batch.
+ * Debug and info go to standard output, warnings and errors to standard error. Use the LOG_ macros, a message below
+ * NOTEPAD_LOG_LEVEL is compiled out along with the formatting of its arguments.
+ */
+class Logger {
+    public:
+        /// @brief The severity of a message.
+        enum Level {
+            Debug, Info, Warning, Error
+        };
+
+        /**
+         * @brief Block until every message queued so far has been written.
+         */
+        static void Flush(void);
+
+        /**
+         * @brief Queue a message for writing, starting the writer on first use.
+         * @param level The severity.
+         * @param message The message, without a trailing newline.
+         */
+        static void Write(Level level, std::string message);
+};
+
+// Formats a stream expression into a message, so LOG_INFO("Loaded " << count << " vertices") works.
+#define NOTEPAD_LOG(level, message) \
+    do { \
+        std::ostringstream logStream; \
+        logStream << message; \
+        Logger::Write(level, logStream.str()); \
+    } while (false)
+
+#if NOTEPAD_LOG_LEVEL <= 0
+#define LOG_DEBUG(message) NOTEPAD_LOG(Logger::Debug, message)
+#else
+#define LOG_DEBUG(message) do {} while (false)
+#endif
+
+#if NOTEPAD_LOG_LEVEL <= 1
+#define LOG_INFO(message) NOTEPAD_LOG(Logger::Info, message)
+#else
+#define LOG_INFO(message) do {} while (false)
+#endif
+
+#if NOTEPAD_LOG_LEVEL <= 2
+#define LOG_WARNING(message) NOTEPAD_LOG(Logger::Warning, message)
+#else
+#define LOG_WARNING(message) do {} while (false)
+#endif
+
+#if NOTEPAD_LOG_LEVEL <= 3
+#define LOG_ERROR(message) NOTEPAD_LOG(Logger::Error, message)
+#else
+#define LOG_ERROR(message) do {} while (false)
+#endif
+
+#endif
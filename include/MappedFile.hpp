@@ -0,0 +1,58 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+/// @brief A read only memory mapping of a whole file, pages are only read from disk when touched.
+class MappedFile {
+    public:
+        /**
+         * @brief Creates an empty mapping.
+         */
+        MappedFile(void);
+
+        /**
+         * @brief Unmaps the file.
+         */
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+         * @brief Unmap the file, the data pointer is no longer valid.
+         */
+        void Close(void);
+
+        /**
+         * @brief Get the mapped bytes.
+         * @return A pointer to the first byte, nullptr when nothing is mapped or the file is empty.
+         */
+        const std::byte* GetData(void) const;
+
+        /**
+         * @brief Get the size of the mapping.
+         * @return The size of the file in bytes.
+         */
+        std::size_t GetSize(void) const;
+
+        /**
+         * @brief Map a file, closing any file mapped before.
+         * @param path The file to map.
+         * @param error A description of the problem if mapping failed.
+         * @return True on success.
+         */
+        bool Open(const std::filesystem::path& path, std::string& error);
+
+    private:
+        /// @brief The start of the mapping.
+        const std::byte* m_data;
+
+        /// @brief The size of the mapping in bytes.
+        std::size_t m_size;
+};
+
+#endif
@@ -27,6 +27,11 @@ class Notepad {
         static int Start(void);
 
     private:
+        /**
+         * @brief Deselect every selected vertex of the active graph that still exists.
+         */
+        static void clearSelection(void);
+
         /** 
          * @brief Create the main application window.
          * @return success status.
@@ -42,13 +47,46 @@ class Notepad {
          */
         static int exit(void);
 
-        static void handleAddEdge(sf::RenderWindow *window);
+        /**
+         * @brief Select the ends of a new edge, adding it once two are selected.
+         * @param position The clicked point in world coordinates.
+         */
+        static void handleAddEdge(sf::Vector2f position);
+
+        /**
+         * @brief Add a vertex unless one is already under the click.
+         * @param position The clicked point in world coordinates.
+         */
+        static void handleAddVertex(sf::Vector2f position);
 
-        static void handleAddVertex(sf::RenderWindow *window);
+        /**
+         * @brief Remove the vertex under the click, or the edge if there is no vertex.
+         * @param position The clicked point in world coordinates.
+         */
+        static void handleDelete(sf::Vector2f position);
+
+        /**
+         * @brief Undo or redo an edit of the active graph, dropping the selection as ids may shift.
+         * @param isRedo True to redo, false to undo.
+         */
+        static void handleHistory(bool isRedo);
+
+        /**
+         * @brief Pick the source of a shortest path, or its target and start the search.
+         * @param position The clicked point in world coordinates.
+         */
+        static void handlePath(sf::Vector2f position);
 
-        static void handleDelete(sf::RenderWindow *window);
+        /**
+         * @brief Pin the selected vertices, or unpin them if they all are pinned already.
+         */
+        static void handlePin(void);
 
-        static void handleSelect(sf::RenderWindow *window);
+        /**
+         * @brief Select the vertex under the click, or move the selected one there.
+         * @param position The clicked point in world coordinates.
+         */
+        static void handleSelect(sf::Vector2f position);
 
         /**
          * @brief Sets up the window for the app and initializes state.
@@ -63,8 +101,14 @@ class Notepad {
          */
         static void loop(void);
 
+        /**
+         * @brief Handle one SFML event, anything but mouse movement asks for a redraw.
+         * @param event The event.
+         */
+        static void handleEvent(const sf::Event& event);
+
         /** 
-         * @brief Process SFML events.
+         * @brief Process the SFML events already queued, without blocking.
          */
         static void processEvents(void);
 
@@ -76,9 +120,24 @@ class Notepad {
         /// @brief The graph currently being selected.
         static Graph* m_activeGraph;
 
+        /// @brief The sum of every graph's revision at the last redraw.
+        static std::uint64_t m_drawnRevision;
+
+        /// @brief The frame limit last handed to the window.
+        static int m_frameLimit;
+
+        /// @brief The number of frames still to draw before going idle.
+        static int m_framesToDraw;
+
         /// @brief A list of graphs for the program.
         static std::vector<Graph*> m_graphs;
 
+        /// @brief The background jobs, polled once per frame.
+        static JobScheduler* m_jobs;
+
+        /// @brief The threads layouts compute forces on, apart from the jobs since the frame waits for them.
+        static ThreadPool* m_layoutPool;
+
         /// @brief Current application state.
         static State m_state;
 
@@ -88,8 +147,14 @@ class Notepad {
         /// @brief Pointer to the SFML RenderWindow.
         static sf::RenderWindow *m_window;
 
-        /// @brief List of currently selected vertices.
-        static std::vector<Vertex*> m_selectedVertices;
+        /// @brief Handles of the currently selected vertices in the active graph, removals elsewhere change ids.
+        static std::vector<VertexHandle> m_selectedVertices;
+
+        /// @brief How long an idle loop blocks for input before checking on jobs and graphs again.
+        static constexpr std::int32_t IdleTimeoutMilliseconds = 250;
+
+        /// @brief Frames drawn after a change, so ImGui can settle hover and popup states.
+        static constexpr int RedrawFrames = 3;
 
 };
 
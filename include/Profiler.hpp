@@ -0,0 +1,221 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+/// @brief The run times of one zone over its recent runs.
+typedef struct zoneStats {
+    /// @brief The name of the zone.
+    std::string_view Name;
+
+    /// @brief The number of runs the times are taken over.
+    std::size_t Count;
+
+    /// @brief The median run time in milliseconds.
+    double Median;
+
+    /// @brief The 90th percentile run time in milliseconds.
+    double P90;
+
+    /// @brief The 99th percentile run time in milliseconds.
+    double P99;
+
+    /// @brief The longest run time in milliseconds.
+    double Max;
+} ZoneStats;
+
+/**
+ * @brief Scoped timing zones, frame times, draw calls and allocations, gathered once a frame on the main thread.
+ *
+ * Each thread records its zones into a ring buffer of its own that only it writes and only the main thread reads, so
+ * recording takes no lock. A full buffer drops the zone rather than wait. Zones are compiled in with
+ * NOTEPAD_PROFILING, which also counts every global operator new.
+ */
+class Profiler {
+    public:
+        /// @brief Times its own lifetime, recorded when it goes out of scope. Use PROFILE_ZONE.
+        class Zone {
+            public:
+                /**
+                 * @brief Starts timing.
+                 * @param name The name of the zone, a string literal.
+                 */
+                Zone(const char* name);
+
+                /**
+                 * @brief Stops timing and records the zone.
+                 */
+                ~Zone();
+
+                Zone(const Zone&) = delete;
+                Zone& operator=(const Zone&) = delete;
+
+            private:
+                /// @brief The name of the zone.
+                const char* m_name;
+
+                /// @brief When the zone started, in nanoseconds since the profiler started.
+                std::uint64_t m_start;
+        };
+
+        /**
+         * @brief Start timing a frame.
+         */
+        static void BeginFrame(void);
+
+        /**
+         * @brief Count a draw call on the current frame.
+         */
+        static void CountDrawCall(void);
+
+        /**
+         * @brief Finish timing a frame and gather the zones every thread recorded since the last one.
+         */
+        static void EndFrame(void);
+
+        /**
+         * @brief Get the number of allocations made during the last frame, by any thread.
+         * @return The number of allocations, 0 without NOTEPAD_PROFILING.
+         */
+        static std::uint64_t GetAllocations(void);
+
+        /**
+         * @brief Get the allocations made since the program started, by every thread.
+         * @param count The number of allocations, 0 without NOTEPAD_PROFILING.
+         * @param bytes The number of bytes allocated, 0 without NOTEPAD_PROFILING.
+         */
+        static void GetAllocationTotals(std::uint64_t& count, std::uint64_t& bytes);
+
+        /**
+         * @brief Get the number of draw calls made during the last frame.
+         * @return The number of draw calls.
+         */
+        static std::uint64_t GetDrawCalls(void);
+
+        /**
+         * @brief Get the times of the recent frames.
+         * @return The frame times in milliseconds, oldest first.
+         */
+        static std::vector<float> GetFrameTimes(void);
+
+        /**
+         * @brief Get the run times of every zone recorded so far, over its recent runs.
+         * @return The zones, sorted by name.
+         */
+        static std::vector<ZoneStats> GetZones(void);
+
+        /**
+         * @brief Write the recent zones as a Chrome trace, for chrome://tracing or Perfetto.
+         * @param path The file to write.
+         * @param error A description of the problem if writing failed.
+         * @return True on success.
+         */
+        static bool WriteTrace(const std::filesystem::path& path, std::string& error);
+
+    private:
+        /// @brief A finished zone.
+        typedef struct zoneRecord {
+            /// @brief The name of the zone.
+            const char* Name;
+
+            /// @brief When the zone started, in nanoseconds since the profiler started.
+            std::uint64_t Start;
+
+            /// @brief When the zone ended, in nanoseconds since the profiler started.
+            std::uint64_t End;
+
+            /// @brief The thread the zone ran on, numbered in the order threads first recorded.
+            std::uint32_t Thread;
+        } ZoneRecord;
+
+        /// @brief The ring of finished zones of one thread, written by that thread and read by the main thread.
+        typedef struct threadBuffer {
+            /// @brief The zones, indexed by their count modulo the size of the ring.
+            std::array<ZoneRecord, 4096> Records;
+
+            /// @brief The number of zones ever written, only the owning thread stores it.
+            std::atomic<std::uint64_t> Head;
+
+            /// @brief The number of zones ever read, only the main thread stores it.
+            std::atomic<std::uint64_t> Tail;
+
+            /// @brief The number of the thread.
+            std::uint32_t Thread;
+        } ThreadBuffer;
+
+        /// @brief The recent run times of a zone.
+        typedef struct zoneHistory {
+            /// @brief The run times in milliseconds, a ring of ZoneHistoryLength.
+            std::vector<float> Times;
+
+            /// @brief The number of runs ever recorded.
+            std::size_t Count;
+        } ZoneHistory;
+
+        /**
+         * @brief A helper to get the buffer of the current thread, registering it on first use.
+         * @return The buffer.
+         */
+        static ThreadBuffer& buffer(void);
+
+        /**
+         * @brief A helper to read the clock.
+         * @return Nanoseconds since the profiler started.
+         */
+        static std::uint64_t now(void);
+
+        /// @brief The buffer of every thread that has recorded a zone, never freed so threads can record until exit.
+        static std::vector<ThreadBuffer*> m_buffers;
+
+        /// @brief Guards registering buffers.
+        static std::mutex m_buffersMutex;
+
+        /// @brief Draw calls made during the current frame.
+        static std::atomic<std::uint64_t> m_drawCalls;
+
+        /// @brief The allocation count when the current frame started.
+        static std::uint64_t m_frameAllocations;
+
+        /// @brief The number of frames ever timed.
+        static std::size_t m_frameCount;
+
+        /// @brief When the current frame started.
+        static std::uint64_t m_frameStart;
+
+        /// @brief The recent frame times in milliseconds, a ring of FrameHistoryLength.
+        static std::vector<float> m_frameTimes;
+
+        /// @brief Allocations made during the last frame.
+        static std::uint64_t m_lastAllocations;
+
+        /// @brief Draw calls made during the last frame.
+        static std::uint64_t m_lastDrawCalls;
+
+        /// @brief The recent zones of every thread, oldest first, kept for the trace.
+        static std::deque<ZoneRecord> m_trace;
+
+        /// @brief The recent run times of every zone, by name.
+        static std::unordered_map<std::string_view, ZoneHistory> m_zones;
+
+        /// @brief The number of frames kept.
+        static constexpr std::size_t FrameHistoryLength = 240;
+
+        /// @brief The number of zones kept for the trace.
+        static constexpr std::size_t TraceLength = 1 << 16;
+
+        /// @brief The number of runs kept per zone.
+        static constexpr std::size_t ZoneHistoryLength = 512;
+};
+
+#ifdef NOTEPAD_PROFILING
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name) do {} while (false)
+#endif
+
+#endif
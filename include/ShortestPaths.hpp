@@ -0,0 +1,116 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef SHORTEST_PATHS_HPP
+#define SHORTEST_PATHS_HPP
+
+#include "AdjacencyStore.hpp"
+#include "JobControl.hpp"
+
+/// @brief The shortest paths from one source.
+typedef struct pathResult {
+    /// @brief The length of a shortest path to every vertex, infinity where there is none.
+    std::vector<float> Distance;
+
+    /// @brief The vertex before every vertex on a shortest path, InvalidVertexId for the source and the unreachable.
+    std::vector<VertexId> Parent;
+
+    /// @brief Was a negative edge weight found? Then nothing was searched, only AllPairs() handles those.
+    bool HasNegativeWeight;
+} PathResult;
+
+/// @brief Shortest paths by edge weight, following edge directions in directed graphs.
+class ShortestPaths {
+    public:
+        /**
+         * @brief Find the distances between every pair of vertices with Floyd-Warshall.
+         *
+         * The matrix is worked on in cache sized blocks, the diagonal block of every round first, then its row and
+         * column, then every other block on the pool, with inner loops over contiguous rows that vectorize. Negative
+         * weights are fine as long as there is no negative cycle, a cycle shows as a negative diagonal entry.
+         * @param topology The graph, at most AllPairsLimit vertices.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of rounds done and is checked for cancellation, may be null.
+         * @return The n x n distances row major, row i holding the distances from vertex i, infinity where there is
+         * no path. Empty if the graph is too large, meaningless if cancelled.
+         */
+        static std::vector<float> AllPairs(const AdjacencyStore& topology, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /**
+         * @brief Find the shortest paths from a source with delta-stepping, for large sparse graphs.
+         *
+         * Vertices are kept in buckets of distance width delta, the mean edge weight. Every bucket is settled in
+         * phases that relax the light edges of its vertices in parallel with atomic minimums until it stays empty,
+         * then their heavy edges once. Parents are found afterwards along the edges that are tight.
+         * @param topology The graph, with no negative weights.
+         * @param source The source vertex.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of vertices settled and is checked for cancellation, may be null.
+         * @return The distances and parents, partial if cancelled.
+         */
+        static PathResult DeltaStepping(const AdjacencyStore& topology, VertexId source, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /**
+         * @brief Find the shortest paths from a source with Dijkstra's algorithm on a 4-ary heap.
+         *
+         * Runs in O(m + n log n) with the heap's keys in an array of their own, so sifting touches few cache lines.
+         * @param topology The graph, with no negative weights.
+         * @param source The source vertex.
+         * @param control Receives the fraction of vertices settled and is checked for cancellation, may be null.
+         * @return The distances and parents, partial if cancelled.
+         */
+        static PathResult Dijkstra(const AdjacencyStore& topology, VertexId source, JobControl* control = nullptr);
+
+        /**
+         * @brief Follow the parents back from a vertex.
+         * @param result The shortest paths.
+         * @param target The last vertex of the path.
+         * @return The vertices of the path from the source to the target, empty if the target is unreachable.
+         */
+        static std::vector<VertexId> Path(const PathResult& result, VertexId target);
+
+        /**
+         * @brief Find the shortest paths from a source, with whichever algorithm suits the size of the graph.
+         * @param topology The graph, with no negative weights.
+         * @param source The source vertex.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of vertices settled and is checked for cancellation, may be null.
+         * @return The distances and parents, partial if cancelled.
+         */
+        static PathResult SingleSource(const AdjacencyStore& topology, VertexId source, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /// @brief The most vertices AllPairs() takes, its matrix holds n^2 floats.
+        static constexpr std::size_t AllPairsLimit = 4096;
+
+    private:
+        /**
+         * @brief A helper to run one Floyd-Warshall round over a block, through the pivots of another.
+         * @param distances The padded matrix.
+         * @param stride The padded row length.
+         * @param rowBlock The block row of the block updated.
+         * @param columnBlock The block column of the block updated.
+         * @param pivotBlock The block of the pivots.
+         */
+        static void relaxBlock(float* distances, std::size_t stride, std::size_t rowBlock, std::size_t columnBlock, std::size_t pivotBlock);
+
+        /**
+         * @brief A helper to fill in the parents once the distances are final, along tight edges from the source.
+         * @param topology The graph.
+         * @param source The source vertex.
+         * @param result The result, Distance set and Parent written.
+         */
+        static void treeFromDistances(const AdjacencyStore& topology, VertexId source, PathResult& result);
+
+        /// @brief The side of a Floyd-Warshall block, 64 x 64 floats fill 16 KiB.
+        static constexpr std::size_t BlockSize = 64;
+
+        /// @brief Graphs with at least this many vertices take delta-stepping in SingleSource().
+        static constexpr std::size_t DeltaSteppingThreshold = 1 << 17;
+
+        /// @brief Phases with fewer vertices than this are relaxed on the calling thread.
+        static constexpr std::size_t ParallelThreshold = 4096;
+};
+
+#endif
@@ -6,30 +6,227 @@
 #ifndef SIDEBAR_HPP
 #define SIDEBAR_HPP
 
+#include "BitAdjacency.hpp"
+#include "Canonical.hpp"
+#include "Generators.hpp"
 #include "Graph.hpp"
+#include "JobScheduler.hpp"
+#include "Spectral.hpp"
 
 class Sidebar {
     public:
         /// @brief Interaction modes for the sidebar.
         enum Mode {
-            Select, AddVertex, AddEdge, Delete
+            Select, AddVertex, AddEdge, Delete, ShortestPath
         };
 
         /**
          * @brief Draw's the sidebar panel.
          * @param window A pointer to the window being drawn on.
          * @param graphs A list of graphs.
+         * @param jobs The scheduler algorithms are started on, its running jobs are listed.
          * @param deltaTime The time since last frame.
          */
-        static void Draw(sf::RenderWindow *window, std::vector<Graph*>& graphs, sf::Time deltaTime);
+        static void Draw(sf::RenderWindow *window, std::vector<Graph*>& graphs, JobScheduler& jobs, sf::Time deltaTime);
+
+        /**
+         * @brief Start a shortest path search in the background, the path is highlighted and its length shown once found.
+         * @param jobs The scheduler.
+         * @param graph The graph.
+         * @param source The first vertex of the path.
+         * @param target The last vertex of the path.
+         */
+        static void StartShortestPath(JobScheduler& jobs, Graph* graph, VertexId source, VertexId target);
 
         /// @brief Current interaction mode.
         static int Mode;
 
+        /// @brief The most frames per second drawn while something changes, 0 for no limit.
+        static int FrameLimit;
+
+        /// @brief An undo (-1) or redo (1) asked for this frame, 0 for none, carried out and reset by the notepad.
+        static int HistoryStep;
+
+        /// @brief The most layout iterations run per frame.
+        static int LayoutIterations;
+
+        /// @brief Is the profiler window shown? Also toggled with F3.
+        static bool ShowProfiler;
+
+        /// @brief Is pinning the selection asked for this frame? Carried out and reset by the notepad.
+        static bool TogglePin;
+
         static Graph* currentActiveGraph;
 
     private:
-        
+        /// @brief The work of a dense graph action, run on the bitset adjacency of a snapshot.
+        typedef std::function<JobScheduler::Completion(const BitAdjacency& adjacency, JobControl& control)> DenseWork;
+
+        /// @brief The cached distance matrix of one graph.
+        typedef struct distances {
+            /// @brief The n x n distances row major, from ShortestPaths::AllPairs().
+            std::vector<float> Values;
+
+            /// @brief The topology version the distances were computed for.
+            std::uint64_t Version;
+
+            /// @brief Are the distances shown in place of the adjacency matrix?
+            bool IsShown;
+
+            /// @brief Is a job computing them?
+            bool IsPending;
+        } Distances;
+
+        /// @brief The cached heatmap of one graph's adjacency matrix.
+        typedef struct heatmap {
+            /// @brief The texture, one pixel per block of CellsPerPixel x CellsPerPixel cells.
+            sf::Texture Texture;
+
+            /// @brief The topology version the texture was built from.
+            std::uint64_t Version;
+
+            /// @brief The graph color the texture was built with.
+            sf::Color Color;
+
+            /// @brief The number of matrix rows and columns per pixel.
+            std::size_t CellsPerPixel;
+
+            /// @brief Was the texture built from the distances rather than the edge weights?
+            bool IsDistance;
+        } Heatmap;
+
+        /**
+         * @brief Draw the adjacency matrix as a heatmap texture, rebuilt only when the graph changed.
+         * @param graph The graph.
+         * @param distances The distance matrix to draw instead, or nullptr.
+         */
+        static void drawHeatmap(Graph* graph, const std::vector<float>* distances);
+
+        /**
+         * @brief Draw the adjacency matrix as text, formatting only the cells scrolled into view.
+         * @param graph The graph.
+         * @param distances The distance matrix to draw instead, or nullptr.
+         */
+        static void drawMatrix(Graph* graph, const std::vector<float>* distances);
+
+        /**
+         * @brief Draw the profiler window: frame times, zone percentiles, draw calls, allocations and the trace export.
+         */
+        static void drawProfiler(void);
+
+        /**
+         * @brief Show a result under a graph, replacing an earlier one with the same label.
+         * @param graph The graph.
+         * @param label The name of the result.
+         * @param value The text of the result.
+         */
+        static void setResult(const Graph* graph, const std::string& label, const std::string& value);
+
+        /**
+         * @brief Start the canonical labelling of every open graph in the background, each one told the others it is isomorphic to.
+         * @param jobs The scheduler.
+         * @param graphs The graphs, nothing happens if empty.
+         */
+        static void startCanonical(JobScheduler& jobs, const std::vector<Graph*>& graphs);
+
+        /**
+         * @brief Start coloring a graph in the background, the coloring is shown once it is done.
+         * @param jobs The scheduler.
+         * @param graph The graph, nothing happens if null.
+         * @param isExact Search for the chromatic number rather than run DSATUR alone?
+         */
+        static void startColoring(JobScheduler& jobs, Graph* graph, bool isExact);
+
+        /**
+         * @brief Start a dense graph action in the background, on the graph's bitset adjacency, built if it is not cached.
+         * @param jobs The scheduler.
+         * @param graph The graph, nothing happens if null.
+         * @param label The name of the result.
+         * @param work The action.
+         */
+        static void startDense(JobScheduler& jobs, Graph* graph, const std::string& label, DenseWork work);
+
+        /**
+         * @brief Start computing the distance matrix of a graph in the background, unless it is current or pending.
+         * @param jobs The scheduler.
+         * @param graph The graph.
+         */
+        static void startDistances(JobScheduler& jobs, Graph* graph);
+
+        /**
+         * @brief Start generating a graph of the chosen family in the background, it becomes a new graph once built.
+         * @param jobs The scheduler.
+         * @param graphs The graphs, the new one is added to the end.
+         */
+        static void startGenerator(JobScheduler& jobs, std::vector<Graph*>& graphs);
+
+        /**
+         * @brief Start a spectral analysis of a graph in the background, or show the cached one if its topology is unchanged.
+         * @param jobs The scheduler.
+         * @param graph The graph, nothing happens if null.
+         * @param isBisection Color the two sides of the Fiedler vector's sign cut too?
+         */
+        static void startSpectral(JobScheduler& jobs, Graph* graph, bool isBisection);
+
+        /**
+         * @brief A helper to get the number of threads a job may use, one core is left to the UI.
+         * @return The number of threads.
+         */
+        static std::size_t jobThreads(void);
+
+        /// @brief The bitset adjacency of every graph a dense action ran on, while its topology is unchanged.
+        static std::unordered_map<const Graph*, std::shared_ptr<const BitAdjacency>> m_bitsets;
+
+        /// @brief The canonical hash of every graph compared so far, under the name it first had.
+        static CanonicalCache m_canonical;
+
+        /// @brief The distance matrix of every graph it was shown for.
+        static std::unordered_map<const Graph*, Distances> m_distances;
+
+        /// @brief The graph file path typed into the sidebar.
+        static char m_filePath[256];
+
+        /// @brief The outcome of the last save or open.
+        static std::string m_fileStatus;
+
+        /// @brief The index of the family chosen to generate.
+        static int m_generatorFamily;
+
+        /// @brief The seed of the random families.
+        static int m_generatorSeed;
+
+        /// @brief The outcome of the last generation.
+        static std::string m_generatorStatus;
+
+        /// @brief The parameter values typed in for the chosen family.
+        static std::vector<double> m_generatorValues;
+
+        /// @brief The heatmap of every graph drawn as one.
+        static std::unordered_map<const Graph*, Heatmap> m_heatmaps;
+
+        /// @brief The spectral analysis of every graph it ran on, while its topology is unchanged.
+        static std::unordered_map<const Graph*, std::shared_ptr<const SpectralResult>> m_spectra;
+
+        /// @brief The outcome of the last trace export.
+        static std::string m_traceStatus;
+
+        /// @brief The results shown under every graph, label and text in the order they first came in.
+        static std::unordered_map<const Graph*, std::vector<std::pair<std::string, std::string>>> m_results;
+
+        /// @brief The number of vertices listed by the common neighbours action.
+        static constexpr std::size_t CommonNeighborsShown = 5;
+
+        /// @brief The largest heatmap texture size, bigger matrices share pixels between cells.
+        static constexpr std::size_t HeatmapMaxSize = 1024;
+
+        /// @brief The number of eigenvalues listed from each end of a full spectrum.
+        static constexpr std::size_t SpectrumShown = 4;
+
+        /// @brief Matrices with more vertices than this are drawn as a heatmap.
+        static constexpr int MatrixTextLimit = 64;
+
+        /// @brief The file the profiler trace is exported to.
+        static constexpr const char* TracePath = "notepad-trace.json";
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,94 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef SPATIAL_GRID_HPP
+#define SPATIAL_GRID_HPP
+
+#include "AdjacencyStore.hpp"
+
+/// @brief A uniform grid of world space cells, for amortised O(1) point and rectangle queries of vertices.
+class SpatialGrid {
+    public:
+        /// @brief A vertex stored in a cell.
+        typedef struct entry {
+            /// @brief The id of the vertex.
+            VertexId Id;
+
+            /// @brief The position of the vertex.
+            sf::Vector2f Position;
+        } Entry;
+
+        /**
+         * @brief Creates an empty grid.
+         * @param cellSize The width and height of a cell in world units.
+         */
+        SpatialGrid(float cellSize = 32.0f);
+
+        /**
+         * @brief Remove every vertex.
+         */
+        void Clear(void);
+
+        /**
+         * @brief Find the vertex closest to a point within a square hit box.
+         * @param point The point in world coordinates.
+         * @param halfExtent Half the width of each vertex's hit box.
+         * @return The id of the closest vertex whose hit box contains the point, or InvalidVertexId if none.
+         */
+        VertexId FindAt(sf::Vector2f point, float halfExtent) const;
+
+        /**
+         * @brief Find every vertex inside a rectangle.
+         * @param rect The rectangle in world coordinates.
+         * @param ids The ids found are appended here.
+         */
+        void FindIn(const sf::FloatRect& rect, std::vector<VertexId>& ids) const;
+
+        /**
+         * @brief Add a vertex.
+         * @param id The id of the vertex.
+         * @param position The position of the vertex.
+         */
+        void Insert(VertexId id, sf::Vector2f position);
+
+        /**
+         * @brief Move a vertex.
+         * @param id The id of the vertex.
+         * @param from The position it was inserted at.
+         * @param to The new position.
+         */
+        void Move(VertexId id, sf::Vector2f from, sf::Vector2f to);
+
+        /**
+         * @brief Remove a vertex.
+         * @param id The id of the vertex.
+         * @param position The position it was inserted at.
+         */
+        void Remove(VertexId id, sf::Vector2f position);
+
+    private:
+        /**
+         * @brief A helper to get the cell coordinate of a world coordinate.
+         * @param coordinate The world coordinate.
+         * @return The cell coordinate.
+         */
+        std::int32_t cellOf(float coordinate) const;
+
+        /**
+         * @brief A helper to key a cell.
+         * @param x The cell column.
+         * @param y The cell row.
+         * @return The key.
+         */
+        static std::uint64_t keyOf(std::int32_t x, std::int32_t y);
+
+        /// @brief The occupied cells, empty ones are erased.
+        std::unordered_map<std::uint64_t, std::vector<Entry>> m_cells;
+
+        /// @brief The width and height of a cell.
+        float m_cellSize;
+};
+
+#endif
@@ -0,0 +1,181 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef SPECTRAL_HPP
+#define SPECTRAL_HPP
+
+#include "AdjacencyStore.hpp"
+#include "JobControl.hpp"
+#include "ThreadPool.hpp"
+
+/// @brief The extreme eigenvalues of a graph's Laplacian and adjacency matrix.
+typedef struct spectralResult {
+    /// @brief The second smallest Laplacian eigenvalue, 0 for a disconnected graph or one of fewer than two vertices.
+    double AlgebraicConnectivity;
+
+    /// @brief A unit eigenvector of AlgebraicConnectivity, one entry per vertex, empty below two vertices.
+    std::vector<float> Fiedler;
+
+    /// @brief The largest Laplacian eigenvalue.
+    double LaplacianRadius;
+
+    /// @brief The largest adjacency eigenvalue, the spectral radius of the graph.
+    double SpectralRadius;
+
+    /// @brief Every Laplacian eigenvalue in increasing order, only for graphs of at most FullSpectrumLimit vertices.
+    std::vector<double> LaplacianSpectrum;
+
+    /// @brief Every adjacency eigenvalue in increasing order, only for graphs of at most FullSpectrumLimit vertices.
+    std::vector<double> AdjacencySpectrum;
+
+    /// @brief The number of Lanczos steps taken over both matrices.
+    std::size_t Iterations;
+
+    /// @brief Did every eigenvalue reach the tolerance within the step limit, and was the analysis not cancelled?
+    bool IsConverged;
+
+    /// @brief The topology version analysed.
+    std::uint64_t Version;
+} SpectralResult;
+
+/**
+ * @brief Spectral analysis of the underlying undirected simple graph, edge weights, directions and self loops ignored.
+ *
+ * Both matrices are applied as sparse operators, a row split sparse matrix vector product over a pool, and their
+ * extreme eigenpairs come from the Lanczos method. Only three vectors of the Krylov basis are kept: a first pass
+ * builds the tridiagonal matrix, a second one repeats the recurrence to add up the Ritz vector, so memory stays O(n + m)
+ * however many steps it takes.
+ */
+class Spectral {
+    public:
+        /**
+         * @brief Compute the algebraic connectivity with a Fiedler vector and the Laplacian and adjacency radii.
+         *
+         * The Lanczos run on the Laplacian is kept orthogonal to the constant vector, so its smallest Ritz value
+         * converges to the algebraic connectivity. A disconnected graph has 0 there and its Fiedler vector splits the
+         * largest component from the rest. Graphs of at most FullSpectrumLimit vertices also get both full spectra
+         * from a dense Householder reduction, and their eigenvalues are taken from those.
+         * @param topology The graph.
+         * @param maxThreads The most worker threads to use, 0 for one per core.
+         * @param control Receives the fraction of the step limit used and is checked for cancellation, may be null.
+         * @return The analysis, not IsConverged if cancelled.
+         */
+        static SpectralResult Analyze(const AdjacencyStore& topology, std::size_t maxThreads = 0, JobControl* control = nullptr);
+
+        /// @brief The most vertices for which the full spectra are computed, in O(n³).
+        static constexpr std::size_t FullSpectrumLimit = 512;
+
+        /// @brief The most Lanczos steps per matrix.
+        static constexpr std::size_t MaxSteps = 3000;
+
+    private:
+        /// @brief A symmetric sparse matrix with a constant off diagonal entry, the Laplacian or the adjacency matrix.
+        typedef struct graphOperator {
+            /// @brief Row offsets into Columns.
+            std::vector<std::size_t> Offsets;
+
+            /// @brief The neighbours of every vertex, each listed once.
+            std::vector<VertexId> Columns;
+
+            /// @brief The diagonal entries.
+            std::vector<double> Diagonal;
+
+            /// @brief The off diagonal entry, -1 for the Laplacian and 1 for the adjacency matrix.
+            double OffDiagonal;
+
+            /// @brief Is the operator kept orthogonal to the constant vector?
+            bool IsDeflated;
+
+            /// @brief The workers products run on, null to run them on the calling thread.
+            ThreadPool* Pool;
+        } Operator;
+
+        /// @brief The extreme eigenpairs found by a Lanczos run.
+        typedef struct lanczosResult {
+            /// @brief The smallest Ritz value.
+            double Lowest;
+
+            /// @brief The largest Ritz value.
+            double Highest;
+
+            /// @brief The Ritz vector of Lowest or Highest, if asked for.
+            std::vector<double> Vector;
+
+            /// @brief The number of steps taken.
+            std::size_t Steps;
+
+            /// @brief Did both ends reach the tolerance?
+            bool IsConverged;
+        } LanczosResult;
+
+        /**
+         * @brief A helper to multiply a vector by an operator.
+         * @param op The operator.
+         * @param x The vector.
+         * @param y Set to the product.
+         * @return The inner product of x and y.
+         */
+        static double apply(const Operator& op, const std::vector<double>& x, std::vector<double>& y);
+
+        /**
+         * @brief A helper to build the dense matrix of an operator and find all of its eigenvalues.
+         * @param op The operator.
+         * @return The eigenvalues in increasing order.
+         */
+        static std::vector<double> denseSpectrum(const Operator& op);
+
+        /**
+         * @brief A helper to run a loop over the vertices in chunks on the operator's pool and add up what each returns.
+         *
+         * Chunks of ChunkRows vertices whatever the number of threads, and the partial sums added in chunk order,
+         * make every sum come out the same on any pool, which the second Lanczos pass relies on.
+         * @param op The operator.
+         * @param body Runs the vertices from begin to end and returns their share of the sum.
+         * @return The sum.
+         */
+        static double sweep(const Operator& op, const std::function<double(std::size_t begin, std::size_t end)>& body);
+
+        /**
+         * @brief A helper to find the k-th smallest eigenvalue of a symmetric tridiagonal matrix by Sturm bisection.
+         * @param diagonal The diagonal.
+         * @param offDiagonal The entries below the diagonal, one fewer.
+         * @param index The index of the eigenvalue, from 0.
+         * @return The eigenvalue.
+         */
+        static double tridiagonalEigenvalue(const std::vector<double>& diagonal, const std::vector<double>& offDiagonal, std::size_t index);
+
+        /**
+         * @brief A helper to find the eigenvector of a symmetric tridiagonal matrix for an extreme eigenvalue by inverse iteration.
+         * @param diagonal The diagonal.
+         * @param offDiagonal The entries below the diagonal, one fewer.
+         * @param eigenvalue The smallest or the largest eigenvalue.
+         * @param isLowest Is it the smallest?
+         * @return A unit eigenvector.
+         */
+        static std::vector<double> tridiagonalEigenvector(const std::vector<double>& diagonal, const std::vector<double>& offDiagonal, double eigenvalue, bool isLowest);
+
+        /**
+         * @brief A helper to run the Lanczos method from a fixed start vector until both ends of the spectrum converge.
+         * @param op The operator.
+         * @param wantLowest Is the vector wanted for the smallest eigenvalue, else for the largest?
+         * @param wantVector Should the second pass build the Ritz vector?
+         * @param control Checked for cancellation, may be null.
+         * @param progress The part of the job done before this run, moved on as it steps.
+         * @param share The part of the job this run is worth.
+         * @return The extreme Ritz values and the vector.
+         */
+        static LanczosResult lanczos(const Operator& op, bool wantLowest, bool wantVector, JobControl* control, float progress, float share);
+
+        /// @brief The residual, relative to the spectrum's width, at which a Ritz value is converged.
+        static constexpr double Tolerance = 1e-8;
+
+        /// @brief The Lanczos steps between convergence checks.
+        static constexpr std::size_t CheckInterval = 16;
+
+        /// @brief The vertices per chunk of a sweep(), smaller operators run on the calling thread.
+        static constexpr std::size_t ChunkRows = 1 << 14;
+};
+
+#endif
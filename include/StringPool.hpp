@@ -0,0 +1,70 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef STRING_POOL_HPP
+#define STRING_POOL_HPP
+
+/// @brief The id of an interned string, EmptyStringId for the empty string.
+typedef std::uint32_t StringId;
+
+/// @brief The id of the empty string in every pool.
+inline constexpr StringId EmptyStringId = 0;
+
+/**
+ * @brief Interned strings, every distinct string stored once in an arena of large blocks.
+ *
+ * Interning copies the characters into the current block, so n names cost a few block allocations rather than one each,
+ * and Clear() hands every block back at once. Strings are never freed one by one, an id stays valid until Clear().
+ */
+class StringPool {
+    public:
+        /**
+         * @brief Creates a pool holding only the empty string.
+         */
+        StringPool(void);
+
+        StringPool(const StringPool&) = delete;
+        StringPool& operator=(const StringPool&) = delete;
+
+        /**
+         * @brief Forget every string and free the arena, only EmptyStringId stays valid.
+         */
+        void Clear(void);
+
+        /**
+         * @brief Get an interned string.
+         * @param id The id, from Intern().
+         * @return The characters, valid until Clear().
+         */
+        std::string_view Get(StringId id) const;
+
+        /**
+         * @brief Get the number of distinct strings, the empty one included.
+         * @return The count.
+         */
+        std::size_t GetCount(void) const;
+
+        /**
+         * @brief Intern a string, copying it into the arena the first time it is seen.
+         * @param text The string.
+         * @return The id, the same for equal strings.
+         */
+        StringId Intern(std::string_view text);
+
+    private:
+        /// @brief The blocks holding the characters.
+        std::pmr::monotonic_buffer_resource m_arena;
+
+        /// @brief The id of every string, keyed by its characters in the arena.
+        std::unordered_map<std::string_view, StringId> m_ids;
+
+        /// @brief Every string, indexed by id.
+        std::vector<std::string_view> m_strings;
+
+        /// @brief The size of the first block of the arena, later ones grow geometrically.
+        static constexpr std::size_t BlockBytes = 1 << 16;
+};
+
+#endif
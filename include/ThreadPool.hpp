@@ -0,0 +1,103 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+/// @brief A fixed set of worker threads with a task deque each, idle workers steal from busy ones.
+class ThreadPool {
+    public:
+        /**
+         * @brief Creates a pool and starts its workers.
+         * @param threadCount The number of workers, 0 for one per core.
+         */
+        ThreadPool(std::size_t threadCount = 0);
+
+        /**
+         * @brief Finishes every queued task and joins the workers.
+         */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Get the number of workers.
+         * @return The number of worker threads.
+         */
+        std::size_t GetThreadCount(void) const;
+
+        /**
+         * @brief Queue a task to run on a worker.
+         *
+         * A task submitted from one of the pool's own workers goes on that worker's deque, where it runs next,
+         * anything else is dealt round robin.
+         * @param task The task.
+         */
+        void Submit(std::function<void()> task);
+
+        /**
+         * @brief Block until every submitted task has finished, not to be called from a task.
+         *
+         * The first exception a task threw since the last Wait() is rethrown here, the other tasks still run.
+         */
+        void Wait(void);
+
+    private:
+        /// @brief The tasks of one worker, the owner pops from the back and thieves take from the front.
+        typedef struct queue {
+            /// @brief Guards the tasks.
+            std::mutex Mutex;
+
+            /// @brief The queued tasks.
+            std::deque<std::function<void()>> Tasks;
+        } Queue;
+
+        /**
+         * @brief A helper to take a task, from the worker's own deque first, then from the others.
+         * @param index The index of the worker.
+         * @param task The task taken.
+         * @return False if every deque was empty.
+         */
+        bool take(std::size_t index, std::function<void()>& task);
+
+        /**
+         * @brief The loop each worker runs until the pool is destroyed.
+         * @param index The index of the worker.
+         */
+        void workerLoop(std::size_t index);
+
+        /// @brief The first exception a task threw, for Wait() to rethrow.
+        std::exception_ptr m_error;
+
+        /// @brief Signalled when every task has finished.
+        std::condition_variable m_idle;
+
+        /// @brief Guards sleeping, waking and the pending count.
+        std::mutex m_mutex;
+
+        /// @brief The next deque for a task submitted from outside the pool.
+        std::atomic<std::size_t> m_nextQueue;
+
+        /// @brief The number of tasks queued or running.
+        std::size_t m_pending;
+
+        /// @brief The deque of every worker.
+        std::vector<std::unique_ptr<Queue>> m_queues;
+
+        /// @brief The number of tasks sitting in a deque.
+        std::atomic<std::size_t> m_queued;
+
+        /// @brief Is the pool shutting down?
+        bool m_stopping;
+
+        /// @brief Signalled when a task is queued or the pool stops.
+        std::condition_variable m_taskReady;
+
+        /// @brief The worker threads.
+        std::vector<std::thread> m_workers;
+};
+
+#endif
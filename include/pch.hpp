@@ -15,10 +15,7 @@
 #include <SFML/System.hpp>
 #include <SFML/Window.hpp>
 
-// Standard library includes
-#include <iostream>
-#include <optional>
-#include <vector>
-#include <string>
+// Graph core includes, the standard library.
+#include "corepch.hpp"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,504 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "AdjacencyStore.hpp"
+
+namespace {
+    /// @brief The last version handed out by any store.
+    std::atomic<std::uint64_t> s_lastVersion = 0;
+}
+
+AdjacencyStore::AdjacencyStore(bool isDirected) {
+    m_isDirected = isDirected;
+    m_edgeCount = 0;
+    m_version = 0;
+    m_componentCount = 0;
+    m_componentsDirty = false;
+    m_componentVersion = ++s_lastVersion;
+    markDirty();
+}
+
+bool AdjacencyStore::AddEdge(VertexId from, VertexId to, float weight) {
+    // Update the weight in place if the edge already exists.
+    Neighbor* existing = const_cast<Neighbor*>(findEntry(from, to));
+    if (existing) {
+        existing->Weight = weight;
+        if (!m_isDirected && from != to) {
+            const_cast<Neighbor*>(findEntry(to, from))->Weight = weight;
+        }
+        markDirty();
+        return false;
+    }
+
+    // Undirected edges live in both lists, self loops only once.
+    m_adjacency[from].push_back({ to, weight });
+    if (!m_isDirected && from != to) {
+        m_adjacency[to].push_back({ from, weight });
+    }
+
+    m_edgeCount++;
+    joinComponents(from, to);
+    markDirty();
+    return true;
+}
+
+VertexId AdjacencyStore::AddVertex(void) {
+    return AddVertices(1);
+}
+
+VertexId AdjacencyStore::AddVertices(std::size_t count) {
+    VertexId first = static_cast<VertexId>(m_adjacency.size());
+    m_adjacency.resize(m_adjacency.size() + count);
+
+    // Every new vertex is a component of its own.
+    if (!m_componentsDirty) {
+        for (VertexId v = first; v < m_adjacency.size(); v++) {
+            m_componentOf.push_back(v);
+            m_componentNext.push_back(v);
+            m_componentSize.push_back(1);
+        }
+        m_componentCount += count;
+    }
+    markDirty();
+    return first;
+}
+
+void AdjacencyStore::AppendEdge(VertexId from, VertexId to, float weight) {
+    m_adjacency[from].push_back({ to, weight });
+    if (!m_isDirected && from != to) {
+        m_adjacency[to].push_back({ from, weight });
+    }
+
+    // A bulk build is cheaper to label in one pass at the end than to merge edge by edge.
+    m_edgeCount++;
+    m_componentsDirty = true;
+    markDirty();
+}
+
+void AdjacencyStore::Assign(std::span<const std::uint64_t> offsets, std::span<const Neighbor> entries) {
+    const std::size_t n = offsets.empty() ? 0 : offsets.size() - 1;
+    m_adjacency.clear();
+    m_adjacency.resize(n);
+
+    for (std::size_t v = 0; v < n; v++) {
+        m_adjacency[v].assign(entries.begin() + offsets[v], entries.begin() + offsets[v + 1]);
+    }
+    countEdges();
+    m_componentsDirty = true;
+    markDirty();
+}
+
+VertexId AdjacencyStore::GetComponent(VertexId id) const {
+    buildComponents();
+    return m_componentOf[id];
+}
+
+std::size_t AdjacencyStore::GetComponentCount(void) const {
+    buildComponents();
+    return m_componentCount;
+}
+
+std::size_t AdjacencyStore::GetComponentSize(VertexId id) const {
+    buildComponents();
+    return m_componentSize[m_componentOf[id]];
+}
+
+std::uint64_t AdjacencyStore::GetComponentVersion(void) const {
+    buildComponents();
+    return m_componentVersion;
+}
+
+const AdjacencyStore::CSR& AdjacencyStore::GetCSR(void) const {
+    if (!m_csrDirty) {
+        return m_csr;
+    }
+
+    // Prefix sum the degrees into row offsets.
+    const std::size_t n = m_adjacency.size();
+    m_csr.Offsets.assign(n + 1, 0);
+    for (std::size_t v = 0; v < n; v++) {
+        m_csr.Offsets[v + 1] = m_csr.Offsets[v] + m_adjacency[v].size();
+    }
+
+    // Copy every list into its row.
+    m_csr.Entries.resize(m_csr.Offsets[n]);
+    for (std::size_t v = 0; v < n; v++) {
+        std::copy(m_adjacency[v].begin(), m_adjacency[v].end(), m_csr.Entries.begin() + m_csr.Offsets[v]);
+    }
+
+    m_csrDirty = false;
+    return m_csr;
+}
+
+std::size_t AdjacencyStore::GetDegree(VertexId id) const {
+    return m_adjacency[id].size();
+}
+
+std::vector<std::vector<float>> AdjacencyStore::GetDenseMatrix(void) const {
+    const std::size_t n = m_adjacency.size();
+    std::vector<std::vector<float>> matrix(n, std::vector<float>(n, 0.0f));
+    for (std::size_t v = 0; v < n; v++) {
+        for (const Neighbor& entry : m_adjacency[v]) {
+            matrix[v][entry.Target] = entry.Weight;
+        }
+    }
+
+    return matrix;
+}
+
+std::size_t AdjacencyStore::GetEdgeCount(void) const {
+    return m_edgeCount;
+}
+
+const std::vector<Neighbor>& AdjacencyStore::GetNeighbors(VertexId id) const {
+    return m_adjacency[id];
+}
+
+std::size_t AdjacencyStore::GetVertexCount(void) const {
+    return m_adjacency.size();
+}
+
+const AdjacencyStore::CSR& AdjacencyStore::GetSymmetricCSR(void) const {
+    if (!m_isDirected) {
+        return GetCSR();
+    }
+    if (!m_symmetricCsrDirty) {
+        return m_symmetricCsr;
+    }
+
+    // Each row holds the out edges followed by the in edges.
+    const std::size_t n = m_adjacency.size();
+    m_symmetricCsr.Offsets.assign(n + 1, 0);
+    for (std::size_t v = 0; v < n; v++) {
+        m_symmetricCsr.Offsets[v + 1] += m_adjacency[v].size();
+        for (const Neighbor& entry : m_adjacency[v]) {
+            if (entry.Target != v) {
+                m_symmetricCsr.Offsets[entry.Target + 1]++;
+            }
+        }
+    }
+    for (std::size_t v = 0; v < n; v++) {
+        m_symmetricCsr.Offsets[v + 1] += m_symmetricCsr.Offsets[v];
+    }
+
+    std::vector<std::size_t> cursor(m_symmetricCsr.Offsets.begin(), m_symmetricCsr.Offsets.end() - 1);
+    m_symmetricCsr.Entries.resize(m_symmetricCsr.Offsets[n]);
+    for (std::size_t v = 0; v < n; v++) {
+        std::copy(m_adjacency[v].begin(), m_adjacency[v].end(), m_symmetricCsr.Entries.begin() + cursor[v]);
+        cursor[v] += m_adjacency[v].size();
+    }
+    for (std::size_t v = 0; v < n; v++) {
+        for (const Neighbor& entry : m_adjacency[v]) {
+            if (entry.Target != v) {
+                m_symmetricCsr.Entries[cursor[entry.Target]++] = { static_cast<VertexId>(v), entry.Weight };
+            }
+        }
+    }
+
+    m_symmetricCsrDirty = false;
+    return m_symmetricCsr;
+}
+
+std::uint64_t AdjacencyStore::GetVersion(void) const {
+    return m_version;
+}
+
+float AdjacencyStore::GetWeight(VertexId from, VertexId to) const {
+    const Neighbor* entry = findEntry(from, to);
+    return entry ? entry->Weight : 0.0f;
+}
+
+bool AdjacencyStore::HasEdge(VertexId from, VertexId to) const {
+    return findEntry(from, to) != nullptr;
+}
+
+void AdjacencyStore::InsertVertex(VertexId id) {
+    m_adjacency.emplace_back();
+    const VertexId last = static_cast<VertexId>(m_adjacency.size() - 1);
+    if (id != last) {
+        moveVertex(id, last);
+    }
+    m_componentsDirty = true;
+    markDirty();
+}
+
+bool AdjacencyStore::IsDirected(void) const {
+    return m_isDirected;
+}
+
+void AdjacencyStore::PopVertex(void) {
+    m_adjacency.pop_back();
+
+    // The vertex has no edges, so unless a removal is pending it is a component of its own and nothing else changes.
+    if (!m_componentsDirty) {
+        m_componentOf.pop_back();
+        m_componentNext.pop_back();
+        m_componentSize.pop_back();
+        m_componentCount--;
+    }
+    markDirty();
+}
+
+void AdjacencyStore::RemoveDuplicateEdges(void) {
+    // The slot of every target in the list being merged, reset after each list so the pass stays O(n + m).
+    const std::uint32_t unseen = std::numeric_limits<std::uint32_t>::max();
+    std::vector<std::uint32_t> slot(m_adjacency.size(), unseen);
+    for (std::vector<Neighbor>& list : m_adjacency) {
+        std::size_t kept = 0;
+        for (const Neighbor& entry : list) {
+            if (slot[entry.Target] == unseen) {
+                slot[entry.Target] = static_cast<std::uint32_t>(kept);
+                list[kept++] = entry;
+            } else {
+                list[slot[entry.Target]].Weight = entry.Weight;
+            }
+        }
+        list.resize(kept);
+        for (const Neighbor& entry : list) {
+            slot[entry.Target] = unseen;
+        }
+    }
+
+    countEdges();
+    markDirty();
+}
+
+bool AdjacencyStore::RemoveEdge(VertexId from, VertexId to) {
+    // Erase rather than swap, so the lists keep their insertion order.
+    const Neighbor* entry = findEntry(from, to);
+    if (!entry) {
+        return false;
+    }
+    m_adjacency[from].erase(m_adjacency[from].begin() + (entry - m_adjacency[from].data()));
+    if (!m_isDirected && from != to) {
+        const Neighbor* reverse = findEntry(to, from);
+        m_adjacency[to].erase(m_adjacency[to].begin() + (reverse - m_adjacency[to].data()));
+    }
+
+    m_edgeCount--;
+    if (from != to) {
+        m_componentsDirty = true;
+    }
+    markDirty();
+    return true;
+}
+
+void AdjacencyStore::RemoveVertex(VertexId id) {
+    if (id >= m_adjacency.size()) {
+        return;
+    }
+
+    // Drop the entries pointing at the vertex, an undirected edge is counted once from the vertex's own list.
+    std::size_t removed = m_adjacency[id].size();
+    if (m_isDirected) {
+        for (VertexId v = 0; v < m_adjacency.size(); v++) {
+            if (v == id) {
+                continue;
+            }
+            std::vector<Neighbor>& list = m_adjacency[v];
+            std::size_t kept = 0;
+            for (const Neighbor& entry : list) {
+                if (entry.Target != id) {
+                    list[kept++] = entry;
+                }
+            }
+            removed += list.size() - kept;
+            list.resize(kept);
+        }
+    } else {
+        for (const Neighbor& entry : m_adjacency[id]) {
+            if (entry.Target != id) {
+                std::vector<Neighbor>& list = m_adjacency[entry.Target];
+                list.erase(list.begin() + (findEntry(entry.Target, id) - list.data()));
+            }
+        }
+    }
+    m_adjacency[id].clear();
+
+    // The last vertex fills the gap, so no other id changes.
+    const VertexId last = static_cast<VertexId>(m_adjacency.size() - 1);
+    if (id != last) {
+        moveVertex(last, id);
+    }
+    m_adjacency.pop_back();
+
+    m_edgeCount -= removed;
+    m_componentsDirty = true;
+    markDirty();
+}
+
+void AdjacencyStore::Reserve(std::size_t vertexCount) {
+    m_adjacency.reserve(vertexCount);
+    m_componentOf.reserve(vertexCount);
+    m_componentNext.reserve(vertexCount);
+    m_componentSize.reserve(vertexCount);
+}
+
+void AdjacencyStore::ReserveNeighbors(VertexId id, std::size_t count) {
+    m_adjacency[id].reserve(count);
+}
+
+void AdjacencyStore::ShrinkToFit(void) {
+    for (std::vector<Neighbor>& list : m_adjacency) {
+        if (list.capacity() > 2 * list.size()) {
+            list.shrink_to_fit();
+        }
+    }
+    if (m_adjacency.capacity() > 2 * m_adjacency.size()) {
+        m_adjacency.shrink_to_fit();
+        m_componentNext.shrink_to_fit();
+        m_componentOf.shrink_to_fit();
+        m_componentSize.shrink_to_fit();
+    }
+}
+
+void AdjacencyStore::buildComponents(void) const {
+    if (!m_componentsDirty) {
+        return;
+    }
+
+    // Union by size with path halving over every edge, sizes kept at the roots.
+    const std::size_t n = m_adjacency.size();
+    std::vector<VertexId> parent(n);
+    for (VertexId v = 0; v < n; v++) {
+        parent[v] = v;
+    }
+    m_componentSize.assign(n, 1);
+    const auto find = [&parent](VertexId v) {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    };
+    for (VertexId v = 0; v < n; v++) {
+        for (const Neighbor& entry : m_adjacency[v]) {
+            VertexId first = find(v);
+            VertexId second = find(entry.Target);
+            if (first == second) {
+                continue;
+            }
+            if (m_componentSize[first] < m_componentSize[second]) {
+                std::swap(first, second);
+            }
+            parent[second] = first;
+            m_componentSize[first] += m_componentSize[second];
+        }
+    }
+
+    // The roots become the representatives, then every other vertex is linked in after the last one of its circle.
+    m_componentOf.resize(n);
+    m_componentNext.resize(n);
+    m_componentCount = 0;
+    for (VertexId v = 0; v < n; v++) {
+        m_componentOf[v] = find(v);
+        if (m_componentOf[v] == v) {
+            m_componentNext[v] = v;
+            m_componentCount++;
+        } else {
+            m_componentSize[v] = 0;
+        }
+    }
+    std::vector<VertexId>& tail = parent;
+    for (VertexId v = 0; v < n; v++) {
+        tail[v] = v;
+    }
+    for (VertexId v = 0; v < n; v++) {
+        const VertexId root = m_componentOf[v];
+        if (root != v) {
+            m_componentNext[v] = root;
+            m_componentNext[tail[root]] = v;
+            tail[root] = v;
+        }
+    }
+
+    m_componentsDirty = false;
+    m_componentVersion = ++s_lastVersion;
+}
+
+void AdjacencyStore::countEdges(void) {
+    std::size_t entries = 0;
+    std::size_t loops = 0;
+    for (std::size_t v = 0; v < m_adjacency.size(); v++) {
+        entries += m_adjacency[v].size();
+        for (const Neighbor& entry : m_adjacency[v]) {
+            if (entry.Target == v) {
+                loops++;
+            }
+        }
+    }
+    m_edgeCount = m_isDirected ? entries : (entries + loops) / 2;
+}
+
+void AdjacencyStore::joinComponents(VertexId from, VertexId to) {
+    if (m_componentsDirty) {
+        return;
+    }
+    VertexId kept = m_componentOf[from];
+    VertexId merged = m_componentOf[to];
+    if (kept == merged) {
+        return;
+    }
+    if (m_componentSize[kept] < m_componentSize[merged]) {
+        std::swap(kept, merged);
+    }
+
+    // Relabel the smaller circle, then splice the two into one by swapping the successors of their representatives.
+    VertexId v = merged;
+    do {
+        m_componentOf[v] = kept;
+        v = m_componentNext[v];
+    } while (v != merged);
+    std::swap(m_componentNext[kept], m_componentNext[merged]);
+
+    m_componentSize[kept] += m_componentSize[merged];
+    m_componentSize[merged] = 0;
+    m_componentCount--;
+    m_componentVersion = ++s_lastVersion;
+}
+
+void AdjacencyStore::markDirty(void) {
+    m_version = ++s_lastVersion;
+    m_csrDirty = true;
+    m_symmetricCsrDirty = true;
+}
+
+const Neighbor* AdjacencyStore::findEntry(VertexId from, VertexId to) const {
+    for (const Neighbor& entry : m_adjacency[from]) {
+        if (entry.Target == to) {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+void AdjacencyStore::moveVertex(VertexId from, VertexId to) {
+    // Undirected edges are listed at both ends, so the entries pointing at the vertex are found from its own list.
+    if (m_isDirected) {
+        for (std::vector<Neighbor>& list : m_adjacency) {
+            for (Neighbor& entry : list) {
+                if (entry.Target == from) {
+                    entry.Target = to;
+                }
+            }
+        }
+    } else {
+        for (const Neighbor& entry : m_adjacency[from]) {
+            if (entry.Target != from) {
+                const_cast<Neighbor*>(findEntry(entry.Target, from))->Target = to;
+            }
+        }
+    }
+
+    m_adjacency[to] = std::move(m_adjacency[from]);
+    m_adjacency[from].clear();
+    for (Neighbor& entry : m_adjacency[to]) {
+        if (entry.Target == from) {
+            entry.Target = to;
+        }
+    }
+}
@@ -0,0 +1,306 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "Batch.hpp"
+#include "Bipartite.hpp"
+#include "Canonical.hpp"
+#include "Cliques.hpp"
+#include "Coloring.hpp"
+#include "Generators.hpp"
+#include "GraphFile.hpp"
+#include "GraphIO.hpp"
+#include "SpanningTrees.hpp"
+#include "Spectral.hpp"
+#include "ThreadPool.hpp"
+
+int Batch::Run(int argc, char **argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    // Collect the graph files in a stable order.
+    std::vector<std::filesystem::path> files;
+    if (!options.Directory.empty()) {
+        std::error_code status;
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(options.Directory, status)) {
+            if (entry.is_regular_file()) {
+                files.push_back(entry.path());
+            }
+        }
+        if (status) {
+            std::cerr << "Cannot read directory " << options.Directory << ": " << status.message() << std::endl;
+            return 2;
+        }
+        std::sort(files.begin(), files.end());
+    }
+    if (!options.SaveDirectory.empty()) {
+        std::error_code status;
+        std::filesystem::create_directories(options.SaveDirectory, status);
+        if (status) {
+            std::cerr << "Cannot create directory " << options.SaveDirectory << ": " << status.message() << std::endl;
+            return 2;
+        }
+    }
+
+    std::ofstream outputFile;
+    if (!options.OutputPath.empty()) {
+        outputFile.open(options.OutputPath);
+        if (!outputFile) {
+            std::cerr << "Cannot write " << options.OutputPath << std::endl;
+            return 2;
+        }
+    }
+    std::ostream& output = options.OutputPath.empty() ? std::cout : outputFile;
+
+    // Every file and generated graph is one task, lines are written in order as soon as their turn comes. A lone
+    // generated graph is built on every worker, otherwise each one gets a single thread like the invariants.
+    const std::size_t tasks = files.size() + options.Generate.size();
+    const std::size_t generatorThreads = tasks > 1 ? 1 : options.Threads;
+    std::mutex mutex;
+    std::vector<std::optional<std::string>> lines(tasks);
+    std::size_t nextLine = 0;
+    bool anyFailed = false;
+    auto taskName = [&](std::size_t i) {
+        return i < files.size() ? files[i].string() : options.Generate[i - files.size()];
+    };
+    {
+        ThreadPool pool(options.Threads);
+        for (std::size_t i = 0; i < tasks; i++) {
+            pool.Submit([&, i]() {
+                // A task that throws fails on its own line, an escaping exception would end the process from the worker.
+                bool failed = false;
+                std::string line;
+                try {
+                    line = i < files.size() ? analyze(files[i], options, failed) : generate(options.Generate[i - files.size()], options, generatorThreads, failed);
+                } catch (const std::exception& exception) {
+                    failed = true;
+                    line = taskName(i) + "\terror=" + exception.what();
+                } catch (...) {
+                    failed = true;
+                    line = taskName(i) + "\terror=unknown exception";
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                anyFailed = anyFailed || failed;
+                lines[i] = std::move(line);
+                while (nextLine < lines.size() && lines[nextLine]) {
+                    output << *lines[nextLine] << '\n';
+                    lines[nextLine].reset();
+                    nextLine++;
+                }
+            });
+        }
+        pool.Wait();
+    }
+    output.flush();
+
+    return anyFailed ? 1 : 0;
+}
+
+std::string Batch::analyze(const std::filesystem::path& path, const Options& options, bool& failed) {
+    std::string line = path.string();
+
+    // Saved graph files carry their own directedness and log, anything else is imported by its extension.
+    AdjacencyStore topology(options.IsDirected);
+    std::string error;
+    if (path.extension() == ".gtn") {
+        GraphFile file;
+        if (!file.Open(path, error) || !file.Load(topology, error)) {
+            failed = true;
+            return line + "\terror=" + error;
+        }
+        for (const GraphFile::LogEntry& entry : file.GetLog()) {
+            GraphFile::Replay(entry, topology);
+        }
+    } else if (!GraphIO::Read(path, GraphIO::DetectFormat(path), topology, error, 1)) {
+        failed = true;
+        return line + "\terror=" + error;
+    }
+
+    return describe(std::move(line), topology, options);
+}
+
+std::string Batch::describe(std::string line, const AdjacencyStore& topology, const Options& options) {
+    for (const Invariant* invariant : options.Invariants) {
+        line += '\t';
+        line += invariant->Name;
+        line += '=';
+        line += invariant->Compute(topology);
+    }
+
+    return line;
+}
+
+std::string Batch::generate(const std::string& spec, const Options& options, std::size_t maxThreads, bool& failed) {
+    std::vector<double> values;
+    std::string error;
+    const Generators::Family* family = Generators::Parse(spec, values, error);
+    GeneratedGraph graph = family->Build(values, options.Seed, maxThreads, nullptr);
+
+    // Saved under the specification with its punctuation swapped out, so it opens like any other graph file.
+    if (!options.SaveDirectory.empty()) {
+        std::string name = spec;
+        std::replace_if(name.begin(), name.end(), [](char c) {
+            return c == ':' || c == ',' || c == '=' || c == '/' || c == '\\';
+        }, '_');
+        const std::filesystem::path path = options.SaveDirectory / (name + ".gtn");
+        bool isSaved = GraphFile::Save(path, graph.Topology, 0x000000ffu, [&graph](VertexId id) -> GraphFile::VertexRecord {
+            return { std::string_view(), graph.X[id] * SaveSpacing, graph.Y[id] * SaveSpacing, 0 };
+        }, error);
+        if (!isSaved) {
+            failed = true;
+            return spec + "\terror=" + error;
+        }
+    }
+
+    return describe(spec, graph.Topology, options);
+}
+
+const std::vector<Batch::Invariant>& Batch::invariants(void) {
+    // Files are already spread over every core, so each invariant runs single threaded.
+    static const std::vector<Invariant> table = {
+        { "vertices", [](const AdjacencyStore& topology) {
+            return std::to_string(topology.GetVertexCount());
+        } },
+        { "edges", [](const AdjacencyStore& topology) {
+            return std::to_string(topology.GetEdgeCount());
+        } },
+        { "components", [](const AdjacencyStore& topology) {
+            return std::to_string(topology.GetComponentCount());
+        } },
+        { "bipartite", [](const AdjacencyStore& topology) {
+            BipartiteResult result = Bipartite::Check(topology);
+            return result.IsBipartite ? std::string("yes") : "no(odd_cycle=" + std::to_string(result.OddCycle.size()) + ")";
+        } },
+        { "spanning_trees", [](const AdjacencyStore& topology) {
+            return SpanningTrees::Count(topology, 1).ToString();
+        } },
+        { "chromatic_number", [](const AdjacencyStore& topology) {
+            ColoringResult result = Coloring::Exact(topology, 1);
+            return result.IsExact ? std::to_string(result.ColorCount) : "<=" + std::to_string(result.ColorCount);
+        } },
+        { "dsatur_colors", [](const AdjacencyStore& topology) {
+            return std::to_string(Coloring::Dsatur(topology).ColorCount);
+        } },
+        { "algebraic_connectivity", [](const AdjacencyStore& topology) {
+            std::ostringstream value;
+            value << Spectral::Analyze(topology, 1).AlgebraicConnectivity;
+            return value.str();
+        } },
+        { "spectral_radius", [](const AdjacencyStore& topology) {
+            std::ostringstream value;
+            value << Spectral::Analyze(topology, 1).SpectralRadius;
+            return value.str();
+        } },
+        { "canonical_hash", [](const AdjacencyStore& topology) {
+            // Many identical pieces in one component can search for minutes, a batch run gives up instead.
+            JobControl control;
+            control.SetDeadline(std::chrono::steady_clock::now() + CanonicalTimeLimit);
+            CanonicalForm form = Canonical::Label(topology, &control);
+            return form.IsExact ? form.Hash.ToString() : std::string("too_symmetric");
+        } },
+        { "triangles", [](const AdjacencyStore& topology) {
+            BitAdjacency adjacency;
+            return adjacency.Assign(topology) ? std::to_string(Cliques::Triangles(adjacency, 1).Total) : std::string("too_large");
+        } },
+        { "clique_number", [](const AdjacencyStore& topology) {
+            BitAdjacency adjacency;
+            return adjacency.Assign(topology) ? std::to_string(Cliques::Maximum(adjacency, 1).Vertices.size()) : std::string("too_large");
+        } },
+    };
+
+    return table;
+}
+
+bool Batch::parseArguments(int argc, char **argv, Options& options) {
+    options.IsDirected = false;
+    options.Seed = 1;
+    options.Threads = 0;
+
+    std::string requested = "vertices,edges,bipartite,spanning_trees";
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--directed") {
+            options.IsDirected = true;
+        } else if (argument == "--generate" && i + 1 < argc) {
+            std::vector<double> values;
+            std::string error;
+            if (!Generators::Parse(argv[++i], values, error)) {
+                std::cerr << "Bad generator " << argv[i] << ": " << error << std::endl;
+                return false;
+            }
+            options.Generate.push_back(argv[i]);
+        } else if (argument == "--invariants" && i + 1 < argc) {
+            requested = argv[++i];
+        } else if (argument == "--output" && i + 1 < argc) {
+            options.OutputPath = argv[++i];
+        } else if (argument == "--save" && i + 1 < argc) {
+            options.SaveDirectory = argv[++i];
+        } else if (argument == "--seed" && i + 1 < argc) {
+            options.Seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (argument == "--threads" && i + 1 < argc) {
+            options.Threads = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!argument.empty() && argument[0] != '-' && options.Directory.empty()) {
+            options.Directory = argument;
+        } else {
+            std::cerr << "Unknown argument: " << argument << std::endl;
+            return false;
+        }
+    }
+
+    // Resolve the comma separated invariant names.
+    std::size_t start = 0;
+    while (start <= requested.size()) {
+        std::size_t comma = std::min(requested.find(',', start), requested.size());
+        std::string name = requested.substr(start, comma - start);
+        start = comma + 1;
+        if (name.empty()) {
+            continue;
+        }
+
+        const Invariant* found = nullptr;
+        for (const Invariant& invariant : invariants()) {
+            if (name == invariant.Name) {
+                found = &invariant;
+            }
+        }
+        if (!found) {
+            std::cerr << "Unknown invariant: " << name << std::endl;
+            return false;
+        }
+        options.Invariants.push_back(found);
+    }
+
+    return !options.Directory.empty() || !options.Generate.empty();
+}
+
+void Batch::printUsage(void) {
+    std::cerr << "Usage: notepad-batch [<directory>] [options]\n"
+              << "  Reads every edge list file in <directory>, then makes every generated graph, and prints one line of\n"
+              << "  invariants per graph.\n"
+              << "  --invariants a,b,c  Invariants to compute, default vertices,edges,bipartite,spanning_trees.\n"
+              << "  --directed          Read the edges as directed.\n"
+              << "  --threads N         Worker threads, default one per core.\n"
+              << "  --output FILE       Write the results to FILE instead of standard output.\n"
+              << "  --generate SPEC     Also analyse a generated graph, SPEC is family[:name=value,...], repeatable.\n"
+              << "  --seed N            Seed of the random generators, default 1.\n"
+              << "  --save DIR          Save every generated graph to DIR as a graph file named after its SPEC.\n"
+              << "  Known invariants:";
+    for (const Invariant& invariant : invariants()) {
+        std::cerr << ' ' << invariant.Name;
+    }
+    std::cerr << "\n  Generator families:";
+    for (const Generators::Family& family : Generators::GetFamilies()) {
+        std::cerr << ' ' << family.Name << '(';
+        for (std::size_t i = 0; i < family.Parameters.size(); i++) {
+            std::cerr << (i == 0 ? "" : ",") << family.Parameters[i].Name << '=' << family.Parameters[i].Default;
+        }
+        std::cerr << ')';
+    }
+    std::cerr << std::endl;
+}
@@ -0,0 +1,637 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "pch.hpp"
+#include "Bench.hpp"
+#include "Canonical.hpp"
+#include "Cliques.hpp"
+#include "Profiler.hpp"
+
+#include <chrono>
+
+int Bench::Run(int argc, char **argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    std::ofstream outputFile;
+    if (!options.OutputPath.empty()) {
+        outputFile.open(options.OutputPath);
+        if (!outputFile) {
+            std::cerr << "Cannot write " << options.OutputPath << std::endl;
+            return 2;
+        }
+    }
+
+    // Rendering needs a GL context, without one the render benchmark is left out.
+    sf::RenderTexture target;
+    const bool isRendering = std::any_of(options.Benchmarks.begin(), options.Benchmarks.end(), [](const Benchmark* benchmark) {
+        return std::string_view(benchmark->Name) == "Render";
+    });
+    if (isRendering) {
+        if (target.resize({ TargetWidth, TargetHeight })) {
+            m_target = &target;
+        } else {
+            std::cerr << "Cannot create an offscreen render target, skipping Render." << std::endl;
+        }
+    }
+
+    std::vector<Measurement> results;
+    for (std::size_t f = 0; f < options.Families.size(); f++) {
+        const Family& family = *options.Families[f];
+
+        // The vertex count and time of the last sample of every operation, to predict the next size.
+        std::vector<std::vector<std::pair<double, double>>> history(options.Benchmarks.size());
+        for (std::size_t n = 10; n <= options.MaxVertices; n *= 10) {
+            if (family.EdgeCount(static_cast<double>(n)) > static_cast<double>(options.MaxEdges)) {
+                std::cerr << family.Name << ": stopping before " << n << " vertices, more than " << options.MaxEdges << " edges" << std::endl;
+                break;
+            }
+            std::mt19937_64 random(options.Seed ^ (n * 0x9E3779B97F4A7C15ull) ^ f);
+            const Instance instance = family.Build(n, random);
+
+            for (std::size_t b = 0; b < options.Benchmarks.size(); b++) {
+                const Benchmark& benchmark = *options.Benchmarks[b];
+
+                // Assume at least linear growth from the last two sizes, and skip sizes that would run too long.
+                std::vector<std::pair<double, double>>& points = history[b];
+                if (!points.empty()) {
+                    double exponent = 1.0;
+                    if (points.size() >= 2) {
+                        const auto& [n1, t1] = points[points.size() - 2];
+                        const auto& [n2, t2] = points.back();
+                        exponent = std::max(exponent, std::log(t2 / t1) / std::log(n2 / n1));
+                    }
+                    const double predicted = points.back().second * std::pow(static_cast<double>(instance.Positions.size()) / points.back().first, exponent);
+                    if (predicted > options.MaxSeconds * 1e9) {
+                        continue;
+                    }
+                }
+
+                // Small sizes are repeated until the time adds up, so the clock resolution does not matter.
+                Sample total = { 0.0, 0, 0 };
+                Sample last = { 0.0, 0, 0 };
+                std::size_t samples = 0;
+                while (samples < MaxSamples && (samples == 0 || total.Nanoseconds < MinSeconds * 1e9)) {
+                    last = benchmark.Run(instance, random);
+                    if (last.Operations == 0) {
+                        break;
+                    }
+                    total.Nanoseconds += last.Nanoseconds;
+                    total.Bytes += last.Bytes;
+                    total.Operations += last.Operations;
+                    samples++;
+                }
+                if (total.Operations == 0) {
+                    continue;
+                }
+                points.emplace_back(static_cast<double>(instance.Positions.size()), std::max(last.Nanoseconds, 1.0));
+
+                Measurement measurement = {
+                    benchmark.Name, family.Name, instance.Positions.size(), instance.Edges.size(), total.Operations,
+                    total.Nanoseconds / static_cast<double>(total.Operations), static_cast<double>(total.Bytes) / static_cast<double>(total.Operations)
+                };
+                std::cerr << measurement.Benchmark << ' ' << measurement.Family << ' ' << measurement.Vertices << ": " << measurement.NsPerOp << " ns/op, " << measurement.BytesPerOp << " B/op" << std::endl;
+                results.push_back(std::move(measurement));
+            }
+        }
+    }
+    m_target = nullptr;
+
+    std::ostream& output = options.OutputPath.empty() ? std::cout : outputFile;
+    writeJson(output, results, options);
+    output.flush();
+
+    if (options.BaselinePath.empty()) {
+        return 0;
+    }
+    std::size_t regressions = 0;
+    if (!compare(results, options, regressions)) {
+        return 2;
+    }
+
+    return regressions > 0 ? 1 : 0;
+}
+
+void Bench::addCycles(Instance& instance, std::size_t length) {
+    // A cycle of length 2 is a single edge, the vertices left over stay isolated.
+    const std::size_t vertices = instance.Positions.size();
+    for (std::size_t first = 0; first + length <= vertices; first += length) {
+        for (std::size_t i = 0; i + 1 < length; i++) {
+            instance.Edges.emplace_back(static_cast<VertexId>(first + i), static_cast<VertexId>(first + i + 1));
+        }
+        if (length > 2) {
+            instance.Edges.emplace_back(static_cast<VertexId>(first + length - 1), static_cast<VertexId>(first));
+        }
+    }
+}
+
+const std::vector<Bench::Benchmark>& Bench::benchmarks(void) {
+    // Graphs are built before the clock starts, only the operation itself is timed.
+    static const std::vector<Benchmark> table = {
+        { "AddVertex", [](const Instance& instance, std::mt19937_64&) {
+            std::vector<std::string> names;
+            names.reserve(instance.Positions.size());
+            for (std::size_t i = 0; i < instance.Positions.size(); i++) {
+                names.push_back(std::to_string(i));
+            }
+            Graph graph;
+            return measure(instance.Positions.size(), [&]() {
+                for (std::size_t i = 0; i < instance.Positions.size(); i++) {
+                    graph.AddVertex(std::move(names[i]), instance.Positions[i]);
+                }
+            });
+        } },
+        { "AddEdge", [](const Instance& instance, std::mt19937_64&) {
+            Graph graph;
+            build(graph, instance, false);
+            return measure(instance.Edges.size(), [&]() {
+                for (const auto& [v1, v2] : instance.Edges) {
+                    graph.AddEdge(v1, v2, 1.0f);
+                }
+            });
+        } },
+        { "RemoveVertex", [](const Instance& instance, std::mt19937_64& random) {
+            Graph graph;
+            build(graph, instance, true);
+            std::vector<VertexId> victims;
+            const std::size_t n = instance.Positions.size();
+            for (std::size_t i = 0; i < std::min(n, Removals); i++) {
+                victims.push_back(static_cast<VertexId>(random() % (n - i)));
+            }
+            return measure(victims.size(), [&]() {
+                for (VertexId id : victims) {
+                    graph.RemoveVertex(id);
+                }
+            });
+        } },
+        { "GetVertexAt", [](const Instance& instance, std::mt19937_64& random) {
+            Graph graph;
+            build(graph, instance, false);
+
+            // Half the queries hit a vertex, half land anywhere in the bounds.
+            std::vector<sf::Vector2f> queries;
+            std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+            for (std::size_t i = 0; i < Queries; i++) {
+                if (i % 2 == 0) {
+                    queries.push_back(instance.Positions[random() % instance.Positions.size()]);
+                } else {
+                    queries.push_back(instance.Bounds.position + sf::Vector2f(unit(random) * instance.Bounds.size.x, unit(random) * instance.Bounds.size.y));
+                }
+            }
+            return measure(queries.size(), [&]() {
+                for (sf::Vector2f query : queries) {
+                    graph.GetVertexAt(query);
+                }
+            });
+        } },
+        { "CalculateBipartite", [](const Instance& instance, std::mt19937_64&) {
+            Graph graph;
+            build(graph, instance, true);
+            return measure(1, [&]() {
+                graph.CalculateBipartite();
+            });
+        } },
+        { "CalculateNumberOfSpanningTrees", [](const Instance& instance, std::mt19937_64&) {
+            Graph graph;
+            build(graph, instance, true);
+            return measure(1, [&]() {
+                graph.CalculateNumberOfSpanningTrees();
+            });
+        } },
+        { "CountTriangles", [](const Instance& instance, std::mt19937_64&) {
+            Graph graph;
+            build(graph, instance, true);
+            return measure(1, [&]() {
+                BitAdjacency adjacency;
+                adjacency.Assign(graph.GetTopology());
+                Cliques::Triangles(adjacency, 1);
+            });
+        } },
+        { "CountTrianglesMatrix", [](const Instance& instance, std::mt19937_64&) {
+            // The same count over the float matrix, the baseline the bitset kernels are measured against.
+            Graph graph;
+            build(graph, instance, true);
+            return measure(1, [&]() {
+                const std::vector<std::vector<float>> matrix = graph.GetAdjacencyMatrix();
+                std::uint64_t triangles = 0;
+                for (std::size_t a = 0; a < matrix.size(); a++) {
+                    for (std::size_t b = a + 1; b < matrix.size(); b++) {
+                        if (matrix[a][b] == 0.0f) {
+                            continue;
+                        }
+                        for (std::size_t c = b + 1; c < matrix.size(); c++) {
+                            triangles += matrix[a][c] != 0.0f && matrix[b][c] != 0.0f;
+                        }
+                    }
+                }
+                volatile std::uint64_t sink = triangles;
+                (void)sink;
+            });
+        } },
+        { "CanonicalLabel", [](const Instance& instance, std::mt19937_64&) {
+            Graph graph;
+            build(graph, instance, true);
+            return measure(1, [&]() {
+                Canonical::Label(graph.GetTopology());
+            });
+        } },
+        { "Render", [](const Instance& instance, std::mt19937_64&) {
+            if (!m_target) {
+                return Sample{ 0.0, 0, 0 };
+            }
+            Graph graph;
+            build(graph, instance, true);
+
+            // The whole graph in view, the first frame uploads the batches and is not timed.
+            const sf::Vector2u size = m_target->getSize();
+            const float pixelSize = std::max({ instance.Bounds.size.x / static_cast<float>(size.x), instance.Bounds.size.y / static_cast<float>(size.y), 1e-3f });
+            const sf::FloatRect visible(instance.Bounds.position, sf::Vector2f(pixelSize * static_cast<float>(size.x), pixelSize * static_cast<float>(size.y)));
+            m_target->setView(sf::View(visible));
+            auto frame = [&]() {
+                m_target->clear(sf::Color::White);
+                graph.Draw(m_target, visible, pixelSize);
+                m_target->display();
+            };
+            frame();
+            return measure(Frames, [&]() {
+                for (std::size_t i = 0; i < Frames; i++) {
+                    frame();
+                }
+            });
+        } },
+    };
+
+    return table;
+}
+
+void Bench::build(Graph& graph, const Instance& instance, bool withEdges) {
+    for (std::size_t i = 0; i < instance.Positions.size(); i++) {
+        graph.AddVertex(std::to_string(i), instance.Positions[i]);
+    }
+    if (withEdges) {
+        for (const auto& [v1, v2] : instance.Edges) {
+            graph.AddEdge(v1, v2, 1.0f);
+        }
+    }
+}
+
+bool Bench::compare(const std::vector<Measurement>& results, const Options& options, std::size_t& regressions) {
+    std::ifstream file(options.BaselinePath);
+    if (!file) {
+        std::cerr << "Cannot read baseline " << options.BaselinePath << std::endl;
+        return false;
+    }
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // Every result is a flat object in the "results" array, keyed by operation, family and size.
+    std::unordered_map<std::string, double> baseline;
+    std::size_t cursor = text.find("\"results\"");
+    if (cursor == std::string::npos) {
+        std::cerr << "Baseline " << options.BaselinePath << " has no results" << std::endl;
+        return false;
+    }
+    const std::size_t end = text.find(']', cursor);
+    while ((cursor = text.find('{', cursor)) < end) {
+        const std::size_t close = text.find('}', cursor);
+        std::string_view object(text.data() + cursor, close - cursor);
+        cursor = close;
+        std::string key = std::string(field(object, "benchmark")) + '/' + std::string(field(object, "family")) + '/' + std::string(field(object, "vertices"));
+        std::string_view value = field(object, "ns_per_op");
+        double nsPerOp = 0.0;
+        if (std::from_chars(value.data(), value.data() + value.size(), nsPerOp).ec == std::errc()) {
+            baseline[key] = nsPerOp;
+        }
+    }
+
+    regressions = 0;
+    for (const Measurement& measurement : results) {
+        auto found = baseline.find(measurement.Benchmark + '/' + measurement.Family + '/' + std::to_string(measurement.Vertices));
+        if (found == baseline.end() || measurement.NsPerOp <= found->second * (1.0 + options.Tolerance)) {
+            continue;
+        }
+        std::cerr << "Regression: " << measurement.Benchmark << " on " << measurement.Family << " with " << measurement.Vertices << " vertices, "
+                  << measurement.NsPerOp << " ns/op against " << found->second << " ns/op in the baseline" << std::endl;
+        regressions++;
+    }
+
+    return true;
+}
+
+const std::vector<Bench::Family>& Bench::families(void) {
+    static const std::vector<Family> table = {
+        { "path", [](std::size_t vertices, std::mt19937_64&) {
+            Instance instance;
+            layOut(instance, vertices);
+            for (std::size_t i = 1; i < vertices; i++) {
+                instance.Edges.emplace_back(static_cast<VertexId>(i - 1), static_cast<VertexId>(i));
+            }
+            return instance;
+        }, [](double n) { return n - 1.0; } },
+        { "grid", [](std::size_t vertices, std::mt19937_64&) {
+            // The nearest square, the same layout as every other family so each vertex joins its neighbours.
+            const std::size_t side = std::max<std::size_t>(2, static_cast<std::size_t>(std::lround(std::sqrt(static_cast<double>(vertices)))));
+            Instance instance;
+            layOut(instance, side * side);
+            for (std::size_t row = 0; row < side; row++) {
+                for (std::size_t column = 0; column < side; column++) {
+                    const VertexId v = static_cast<VertexId>(row * side + column);
+                    if (column + 1 < side) {
+                        instance.Edges.emplace_back(v, v + 1);
+                    }
+                    if (row + 1 < side) {
+                        instance.Edges.emplace_back(v, static_cast<VertexId>(v + side));
+                    }
+                }
+            }
+            return instance;
+        }, [](double n) { return 2.0 * n; } },
+        { "complete", [](std::size_t vertices, std::mt19937_64&) {
+            Instance instance;
+            layOut(instance, vertices);
+            for (std::size_t i = 0; i < vertices; i++) {
+                for (std::size_t j = i + 1; j < vertices; j++) {
+                    instance.Edges.emplace_back(static_cast<VertexId>(i), static_cast<VertexId>(j));
+                }
+            }
+            return instance;
+        }, [](double n) { return n * (n - 1.0) / 2.0; } },
+        { "sparse", [](std::size_t vertices, std::mt19937_64& random) {
+            // Average degree 4, placed at random so edges cross the whole area.
+            Instance instance;
+            layOut(instance, vertices);
+            std::shuffle(instance.Positions.begin(), instance.Positions.end(), random);
+            const std::size_t edges = std::min(2 * vertices, vertices * (vertices - 1) / 2);
+            std::unordered_set<std::uint64_t> seen;
+            while (instance.Edges.size() < edges) {
+                VertexId v1 = static_cast<VertexId>(random() % vertices);
+                VertexId v2 = static_cast<VertexId>(random() % vertices);
+                if (v1 == v2 || !seen.insert((static_cast<std::uint64_t>(std::min(v1, v2)) << 32) | std::max(v1, v2)).second) {
+                    continue;
+                }
+                instance.Edges.emplace_back(v1, v2);
+            }
+            return instance;
+        }, [](double n) { return 2.0 * n; } },
+        { "dense", [](std::size_t vertices, std::mt19937_64& random) {
+            // Every edge with probability one half.
+            Instance instance;
+            layOut(instance, vertices);
+            std::shuffle(instance.Positions.begin(), instance.Positions.end(), random);
+            for (std::size_t i = 0; i < vertices; i++) {
+                for (std::size_t j = i + 1; j < vertices; j++) {
+                    if (random() & 1) {
+                        instance.Edges.emplace_back(static_cast<VertexId>(i), static_cast<VertexId>(j));
+                    }
+                }
+            }
+            return instance;
+        }, [](double n) { return n * (n - 1.0) / 4.0; } },
+        { "matching", [](std::size_t vertices, std::mt19937_64&) {
+            // Disjoint edges, and the cycles below, are many copies of one component for the canonical labelling.
+            Instance instance;
+            layOut(instance, vertices);
+            addCycles(instance, 2);
+            return instance;
+        }, [](double n) { return n / 2.0; } },
+        { "triangles", [](std::size_t vertices, std::mt19937_64&) {
+            Instance instance;
+            layOut(instance, vertices);
+            addCycles(instance, 3);
+            return instance;
+        }, [](double n) { return n; } },
+        { "pentagons", [](std::size_t vertices, std::mt19937_64&) {
+            Instance instance;
+            layOut(instance, vertices);
+            addCycles(instance, 5);
+            return instance;
+        }, [](double n) { return n; } },
+        { "forest", [](std::size_t vertices, std::mt19937_64& random) {
+            // G(n, m) with m = n / 2, below the giant component, so mostly small trees and isolated vertices.
+            Instance instance;
+            layOut(instance, vertices);
+            std::shuffle(instance.Positions.begin(), instance.Positions.end(), random);
+            const std::size_t edges = vertices / 2;
+            std::unordered_set<std::uint64_t> seen;
+            while (instance.Edges.size() < edges) {
+                VertexId v1 = static_cast<VertexId>(random() % vertices);
+                VertexId v2 = static_cast<VertexId>(random() % vertices);
+                if (v1 == v2 || !seen.insert((static_cast<std::uint64_t>(std::min(v1, v2)) << 32) | std::max(v1, v2)).second) {
+                    continue;
+                }
+                instance.Edges.emplace_back(v1, v2);
+            }
+            return instance;
+        }, [](double n) { return n / 2.0; } },
+    };
+
+    return table;
+}
+
+std::string_view Bench::field(std::string_view object, std::string_view key) {
+    std::string quoted = "\"" + std::string(key) + "\"";
+    std::size_t position = object.find(quoted);
+    if (position == std::string_view::npos) {
+        return {};
+    }
+    position = object.find(':', position + quoted.size());
+    if (position == std::string_view::npos) {
+        return {};
+    }
+    position = object.find_first_not_of(" \t\r\n", position + 1);
+    if (position == std::string_view::npos) {
+        return {};
+    }
+    if (object[position] == '"') {
+        const std::size_t close = object.find('"', position + 1);
+        return close == std::string_view::npos ? std::string_view() : object.substr(position + 1, close - position - 1);
+    }
+    const std::size_t close = object.find_first_of(",} \t\r\n", position);
+    return object.substr(position, close == std::string_view::npos ? std::string_view::npos : close - position);
+}
+
+double Bench::fitExponent(const std::vector<Measurement>& results, const std::string& benchmark, const std::string& family) {
+    // Least squares on log(ns/op) against log(vertices).
+    double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+    std::size_t count = 0;
+    for (const Measurement& measurement : results) {
+        if (measurement.Benchmark != benchmark || measurement.Family != family || measurement.NsPerOp <= 0.0) {
+            continue;
+        }
+        const double x = std::log(static_cast<double>(measurement.Vertices));
+        const double y = std::log(measurement.NsPerOp);
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+        count++;
+    }
+    const double denominator = static_cast<double>(count) * sumXX - sumX * sumX;
+    if (count < 2 || denominator <= 0.0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    return (static_cast<double>(count) * sumXY - sumX * sumY) / denominator;
+}
+
+void Bench::layOut(Instance& instance, std::size_t vertices) {
+    const std::size_t side = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(vertices)))));
+    instance.Positions.clear();
+    instance.Positions.reserve(vertices);
+    for (std::size_t i = 0; i < vertices; i++) {
+        instance.Positions.emplace_back(static_cast<float>(i % side) * Spacing, static_cast<float>(i / side) * Spacing);
+    }
+    const std::size_t rows = (vertices + side - 1) / side;
+    instance.Bounds = sf::FloatRect({ 0.0f, 0.0f }, { static_cast<float>(side - 1) * Spacing, static_cast<float>(rows > 0 ? rows - 1 : 0) * Spacing });
+}
+
+Bench::Sample Bench::measure(std::size_t operations, const std::function<void()>& body) {
+    std::uint64_t allocations = 0;
+    std::uint64_t bytesBefore = 0;
+    std::uint64_t bytesAfter = 0;
+    Profiler::GetAllocationTotals(allocations, bytesBefore);
+    const auto start = std::chrono::steady_clock::now();
+    body();
+    const auto end = std::chrono::steady_clock::now();
+    Profiler::GetAllocationTotals(allocations, bytesAfter);
+
+    return { std::chrono::duration<double, std::nano>(end - start).count(), bytesAfter - bytesBefore, operations };
+}
+
+bool Bench::parseArguments(int argc, char **argv, Options& options) {
+    options.MaxEdges = 4000000;
+    options.MaxVertices = 1000000;
+    options.MaxSeconds = 2.0;
+    options.Seed = 1;
+    options.Tolerance = 0.2;
+
+    std::string requestedBenchmarks;
+    std::string requestedFamilies;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--baseline" && i + 1 < argc) {
+            options.BaselinePath = argv[++i];
+        } else if (argument == "--benchmarks" && i + 1 < argc) {
+            requestedBenchmarks = argv[++i];
+        } else if (argument == "--families" && i + 1 < argc) {
+            requestedFamilies = argv[++i];
+        } else if (argument == "--max-edges" && i + 1 < argc) {
+            options.MaxEdges = std::strtoull(argv[++i], nullptr, 10);
+        } else if (argument == "--max-seconds" && i + 1 < argc) {
+            options.MaxSeconds = std::strtod(argv[++i], nullptr);
+        } else if (argument == "--max-vertices" && i + 1 < argc) {
+            options.MaxVertices = std::strtoull(argv[++i], nullptr, 10);
+        } else if (argument == "--output" && i + 1 < argc) {
+            options.OutputPath = argv[++i];
+        } else if (argument == "--seed" && i + 1 < argc) {
+            options.Seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (argument == "--tolerance" && i + 1 < argc) {
+            options.Tolerance = std::strtod(argv[++i], nullptr);
+        } else {
+            std::cerr << "Unknown argument: " << argument << std::endl;
+            return false;
+        }
+    }
+
+    // Everything unless a list narrows it down.
+    if (requestedBenchmarks.empty()) {
+        for (const Benchmark& benchmark : benchmarks()) {
+            options.Benchmarks.push_back(&benchmark);
+        }
+    } else if (!resolve(requestedBenchmarks, benchmarks(), options.Benchmarks)) {
+        return false;
+    }
+    if (requestedFamilies.empty()) {
+        for (const Family& family : families()) {
+            options.Families.push_back(&family);
+        }
+    } else if (!resolve(requestedFamilies, families(), options.Families)) {
+        return false;
+    }
+
+    return true;
+}
+
+void Bench::printUsage(void) {
+    std::cerr << "Usage: notepad-bench [options]\n"
+              << "  Times Graph operations on families of graphs from 10 vertices up, growing tenfold, and writes JSON.\n"
+              << "  --benchmarks a,b,c  Operations to time, default all.\n"
+              << "  --families a,b,c    Families to time them on, default all.\n"
+              << "  --max-vertices N    Largest size, default 1000000.\n"
+              << "  --max-edges N       Skip sizes with more edges, default 4000000.\n"
+              << "  --max-seconds S     Skip sizes predicted to take longer per sample, default 2.\n"
+              << "  --seed N            Seed of the random families, default 1.\n"
+              << "  --output FILE       Write the JSON to FILE instead of standard output.\n"
+              << "  --baseline FILE     Fail if an operation is slower than in FILE, an earlier output.\n"
+              << "  --tolerance F       The fraction an operation may slow down by, default 0.2.\n"
+              << "  Known operations:";
+    for (const Benchmark& benchmark : benchmarks()) {
+        std::cerr << ' ' << benchmark.Name;
+    }
+    std::cerr << "\n  Known families:";
+    for (const Family& family : families()) {
+        std::cerr << ' ' << family.Name;
+    }
+    std::cerr << std::endl;
+}
+
+template <typename T>
+bool Bench::resolve(const std::string& list, const std::vector<T>& table, std::vector<const T*>& chosen) {
+    std::size_t start = 0;
+    while (start <= list.size()) {
+        std::size_t comma = std::min(list.find(',', start), list.size());
+        std::string name = list.substr(start, comma - start);
+        start = comma + 1;
+        if (name.empty()) {
+            continue;
+        }
+
+        const T* found = nullptr;
+        for (const T& entry : table) {
+            if (name == entry.Name) {
+                found = &entry;
+            }
+        }
+        if (!found) {
+            std::cerr << "Unknown name: " << name << std::endl;
+            return false;
+        }
+        chosen.push_back(found);
+    }
+
+    return true;
+}
+
+void Bench::writeJson(std::ostream& output, const std::vector<Measurement>& results, const Options& options) {
+    output << "{\n  \"seed\": " << options.Seed << ",\n  \"results\": [";
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const Measurement& measurement = results[i];
+        output << (i == 0 ? "\n" : ",\n")
+               << "    {\"benchmark\": \"" << measurement.Benchmark << "\", \"family\": \"" << measurement.Family
+               << "\", \"vertices\": " << measurement.Vertices << ", \"edges\": " << measurement.Edges
+               << ", \"operations\": " << measurement.Operations << ", \"ns_per_op\": " << measurement.NsPerOp
+               << ", \"bytes_per_op\": " << measurement.BytesPerOp << "}";
+    }
+
+    // One exponent per operation and family measured at two sizes or more.
+    output << "\n  ],\n  \"exponents\": [";
+    bool isFirst = true;
+    for (const Benchmark* benchmark : options.Benchmarks) {
+        for (const Family* family : options.Families) {
+            const double exponent = fitExponent(results, benchmark->Name, family->Name);
+            if (std::isnan(exponent)) {
+                continue;
+            }
+            output << (isFirst ? "\n" : ",\n")
+                   << "    {\"benchmark\": \"" << benchmark->Name << "\", \"family\": \"" << family->Name << "\", \"exponent\": " << exponent << "}";
+            isFirst = false;
+        }
+    }
+    output << "\n  ]\n}\n";
+}
+
+sf::RenderTexture* Bench::m_target = nullptr;
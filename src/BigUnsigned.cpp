@@ -0,0 +1,108 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "BigUnsigned.hpp"
+
+BigUnsigned::BigUnsigned(std::uint64_t value) {
+    while (value > 0) {
+        m_limbs.push_back(static_cast<std::uint32_t>(value));
+        value >>= 32;
+    }
+}
+
+void BigUnsigned::AddSmall(std::uint32_t value) {
+    std::uint64_t carry = value;
+    for (std::size_t i = 0; i < m_limbs.size() && carry > 0; i++) {
+        std::uint64_t sum = static_cast<std::uint64_t>(m_limbs[i]) + carry;
+        m_limbs[i] = static_cast<std::uint32_t>(sum);
+        carry = sum >> 32;
+    }
+
+    if (carry > 0) {
+        m_limbs.push_back(static_cast<std::uint32_t>(carry));
+    }
+}
+
+std::size_t BigUnsigned::BitLength(void) const {
+    if (m_limbs.empty()) {
+        return 0;
+    }
+
+    return (m_limbs.size() - 1) * 32 + std::bit_width(m_limbs.back());
+}
+
+bool BigUnsigned::IsZero(void) const {
+    return m_limbs.empty();
+}
+
+void BigUnsigned::MulSmall(std::uint32_t value) {
+    std::uint64_t carry = 0;
+    for (std::uint32_t& limb : m_limbs) {
+        std::uint64_t product = static_cast<std::uint64_t>(limb) * value + carry;
+        limb = static_cast<std::uint32_t>(product);
+        carry = product >> 32;
+    }
+
+    if (carry > 0) {
+        m_limbs.push_back(static_cast<std::uint32_t>(carry));
+    }
+    trim();
+}
+
+std::uint32_t BigUnsigned::ModSmall(std::uint32_t modulus) const {
+    std::uint64_t remainder = 0;
+    for (std::size_t i = m_limbs.size(); i-- > 0;) {
+        remainder = ((remainder << 32) | m_limbs[i]) % modulus;
+    }
+
+    return static_cast<std::uint32_t>(remainder);
+}
+
+std::string BigUnsigned::ToString(void) const {
+    if (m_limbs.empty()) {
+        return "0";
+    }
+
+    // Peel off nine decimal digits at a time.
+    std::vector<std::uint32_t> limbs = m_limbs;
+    std::vector<std::uint32_t> chunks;
+    while (!limbs.empty()) {
+        std::uint64_t remainder = 0;
+        for (std::size_t i = limbs.size(); i-- > 0;) {
+            std::uint64_t current = (remainder << 32) | limbs[i];
+            limbs[i] = static_cast<std::uint32_t>(current / 1000000000u);
+            remainder = current % 1000000000u;
+        }
+        chunks.push_back(static_cast<std::uint32_t>(remainder));
+        while (!limbs.empty() && limbs.back() == 0) {
+            limbs.pop_back();
+        }
+    }
+
+    // Most significant chunk unpadded, the rest zero padded to nine digits.
+    std::string digits = std::to_string(chunks.back());
+    for (std::size_t i = chunks.size() - 1; i-- > 0;) {
+        std::string chunk = std::to_string(chunks[i]);
+        digits.append(9 - chunk.size(), '0');
+        digits += chunk;
+    }
+
+    return digits;
+}
+
+bool BigUnsigned::operator==(const BigUnsigned& other) const {
+    return m_limbs == other.m_limbs;
+}
+
+void BigUnsigned::trim(void) {
+    while (!m_limbs.empty() && m_limbs.back() == 0) {
+        m_limbs.pop_back();
+    }
+}
+
+std::ostream& operator<<(std::ostream& stream, const BigUnsigned& value) {
+    return stream << value.ToString();
+}
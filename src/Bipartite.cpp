@@ -0,0 +1,165 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "Bipartite.hpp"
+#include "Profiler.hpp"
+
+BipartiteResult Bipartite::Check(const AdjacencyStore& topology, JobControl* control) {
+    PROFILE_ZONE("Bipartite::Check");
+    const AdjacencyStore::CSR& csr = topology.GetSymmetricCSR();
+    const std::size_t n = topology.GetVertexCount();
+    const std::uint32_t unvisited = std::numeric_limits<std::uint32_t>::max();
+
+    BipartiteResult result;
+    result.IsBipartite = true;
+    result.Component.assign(n, unvisited);
+
+    std::vector<std::uint8_t> side(n, 0);
+    std::vector<VertexId> parent(n, InvalidVertexId);
+    std::vector<VertexId> order;
+    order.reserve(n);
+
+    // Scratch space for the exact witness search, only allocated if it is needed.
+    std::vector<std::uint32_t> distance;
+    std::vector<VertexId> searchParent;
+
+    for (VertexId root = 0; root < n; root++) {
+        if (result.Component[root] != unvisited) {
+            continue;
+        }
+        if (control) {
+            if (control->IsCancelled()) {
+                break;
+            }
+            control->SetProgress(static_cast<float>(order.size()) / n);
+        }
+
+        // Breadth first search of the component, alternating sides by level.
+        const std::uint32_t component = static_cast<std::uint32_t>(result.Components.size());
+        const std::size_t start = order.size();
+        order.push_back(root);
+        result.Component[root] = component;
+        parent[root] = root;
+
+        VertexId conflictFirst = InvalidVertexId;
+        VertexId conflictSecond = InvalidVertexId;
+        double steps = 0.0;
+        for (std::size_t head = start; head < order.size(); head++) {
+            VertexId v = order[head];
+            steps += static_cast<double>(csr.Offsets[v + 1] - csr.Offsets[v]);
+            for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+                VertexId u = csr.Entries[e].Target;
+                if (result.Component[u] == unvisited) {
+                    result.Component[u] = component;
+                    side[u] = side[v] ^ 1;
+                    parent[u] = v;
+                    order.push_back(u);
+                } else if (side[u] == side[v] && conflictFirst == InvalidVertexId) {
+                    // Same side means same level, the first such edge found is the shallowest.
+                    conflictFirst = v;
+                    conflictSecond = u;
+                }
+            }
+        }
+
+        BipartiteComponent parts;
+        parts.IsBipartite = conflictFirst == InvalidVertexId;
+        if (parts.IsBipartite) {
+            for (std::size_t i = start; i < order.size(); i++) {
+                (side[order[i]] == 0 ? parts.Left : parts.Right).push_back(order[i]);
+            }
+        } else {
+            result.IsBipartite = false;
+
+            // Small components get the exact shortest odd cycle, large ones keep the linear time witness.
+            std::vector<VertexId> cycle;
+            const double members = static_cast<double>(order.size() - start);
+            if (members * steps <= ExactWitnessBudget) {
+                if (distance.empty()) {
+                    distance.assign(n, unvisited);
+                    searchParent.assign(n, InvalidVertexId);
+                }
+                std::vector<VertexId> memberList(order.begin() + start, order.end());
+                cycle = shortestOddCycle(csr, memberList, distance, searchParent, control);
+            } else {
+                cycle = treeCycle(parent, conflictFirst, conflictSecond);
+            }
+
+            if (result.OddCycle.empty() || cycle.size() < result.OddCycle.size()) {
+                result.OddCycle = std::move(cycle);
+            }
+        }
+        result.Components.push_back(std::move(parts));
+    }
+
+    return result;
+}
+
+std::vector<VertexId> Bipartite::shortestOddCycle(const AdjacencyStore::CSR& csr, const std::vector<VertexId>& members, std::vector<std::uint32_t>& distance, std::vector<VertexId>& parent, const JobControl* control) {
+    const std::uint32_t unvisited = std::numeric_limits<std::uint32_t>::max();
+    std::vector<VertexId> best;
+    std::size_t bestLength = std::numeric_limits<std::size_t>::max();
+    std::vector<VertexId> queue;
+
+    for (VertexId root : members) {
+        if (control && control->IsCancelled()) {
+            break;
+        }
+        queue.assign(1, root);
+        distance[root] = 0;
+        parent[root] = root;
+
+        // A conflict at depth d closes a cycle of at most 2d + 1, stop once that can no longer beat the best.
+        bool found = false;
+        for (std::size_t head = 0; head < queue.size() && !found; head++) {
+            VertexId v = queue[head];
+            if (2 * static_cast<std::size_t>(distance[v]) + 1 >= bestLength) {
+                break;
+            }
+            for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+                VertexId u = csr.Entries[e].Target;
+                if (distance[u] == unvisited) {
+                    distance[u] = distance[v] + 1;
+                    parent[u] = v;
+                    queue.push_back(u);
+                } else if (distance[u] == distance[v]) {
+                    std::vector<VertexId> cycle = treeCycle(parent, v, u);
+                    if (cycle.size() < bestLength) {
+                        bestLength = cycle.size();
+                        best = std::move(cycle);
+                    }
+                    found = true;
+                    break;
+                }
+            }
+        }
+
+        for (VertexId v : queue) {
+            distance[v] = unvisited;
+        }
+    }
+
+    return best;
+}
+
+std::vector<VertexId> Bipartite::treeCycle(const std::vector<VertexId>& parent, VertexId first, VertexId second) {
+    // Both ends are at the same depth, so climbing in lockstep meets at their lowest common ancestor.
+    std::vector<VertexId> cycle = { first };
+    std::vector<VertexId> otherSide = { second };
+    while (first != second) {
+        first = parent[first];
+        second = parent[second];
+        cycle.push_back(first);
+        otherSide.push_back(second);
+    }
+
+    // Come back down the other side, the ancestor is already in the cycle.
+    for (std::size_t i = otherSide.size() - 1; i-- > 0;) {
+        cycle.push_back(otherSide[i]);
+    }
+
+    return cycle;
+}
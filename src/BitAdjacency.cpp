@@ -0,0 +1,167 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "BitAdjacency.hpp"
+#include "Profiler.hpp"
+
+// The vector kernels are compiled for their instruction sets on their own and only called once the processor is
+// known to have them, so the rest of the build keeps its baseline flags.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NOTEPAD_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace {
+    /// @brief A CountAnd() implementation.
+    typedef std::size_t (*CountKernel)(const std::uint64_t*, const std::uint64_t*, std::size_t);
+
+    /**
+     * @brief Count the common bits a word at a time, four accumulators keep the popcounts independent.
+     */
+    std::size_t countAndScalar(const std::uint64_t* first, const std::uint64_t* second, std::size_t words) {
+        std::size_t counts[4] = { 0, 0, 0, 0 };
+        for (std::size_t i = 0; i < words; i += 4) {
+            counts[0] += std::popcount(first[i + 0] & second[i + 0]);
+            counts[1] += std::popcount(first[i + 1] & second[i + 1]);
+            counts[2] += std::popcount(first[i + 2] & second[i + 2]);
+            counts[3] += std::popcount(first[i + 3] & second[i + 3]);
+        }
+
+        return counts[0] + counts[1] + counts[2] + counts[3];
+    }
+
+#ifdef NOTEPAD_X86_KERNELS
+    /**
+     * @brief Count the common bits 256 at a time, looking up the count of every nibble with a byte shuffle.
+     */
+    __attribute__((target("avx2"))) std::size_t countAndAvx2(const std::uint64_t* first, const std::uint64_t* second, std::size_t words) {
+        const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i nibbles = _mm256_set1_epi8(0x0f);
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i total = zero;
+        for (std::size_t i = 0; i < words; i += 4) {
+            const __m256i both = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(second + i)));
+            const __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(both, nibbles));
+            const __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(both, 4), nibbles));
+
+            // Byte counts are at most 8, summing them into the 64 bit lanes right away cannot overflow.
+            total = _mm256_add_epi64(total, _mm256_sad_epu8(_mm256_add_epi8(low, high), zero));
+        }
+
+        return static_cast<std::size_t>(_mm256_extract_epi64(total, 0) + _mm256_extract_epi64(total, 1) + _mm256_extract_epi64(total, 2) + _mm256_extract_epi64(total, 3));
+    }
+
+    /**
+     * @brief Count the common bits 512 at a time with the vector popcount instruction.
+     */
+    __attribute__((target("avx512f,avx512vpopcntdq"))) std::size_t countAndAvx512(const std::uint64_t* first, const std::uint64_t* second, std::size_t words) {
+        __m512i total = _mm512_setzero_si512();
+        for (std::size_t i = 0; i < words; i += 8) {
+            const __m512i both = _mm512_and_si512(_mm512_loadu_si512(first + i), _mm512_loadu_si512(second + i));
+            total = _mm512_add_epi64(total, _mm512_popcnt_epi64(both));
+        }
+
+        // The lanes are summed by hand, GCC 12 warns that the reduce and extract intrinsics read an uninitialised vector.
+        alignas(64) std::uint64_t lanes[8];
+        _mm512_store_si512(lanes, total);
+        return static_cast<std::size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] + lanes[5] + lanes[6] + lanes[7]);
+    }
+#endif
+
+    /**
+     * @brief Pick the fastest kernel the processor runs.
+     * @param name Set to the name of the kernel.
+     * @return The kernel.
+     */
+    CountKernel chooseKernel(const char*& name) {
+#ifdef NOTEPAD_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq")) {
+            name = "AVX-512";
+            return countAndAvx512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            name = "AVX2";
+            return countAndAvx2;
+        }
+#endif
+        name = "scalar";
+        return countAndScalar;
+    }
+
+    /// @brief The name of the kernel picked.
+    const char* kernelName = nullptr;
+
+    /// @brief The kernel picked, once, before main() runs.
+    const CountKernel countKernel = chooseKernel(kernelName);
+}
+
+BitAdjacency::BitAdjacency(void) : m_size(0), m_version(0), m_words(0) {
+}
+
+bool BitAdjacency::Assign(const AdjacencyStore& topology) {
+    PROFILE_ZONE("BitAdjacency::Assign");
+    m_bits.clear();
+    m_size = 0;
+    m_words = 0;
+    m_version = topology.GetVersion();
+    const std::size_t n = topology.GetVertexCount();
+    if (n > VertexLimit) {
+        return false;
+    }
+
+    m_size = n;
+    m_words = (n + BlockWords * 64 - 1) / (BlockWords * 64) * BlockWords;
+    m_bits.assign(n * m_words, 0);
+    const AdjacencyStore::CSR& csr = topology.GetSymmetricCSR();
+    for (VertexId v = 0; v < n; v++) {
+        std::uint64_t* row = &m_bits[v * m_words];
+        for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+            const VertexId u = csr.Entries[e].Target;
+            if (u != v) {
+                row[u / 64] |= std::uint64_t(1) << (u % 64);
+            }
+        }
+    }
+
+    return true;
+}
+
+std::size_t BitAdjacency::CommonNeighbors(VertexId u, VertexId v) const {
+    return CountAnd(GetRow(u), GetRow(v), m_words);
+}
+
+std::size_t BitAdjacency::GetDegree(VertexId v) const {
+    return CountAnd(GetRow(v), GetRow(v), m_words);
+}
+
+const std::uint64_t* BitAdjacency::GetRow(VertexId v) const {
+    return &m_bits[v * m_words];
+}
+
+std::size_t BitAdjacency::GetVertexCount(void) const {
+    return m_size;
+}
+
+std::uint64_t BitAdjacency::GetVersion(void) const {
+    return m_version;
+}
+
+std::size_t BitAdjacency::GetWords(void) const {
+    return m_words;
+}
+
+bool BitAdjacency::HasEdge(VertexId u, VertexId v) const {
+    return (m_bits[u * m_words + v / 64] >> (v % 64)) & 1;
+}
+
+std::size_t BitAdjacency::CountAnd(const std::uint64_t* first, const std::uint64_t* second, std::size_t words) {
+    return countKernel(first, second, words);
+}
+
+const char* BitAdjacency::GetKernelName(void) {
+    return kernelName;
+}
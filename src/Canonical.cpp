@@ -0,0 +1,985 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "Canonical.hpp"
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
+
+#include <numeric>
+
+namespace {
+    /**
+     * @brief The SplitMix64 finaliser, a bijection that spreads every input bit over the output.
+     * @param z The value.
+     * @return The mixed value.
+     */
+    std::uint64_t mix(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * @brief Hash a canonical form, two independent 64 bit lanes over the same words.
+     * @param form The form, its Edges filled in.
+     * @return The hash.
+     */
+    CanonicalHash hashForm(const CanonicalForm& form) {
+        std::uint64_t high = mix(0x243f6a8885a308d3ull ^ form.VertexCount);
+        std::uint64_t low = mix(0x13198a2e03707344ull + form.VertexCount * 0x9e3779b97f4a7c15ull);
+        high = mix(high ^ (form.IsDirected ? 1 : 0));
+        low = mix(low + (form.IsDirected ? 0xa4093822299f31d0ull : 0x082efa98ec4e6c89ull));
+        for (std::uint64_t edge : form.Edges) {
+            high = mix(high ^ edge) + 0x452821e638d01377ull;
+            low = mix(low + edge * 0x9e3779b97f4a7c15ull) ^ 0xbe5466cf34e90c6cull;
+        }
+        CanonicalHash hash;
+        hash.High = mix(high ^ form.Edges.size());
+        hash.Low = mix(low ^ hash.High);
+        return hash;
+    }
+
+    /**
+     * @brief Find where two search paths part.
+     * @param first The first path.
+     * @param second The second path.
+     * @return The first depth they differ at, or the length of the shorter.
+     */
+    std::size_t divergence(const std::vector<VertexId>& first, const std::vector<VertexId>& second) {
+        std::size_t depth = 0;
+        while (depth < first.size() && depth < second.size() && first[depth] == second[depth]) {
+            depth++;
+        }
+        return depth;
+    }
+
+    /**
+     * @brief Find the representative of a vertex's orbit.
+     * @param orbits The union-find parents, missing for roots.
+     * @param v The vertex.
+     * @return The representative.
+     */
+    VertexId findOrbit(std::unordered_map<VertexId, VertexId>& orbits, VertexId v) {
+        for (auto it = orbits.find(v); it != orbits.end(); it = orbits.find(v)) {
+            auto parent = orbits.find(it->second);
+            if (parent != orbits.end()) {
+                it->second = parent->second;
+            }
+            v = it->second;
+        }
+        return v;
+    }
+}
+
+std::string CanonicalHash::ToString(void) const {
+    char text[33];
+    std::snprintf(text, sizeof(text), "%016llx%016llx", static_cast<unsigned long long>(High), static_cast<unsigned long long>(Low));
+    return text;
+}
+
+bool Canonical::IsIsomorphic(const CanonicalForm& first, const CanonicalForm& second) {
+    return first.VertexCount == second.VertexCount && first.IsDirected == second.IsDirected && first.Edges == second.Edges;
+}
+
+CanonicalForm Canonical::Label(const AdjacencyStore& topology, JobControl* control) {
+    PROFILE_ZONE("Canonical::Label");
+    const std::size_t n = topology.GetVertexCount();
+    CanonicalForm form;
+    form.VertexCount = n;
+    form.IsDirected = topology.IsDirected();
+    form.Generators = 0;
+    form.Nodes = 0;
+    form.IsExact = true;
+    if (n == 0) {
+        form.Hash = hashForm(form);
+        return form;
+    }
+
+    // Distinct sorted neighbour lists, and the transposed ones for a directed graph.
+    Search search;
+    search.Size = n;
+    search.IsDirected = form.IsDirected;
+    const AdjacencyStore::CSR& csr = topology.GetCSR();
+    search.OutOffsets.assign(n + 1, 0);
+    search.Out.reserve(csr.Entries.size());
+    for (VertexId v = 0; v < n; v++) {
+        const std::size_t begin = search.Out.size();
+        for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+            search.Out.push_back(csr.Entries[e].Target);
+        }
+        std::sort(search.Out.begin() + begin, search.Out.end());
+        search.Out.erase(std::unique(search.Out.begin() + begin, search.Out.end()), search.Out.end());
+        search.OutOffsets[v + 1] = search.Out.size();
+    }
+    if (search.IsDirected) {
+        search.InOffsets.assign(n + 1, 0);
+        for (VertexId u : search.Out) {
+            search.InOffsets[u + 1]++;
+        }
+        for (std::size_t v = 0; v < n; v++) {
+            search.InOffsets[v + 1] += search.InOffsets[v];
+        }
+        search.In.resize(search.Out.size());
+        std::vector<std::size_t> fill(search.InOffsets.begin(), search.InOffsets.end() - 1);
+        for (VertexId v = 0; v < n; v++) {
+            for (std::size_t e = search.OutOffsets[v]; e < search.OutOffsets[v + 1]; e++) {
+                search.In[fill[search.Out[e]]++] = v;
+            }
+        }
+    }
+
+    if (topology.GetComponentCount() == 1) {
+        form = labelConnected(search, control);
+        form.Hash = hashForm(form);
+        return form;
+    }
+
+    // Every component is labelled on its own, then they take consecutive labels in order of their forms. Isomorphic
+    // components end up side by side with the same edges, so their swaps are automorphisms the search never sees.
+    std::vector<VertexId> componentIndex(n, InvalidVertexId);
+    std::vector<VertexId> componentOf(n);
+    std::vector<std::size_t> memberOffsets(1, 0);
+    for (VertexId v = 0; v < n; v++) {
+        VertexId& index = componentIndex[topology.GetComponent(v)];
+        if (index == InvalidVertexId) {
+            index = static_cast<VertexId>(memberOffsets.size() - 1);
+            memberOffsets.push_back(0);
+        }
+        componentOf[v] = index;
+        memberOffsets[index + 1]++;
+    }
+    const std::size_t components = memberOffsets.size() - 1;
+    for (std::size_t c = 0; c < components; c++) {
+        memberOffsets[c + 1] += memberOffsets[c];
+    }
+    std::vector<VertexId> members(n);
+    std::vector<VertexId> local(n);
+    std::vector<std::size_t> fill(memberOffsets.begin(), memberOffsets.end() - 1);
+    for (VertexId v = 0; v < n; v++) {
+        local[v] = static_cast<VertexId>(fill[componentOf[v]] - memberOffsets[componentOf[v]]);
+        members[fill[componentOf[v]]++] = v;
+    }
+
+    // Members are in increasing id, so the local ids keep every neighbour list sorted.
+    std::vector<CanonicalForm> forms(components);
+    for (std::size_t c = 0; c < components; c++) {
+        auto extract = [&](const std::vector<std::size_t>& offsets, const std::vector<VertexId>& lists, std::vector<std::size_t>& partOffsets, std::vector<VertexId>& partLists) {
+            partOffsets.assign(1, 0);
+            partLists.clear();
+            for (std::size_t i = memberOffsets[c]; i < memberOffsets[c + 1]; i++) {
+                for (std::size_t e = offsets[members[i]]; e < offsets[members[i] + 1]; e++) {
+                    partLists.push_back(local[lists[e]]);
+                }
+                partOffsets.push_back(partLists.size());
+            }
+        };
+        Search part;
+        part.Size = memberOffsets[c + 1] - memberOffsets[c];
+        part.IsDirected = search.IsDirected;
+        extract(search.OutOffsets, search.Out, part.OutOffsets, part.Out);
+        if (search.IsDirected) {
+            extract(search.InOffsets, search.In, part.InOffsets, part.In);
+        }
+        forms[c] = labelConnected(part, control);
+    }
+
+    std::vector<std::size_t> order(components);
+    std::iota(order.begin(), order.end(), 0);
+    auto isBefore = [&forms](std::size_t a, std::size_t b) {
+        return forms[a].VertexCount != forms[b].VertexCount ? forms[a].VertexCount < forms[b].VertexCount : forms[a].Edges < forms[b].Edges;
+    };
+    std::sort(order.begin(), order.end(), isBefore);
+    form.Labels.assign(n, InvalidVertexId);
+    std::uint64_t offset = 0;
+    for (std::size_t i = 0; i < components; i++) {
+        const std::size_t c = order[i];
+        const CanonicalForm& componentForm = forms[c];
+        for (std::size_t j = memberOffsets[c]; j < memberOffsets[c + 1]; j++) {
+            form.Labels[members[j]] = static_cast<VertexId>(offset + componentForm.Labels[j - memberOffsets[c]]);
+        }
+        for (std::uint64_t edge : componentForm.Edges) {
+            form.Edges.push_back(((edge >> 32) + offset) << 32 | ((edge & 0xffffffffull) + offset));
+        }
+        form.Generators += componentForm.Generators + (i > 0 && !isBefore(order[i - 1], c) ? 1 : 0);
+        form.Nodes += componentForm.Nodes;
+        form.IsExact = form.IsExact && componentForm.IsExact;
+        offset += componentForm.VertexCount;
+    }
+    form.Hash = hashForm(form);
+    return form;
+}
+
+std::vector<CanonicalForm> Canonical::LabelAll(const std::vector<std::shared_ptr<const AdjacencyStore>>& graphs, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("Canonical::LabelAll");
+    std::vector<CanonicalForm> forms(graphs.size());
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(std::min(threadCount, std::max<std::size_t>(1, graphs.size())));
+    std::atomic<std::size_t> finished = 0;
+    for (std::size_t i = 0; i < graphs.size(); i++) {
+        pool.Submit([&graphs, &forms, &finished, i, control]() {
+            forms[i] = Label(*graphs[i], control);
+            const std::size_t done = ++finished;
+            if (control) {
+                control->SetProgress(static_cast<float>(done) / graphs.size());
+            }
+        });
+    }
+    pool.Wait();
+    return forms;
+}
+
+void Canonical::contract(Search& search, const std::vector<VertexId>& groupOf, const std::vector<VertexId>& first, const std::vector<std::uint8_t>& kind) {
+    auto merge = [&groupOf, &first, &kind](std::vector<std::size_t>& offsets, std::vector<VertexId>& lists) {
+        std::vector<std::size_t> mergedOffsets(first.size() + 1, 0);
+        std::vector<VertexId> merged;
+        merged.reserve(lists.size());
+        for (VertexId group = 0; group < first.size(); group++) {
+            const std::size_t begin = merged.size();
+            for (std::size_t e = offsets[first[group]]; e < offsets[first[group] + 1]; e++) {
+                // Adjacent twins lose the edges inside their group, a lone vertex keeps its self loop.
+                const VertexId other = groupOf[lists[e]];
+                if (other != InvalidVertexId && (other != group || kind[group] == 0)) {
+                    merged.push_back(other);
+                }
+            }
+            std::sort(merged.begin() + begin, merged.end());
+            merged.erase(std::unique(merged.begin() + begin, merged.end()), merged.end());
+            mergedOffsets[group + 1] = merged.size();
+        }
+        offsets.swap(mergedOffsets);
+        lists.swap(merged);
+    };
+    merge(search.OutOffsets, search.Out);
+    if (search.IsDirected) {
+        merge(search.InOffsets, search.In);
+    }
+    search.Size = first.size();
+}
+
+std::vector<std::uint64_t> Canonical::certificate(const Search& search, const std::vector<std::uint32_t>& position) {
+    std::vector<std::uint64_t> edges;
+    edges.reserve(search.IsDirected ? search.Out.size() : search.Out.size() / 2 + 1);
+    for (VertexId v = 0; v < search.Size; v++) {
+        const std::uint64_t first = position[v];
+        for (std::size_t e = search.OutOffsets[v]; e < search.OutOffsets[v + 1]; e++) {
+            const std::uint64_t second = position[search.Out[e]];
+            if (search.IsDirected || first <= second) {
+                edges.push_back(first << 32 | second);
+            }
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+
+bool Canonical::isAutomorphism(const Search& search, const std::vector<VertexId>& from, const std::vector<std::uint32_t>& fromPosition, std::vector<std::pair<VertexId, VertexId>>& generator) {
+    generator.clear();
+    for (std::size_t position = 0; position < search.Size; position++) {
+        if (from[position] != search.Order[position]) {
+            generator.emplace_back(from[position], search.Order[position]);
+        }
+    }
+
+    // The map sends the edges at moved vertices among themselves and fixes the rest, so those are all to check.
+    auto isMapped = [&search, &from, &fromPosition](const std::vector<std::size_t>& offsets, const std::vector<VertexId>& lists, VertexId v, VertexId image) {
+        if (offsets[v + 1] - offsets[v] != offsets[image + 1] - offsets[image]) {
+            return false;
+        }
+        const auto begin = lists.begin() + offsets[image];
+        const auto end = lists.begin() + offsets[image + 1];
+        for (std::size_t e = offsets[v]; e < offsets[v + 1]; e++) {
+            if (!std::binary_search(begin, end, search.Order[fromPosition[lists[e]]])) {
+                return false;
+            }
+        }
+        return true;
+    };
+    for (const auto& [v, image] : generator) {
+        if (!isMapped(search.OutOffsets, search.Out, v, image) || (search.IsDirected && !isMapped(search.InOffsets, search.In, v, image))) {
+            return false;
+        }
+    }
+    return !generator.empty();
+}
+
+void Canonical::individualize(Search& search, VertexId v) {
+    const std::uint32_t start = search.CellOf[v];
+    const std::uint32_t end = search.CellEnd[start];
+    const std::uint32_t last = end - 1;
+    const VertexId other = search.Order[last];
+    std::swap(search.Order[search.Position[v]], search.Order[last]);
+    search.Position[other] = search.Position[v];
+    search.Position[v] = last;
+    search.CellEnd[start] = last;
+    search.CellEnd[last] = end;
+    search.CellOf[v] = last;
+    search.CellCount++;
+    record(search, Split { start, last, end, mix(0x3c6ef372fe94f82bull ^ (std::uint64_t(start) << 32 | end)) });
+    search.Queue.push_back(last);
+    search.InQueue[last] = 1;
+    refine(search);
+}
+
+CanonicalForm Canonical::labelConnected(Search& search, JobControl* control) {
+    const std::size_t n = search.Size;
+    CanonicalForm form;
+    form.VertexCount = n;
+    form.IsDirected = search.IsDirected;
+    form.Generators = 0;
+    form.Nodes = 0;
+    form.IsExact = true;
+
+    std::vector<std::size_t> graphOffsets = search.OutOffsets;
+    std::vector<VertexId> graph = search.Out;
+
+    // Trees hanging off the graph are peeled into the colours of the core vertices they hang from.
+    std::vector<VertexId> parent;
+    std::vector<std::uint32_t> colour;
+    peel(search, parent, colour);
+    std::vector<VertexId> core;
+    std::vector<VertexId> coreIndex(n, InvalidVertexId);
+    for (VertexId v = 0; v < n; v++) {
+        if (parent[v] == InvalidVertexId) {
+            coreIndex[v] = static_cast<VertexId>(core.size());
+            core.push_back(v);
+        }
+    }
+    const std::size_t k = core.size();
+    std::vector<std::uint32_t> coreColour(k);
+    for (std::size_t i = 0; i < k; i++) {
+        coreColour[i] = colour[core[i]];
+    }
+    if (k < n) {
+        contract(search, coreIndex, core, std::vector<std::uint8_t>(k, 0));
+    }
+
+    // Twins of the core merge into one vertex of the quotient graph the search runs on.
+    std::vector<VertexId> classOf;
+    std::vector<std::uint8_t> kind;
+    const std::size_t q = twins(search, coreColour, classOf, kind);
+    std::vector<std::size_t> memberOffsets(q + 1, 0);
+    for (std::size_t i = 0; i < k; i++) {
+        memberOffsets[classOf[i] + 1]++;
+    }
+    for (std::size_t c = 0; c < q; c++) {
+        memberOffsets[c + 1] += memberOffsets[c];
+    }
+    std::vector<VertexId> members(k);
+    std::vector<std::size_t> fill(memberOffsets.begin(), memberOffsets.end() - 1);
+    for (VertexId i = 0; i < k; i++) {
+        members[fill[classOf[i]]++] = i;
+    }
+    if (q < k) {
+        std::vector<VertexId> first(q);
+        for (std::size_t c = 0; c < q; c++) {
+            first[c] = members[memberOffsets[c]];
+        }
+        contract(search, classOf, first, kind);
+    }
+    if (!search.IsDirected) {
+        search.InOffsets = search.OutOffsets;
+        search.In = search.Out;
+    }
+
+    // The initial partition has a cell per colour, that of the core vertices, the kind of class and its size.
+    std::vector<std::uint64_t> classColour(q);
+    for (std::size_t c = 0; c < q; c++) {
+        classColour[c] = std::uint64_t(coreColour[members[memberOffsets[c]]]) << 34 | std::uint64_t(kind[c]) << 32 | (memberOffsets[c + 1] - memberOffsets[c]);
+    }
+    search.Order.resize(q);
+    std::iota(search.Order.begin(), search.Order.end(), 0);
+    std::stable_sort(search.Order.begin(), search.Order.end(), [&classColour](VertexId a, VertexId b) {
+        return classColour[a] < classColour[b];
+    });
+    search.Position.resize(q);
+    search.CellOf.resize(q);
+    search.CellEnd.assign(q, 0);
+    search.InQueue.assign(q, 0);
+    search.Counts.assign(q, 0);
+    search.CellTouched.assign(q, 0);
+    search.IsFixed.assign(q, 0);
+    search.IsTried.assign(q, 0);
+    search.CellCount = 0;
+    search.Agreed = 0;
+    search.Standing = 0;
+    std::uint32_t cellStart = 0;
+    for (std::uint32_t position = 0; position < q; position++) {
+        const VertexId c = search.Order[position];
+        if (position > 0 && classColour[c] != classColour[search.Order[position - 1]]) {
+            cellStart = position;
+        }
+        search.Position[c] = position;
+        search.CellOf[c] = cellStart;
+        search.CellEnd[cellStart] = position + 1;
+        if (cellStart == position) {
+            search.CellCount++;
+            search.Queue.push_back(position);
+            search.InQueue[position] = 1;
+        }
+    }
+    refine(search);
+    search.Nodes = 1;
+
+    // A helper to find the first cell of two or more vertices from a cell start on, or the end.
+    auto targetCell = [&search](std::uint32_t start) {
+        while (start < search.Size && search.CellEnd[start] - start == 1) {
+            start = search.CellEnd[start];
+        }
+        return start;
+    };
+
+    std::vector<Frame> stack;
+    if (search.CellCount == q) {
+        leaf(search);
+    } else {
+        stack.push_back(Frame { targetCell(0), search.Trail.size(), {}, {}, 0 });
+    }
+    while (!stack.empty()) {
+        // Past the first leaf there is always a labelling to settle for.
+        if (!search.First.empty() && (search.Nodes >= MaxNodes || (control && control->IsCancelled()))) {
+            form.IsExact = false;
+            break;
+        }
+        Frame& frame = stack.back();
+
+        // Automorphisms found since the last child that fix the path to here join the orbits of its children.
+        for (; frame.Applied < search.Generators.size(); frame.Applied++) {
+            const auto& generator = search.Generators[frame.Applied];
+            const bool isFixing = std::none_of(generator.begin(), generator.end(), [&search](const std::pair<VertexId, VertexId>& moved) {
+                return search.IsFixed[moved.first] != 0;
+            });
+            if (isFixing) {
+                for (const auto& [v, image] : generator) {
+                    const VertexId first = findOrbit(frame.Orbits, v);
+                    const VertexId second = findOrbit(frame.Orbits, image);
+                    if (first != second) {
+                        frame.Orbits[std::max(first, second)] = std::min(first, second);
+                    }
+                }
+            }
+        }
+
+        // The first child is whichever vertex starts the cell, in O(1) on the way down. The next one is the smallest
+        // vertex that shares no orbit with one tried, which any order of the children allows.
+        VertexId next = InvalidVertexId;
+        if (frame.Tried.empty()) {
+            next = search.Order[frame.Start];
+        } else {
+            for (VertexId v : frame.Tried) {
+                search.IsTried[findOrbit(frame.Orbits, v)] = 1;
+            }
+            for (std::uint32_t position = frame.Start; position < search.CellEnd[frame.Start]; position++) {
+                const VertexId v = search.Order[position];
+                if (v < next && !search.IsTried[findOrbit(frame.Orbits, v)]) {
+                    next = v;
+                }
+            }
+            for (VertexId v : frame.Tried) {
+                search.IsTried[findOrbit(frame.Orbits, v)] = 0;
+            }
+        }
+        if (next == InvalidVertexId) {
+            stack.pop_back();
+            if (!stack.empty()) {
+                undo(search, stack.back().Mark);
+                search.IsFixed[search.Path.back()] = 0;
+                search.Path.pop_back();
+            }
+            continue;
+        }
+
+        frame.Tried.push_back(next);
+        search.Path.push_back(next);
+        search.IsFixed[next] = 1;
+        individualize(search, next);
+        search.Nodes++;
+        if (search.Standing > 0) {
+            // Every leaf below has a worse trace than the best one, so the child goes no further.
+            undo(search, frame.Mark);
+            search.IsFixed[next] = 0;
+            search.Path.pop_back();
+            continue;
+        }
+        if (search.CellCount < q) {
+            const std::uint32_t start = targetCell(frame.Start);
+            stack.push_back(Frame { start, search.Trail.size(), {}, {}, 0 });
+            continue;
+        }
+
+        // A leaf, back to its parent and from there to wherever an automorphism says the rest is equivalent.
+        const std::size_t depth = std::min(leaf(search), stack.size() - 1);
+        undo(search, frame.Mark);
+        search.IsFixed[next] = 0;
+        search.Path.pop_back();
+        while (stack.size() - 1 > depth) {
+            stack.pop_back();
+            undo(search, stack.back().Mark);
+            search.IsFixed[search.Path.back()] = 0;
+            search.Path.pop_back();
+        }
+    }
+
+    // Every class takes the next labels in the order of the best leaf, its members in any order since they are twins.
+    form.Labels.assign(n, InvalidVertexId);
+    std::vector<VertexId> byLabel(n);
+    VertexId label = 0;
+    for (VertexId c : search.Best) {
+        for (std::size_t i = memberOffsets[c]; i < memberOffsets[c + 1]; i++) {
+            byLabel[label] = core[members[i]];
+            form.Labels[core[members[i]]] = label++;
+        }
+    }
+
+    // Peeled vertices follow breadth first, the children of every vertex by type, ties being isomorphic subtrees.
+    if (k < n) {
+        std::vector<std::size_t> childOffsets(n + 1, 0);
+        for (VertexId v = 0; v < n; v++) {
+            if (parent[v] != InvalidVertexId) {
+                childOffsets[parent[v] + 1]++;
+            }
+        }
+        for (std::size_t v = 0; v < n; v++) {
+            childOffsets[v + 1] += childOffsets[v];
+        }
+        std::vector<VertexId> children(n - k);
+        fill.assign(childOffsets.begin(), childOffsets.end() - 1);
+        for (VertexId v = 0; v < n; v++) {
+            if (parent[v] != InvalidVertexId) {
+                children[fill[parent[v]]++] = v;
+            }
+        }
+        for (std::size_t head = 0; head < label; head++) {
+            const VertexId v = byLabel[head];
+            const auto begin = children.begin() + childOffsets[v];
+            const auto end = children.begin() + childOffsets[v + 1];
+            std::sort(begin, end, [&colour](VertexId a, VertexId b) {
+                return colour[a] < colour[b];
+            });
+            for (auto it = begin; it != end; ++it) {
+                byLabel[label] = *it;
+                form.Labels[*it] = label++;
+            }
+        }
+    }
+    if (q < n) {
+        search.Size = n;
+        search.OutOffsets.swap(graphOffsets);
+        search.Out.swap(graph);
+        form.Edges = certificate(search, form.Labels);
+    } else {
+        form.Edges = std::move(search.BestEdges);
+    }
+    form.Generators = search.Generators.size() + k - q;
+    form.Nodes = search.Nodes;
+    return form;
+}
+
+std::size_t Canonical::leaf(Search& search) {
+    // A helper to make the current leaf the best one, its trail the trace to beat.
+    auto setBest = [&search](std::vector<std::uint64_t>&& edges) {
+        search.Best = search.Order;
+        search.BestPosition = search.Position;
+        search.BestPath = search.Path;
+        search.BestEdges = std::move(edges);
+        search.BestTrace.resize(search.Trail.size());
+        for (std::size_t i = 0; i < search.Trail.size(); i++) {
+            search.BestTrace[i] = search.Trail[i].Code;
+        }
+        search.Agreed = search.Trail.size();
+        search.Standing = 0;
+    };
+    if (search.First.empty()) {
+        search.First = search.Order;
+        search.FirstPosition = search.Position;
+        search.FirstPath = search.Path;
+        setBest(certificate(search, search.Position));
+        return search.Path.size();
+    }
+
+    // A better trace beats the best leaf whatever the edges, and no leaf of another trace can be equivalent to it.
+    if (search.Standing < 0 || search.Agreed < search.BestTrace.size()) {
+        setBest(certificate(search, search.Position));
+        return search.Path.size();
+    }
+
+    std::vector<std::pair<VertexId, VertexId>> generator;
+    if (isAutomorphism(search, search.First, search.FirstPosition, generator)) {
+        search.Generators.push_back(std::move(generator));
+        return divergence(search.Path, search.FirstPath);
+    }
+    if (search.BestPath != search.FirstPath && isAutomorphism(search, search.Best, search.BestPosition, generator)) {
+        search.Generators.push_back(std::move(generator));
+        return divergence(search.Path, search.BestPath);
+    }
+    std::vector<std::uint64_t> edges = certificate(search, search.Position);
+    if (edges < search.BestEdges) {
+        setBest(std::move(edges));
+    }
+    return search.Path.size();
+}
+
+void Canonical::peel(const Search& search, std::vector<VertexId>& parent, std::vector<std::uint32_t>& colour) {
+    const std::size_t n = search.Size;
+    parent.assign(n, InvalidVertexId);
+    colour.assign(n, 0);
+    std::vector<std::uint8_t> hasLoop(n);
+    for (VertexId v = 0; v < n; v++) {
+        hasLoop[v] = std::binary_search(search.Out.begin() + search.OutOffsets[v], search.Out.begin() + search.OutOffsets[v + 1], v);
+        colour[v] = hasLoop[v];
+    }
+    if (search.IsDirected) {
+        return;
+    }
+
+    // Leaves go a round at a time, so a vertex goes in the round after its highest child and every round's types,
+    // numbered in order of their self loop and sorted child types, come out the same under any vertex ids.
+    std::vector<std::uint32_t> degree(n);
+    std::vector<VertexId> leaves;
+    for (VertexId v = 0; v < n; v++) {
+        degree[v] = static_cast<std::uint32_t>(search.OutOffsets[v + 1] - search.OutOffsets[v]) - hasLoop[v];
+        if (degree[v] == 1) {
+            leaves.push_back(v);
+        }
+    }
+    std::vector<std::vector<std::uint32_t>> childTypes(n);
+    auto isBefore = [&hasLoop, &childTypes](VertexId a, VertexId b) {
+        return hasLoop[a] != hasLoop[b] ? hasLoop[a] < hasLoop[b] : childTypes[a] < childTypes[b];
+    };
+    std::vector<std::uint8_t> inRound(n, 0);
+    std::vector<std::pair<VertexId, VertexId>> peeled;
+    std::vector<VertexId> order;
+    std::uint32_t types = 0;
+    while (!leaves.empty()) {
+        for (VertexId v : leaves) {
+            inRound[v] = 1;
+        }
+        peeled.clear();
+        for (VertexId v : leaves) {
+            VertexId u = InvalidVertexId;
+            for (std::size_t e = search.OutOffsets[v]; e < search.OutOffsets[v + 1] && u == InvalidVertexId; e++) {
+                const VertexId w = search.Out[e];
+                u = w != v && parent[w] == InvalidVertexId ? w : InvalidVertexId;
+            }
+            // Two leaves of one round on one edge are the centre of a tree, which stays in the core.
+            if (!inRound[u] || degree[u] != 1) {
+                peeled.emplace_back(v, u);
+            }
+        }
+        order.clear();
+        for (const auto& [v, u] : peeled) {
+            parent[v] = u;
+            std::sort(childTypes[v].begin(), childTypes[v].end());
+            order.push_back(v);
+        }
+        std::sort(order.begin(), order.end(), isBefore);
+        for (std::size_t i = 0; i < order.size(); i++) {
+            types += i == 0 || isBefore(order[i - 1], order[i]) ? 1 : 0;
+            colour[order[i]] = types - 1;
+        }
+        for (VertexId v : leaves) {
+            inRound[v] = 0;
+        }
+        leaves.clear();
+        for (const auto& [v, u] : peeled) {
+            childTypes[u].push_back(colour[v]);
+            if (--degree[u] == 1) {
+                leaves.push_back(u);
+            }
+            std::vector<std::uint32_t>().swap(childTypes[v]);
+        }
+        std::erase_if(leaves, [&degree](VertexId u) {
+            return degree[u] != 1;
+        });
+    }
+
+    // The core vertices are coloured the same way, by their self loop and the types hanging from them.
+    order.clear();
+    for (VertexId v = 0; v < n; v++) {
+        if (parent[v] == InvalidVertexId) {
+            std::sort(childTypes[v].begin(), childTypes[v].end());
+            order.push_back(v);
+        }
+    }
+    std::sort(order.begin(), order.end(), isBefore);
+    std::uint32_t colours = 0;
+    for (std::size_t i = 0; i < order.size(); i++) {
+        colours += i == 0 || isBefore(order[i - 1], order[i]) ? 1 : 0;
+        colour[order[i]] = colours - 1;
+    }
+}
+
+void Canonical::record(Search& search, const Split& split) {
+    search.Trail.push_back(split);
+    if (search.Best.empty() || search.Standing != 0) {
+        return;
+    }
+
+    // A trail running past the end of the trace, possible only through a clash of codes, counts as after it.
+    const std::size_t i = search.Trail.size() - 1;
+    if (i >= search.BestTrace.size() || split.Code > search.BestTrace[i]) {
+        search.Standing = 1;
+    } else if (split.Code < search.BestTrace[i]) {
+        search.Standing = -1;
+    } else {
+        search.Agreed++;
+    }
+}
+
+void Canonical::refine(Search& search) {
+    std::size_t head = 0;
+    while (head < search.Queue.size() && search.CellCount < search.Size && search.Standing <= 0) {
+        const std::uint32_t start = search.Queue[head++];
+        search.InQueue[start] = 0;
+        const std::uint32_t end = search.CellEnd[start];
+        for (int pass = 0; pass < (search.IsDirected ? 2 : 1); pass++) {
+            // Count the edges from every vertex into the splitter, then for a directed graph the edges out of it.
+            const std::vector<std::size_t>& offsets = pass == 0 ? search.InOffsets : search.OutOffsets;
+            const std::vector<VertexId>& lists = pass == 0 ? search.In : search.Out;
+            for (std::uint32_t position = start; position < end; position++) {
+                const VertexId w = search.Order[position];
+                for (std::size_t e = offsets[w]; e < offsets[w + 1]; e++) {
+                    if (search.Counts[lists[e]]++ == 0) {
+                        search.Touched.push_back(lists[e]);
+                    }
+                }
+            }
+
+            // Gather the touched vertices at the end of their cells.
+            for (VertexId u : search.Touched) {
+                const std::uint32_t cell = search.CellOf[u];
+                const std::uint32_t k = search.CellTouched[cell]++;
+                if (k == 0) {
+                    search.TouchedCells.push_back(cell);
+                }
+                const std::uint32_t target = search.CellEnd[cell] - 1 - k;
+                const VertexId other = search.Order[target];
+                std::swap(search.Order[search.Position[u]], search.Order[target]);
+                search.Position[other] = search.Position[u];
+                search.Position[u] = target;
+            }
+
+            // Split in cell order so the queue, and with it the leaves, do not depend on the vertex ids.
+            std::sort(search.TouchedCells.begin(), search.TouchedCells.end());
+            for (std::uint32_t cell : search.TouchedCells) {
+                splitCell(search, cell);
+            }
+            for (VertexId u : search.Touched) {
+                search.Counts[u] = 0;
+            }
+            for (std::uint32_t cell : search.TouchedCells) {
+                search.CellTouched[cell] = 0;
+            }
+            search.Touched.clear();
+            search.TouchedCells.clear();
+        }
+    }
+    for (; head < search.Queue.size(); head++) {
+        search.InQueue[search.Queue[head]] = 0;
+    }
+    search.Queue.clear();
+}
+
+void Canonical::splitCell(Search& search, std::uint32_t start) {
+    const std::uint32_t end = search.CellEnd[start];
+    const std::uint32_t touched = search.CellTouched[start];
+    if (end - start == 1) {
+        return;
+    }
+
+    // The untouched part first, then the touched vertices by increasing count.
+    const std::uint32_t tail = end - touched;
+    std::sort(search.Order.begin() + tail, search.Order.begin() + end, [&search](VertexId a, VertexId b) {
+        return search.Counts[a] < search.Counts[b];
+    });
+    for (std::uint32_t position = tail; position < end; position++) {
+        search.Position[search.Order[position]] = position;
+    }
+    search.Bounds.clear();
+    if (tail > start) {
+        search.Bounds.push_back(start);
+    }
+    for (std::uint32_t position = tail; position < end; position++) {
+        if (position == tail || search.Counts[search.Order[position]] != search.Counts[search.Order[position - 1]]) {
+            search.Bounds.push_back(position);
+        }
+    }
+    if (search.Bounds.size() == 1) {
+        return;
+    }
+    search.Bounds.push_back(end);
+
+    // The largest part moves to the front and keeps the cell's start, so only the others need relabelling.
+    const std::size_t parts = search.Bounds.size() - 1;
+    std::size_t largest = 0;
+    for (std::size_t i = 1; i < parts; i++) {
+        if (search.Bounds[i + 1] - search.Bounds[i] > search.Bounds[largest + 1] - search.Bounds[largest]) {
+            largest = i;
+        }
+    }
+    if (largest > 0) {
+        const std::uint32_t size = search.Bounds[largest + 1] - search.Bounds[largest];
+        std::rotate(search.Order.begin() + start, search.Order.begin() + search.Bounds[largest], search.Order.begin() + search.Bounds[largest + 1]);
+        for (std::uint32_t position = start; position < search.Bounds[largest + 1]; position++) {
+            search.Position[search.Order[position]] = position;
+        }
+        for (std::size_t i = largest; i > 0; i--) {
+            search.Bounds[i] = search.Bounds[i - 1] + size;
+        }
+        search.Bounds[0] = start;
+        search.Bounds[1] = start + size;
+    }
+
+    const std::uint32_t middle = search.Bounds[1];
+    search.CellEnd[start] = middle;
+    std::uint64_t code = mix(std::uint64_t(start) << 32 | end);
+    for (std::size_t i = 0; i < parts; i++) {
+        code = mix(code ^ (std::uint64_t(search.Counts[search.Order[search.Bounds[i]]]) << 32 | (search.Bounds[i + 1] - search.Bounds[i])));
+    }
+    for (std::size_t i = 1; i < parts; i++) {
+        const std::uint32_t partStart = search.Bounds[i];
+        const std::uint32_t partEnd = search.Bounds[i + 1];
+        search.CellEnd[partStart] = partEnd;
+        for (std::uint32_t position = partStart; position < partEnd; position++) {
+            search.CellOf[search.Order[position]] = partStart;
+        }
+        if (!search.InQueue[partStart]) {
+            search.InQueue[partStart] = 1;
+            search.Queue.push_back(partStart);
+        }
+    }
+    search.CellCount += parts - 1;
+    record(search, Split { start, middle, end, code });
+}
+
+std::size_t Canonical::twins(const Search& search, const std::vector<std::uint32_t>& colour, std::vector<VertexId>& classOf, std::vector<std::uint8_t>& kind) {
+    const std::size_t n = search.Size;
+    auto isSame = [&search, &colour](VertexId u, VertexId v) {
+        auto sameRange = [](const std::vector<std::size_t>& offsets, const std::vector<VertexId>& lists, VertexId u, VertexId v) {
+            return std::equal(lists.begin() + offsets[u], lists.begin() + offsets[u + 1], lists.begin() + offsets[v], lists.begin() + offsets[v + 1]);
+        };
+        return colour[u] == colour[v] && sameRange(search.OutOffsets, search.Out, u, v) && (!search.IsDirected || sameRange(search.InOffsets, search.In, u, v));
+    };
+    auto isSameClosed = [&search, &colour](VertexId u, VertexId v) {
+        // N(u) + u == N(v) + v, that is u and v adjacent and alike but for each other.
+        const auto uBegin = search.Out.begin() + search.OutOffsets[u], uEnd = search.Out.begin() + search.OutOffsets[u + 1];
+        const auto vBegin = search.Out.begin() + search.OutOffsets[v], vEnd = search.Out.begin() + search.OutOffsets[v + 1];
+        if (colour[u] != colour[v] || uEnd - uBegin != vEnd - vBegin || !std::binary_search(uBegin, uEnd, v)) {
+            return false;
+        }
+        auto a = uBegin, b = vBegin;
+        while (true) {
+            a = a != uEnd && *a == v ? a + 1 : a;
+            b = b != vEnd && *b == u ? b + 1 : b;
+            if (a == uEnd || b == vEnd) {
+                return a == uEnd && b == vEnd;
+            }
+            if (*a++ != *b++) {
+                return false;
+            }
+        }
+    };
+
+    // A hash of the colour and the neighbours that ignores their order, equal for twins, then a check for every match.
+    std::vector<std::uint64_t> hashes(n, 0);
+    std::vector<std::uint8_t> hasLoop(n, 0);
+    for (VertexId v = 0; v < n; v++) {
+        hashes[v] = mix(colour[v] + 0x9e3779b97f4a7c15ull);
+        hasLoop[v] = std::binary_search(search.Out.begin() + search.OutOffsets[v], search.Out.begin() + search.OutOffsets[v + 1], v);
+        for (std::size_t e = search.OutOffsets[v]; e < search.OutOffsets[v + 1]; e++) {
+            hashes[v] += mix(search.Out[e] + 1);
+        }
+        if (search.IsDirected) {
+            for (std::size_t e = search.InOffsets[v]; e < search.InOffsets[v + 1]; e++) {
+                hashes[v] += mix((search.In[e] + 1) ^ 0x8000000000000000ull);
+            }
+        }
+    }
+    classOf.assign(n, InvalidVertexId);
+    std::vector<VertexId> leader(n);
+    std::vector<std::uint8_t> leaderKind(n, 0);
+    std::vector<std::pair<std::uint64_t, VertexId>> keyed;
+    std::vector<std::pair<VertexId, std::size_t>> groups;
+    for (std::uint8_t pass = 1; pass <= (search.IsDirected ? 1 : 2); pass++) {
+        keyed.clear();
+        for (VertexId v = 0; v < n; v++) {
+            if (!hasLoop[v] && classOf[v] == InvalidVertexId) {
+                keyed.emplace_back(pass == 1 ? hashes[v] : hashes[v] + mix(v + 1), v);
+            }
+        }
+        std::sort(keyed.begin(), keyed.end());
+        for (std::size_t i = 0, j = 0; i < keyed.size(); i = j) {
+            groups.clear();
+            for (j = i; j < keyed.size() && keyed[j].first == keyed[i].first; j++) {
+                const VertexId v = keyed[j].second;
+                auto group = std::find_if(groups.begin(), groups.end(), [&](const std::pair<VertexId, std::size_t>& group) {
+                    return pass == 1 ? isSame(group.first, v) : isSameClosed(group.first, v);
+                });
+                if (group != groups.end()) {
+                    group->second++;
+                    leader[v] = group->first;
+                } else {
+                    groups.emplace_back(v, 1);
+                    leader[v] = v;
+                }
+            }
+            for (const auto& [first, size] : groups) {
+                if (size > 1) {
+                    leaderKind[first] = pass;
+                }
+            }
+            for (std::size_t k = i; k < j; k++) {
+                const VertexId v = keyed[k].second;
+                if (leaderKind[leader[v]] == pass) {
+                    classOf[v] = leader[v];
+                }
+            }
+        }
+    }
+
+    // Number the classes by their smallest vertex, the leader, which comes first in every run.
+    std::vector<VertexId> number(n, InvalidVertexId);
+    kind.clear();
+    for (VertexId v = 0; v < n; v++) {
+        const VertexId first = classOf[v] == InvalidVertexId ? v : classOf[v];
+        if (number[first] == InvalidVertexId) {
+            number[first] = static_cast<VertexId>(kind.size());
+            kind.push_back(classOf[v] == InvalidVertexId ? 0 : leaderKind[first]);
+        }
+        classOf[v] = number[first];
+    }
+    return kind.size();
+}
+
+void Canonical::undo(Search& search, std::size_t mark) {
+    while (search.Trail.size() > mark) {
+        const Split split = search.Trail.back();
+        search.Trail.pop_back();
+        for (std::uint32_t position = split.Middle; position < split.End; position = search.CellEnd[position]) {
+            search.CellCount--;
+        }
+        for (std::uint32_t position = split.Middle; position < split.End; position++) {
+            search.CellOf[search.Order[position]] = split.Start;
+        }
+        search.CellEnd[split.Start] = split.End;
+    }
+    if (search.Agreed >= mark) {
+        search.Agreed = mark;
+        search.Standing = 0;
+    }
+}
+
+const std::string* CanonicalCache::Find(const CanonicalHash& hash) const {
+    auto it = m_names.find(hash);
+    return it != m_names.end() ? &it->second : nullptr;
+}
+
+bool CanonicalCache::Insert(const CanonicalHash& hash, const std::string& name) {
+    return m_names.emplace(hash, name).second;
+}
+
+std::size_t CanonicalCache::GetSize(void) const {
+    return m_names.size();
+}
@@ -5,9 +5,57 @@
 
 #include "pch.hpp"
 #include "Canvas.hpp"
+#include "Profiler.hpp"
 
 void Canvas::Draw(sf::RenderWindow *window, std::vector<Graph*>& graphs) {
+    PROFILE_ZONE("Canvas::Draw");
+
+    // Draw through the camera, then hand the default view back for the sidebar.
+    sf::FloatRect visible = getVisibleRect(window);
+    window->setView(sf::View(visible));
     for (Graph* graph : graphs) {
-        graph->Draw(window);
+        graph->Draw(window, visible, m_zoom);
+    }
+    window->setView(window->getDefaultView());
+}
+
+void Canvas::HandleEvent(sf::RenderWindow *window, const sf::Event& event) {
+    if (const auto* pressed = event.getIf<sf::Event::MouseButtonPressed>()) {
+        if (pressed->button == sf::Mouse::Button::Right || pressed->button == sf::Mouse::Button::Middle) {
+            m_isPanning = true;
+            m_panPixel = pressed->position;
+        }
+    } else if (const auto* released = event.getIf<sf::Event::MouseButtonReleased>()) {
+        if (released->button == sf::Mouse::Button::Right || released->button == sf::Mouse::Button::Middle) {
+            m_isPanning = false;
+        }
+    } else if (const auto* moved = event.getIf<sf::Event::MouseMoved>()) {
+        if (m_isPanning) {
+            sf::Vector2i delta = moved->position - m_panPixel;
+            m_origin -= sf::Vector2f(delta) * m_zoom;
+            m_panPixel = moved->position;
+        }
+    } else if (const auto* scrolled = event.getIf<sf::Event::MouseWheelScrolled>()) {
+        if (scrolled->wheel != sf::Mouse::Wheel::Vertical) {
+            return;
+        }
+
+        // Keep the world point under the cursor fixed.
+        sf::Vector2f anchor = MapPixelToWorld(scrolled->position);
+        m_zoom = std::clamp(m_zoom * std::pow(ZoomStep, -scrolled->delta), MinZoom, MaxZoom);
+        m_origin = anchor - sf::Vector2f(scrolled->position) * m_zoom;
     }
-}
\ No newline at end of file
+}
+
+sf::Vector2f Canvas::MapPixelToWorld(sf::Vector2i pixel) {
+    return m_origin + sf::Vector2f(pixel) * m_zoom;
+}
+
+sf::FloatRect Canvas::getVisibleRect(sf::RenderWindow *window) {
+    return sf::FloatRect(m_origin, sf::Vector2f(window->getSize()) * m_zoom);
+}
+
+bool Canvas::m_isPanning = false;
+sf::Vector2f Canvas::m_origin = { 0.0f, 0.0f };
+sf::Vector2i Canvas::m_panPixel = { 0, 0 };
+float Canvas::m_zoom = 1.0f;
@@ -0,0 +1,309 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "Cliques.hpp"
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
+
+#include <numeric>
+
+CliqueResult Cliques::Maximum(const BitAdjacency& adjacency, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("Cliques::Maximum");
+    const std::size_t n = adjacency.GetVertexCount();
+    CliqueResult result;
+    result.IsExact = true;
+    if (n == 0) {
+        return result;
+    }
+
+    // Search positions in degeneracy order, repeatedly taking out a vertex of least remaining degree with the one
+    // taken out last first, so the dense core comes early in every row (Batagelj and Zaversnik's bucket sort).
+    Search search;
+    search.Size = n;
+    search.Words = adjacency.GetWords();
+    std::vector<std::size_t> degree(n);
+    std::size_t maxDegree = 0;
+    for (VertexId v = 0; v < n; v++) {
+        degree[v] = adjacency.GetDegree(v);
+        maxDegree = std::max(maxDegree, degree[v]);
+    }
+    std::vector<std::size_t> bucketStart(maxDegree + 2, 0);
+    for (VertexId v = 0; v < n; v++) {
+        bucketStart[degree[v] + 1]++;
+    }
+    std::partial_sum(bucketStart.begin(), bucketStart.end(), bucketStart.begin());
+    std::vector<VertexId> removal(n);
+    std::vector<std::size_t> slot(n);
+    std::vector<std::size_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+    for (VertexId v = 0; v < n; v++) {
+        slot[v] = fill[degree[v]]++;
+        removal[slot[v]] = v;
+    }
+    for (std::size_t i = 0; i < n; i++) {
+        const VertexId v = removal[i];
+        const std::uint64_t* row = adjacency.GetRow(v);
+        for (std::size_t word = 0; word < search.Words; word++) {
+            for (std::uint64_t bits = row[word]; bits != 0; bits &= bits - 1) {
+                // A neighbour still in a higher bucket swaps to the front of it and drops to the bucket below.
+                const VertexId u = static_cast<VertexId>(word * 64 + std::countr_zero(bits));
+                if (degree[u] > degree[v]) {
+                    const std::size_t front = std::max(bucketStart[degree[u]], i + 1);
+                    const VertexId other = removal[front];
+                    std::swap(removal[slot[u]], removal[front]);
+                    std::swap(slot[u], slot[other]);
+                    bucketStart[degree[u]] = front + 1;
+                    degree[u]--;
+                }
+            }
+        }
+    }
+    search.Order.assign(removal.rbegin(), removal.rend());
+    std::vector<std::uint32_t> position(n);
+    for (std::uint32_t i = 0; i < n; i++) {
+        position[search.Order[i]] = i;
+    }
+    search.Rows.assign(n * search.Words, 0);
+    for (std::uint32_t i = 0; i < n; i++) {
+        const std::uint64_t* row = adjacency.GetRow(search.Order[i]);
+        for (std::size_t word = 0; word < search.Words; word++) {
+            for (std::uint64_t bits = row[word]; bits != 0; bits &= bits - 1) {
+                const std::uint32_t j = position[word * 64 + std::countr_zero(bits)];
+                search.Rows[i * search.Words + j / 64] |= std::uint64_t(1) << (j % 64);
+            }
+        }
+    }
+    search.Control = control;
+
+    // A greedy clique from the best connected vertex to prune with from the start.
+    std::vector<std::uint64_t> candidates(search.Rows.begin(), search.Rows.begin() + search.Words);
+    search.BestClique.assign(1, 0);
+    for (std::size_t word = 0; word < search.Words; word++) {
+        while (candidates[word] != 0) {
+            const std::uint32_t next = static_cast<std::uint32_t>(word * 64 + std::countr_zero(candidates[word]));
+            search.BestClique.push_back(next);
+            for (std::size_t other = 0; other < search.Words; other++) {
+                candidates[other] &= search.Rows[next * search.Words + other];
+            }
+        }
+    }
+    search.Best = static_cast<std::uint32_t>(search.BestClique.size());
+
+    // Colour every vertex once, then branch on each with the vertices before it in colour order as candidates.
+    std::vector<std::uint64_t> everything(search.Words, 0);
+    for (std::size_t i = 0; i < n; i++) {
+        everything[i / 64] |= std::uint64_t(1) << (i % 64);
+    }
+    std::vector<std::uint32_t> order;
+    std::vector<std::uint32_t> colors;
+    Workspace root;
+    colorSort(search, root, everything.data(), 1, order, colors);
+    std::vector<std::uint32_t> rank(n);
+    for (std::uint32_t i = 0; i < n; i++) {
+        rank[order[i]] = i;
+    }
+
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(threadCount);
+    std::atomic<std::size_t> finished = 0;
+    for (std::size_t i = n; i-- > 0;) {
+        pool.Submit([&search, &order, &colors, &rank, &finished, i, n, control]() {
+            if ((!control || !control->IsCancelled()) && 1 + colors[i] > search.Best.load()) {
+                const std::uint32_t first = order[i];
+                const std::uint64_t* row = &search.Rows[first * search.Words];
+                std::vector<std::uint64_t> candidates(search.Words, 0);
+                bool isEmpty = true;
+                for (std::size_t word = 0; word < search.Words; word++) {
+                    for (std::uint64_t bits = row[word]; bits != 0; bits &= bits - 1) {
+                        const std::uint32_t j = static_cast<std::uint32_t>(word * 64 + std::countr_zero(bits));
+                        if (rank[j] < i) {
+                            candidates[word] |= std::uint64_t(1) << (j % 64);
+                            isEmpty = false;
+                        }
+                    }
+                }
+                // A clique through the vertex has at most one vertex of every colour up to its own.
+                Workspace workspace;
+                workspace.Clique.assign(1, first);
+                workspace.Levels.resize(colors[i] + 1);
+                if (isEmpty) {
+                    offer(search, workspace.Clique);
+                } else {
+                    expand(search, workspace, candidates);
+                }
+            }
+            const std::size_t done = ++finished;
+            if (control) {
+                control->SetProgress(static_cast<float>(done) / n);
+            }
+        });
+    }
+    pool.Wait();
+
+    for (std::uint32_t i : search.BestClique) {
+        result.Vertices.push_back(search.Order[i]);
+    }
+    std::sort(result.Vertices.begin(), result.Vertices.end());
+    result.IsExact = !control || !control->IsCancelled();
+
+    return result;
+}
+
+TriangleResult Cliques::Triangles(const BitAdjacency& adjacency, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("Cliques::Triangles");
+    const std::size_t n = adjacency.GetVertexCount();
+    const std::size_t words = adjacency.GetWords();
+    TriangleResult result;
+    result.PerVertex.assign(n, 0);
+    result.Clustering.assign(n, 0.0f);
+    result.Total = 0;
+    result.AverageClustering = 0.0;
+    result.Transitivity = 0.0;
+
+    // Twice the triangles through every vertex and the paths of length two centered on it, per vertex so chunks
+    // never write to the same entry.
+    std::vector<std::uint64_t> wedges(n, 0);
+    auto chunk = [&](std::size_t begin, std::size_t end) {
+        for (VertexId v = static_cast<VertexId>(begin); v < end; v++) {
+            const std::uint64_t* row = adjacency.GetRow(v);
+            std::uint64_t closed = 0;
+            std::uint64_t degree = 0;
+            for (std::size_t word = 0; word < words; word++) {
+                for (std::uint64_t bits = row[word]; bits != 0; bits &= bits - 1) {
+                    const VertexId u = static_cast<VertexId>(word * 64 + std::countr_zero(bits));
+                    closed += BitAdjacency::CountAnd(row, adjacency.GetRow(u), words);
+                    degree++;
+                }
+            }
+            result.PerVertex[v] = closed / 2;
+            wedges[v] = degree > 0 ? degree * (degree - 1) : 0;
+            if (degree >= 2) {
+                result.Clustering[v] = static_cast<float>(static_cast<double>(closed) / wedges[v]);
+            }
+        }
+    };
+
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t chunks = std::min(n, threadCount * 4);
+    std::atomic<std::size_t> finished = 0;
+    auto run = [&](std::size_t c) {
+        if (!control || !control->IsCancelled()) {
+            chunk(n * c / chunks, n * (c + 1) / chunks);
+        }
+        const std::size_t done = ++finished;
+        if (control) {
+            control->SetProgress(static_cast<float>(done) / chunks);
+        }
+    };
+    if (threadCount > 1 && chunks > 1) {
+        ThreadPool pool(threadCount);
+        for (std::size_t c = 0; c < chunks; c++) {
+            pool.Submit([&run, c]() {
+                run(c);
+            });
+        }
+        pool.Wait();
+    } else {
+        for (std::size_t c = 0; c < chunks; c++) {
+            run(c);
+        }
+    }
+
+    std::uint64_t closed = 0;
+    std::uint64_t open = 0;
+    double clustering = 0.0;
+    for (VertexId v = 0; v < n; v++) {
+        closed += result.PerVertex[v];
+        open += wedges[v];
+        clustering += result.Clustering[v];
+    }
+    result.Total = closed / 3;
+    result.AverageClustering = n > 0 ? clustering / n : 0.0;
+    result.Transitivity = open > 0 ? 2.0 * closed / open : 0.0;
+
+    return result;
+}
+
+void Cliques::colorSort(const Search& search, Workspace& workspace, const std::uint64_t* candidates, std::uint32_t minColor, std::vector<std::uint32_t>& order, std::vector<std::uint32_t>& colors) {
+    order.clear();
+    colors.clear();
+    std::vector<std::uint64_t>& uncolored = workspace.Uncolored;
+    std::vector<std::uint64_t>& available = workspace.Available;
+    uncolored.assign(candidates, candidates + search.Words);
+    available.resize(search.Words);
+    std::size_t remaining = 0;
+    for (std::uint64_t word : uncolored) {
+        remaining += std::popcount(word);
+    }
+
+    // Every class takes the first candidate left, then the first not adjacent to any taken, and so on.
+    for (std::uint32_t color = 1; remaining > 0; color++) {
+        available = uncolored;
+        for (std::size_t word = 0; word < search.Words; word++) {
+            while (available[word] != 0) {
+                const std::uint32_t v = static_cast<std::uint32_t>(word * 64 + std::countr_zero(available[word]));
+                const std::uint64_t bit = std::uint64_t(1) << (v % 64);
+                uncolored[word] &= ~bit;
+                remaining--;
+                const std::uint64_t* row = &search.Rows[v * search.Words];
+                available[word] &= ~(row[word] | bit);
+                for (std::size_t other = word + 1; other < search.Words; other++) {
+                    available[other] &= ~row[other];
+                }
+                if (color >= minColor) {
+                    order.push_back(v);
+                    colors.push_back(color);
+                }
+            }
+        }
+    }
+}
+
+bool Cliques::expand(Search& search, Workspace& workspace, std::vector<std::uint64_t>& candidates) {
+    if (search.Control && search.Control->IsCancelled()) {
+        return false;
+    }
+
+    // Only a candidate whose colour would take the clique past the best can start a larger one.
+    std::vector<std::uint32_t>& clique = workspace.Clique;
+    Level& level = workspace.Levels[clique.size()];
+    const std::uint32_t best = search.Best.load(std::memory_order_relaxed);
+    const std::uint32_t minColor = best >= clique.size() ? static_cast<std::uint32_t>(best - clique.size() + 1) : 1;
+    colorSort(search, workspace, candidates.data(), minColor, level.Order, level.Colors);
+
+    level.Next.resize(search.Words);
+    for (std::size_t i = level.Order.size(); i-- > 0;) {
+        if (clique.size() + level.Colors[i] <= search.Best.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        const std::uint32_t v = level.Order[i];
+        const std::uint64_t* row = &search.Rows[v * search.Words];
+        std::uint64_t any = 0;
+        for (std::size_t word = 0; word < search.Words; word++) {
+            level.Next[word] = candidates[word] & row[word];
+            any |= level.Next[word];
+        }
+
+        clique.push_back(v);
+        if (any == 0) {
+            offer(search, clique);
+        } else if (!expand(search, workspace, level.Next)) {
+            clique.pop_back();
+            return false;
+        }
+        clique.pop_back();
+        candidates[v / 64] &= ~(std::uint64_t(1) << (v % 64));
+    }
+
+    return true;
+}
+
+void Cliques::offer(Search& search, const std::vector<std::uint32_t>& clique) {
+    std::lock_guard<std::mutex> lock(search.Mutex);
+    if (clique.size() > search.Best.load()) {
+        search.BestClique = clique;
+        search.Best.store(static_cast<std::uint32_t>(clique.size()));
+    }
+}
@@ -0,0 +1,353 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "Coloring.hpp"
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
+
+ColoringResult Coloring::Dsatur(const AdjacencyStore& topology, JobControl* control) {
+    PROFILE_ZONE("Coloring::Dsatur");
+    const AdjacencyStore::CSR& csr = topology.GetSymmetricCSR();
+    const std::size_t n = topology.GetVertexCount();
+
+    ColoringResult result;
+    result.Colors.assign(n, 0);
+    result.ColorCount = 0;
+    result.LowerBound = 0;
+    result.IsExact = n == 0;
+
+    // The colours around every vertex as a bitset, grown as colours come up.
+    std::vector<std::vector<std::uint64_t>> seen(n);
+    std::vector<std::uint32_t> saturation(n, 0);
+
+    // A max heap of (saturation, degree, vertex), an entry is stale once the saturation of its vertex moved on.
+    typedef std::tuple<std::uint32_t, std::size_t, VertexId> Entry;
+    std::vector<Entry> heap;
+    heap.reserve(n);
+    for (VertexId v = 0; v < n; v++) {
+        heap.emplace_back(0, csr.Offsets[v + 1] - csr.Offsets[v], v);
+    }
+    std::make_heap(heap.begin(), heap.end());
+
+    std::size_t colored = 0;
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end());
+        const auto [entrySaturation, degree, v] = heap.back();
+        heap.pop_back();
+        if (result.Colors[v] != 0 || entrySaturation != saturation[v]) {
+            continue;
+        }
+
+        // The smallest colour missing around v.
+        const std::vector<std::uint64_t>& around = seen[v];
+        std::size_t word = 0;
+        while (word < around.size() && around[word] == ~std::uint64_t(0)) {
+            word++;
+        }
+        const std::size_t color = word * 64 + (word < around.size() ? std::countr_one(around[word]) : 0);
+        result.Colors[v] = static_cast<int>(color + 1);
+        result.ColorCount = std::max(result.ColorCount, color + 1);
+
+        for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+            const VertexId u = csr.Entries[e].Target;
+            if (u == v || result.Colors[u] != 0) {
+                continue;
+            }
+            std::vector<std::uint64_t>& bits = seen[u];
+            if (bits.size() <= color / 64) {
+                bits.resize(color / 64 + 1, 0);
+            }
+            const std::uint64_t bit = std::uint64_t(1) << (color % 64);
+            if ((bits[color / 64] & bit) == 0) {
+                bits[color / 64] |= bit;
+                saturation[u]++;
+                heap.emplace_back(saturation[u], csr.Offsets[u + 1] - csr.Offsets[u], u);
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+
+        colored++;
+        if (control && colored % 4096 == 0) {
+            if (control->IsCancelled()) {
+                break;
+            }
+            control->SetProgress(static_cast<float>(colored) / n);
+        }
+    }
+
+    return result;
+}
+
+ColoringResult Coloring::Exact(const AdjacencyStore& topology, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("Coloring::Exact");
+    ColoringResult result = Dsatur(topology, control);
+    const std::size_t n = topology.GetVertexCount();
+    if (n == 0 || n > ExactLimit || (control && control->IsCancelled())) {
+        return result;
+    }
+
+    // Adjacency as bitset rows, so colouring a vertex visits its neighbours a word at a time.
+    Search search;
+    search.Size = n;
+    search.Words = (n + 63) / 64;
+    search.Adjacency.assign(n * search.Words, 0);
+    search.Degree.assign(n, 0);
+    const AdjacencyStore::CSR& csr = topology.GetSymmetricCSR();
+    for (VertexId v = 0; v < n; v++) {
+        for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+            const VertexId u = csr.Entries[e].Target;
+            if (u != v) {
+                search.Adjacency[v * search.Words + u / 64] |= std::uint64_t(1) << (u % 64);
+            }
+        }
+        for (std::size_t word = 0; word < search.Words; word++) {
+            search.Degree[v] += static_cast<std::uint32_t>(std::popcount(search.Adjacency[v * search.Words + word]));
+        }
+    }
+
+    const std::vector<VertexId> clique = greedyClique(search);
+    search.LowerBound = static_cast<std::uint32_t>(clique.size());
+    search.Palette = result.ColorCount;
+    search.Best = static_cast<std::uint32_t>(result.ColorCount);
+    search.BestColors.resize(n);
+    for (VertexId v = 0; v < n; v++) {
+        search.BestColors[v] = static_cast<std::uint32_t>(result.Colors[v] - 1);
+    }
+    search.Control = control;
+
+    if (search.LowerBound < search.Best) {
+        SearchState root;
+        root.Colors.assign(n, NoColor);
+        root.Counts.assign(n * search.Palette, 0);
+        root.Saturation.assign(n, 0);
+        root.ClassSizes.assign(search.Palette, 0);
+        root.ColorCount = 0;
+        root.Uncolored = n;
+
+        // Any colouring can be renamed so the clique takes the first colours, which removes their permutations.
+        for (std::size_t i = 0; i < clique.size(); i++) {
+            assign(search, root, clique[i], static_cast<std::uint32_t>(i));
+        }
+
+        // Split the top of the tree breadth first until every worker has plenty of subproblems to steal.
+        const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+        std::vector<SearchState> frontier;
+        frontier.push_back(std::move(root));
+        while (!frontier.empty() && frontier.size() < threadCount * SubproblemsPerThread) {
+            std::vector<SearchState> next;
+            for (SearchState& state : frontier) {
+                if (state.Uncolored == 0) {
+                    offer(search, state);
+                    continue;
+                }
+                const VertexId v = select(search, state);
+                for (std::uint32_t color = 0; color <= state.ColorCount; color++) {
+                    const std::uint32_t used = color < state.ColorCount ? state.ColorCount : state.ColorCount + 1;
+                    if (used >= search.Best.load() || (color < state.ColorCount && state.Counts[v * search.Palette + color] != 0)) {
+                        continue;
+                    }
+                    SearchState child = state;
+                    assign(search, child, v, color);
+                    next.push_back(std::move(child));
+                }
+            }
+            frontier = std::move(next);
+        }
+
+        ThreadPool pool(threadCount);
+        std::atomic<std::size_t> finished = 0;
+        const std::size_t total = frontier.size();
+        for (SearchState& state : frontier) {
+            pool.Submit([&search, &state, &finished, total, control]() {
+                branch(search, state);
+                const std::size_t done = ++finished;
+                if (control) {
+                    control->SetProgress(static_cast<float>(done) / total);
+                }
+            });
+        }
+        pool.Wait();
+    }
+
+    for (VertexId v = 0; v < n; v++) {
+        result.Colors[v] = static_cast<int>(search.BestColors[v] + 1);
+    }
+    result.ColorCount = search.Best.load();
+    result.IsExact = !control || !control->IsCancelled();
+    result.LowerBound = result.IsExact ? result.ColorCount : clique.size();
+
+    return result;
+}
+
+ColoringResult Coloring::Greedy(const AdjacencyStore& topology) {
+    PROFILE_ZONE("Coloring::Greedy");
+    const AdjacencyStore::CSR& csr = topology.GetSymmetricCSR();
+    const std::size_t n = topology.GetVertexCount();
+
+    ColoringResult result;
+    result.Colors.assign(n, 0);
+    result.ColorCount = 0;
+    result.LowerBound = 0;
+    result.IsExact = n == 0;
+
+    std::vector<VertexId> order(n);
+    for (VertexId v = 0; v < n; v++) {
+        order[v] = v;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](VertexId a, VertexId b) {
+        return csr.Offsets[a + 1] - csr.Offsets[a] > csr.Offsets[b + 1] - csr.Offsets[b];
+    });
+
+    // Colours taken around the current vertex are stamped with its id, so nothing is cleared between vertices.
+    std::vector<VertexId> taken(n + 2, InvalidVertexId);
+    for (VertexId v : order) {
+        for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+            taken[result.Colors[csr.Entries[e].Target]] = v;
+        }
+        int color = 1;
+        while (taken[color] == v) {
+            color++;
+        }
+        result.Colors[v] = color;
+        result.ColorCount = std::max(result.ColorCount, static_cast<std::size_t>(color));
+    }
+
+    return result;
+}
+
+void Coloring::assign(const Search& search, SearchState& state, VertexId v, std::uint32_t color) {
+    state.Colors[v] = color;
+    if (color == state.ColorCount) {
+        state.ColorCount++;
+    }
+    state.ClassSizes[color]++;
+    state.Uncolored--;
+
+    const std::uint64_t* row = &search.Adjacency[v * search.Words];
+    for (std::size_t word = 0; word < search.Words; word++) {
+        for (std::uint64_t bits = row[word]; bits != 0; bits &= bits - 1) {
+            const VertexId u = static_cast<VertexId>(word * 64 + std::countr_zero(bits));
+            if (state.Colors[u] == NoColor && state.Counts[u * search.Palette + color]++ == 0) {
+                state.Saturation[u]++;
+            }
+        }
+    }
+}
+
+void Coloring::branch(Search& search, SearchState& state) {
+    if (search.Control && search.Control->IsCancelled()) {
+        return;
+    }
+    if (state.Uncolored == 0) {
+        offer(search, state);
+        return;
+    }
+
+    // Every completion uses at least the colours already used, and nothing beats the clique.
+    const std::uint32_t best = search.Best.load(std::memory_order_relaxed);
+    if (best <= search.LowerBound || state.ColorCount >= best) {
+        return;
+    }
+
+    // A vertex that already sees every colour only leaves the new one, the most constrained vertex fails fastest.
+    const VertexId v = select(search, state);
+    for (std::uint32_t color = 0; color < state.ColorCount; color++) {
+        if (state.ColorCount >= search.Best.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (state.Counts[v * search.Palette + color] == 0) {
+            assign(search, state, v, color);
+            branch(search, state);
+            unassign(search, state, v);
+        }
+    }
+    if (state.ColorCount + 1 < search.Best.load(std::memory_order_relaxed)) {
+        assign(search, state, v, state.ColorCount);
+        branch(search, state);
+        unassign(search, state, v);
+    }
+}
+
+std::vector<VertexId> Coloring::greedyClique(const Search& search) {
+    // From every vertex, keep adding the candidate adjacent to the most other candidates.
+    std::vector<VertexId> best;
+    std::vector<VertexId> clique;
+    std::vector<std::uint64_t> candidates(search.Words);
+    for (VertexId start = 0; start < search.Size; start++) {
+        clique.assign(1, start);
+        std::copy_n(&search.Adjacency[start * search.Words], search.Words, candidates.begin());
+        while (true) {
+            VertexId pick = InvalidVertexId;
+            int pickDegree = -1;
+            for (std::size_t word = 0; word < search.Words; word++) {
+                for (std::uint64_t bits = candidates[word]; bits != 0; bits &= bits - 1) {
+                    const VertexId u = static_cast<VertexId>(word * 64 + std::countr_zero(bits));
+                    int degree = 0;
+                    for (std::size_t other = 0; other < search.Words; other++) {
+                        degree += std::popcount(candidates[other] & search.Adjacency[u * search.Words + other]);
+                    }
+                    if (degree > pickDegree) {
+                        pick = u;
+                        pickDegree = degree;
+                    }
+                }
+            }
+            if (pick == InvalidVertexId) {
+                break;
+            }
+            clique.push_back(pick);
+            for (std::size_t word = 0; word < search.Words; word++) {
+                candidates[word] &= search.Adjacency[pick * search.Words + word];
+            }
+        }
+        if (clique.size() > best.size()) {
+            best = clique;
+        }
+    }
+
+    return best;
+}
+
+void Coloring::offer(Search& search, const SearchState& state) {
+    std::lock_guard<std::mutex> lock(search.Mutex);
+    if (state.ColorCount < search.Best.load()) {
+        search.BestColors = state.Colors;
+        search.Best.store(state.ColorCount);
+    }
+}
+
+VertexId Coloring::select(const Search& search, const SearchState& state) {
+    VertexId best = InvalidVertexId;
+    for (VertexId v = 0; v < search.Size; v++) {
+        if (state.Colors[v] != NoColor) {
+            continue;
+        }
+        if (best == InvalidVertexId || state.Saturation[v] > state.Saturation[best] || (state.Saturation[v] == state.Saturation[best] && search.Degree[v] > search.Degree[best])) {
+            best = v;
+        }
+    }
+
+    return best;
+}
+
+void Coloring::unassign(const Search& search, SearchState& state, VertexId v) {
+    const std::uint32_t color = state.Colors[v];
+    state.Colors[v] = NoColor;
+    if (--state.ClassSizes[color] == 0) {
+        state.ColorCount--;
+    }
+    state.Uncolored++;
+
+    const std::uint64_t* row = &search.Adjacency[v * search.Words];
+    for (std::size_t word = 0; word < search.Words; word++) {
+        for (std::uint64_t bits = row[word]; bits != 0; bits &= bits - 1) {
+            const VertexId u = static_cast<VertexId>(word * 64 + std::countr_zero(bits));
+            if (state.Colors[u] == NoColor && --state.Counts[u * search.Palette + color] == 0) {
+                state.Saturation[u]--;
+            }
+        }
+    }
+}
@@ -0,0 +1,265 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "ForceLayout.hpp"
+#include "Profiler.hpp"
+
+ForceLayout::ForceLayout(void) {
+    m_temperature = 0.0f;
+    m_version = 0;
+    m_offsets.push_back(0);
+}
+
+void ForceLayout::Assign(const AdjacencyStore& topology, std::vector<float> x, std::vector<float> y) {
+    const std::size_t n = x.size();
+    m_x = std::move(x);
+    m_y = std::move(y);
+    m_forceX.assign(n, 0.0f);
+    m_forceY.assign(n, 0.0f);
+    m_pinned.resize(n, 0);
+    m_version = topology.GetVersion();
+
+    // Only the ends of the edges matter, directed edges are followed both ways.
+    const AdjacencyStore::CSR& csr = topology.GetSymmetricCSR();
+    m_offsets = csr.Offsets;
+    m_targets.resize(csr.Entries.size());
+    for (std::size_t i = 0; i < csr.Entries.size(); i++) {
+        m_targets[i] = csr.Entries[i].Target;
+    }
+
+    // Vertices on the same spot feel no force from each other, spread them on a small spiral.
+    std::unordered_set<std::uint64_t> occupied;
+    occupied.reserve(n);
+    for (VertexId id = 0; id < n; id++) {
+        for (std::size_t turn = 1; !occupied.insert(std::uint64_t(std::bit_cast<std::uint32_t>(m_x[id])) << 32 | std::bit_cast<std::uint32_t>(m_y[id])).second; turn++) {
+            const float angle = 2.39996323f * static_cast<float>(turn);
+            const float radius = IdealLength * 0.1f * std::sqrt(static_cast<float>(turn));
+            m_x[id] += radius * std::cos(angle);
+            m_y[id] += radius * std::sin(angle);
+        }
+    }
+}
+
+std::uint64_t ForceLayout::GetVersion(void) const {
+    return m_version;
+}
+
+std::span<const float> ForceLayout::GetX(void) const {
+    return m_x;
+}
+
+std::span<const float> ForceLayout::GetY(void) const {
+    return m_y;
+}
+
+void ForceLayout::Heat(void) {
+    if (m_x.empty()) {
+        return;
+    }
+
+    // A tenth of the drawing, or of the square the vertices would fill at their ideal distance if it is larger.
+    const auto [minX, maxX] = std::minmax_element(m_x.begin(), m_x.end());
+    const auto [minY, maxY] = std::minmax_element(m_y.begin(), m_y.end());
+    const float ideal = IdealLength * std::sqrt(static_cast<float>(m_x.size()));
+    m_temperature = std::max({ IdealLength, *maxX - *minX, *maxY - *minY, ideal }) * 0.1f;
+}
+
+bool ForceLayout::IsRunning(void) const {
+    return m_temperature >= MinTemperature;
+}
+
+void ForceLayout::SetPinned(VertexId id, bool isPinned) {
+    m_pinned[id] = isPinned ? 1 : 0;
+}
+
+void ForceLayout::SetPosition(VertexId id, float x, float y) {
+    m_x[id] = x;
+    m_y[id] = y;
+}
+
+bool ForceLayout::Step(std::size_t iterations, ThreadPool* pool) {
+    PROFILE_ZONE("ForceLayout::Step");
+
+    const std::size_t n = m_x.size();
+    for (std::size_t iteration = 0; iteration < iterations && IsRunning() && n > 0; iteration++) {
+        // The tree is rebuilt every iteration, from the square around every vertex.
+        const auto [minX, maxX] = std::minmax_element(m_x.begin(), m_x.end());
+        const auto [minY, maxY] = std::minmax_element(m_y.begin(), m_y.end());
+        const float half = std::max(std::max(*maxX - *minX, *maxY - *minY) * 0.5f, 1.0f);
+        m_order.resize(n);
+        for (VertexId id = 0; id < n; id++) {
+            m_order[id] = id;
+        }
+        m_nodes.clear();
+        build(0, static_cast<std::uint32_t>(n), (*minX + *maxX) * 0.5f, (*minY + *maxY) * 0.5f, half, 0);
+
+        // Leaves are walked in tree order, so their positions are copied next to each other.
+        m_sortedX.resize(n);
+        m_sortedY.resize(n);
+        for (std::size_t i = 0; i < n; i++) {
+            m_sortedX[i] = m_x[m_order[i]];
+            m_sortedY[i] = m_y[m_order[i]];
+        }
+
+        // Neighbouring chunks of tree order walk the same parts of the tree.
+        parallelFor(pool, n, [this](std::size_t begin, std::size_t end) {
+            computeForces(begin, end);
+        });
+
+        // Every vertex moves along its force, at most as far as the temperature allows.
+        const float temperature = m_temperature;
+        parallelFor(pool, n, [this, temperature](std::size_t begin, std::size_t end) {
+            for (std::size_t id = begin; id < end; id++) {
+                const float length = std::sqrt(m_forceX[id] * m_forceX[id] + m_forceY[id] * m_forceY[id]);
+                const float scale = m_pinned[id] ? 0.0f : std::min(length, temperature) / std::max(length, 1e-6f);
+                m_x[id] += m_forceX[id] * scale;
+                m_y[id] += m_forceY[id] * scale;
+            }
+        });
+        m_temperature *= Cooling;
+    }
+
+    return IsRunning();
+}
+
+std::uint32_t ForceLayout::build(std::uint32_t begin, std::uint32_t end, float centerX, float centerY, float half, std::size_t depth) {
+    const std::uint32_t index = static_cast<std::uint32_t>(m_nodes.size());
+    float sumX = 0.0f;
+    float sumY = 0.0f;
+    for (std::uint32_t i = begin; i < end; i++) {
+        sumX += m_x[m_order[i]];
+        sumY += m_y[m_order[i]];
+    }
+    const float mass = static_cast<float>(end - begin);
+    m_nodes.push_back({ sumX / mass, sumY / mass, mass, 2.0f * half, begin, end, { 0, 0, 0, 0 } });
+    if (end - begin <= LeafSize || depth == MaxDepth) {
+        return index;
+    }
+
+    // Split by row, then each row by column, the quadrants end up in order: top left, top right, bottom left, bottom right.
+    VertexId* first = m_order.data() + begin;
+    VertexId* last = m_order.data() + end;
+    VertexId* middle = std::partition(first, last, [&](VertexId id) { return m_y[id] < centerY; });
+    VertexId* bounds[5] = {
+        first,
+        std::partition(first, middle, [&](VertexId id) { return m_x[id] < centerX; }),
+        middle,
+        std::partition(middle, last, [&](VertexId id) { return m_x[id] < centerX; }),
+        last
+    };
+    const float quarter = half * 0.5f;
+    for (std::size_t quadrant = 0; quadrant < 4; quadrant++) {
+        if (bounds[quadrant] == bounds[quadrant + 1]) {
+            continue;
+        }
+        const float x = centerX + (quadrant % 2 == 0 ? -quarter : quarter);
+        const float y = centerY + (quadrant < 2 ? -quarter : quarter);
+        const std::uint32_t child = build(static_cast<std::uint32_t>(bounds[quadrant] - m_order.data()), static_cast<std::uint32_t>(bounds[quadrant + 1] - m_order.data()), x, y, quarter, depth + 1);
+        m_nodes[index].Children[quadrant] = child;
+    }
+
+    return index;
+}
+
+void ForceLayout::computeForces(std::size_t begin, std::size_t end) {
+    const float k2 = IdealLength * IdealLength;
+    const float theta2 = Theta * Theta;
+    const Node& root = m_nodes[0];
+    const float* sortedX = m_sortedX.data();
+    const float* sortedY = m_sortedY.data();
+
+    // Each node pushes its children once, so the stack never holds more than three per level.
+    std::array<std::uint32_t, 4 * MaxDepth + 4> stack;
+    for (std::size_t i = begin; i < end; i++) {
+        const VertexId id = m_order[i];
+        const float x = sortedX[i];
+        const float y = sortedY[i];
+        float forceX = 0.0f;
+        float forceY = 0.0f;
+
+        // Repulsion, k^2 / d away from every other vertex, far nodes taken as one body at their center of mass.
+        std::size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Node& node = m_nodes[stack[--top]];
+            const float dx = x - node.X;
+            const float dy = y - node.Y;
+            const float d2 = dx * dx + dy * dy;
+            const bool isLeaf = (node.Children[0] | node.Children[1] | node.Children[2] | node.Children[3]) == 0;
+            if (!isLeaf && node.Size * node.Size < theta2 * d2) {
+                const float scale = k2 * node.Mass / (d2 + Softening);
+                forceX += dx * scale;
+                forceY += dy * scale;
+            } else if (!isLeaf) {
+                for (std::uint32_t child : node.Children) {
+                    if (child != 0) {
+                        stack[top++] = child;
+                    }
+                }
+            } else {
+                // Every vertex of a leaf one by one, in independent lanes so the loop vectorizes. The vertex
+                // itself is at distance 0 and adds nothing.
+                float laneX[Lanes] = {};
+                float laneY[Lanes] = {};
+                std::size_t j = node.Begin;
+                for (; j + Lanes <= node.End; j += Lanes) {
+                    for (std::size_t lane = 0; lane < Lanes; lane++) {
+                        const float ldx = x - sortedX[j + lane];
+                        const float ldy = y - sortedY[j + lane];
+                        const float scale = k2 / (ldx * ldx + ldy * ldy + Softening);
+                        laneX[lane] += ldx * scale;
+                        laneY[lane] += ldy * scale;
+                    }
+                }
+                for (std::size_t lane = 0; j < node.End; j++, lane++) {
+                    const float ldx = x - sortedX[j];
+                    const float ldy = y - sortedY[j];
+                    const float scale = k2 / (ldx * ldx + ldy * ldy + Softening);
+                    laneX[lane] += ldx * scale;
+                    laneY[lane] += ldy * scale;
+                }
+                for (std::size_t lane = 0; lane < Lanes; lane++) {
+                    forceX += laneX[lane];
+                    forceY += laneY[lane];
+                }
+            }
+        }
+
+        // Attraction, d^2 / k toward every neighbour.
+        for (std::size_t e = m_offsets[id]; e < m_offsets[id + 1]; e++) {
+            const float dx = x - m_x[m_targets[e]];
+            const float dy = y - m_y[m_targets[e]];
+            const float scale = std::sqrt(dx * dx + dy * dy) / IdealLength;
+            forceX -= dx * scale;
+            forceY -= dy * scale;
+        }
+
+        // Gravity toward the center of mass, so components do not drift apart forever.
+        forceX -= Gravity * (x - root.X);
+        forceY -= Gravity * (y - root.Y);
+
+        m_forceX[id] = forceX;
+        m_forceY[id] = forceY;
+    }
+}
+
+void ForceLayout::parallelFor(ThreadPool* pool, std::size_t count, const std::function<void(std::size_t, std::size_t)>& body) {
+    if (!pool || count < ParallelThreshold) {
+        body(0, count);
+        return;
+    }
+
+    // A few chunks per worker, so stealing evens out chunks that walk deeper parts of the tree.
+    const std::size_t chunks = std::min(pool->GetThreadCount() * 4, count / (ParallelThreshold / 4));
+    for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+        const std::size_t begin = count * chunk / chunks;
+        const std::size_t end = count * (chunk + 1) / chunks;
+        pool->Submit([&body, begin, end]() {
+            body(begin, end);
+        });
+    }
+    pool->Wait();
+}
@@ -0,0 +1,914 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "Generators.hpp"
+#include "Profiler.hpp"
+
+#include <numbers>
+
+namespace {
+    /**
+     * @brief Scramble a 64 bit value with the SplitMix64 finaliser.
+     * @param x The value.
+     * @return The scrambled value.
+     */
+    std::uint64_t mix(std::uint64_t x) {
+        x += 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    /**
+     * @brief Scale random bits to a whole number below a bound, through a double so it builds on every compiler.
+     * @param bits 64 random bits.
+     * @param bound The bound, above 0 and below 2^53.
+     * @return The number, in [0, bound).
+     */
+    std::uint64_t scaleBelow(std::uint64_t bits, std::uint64_t bound) {
+        const double unit = static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+        return std::min(bound - 1, static_cast<std::uint64_t>(unit * static_cast<double>(bound)));
+    }
+
+    /// @brief A SplitMix64 stream, small and fast enough to start one per chunk.
+    typedef struct stream {
+        /// @brief The state, moved on by a constant every draw.
+        std::uint64_t State;
+
+        /**
+         * @brief Start the stream of a chunk.
+         * @param seed The seed of the graph.
+         * @param chunk The chunk.
+         */
+        stream(std::uint64_t seed, std::uint64_t chunk) : State(mix(seed ^ mix(chunk))) {}
+
+        /**
+         * @brief Draw the next value.
+         * @return 64 random bits.
+         */
+        std::uint64_t operator()(void) {
+            State += 0x9e3779b97f4a7c15ull;
+            std::uint64_t z = State;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        /**
+         * @brief Draw a number in [0, 1).
+         * @return The number.
+         */
+        double Unit(void) {
+            return static_cast<double>((*this)() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        /**
+         * @brief Draw a whole number in [0, bound).
+         * @param bound The bound, above 0.
+         * @return The number.
+         */
+        std::uint64_t Below(std::uint64_t bound) {
+            return scaleBelow((*this)(), bound);
+        }
+    } Stream;
+
+    /**
+     * @brief Draw the number of successes in a run of trials.
+     *
+     * Large draws use the normal approximation, close enough for sharing out edges and far cheaper than an exact draw
+     * when the trials run into the millions. Small ones count the successes with geometric skips between them.
+     * @param random The stream.
+     * @param trials The number of trials.
+     * @param p The chance of success of each.
+     * @return The number of successes.
+     */
+    std::uint64_t binomial(Stream& random, std::uint64_t trials, double p) {
+        if (p <= 0.0 || trials == 0) {
+            return 0;
+        }
+        if (p >= 1.0) {
+            return trials;
+        }
+        if (p > 0.5) {
+            return trials - binomial(random, trials, 1.0 - p);
+        }
+        const double mean = static_cast<double>(trials) * p;
+        const double variance = mean * (1.0 - p);
+        if (variance > 100.0) {
+            const double radius = std::sqrt(-2.0 * std::log(1.0 - random.Unit()));
+            const double normal = radius * std::cos(2.0 * std::numbers::pi * random.Unit());
+            return static_cast<std::uint64_t>(std::clamp(std::round(mean + std::sqrt(variance) * normal), 0.0, static_cast<double>(trials)));
+        }
+        const double logMiss = std::log1p(-p);
+        std::uint64_t successes = 0;
+        double position = std::floor(std::log(1.0 - random.Unit()) / logMiss);
+        while (position < static_cast<double>(trials)) {
+            successes++;
+            position += 1.0 + std::floor(std::log(1.0 - random.Unit()) / logMiss);
+        }
+        return successes;
+    }
+
+    /**
+     * @brief Pack an edge into one value, the first vertex in the high half.
+     * @param from The first vertex.
+     * @param to The second vertex.
+     * @return The packed edge.
+     */
+    std::uint64_t pack(std::uint64_t from, std::uint64_t to) {
+        return (from << 32) | to;
+    }
+
+    /**
+     * @brief Get the number of the first pair of a row, when the pairs i < j of n vertices are numbered row by row.
+     * @param n The number of vertices.
+     * @param row The row, the smaller vertex i.
+     * @return The number of the pair (i, i + 1).
+     */
+    std::uint64_t rowStart(std::uint64_t n, std::uint64_t row) {
+        return row * (2 * n - row - 1) / 2;
+    }
+
+    /**
+     * @brief Get the row of a pair number, the inverse of rowStart().
+     * @param n The number of vertices.
+     * @param index The pair number, below n(n - 1) / 2.
+     * @return The row.
+     */
+    std::uint64_t rowOf(std::uint64_t n, std::uint64_t index) {
+        const double b = 2.0 * static_cast<double>(n) - 1.0;
+        const double root = std::sqrt(std::max(0.0, b * b - 8.0 * static_cast<double>(index)));
+        std::uint64_t row = static_cast<std::uint64_t>(std::max(0.0, (b - root) / 2.0));
+        row = std::min(row, n - 2);
+        while (row > 0 && rowStart(n, row) > index) {
+            row--;
+        }
+        while (row + 2 < n && rowStart(n, row + 1) <= index) {
+            row++;
+        }
+        return row;
+    }
+
+    /**
+     * @brief Get the number of chunks an amount of work is cut into.
+     * @param total The amount of work.
+     * @param size The work per chunk.
+     * @return The number of chunks, at least 1.
+     */
+    std::size_t chunkCount(double total, double size) {
+        return static_cast<std::size_t>(std::max(1.0, std::ceil(total / size)));
+    }
+}
+
+GeneratedGraph Generators::Complete(std::size_t n, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("Generators::Complete");
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(threadCount);
+
+    // Rows dealt out in turn, so every chunk gets long and short ones alike.
+    const double pairs = static_cast<double>(n) * (static_cast<double>(n) - 1.0) / 2.0;
+    const std::size_t chunks = std::min(std::max<std::size_t>(n, 1), chunkCount(pairs, ChunkEdges));
+    EdgeChunks edges(chunks);
+    const bool isDone = run(pool, chunks, control, [&](std::size_t chunk) {
+        for (std::size_t i = chunk; i < n; i += chunks) {
+            for (std::size_t j = i + 1; j < n; j++) {
+                edges[chunk].push_back(pack(i, j));
+            }
+        }
+    });
+
+    GeneratedGraph graph;
+    if (isDone) {
+        assemble(n, edges, pool, graph);
+        placeCircle(graph, n);
+    }
+    return graph;
+}
+
+GeneratedGraph Generators::Cycle(std::size_t n, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("Generators::Cycle");
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(threadCount);
+
+    const std::size_t chunks = chunkCount(static_cast<double>(n), ChunkEdges);
+    EdgeChunks edges(chunks);
+    const bool isDone = run(pool, chunks, control, [&](std::size_t chunk) {
+        const std::size_t end = std::min(n, (chunk + 1) * ChunkEdges);
+        for (std::size_t i = chunk * ChunkEdges; i < end; i++) {
+            edges[chunk].push_back(pack(i, (i + 1) % n));
+        }
+    });
+
+    GeneratedGraph graph;
+    if (isDone) {
+        assemble(n, edges, pool, graph);
+        placeCircle(graph, n);
+    }
+    return graph;
+}
+
+GeneratedGraph Generators::Grid(std::size_t rows, std::size_t columns, bool isTorus, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("Generators::Grid");
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(threadCount);
+
+    const std::size_t n = rows * columns;
+    const std::size_t chunks = chunkCount(static_cast<double>(n), ChunkEdges / 2);
+    EdgeChunks edges(chunks);
+    const bool isDone = run(pool, chunks, control, [&](std::size_t chunk) {
+        const std::size_t end = std::min(n, (chunk + 1) * (ChunkEdges / 2));
+        for (std::size_t v = chunk * (ChunkEdges / 2); v < end; v++) {
+            const std::size_t row = v / columns;
+            const std::size_t column = v % columns;
+            if (column + 1 < columns) {
+                edges[chunk].push_back(pack(v, v + 1));
+            } else if (isTorus) {
+                edges[chunk].push_back(pack(v, v + 1 - columns));
+            }
+            if (row + 1 < rows) {
+                edges[chunk].push_back(pack(v, v + columns));
+            } else if (isTorus) {
+                edges[chunk].push_back(pack(v, column));
+            }
+        }
+    });
+
+    GeneratedGraph graph;
+    if (isDone) {
+        assemble(n, edges, pool, graph);
+        placeGrid(graph, n, columns);
+    }
+    return graph;
+}
+
+GeneratedGraph Generators::Hypercube(std::size_t dimension, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("Generators::Hypercube");
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(threadCount);
+
+    const std::size_t n = std::size_t(1) << dimension;
+    const std::size_t perChunk = std::max<std::size_t>(1, ChunkEdges / std::max<std::size_t>(1, dimension));
+    const std::size_t chunks = chunkCount(static_cast<double>(n), static_cast<double>(perChunk));
+    EdgeChunks edges(chunks);
+    const bool isDone = run(pool, chunks, control, [&](std::size_t chunk) {
+        const std::size_t end = std::min(n, (chunk + 1) * perChunk);
+        for (std::size_t v = chunk * perChunk; v < end; v++) {
+            for (std::size_t bit = 0; bit < dimension; bit++) {
+                const std::size_t u = v ^ (std::size_t(1) << bit);
+                if (u > v) {
+                    edges[chunk].push_back(pack(v, u));
+                }
+            }
+        }
+    });
+
+    GeneratedGraph graph;
+    if (isDone) {
+        assemble(n, edges, pool, graph);
+        // The low half of the bits picks the column and the high half the row, so flipping a bit moves along one axis.
+        placeGrid(graph, n, std::size_t(1) << ((dimension + 1) / 2));
+    }
+    return graph;
+}
+
+GeneratedGraph Generators::CompleteBipartite(std::size_t left, std::size_t right, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("Generators::CompleteBipartite");
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(threadCount);
+
+    const std::size_t n = left + right;
+    const std::size_t perChunk = std::max<std::size_t>(1, ChunkEdges / std::max<std::size_t>(1, right));
+    const std::size_t chunks = chunkCount(static_cast<double>(left), static_cast<double>(perChunk));
+    EdgeChunks edges(chunks);
+    const bool isDone = run(pool, chunks, control, [&](std::size_t chunk) {
+        const std::size_t end = std::min(left, (chunk + 1) * perChunk);
+        for (std::size_t i = chunk * perChunk; i < end; i++) {
+            for (std::size_t j = left; j < n; j++) {
+                edges[chunk].push_back(pack(i, j));
+            }
+        }
+    });
+
+    GeneratedGraph graph;
+    if (isDone) {
+        assemble(n, edges, pool, graph);
+        // Two columns, the shorter one centred against the longer.
+        const float gap = std::max(2.0f, static_cast<float>(std::max(left, right)) / 2.0f);
+        graph.X.resize(n);
+        graph.Y.resize(n);
+        for (std::size_t v = 0; v < n; v++) {
+            const bool isLeft = v < left;
+            const std::size_t size = isLeft ? left : right;
+            const std::size_t index = isLeft ? v : v - left;
+            graph.X[v] = isLeft ? 0.0f : gap;
+            graph.Y[v] = static_cast<float>(index) + (static_cast<float>(std::max(left, right)) - static_cast<float>(size)) / 2.0f;
+        }
+    }
+    return graph;
+}
+
+GeneratedGraph Generators::Gnp(std::size_t n, double p, std::uint64_t seed, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("Generators::Gnp");
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(threadCount);
+
+    const std::uint64_t pairs = n < 2 ? 0 : static_cast<std::uint64_t>(n) * (n - 1) / 2;
+    // Chunks are equal ranges of pair numbers, sized by the edges expected in them.
+    const std::size_t chunks = pairs == 0 || p <= 0.0 ? 1 : std::min<std::size_t>(pairs, chunkCount(static_cast<double>(pairs) * p, ChunkEdges));
+    const double logMiss = p < 1.0 ? std::log1p(-p) : 0.0;
+    EdgeChunks edges(chunks);
+    const bool isDone = run(pool, chunks, control, [&](std::size_t chunk) {
+        const std::uint64_t begin = pairs / chunks * chunk + std::min<std::uint64_t>(chunk, pairs % chunks);
+        const std::uint64_t end = begin + pairs / chunks + (chunk < pairs % chunks);
+        if (p <= 0.0 || begin == end) {
+            return;
+        }
+        Stream random(seed, chunk);
+        std::uint64_t row = rowOf(n, begin);
+        std::uint64_t rowEnd = rowStart(n, row + 1);
+        std::uint64_t index = begin;
+        std::vector<std::uint64_t>& out = edges[chunk];
+        out.reserve(static_cast<std::size_t>(static_cast<double>(end - begin) * p * 1.05) + 16);
+        while (true) {
+            // The gap to the next chosen pair is geometric, the pairs in between all missed.
+            if (p < 1.0) {
+                const double skip = std::floor(std::log(1.0 - random.Unit()) / logMiss);
+                if (skip >= static_cast<double>(end - index)) {
+                    break;
+                }
+                index += static_cast<std::uint64_t>(skip);
+            }
+            if (index >= end) {
+                break;
+            }
+            while (index >= rowEnd) {
+                row++;
+                rowEnd = rowStart(n, row + 1);
+            }
+            out.push_back(pack(row, row + 1 + (index - rowStart(n, row))));
+            index++;
+        }
+    });
+
+    GeneratedGraph graph;
+    if (isDone) {
+        assemble(n, edges, pool, graph);
+        placeRandom(graph, n, seed);
+    }
+    return graph;
+}
+
+GeneratedGraph Generators::Gnm(std::size_t n, std::size_t m, std::uint64_t seed, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("Generators::Gnm");
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(threadCount);
+
+    const std::uint64_t pairs = n < 2 ? 0 : static_cast<std::uint64_t>(n) * (n - 1) / 2;
+    m = std::min<std::uint64_t>(m, pairs);
+    const std::size_t chunks = pairs == 0 ? 1 : std::min<std::size_t>(pairs, chunkCount(static_cast<double>(m), ChunkEdges));
+
+    // Deal the edges out to the ranges in order, each one's share binomial in what is left, kept within what fits.
+    std::vector<std::uint64_t> shares(chunks, 0);
+    Stream dealer(seed, chunks);
+    std::uint64_t remaining = m;
+    for (std::size_t chunk = 0; chunk < chunks && remaining > 0; chunk++) {
+        const std::uint64_t size = pairs / chunks + (chunk < pairs % chunks);
+        const std::uint64_t after = pairs - (pairs / chunks * (chunk + 1) + std::min<std::uint64_t>(chunk + 1, pairs % chunks));
+        std::uint64_t share = remaining;
+        if (after > 0) {
+            share = binomial(dealer, remaining, static_cast<double>(size) / static_cast<double>(size + after));
+        }
+        share = std::clamp(share, remaining > after ? remaining - after : 0, std::min(size, remaining));
+        shares[chunk] = share;
+        remaining -= share;
+    }
+
+    EdgeChunks edges(chunks);
+    const bool isDone = run(pool, chunks, control, [&](std::size_t chunk) {
+        const std::uint64_t begin = pairs / chunks * chunk + std::min<std::uint64_t>(chunk, pairs % chunks);
+        const std::uint64_t size = pairs / chunks + (chunk < pairs % chunks);
+        const std::uint64_t share = shares[chunk];
+        if (share == 0) {
+            return;
+        }
+        Stream random(seed, chunk);
+        std::vector<std::uint64_t> chosen;
+        chosen.reserve(share);
+        if (share * 2 >= size) {
+            // Dense, select each pair in turn with the chance of filling the rest of the share.
+            std::uint64_t left = share;
+            for (std::uint64_t i = 0; i < size && left > 0; i++) {
+                if (random.Below(size - i) < left) {
+                    chosen.push_back(begin + i);
+                    left--;
+                }
+            }
+        } else {
+            // Sparse, draw the missing number again until the distinct draws fill the share.
+            while (chosen.size() < share) {
+                const std::size_t missing = share - chosen.size();
+                for (std::size_t i = 0; i < missing; i++) {
+                    chosen.push_back(begin + random.Below(size));
+                }
+                std::sort(chosen.begin(), chosen.end());
+                chosen.erase(std::unique(chosen.begin(), chosen.end()), chosen.end());
+            }
+        }
+
+        std::uint64_t row = rowOf(n, chosen.front());
+        std::uint64_t rowEnd = rowStart(n, row + 1);
+        std::vector<std::uint64_t>& out = edges[chunk];
+        out.reserve(chosen.size());
+        for (std::uint64_t index : chosen) {
+            while (index >= rowEnd) {
+                row++;
+                rowEnd = rowStart(n, row + 1);
+            }
+            out.push_back(pack(row, row + 1 + (index - rowStart(n, row))));
+        }
+    });
+
+    GeneratedGraph graph;
+    if (isDone) {
+        assemble(n, edges, pool, graph);
+        placeRandom(graph, n, seed);
+    }
+    return graph;
+}
+
+GeneratedGraph Generators::BarabasiAlbert(std::size_t n, std::size_t k, std::uint64_t seed, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("Generators::BarabasiAlbert");
+    if (k == 0) {
+        return Gnp(n, 0.0, seed, maxThreads, control);
+    }
+    if (n <= k + 1) {
+        return Complete(n, maxThreads, control);
+    }
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(threadCount);
+
+    // Edges are numbered: the complete graph on the first k + 1 vertices, then k for every vertex after, in order.
+    // Position 2e is the source of edge e and 2e + 1 its target.
+    std::vector<std::uint32_t> seedFrom;
+    std::vector<std::uint32_t> seedTo;
+    for (std::size_t i = 0; i <= k; i++) {
+        for (std::size_t j = i + 1; j <= k; j++) {
+            seedFrom.push_back(static_cast<std::uint32_t>(i));
+            seedTo.push_back(static_cast<std::uint32_t>(j));
+        }
+    }
+    const std::uint64_t seedEdges = seedFrom.size();
+    const std::uint64_t total = seedEdges + static_cast<std::uint64_t>(n - k - 1) * k;
+
+    // The target of a grown edge is the endpoint at a random position before its vertex's first edge. A source is known
+    // outright, a target of a grown edge is resolved the same way from further back, which ends in a step or two.
+    auto targetOf = [&](std::uint64_t edge) -> std::uint64_t {
+        while (true) {
+            const std::uint64_t vertex = k + 1 + (edge - seedEdges) / k;
+            const std::uint64_t first = seedEdges + (vertex - k - 1) * k;
+            const std::uint64_t position = scaleBelow(mix(seed ^ mix(edge)), 2 * first);
+            const std::uint64_t drawn = position / 2;
+            if (drawn < seedEdges) {
+                return position % 2 == 0 ? seedFrom[drawn] : seedTo[drawn];
+            }
+            if (position % 2 == 0) {
+                return k + 1 + (drawn - seedEdges) / k;
+            }
+            edge = drawn;
+        }
+    };
+
+    const std::size_t chunks = chunkCount(static_cast<double>(total), ChunkEdges);
+    EdgeChunks edges(chunks);
+    const bool isDone = run(pool, chunks, control, [&](std::size_t chunk) {
+        const std::uint64_t end = std::min<std::uint64_t>(total, (chunk + 1) * ChunkEdges);
+        std::vector<std::uint64_t>& out = edges[chunk];
+        out.reserve(end - chunk * ChunkEdges);
+        for (std::uint64_t edge = chunk * ChunkEdges; edge < end; edge++) {
+            if (edge < seedEdges) {
+                out.push_back(pack(seedFrom[edge], seedTo[edge]));
+            } else {
+                out.push_back(pack(k + 1 + (edge - seedEdges) / k, targetOf(edge)));
+            }
+        }
+    });
+
+    GeneratedGraph graph;
+    if (isDone) {
+        assemble(n, edges, pool, graph);
+        placeRandom(graph, n, seed);
+    }
+    return graph;
+}
+
+GeneratedGraph Generators::WattsStrogatz(std::size_t n, std::size_t k, double p, std::uint64_t seed, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("Generators::WattsStrogatz");
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(threadCount);
+
+    const std::size_t half = std::min(k / 2, n > 0 ? (n - 1) / 2 : 0);
+    const std::size_t perChunk = std::max<std::size_t>(1, ChunkEdges / std::max<std::size_t>(1, half));
+    const std::size_t chunks = chunkCount(static_cast<double>(n), static_cast<double>(perChunk));
+    EdgeChunks edges(chunks);
+    const bool isDone = run(pool, chunks, control, [&](std::size_t chunk) {
+        Stream random(seed, chunk);
+        const std::size_t end = std::min(n, (chunk + 1) * perChunk);
+        std::vector<std::uint64_t>& out = edges[chunk];
+        out.reserve((end - chunk * perChunk) * half);
+        for (std::size_t i = chunk * perChunk; i < end; i++) {
+            for (std::size_t j = 1; j <= half; j++) {
+                std::size_t target = (i + j) % n;
+                if (random.Unit() < p) {
+                    // Any vertex but i itself.
+                    target = random.Below(n - 1);
+                    target += target >= i;
+                }
+                out.push_back(pack(i, target));
+            }
+        }
+    });
+
+    GeneratedGraph graph;
+    if (isDone) {
+        assemble(n, edges, pool, graph);
+        placeCircle(graph, n);
+    }
+    return graph;
+}
+
+GeneratedGraph Generators::Geometric(std::size_t n, double radius, std::uint64_t seed, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("Generators::Geometric");
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(threadCount);
+
+    // The points, drawn in fixed chunks like the edges of the other generators.
+    std::vector<float> x(n);
+    std::vector<float> y(n);
+    const std::size_t pointChunks = chunkCount(static_cast<double>(n), ChunkEdges);
+    for (std::size_t chunk = 0; chunk < pointChunks; chunk++) {
+        pool.Submit([&, chunk]() {
+            Stream random(seed, chunk);
+            const std::size_t end = std::min(n, (chunk + 1) * ChunkEdges);
+            for (std::size_t v = chunk * ChunkEdges; v < end; v++) {
+                x[v] = static_cast<float>(random.Unit());
+                y[v] = static_cast<float>(random.Unit());
+            }
+        });
+    }
+    pool.Wait();
+
+    // Cells at least the radius wide, and no more of them than points.
+    const std::size_t side = static_cast<std::size_t>(std::clamp(std::floor(1.0 / std::max(radius, 1e-9)), 1.0, std::ceil(std::sqrt(static_cast<double>(std::max<std::size_t>(n, 1))))));
+    auto cellOf = [side](float value) {
+        return std::min(side - 1, static_cast<std::size_t>(value * static_cast<float>(side)));
+    };
+    std::vector<std::uint32_t> cellStart(side * side + 1, 0);
+    for (std::size_t v = 0; v < n; v++) {
+        cellStart[cellOf(y[v]) * side + cellOf(x[v]) + 1]++;
+    }
+    for (std::size_t cell = 0; cell < side * side; cell++) {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+    std::vector<std::uint32_t> members(n);
+    {
+        std::vector<std::uint32_t> cursor(cellStart.begin(), cellStart.end() - 1);
+        for (std::size_t v = 0; v < n; v++) {
+            members[cursor[cellOf(y[v]) * side + cellOf(x[v])]++] = static_cast<std::uint32_t>(v);
+        }
+    }
+
+    // Each pair of points is compared once, within a cell or across to the cells right of and below it.
+    const float limit = static_cast<float>(radius * radius);
+    const double expected = static_cast<double>(n) * static_cast<double>(n) / 2.0 * std::min(1.0, std::numbers::pi * radius * radius);
+    const std::size_t rowsPerChunk = std::max<std::size_t>(1, static_cast<std::size_t>(static_cast<double>(side) * ChunkEdges / std::max(1.0, expected)));
+    const std::size_t chunks = chunkCount(static_cast<double>(side), static_cast<double>(rowsPerChunk));
+    EdgeChunks edges(chunks);
+    const bool isDone = run(pool, chunks, control, [&](std::size_t chunk) {
+        static constexpr int Offsets[4][2] = { { 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 } };
+        std::vector<std::uint64_t>& out = edges[chunk];
+        const std::size_t endRow = std::min(side, (chunk + 1) * rowsPerChunk);
+        for (std::size_t row = chunk * rowsPerChunk; row < endRow; row++) {
+            for (std::size_t column = 0; column < side; column++) {
+                const std::size_t cell = row * side + column;
+                for (std::uint32_t a = cellStart[cell]; a < cellStart[cell + 1]; a++) {
+                    const std::uint32_t u = members[a];
+                    for (std::uint32_t b = a + 1; b < cellStart[cell + 1]; b++) {
+                        const std::uint32_t v = members[b];
+                        const float dx = x[u] - x[v];
+                        const float dy = y[u] - y[v];
+                        if (dx * dx + dy * dy <= limit) {
+                            out.push_back(pack(u, v));
+                        }
+                    }
+                    for (const auto& offset : Offsets) {
+                        const std::ptrdiff_t otherColumn = static_cast<std::ptrdiff_t>(column) + offset[0];
+                        const std::size_t otherRow = row + offset[1];
+                        if (otherColumn < 0 || otherColumn >= static_cast<std::ptrdiff_t>(side) || otherRow >= side) {
+                            continue;
+                        }
+                        const std::size_t other = otherRow * side + otherColumn;
+                        for (std::uint32_t b = cellStart[other]; b < cellStart[other + 1]; b++) {
+                            const std::uint32_t v = members[b];
+                            const float dx = x[u] - x[v];
+                            const float dy = y[u] - y[v];
+                            if (dx * dx + dy * dy <= limit) {
+                                out.push_back(pack(u, v));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    GeneratedGraph graph;
+    if (isDone) {
+        assemble(n, edges, pool, graph);
+        const float scale = std::sqrt(static_cast<float>(n));
+        graph.X.resize(n);
+        graph.Y.resize(n);
+        for (std::size_t v = 0; v < n; v++) {
+            graph.X[v] = x[v] * scale;
+            graph.Y[v] = y[v] * scale;
+        }
+    }
+    return graph;
+}
+
+const std::vector<Generators::Family>& Generators::GetFamilies(void) {
+    static const std::vector<Family> families = {
+        { "complete", { { "n", 12, 1, 65536, true } },
+            [](const std::vector<double>& values) { return values[0] * (values[0] - 1) / 2; },
+            [](const std::vector<double>& values, std::uint64_t, std::size_t maxThreads, JobControl* control) {
+                return Complete(static_cast<std::size_t>(values[0]), maxThreads, control);
+            } },
+        { "cycle", { { "n", 24, 1, 1e8, true } },
+            [](const std::vector<double>& values) { return values[0]; },
+            [](const std::vector<double>& values, std::uint64_t, std::size_t maxThreads, JobControl* control) {
+                return Cycle(static_cast<std::size_t>(values[0]), maxThreads, control);
+            } },
+        { "grid", { { "rows", 10, 1, 1e4, true }, { "columns", 10, 1, 1e4, true } },
+            [](const std::vector<double>& values) { return 2 * values[0] * values[1]; },
+            [](const std::vector<double>& values, std::uint64_t, std::size_t maxThreads, JobControl* control) {
+                return Grid(static_cast<std::size_t>(values[0]), static_cast<std::size_t>(values[1]), false, maxThreads, control);
+            } },
+        { "torus", { { "rows", 10, 1, 1e4, true }, { "columns", 10, 1, 1e4, true } },
+            [](const std::vector<double>& values) { return 2 * values[0] * values[1]; },
+            [](const std::vector<double>& values, std::uint64_t, std::size_t maxThreads, JobControl* control) {
+                return Grid(static_cast<std::size_t>(values[0]), static_cast<std::size_t>(values[1]), true, maxThreads, control);
+            } },
+        { "hypercube", { { "dimension", 4, 0, 26, true } },
+            [](const std::vector<double>& values) { return values[0] * std::ldexp(1.0, static_cast<int>(values[0]) - 1); },
+            [](const std::vector<double>& values, std::uint64_t, std::size_t maxThreads, JobControl* control) {
+                return Hypercube(static_cast<std::size_t>(values[0]), maxThreads, control);
+            } },
+        { "bipartite", { { "left", 3, 0, 1e8, true }, { "right", 3, 0, 1e8, true } },
+            [](const std::vector<double>& values) { return std::max(values[0] * values[1], values[0] + values[1]); },
+            [](const std::vector<double>& values, std::uint64_t, std::size_t maxThreads, JobControl* control) {
+                return CompleteBipartite(static_cast<std::size_t>(values[0]), static_cast<std::size_t>(values[1]), maxThreads, control);
+            } },
+        { "gnp", { { "n", 1000, 1, 1e8, true }, { "p", 0.005, 0, 1, false } },
+            [](const std::vector<double>& values) { return std::max(values[1] * values[0] * (values[0] - 1) / 2, values[0]); },
+            [](const std::vector<double>& values, std::uint64_t seed, std::size_t maxThreads, JobControl* control) {
+                return Gnp(static_cast<std::size_t>(values[0]), values[1], seed, maxThreads, control);
+            } },
+        { "gnm", { { "n", 1000, 1, 1e8, true }, { "m", 2500, 0, MaxEdges, true } },
+            [](const std::vector<double>& values) { return std::max(values[1], values[0]); },
+            [](const std::vector<double>& values, std::uint64_t seed, std::size_t maxThreads, JobControl* control) {
+                return Gnm(static_cast<std::size_t>(values[0]), static_cast<std::size_t>(values[1]), seed, maxThreads, control);
+            } },
+        { "barabasi_albert", { { "n", 1000, 1, 1e8, true }, { "k", 2, 1, 1000, true } },
+            [](const std::vector<double>& values) { return values[0] * values[1]; },
+            [](const std::vector<double>& values, std::uint64_t seed, std::size_t maxThreads, JobControl* control) {
+                return BarabasiAlbert(static_cast<std::size_t>(values[0]), static_cast<std::size_t>(values[1]), seed, maxThreads, control);
+            } },
+        { "watts_strogatz", { { "n", 1000, 1, 1e8, true }, { "k", 4, 2, 1000, true }, { "p", 0.1, 0, 1, false } },
+            [](const std::vector<double>& values) { return values[0] * std::max(1.0, values[1] / 2); },
+            [](const std::vector<double>& values, std::uint64_t seed, std::size_t maxThreads, JobControl* control) {
+                return WattsStrogatz(static_cast<std::size_t>(values[0]), static_cast<std::size_t>(values[1]), values[2], seed, maxThreads, control);
+            } },
+        { "geometric", { { "n", 1000, 1, 1e8, true }, { "radius", 0.05, 0, 1.5, false } },
+            [](const std::vector<double>& values) {
+                return std::max(values[0] * values[0] / 2 * std::min(1.0, std::numbers::pi * values[1] * values[1]), values[0]);
+            },
+            [](const std::vector<double>& values, std::uint64_t seed, std::size_t maxThreads, JobControl* control) {
+                return Geometric(static_cast<std::size_t>(values[0]), values[1], seed, maxThreads, control);
+            } },
+    };
+    return families;
+}
+
+bool Generators::Check(const Family& family, const std::vector<double>& values, std::string& error) {
+    if (values.size() != family.Parameters.size()) {
+        error = std::string(family.Name) + " takes " + std::to_string(family.Parameters.size()) + " parameters";
+        return false;
+    }
+    for (std::size_t i = 0; i < values.size(); i++) {
+        const Parameter& parameter = family.Parameters[i];
+        if (!(values[i] >= parameter.Min && values[i] <= parameter.Max) || (parameter.IsInteger && values[i] != std::floor(values[i]))) {
+            std::ostringstream message;
+            message << parameter.Name << " must be " << (parameter.IsInteger ? "a whole number " : "") << "from " << parameter.Min << " to " << parameter.Max;
+            error = message.str();
+            return false;
+        }
+    }
+    if (family.EstimateEdges(values) > MaxEdges) {
+        error = "too large, more than " + std::to_string(static_cast<std::uint64_t>(MaxEdges)) + " edges";
+        return false;
+    }
+    return true;
+}
+
+const Generators::Family* Generators::Parse(const std::string& spec, std::vector<double>& values, std::string& error) {
+    const std::size_t colon = spec.find(':');
+    const std::string name = spec.substr(0, colon);
+    const std::vector<Family>& families = GetFamilies();
+    auto found = std::find_if(families.begin(), families.end(), [&name](const Family& family) {
+        return name == family.Name;
+    });
+    if (found == families.end()) {
+        error = "unknown family '" + name + "'";
+        return nullptr;
+    }
+
+    values.clear();
+    for (const Parameter& parameter : found->Parameters) {
+        values.push_back(parameter.Default);
+    }
+    if (colon != std::string::npos) {
+        std::istringstream pairs(spec.substr(colon + 1));
+        std::string pair;
+        while (std::getline(pairs, pair, ',')) {
+            const std::size_t equals = pair.find('=');
+            const std::string key = pair.substr(0, equals);
+            auto parameter = std::find_if(found->Parameters.begin(), found->Parameters.end(), [&key](const Parameter& candidate) {
+                return key == candidate.Name;
+            });
+            if (parameter == found->Parameters.end() || equals == std::string::npos) {
+                error = "unknown parameter '" + key + "' for " + found->Name;
+                return nullptr;
+            }
+            const std::string text = pair.substr(equals + 1);
+            char* end = nullptr;
+            const double value = std::strtod(text.c_str(), &end);
+            if (text.empty() || *end != '\0') {
+                error = "bad value '" + text + "' for " + key;
+                return nullptr;
+            }
+            values[parameter - found->Parameters.begin()] = value;
+        }
+    }
+    return Check(*found, values, error) ? &*found : nullptr;
+}
+
+bool Generators::run(ThreadPool& pool, std::size_t chunks, JobControl* control, const std::function<void(std::size_t chunk)>& body) {
+    std::atomic<std::size_t> done = 0;
+    for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+        pool.Submit([&body, &done, control, chunks, chunk]() {
+            if (control && control->IsCancelled()) {
+                return;
+            }
+            body(chunk);
+            if (control) {
+                control->SetProgress(static_cast<float>(++done) / static_cast<float>(chunks));
+            }
+        });
+    }
+    pool.Wait();
+    return !(control && control->IsCancelled());
+}
+
+void Generators::assemble(std::size_t n, EdgeChunks& chunks, ThreadPool& pool, GeneratedGraph& graph) {
+    PROFILE_ZONE("Generators::assemble");
+    const std::size_t buckets = chunkCount(static_cast<double>(n), BucketVertices);
+    auto forBuckets = [&](const std::function<void(std::size_t bucket, std::size_t begin, std::size_t end)>& body) {
+        for (std::size_t bucket = 0; bucket < buckets; bucket++) {
+            pool.Submit([&body, bucket, n]() {
+                body(bucket, bucket * BucketVertices, std::min(n, (bucket + 1) * BucketVertices));
+            });
+        }
+        pool.Wait();
+    };
+
+    // Count the edges of every chunk at both ends by the bucket of vertices each end falls in, self loops dropped.
+    std::vector<std::uint64_t> starts(chunks.size() * buckets + 1, 0);
+    for (std::size_t chunk = 0; chunk < chunks.size(); chunk++) {
+        pool.Submit([&chunks, &starts, buckets, chunk]() {
+            for (std::uint64_t edge : chunks[chunk]) {
+                const std::uint64_t from = edge >> 32;
+                const std::uint64_t to = edge & 0xffffffffull;
+                if (from != to) {
+                    starts[(from / BucketVertices) * chunks.size() + chunk + 1]++;
+                    starts[(to / BucketVertices) * chunks.size() + chunk + 1]++;
+                }
+            }
+        });
+    }
+    pool.Wait();
+    for (std::size_t i = 1; i < starts.size(); i++) {
+        starts[i] += starts[i - 1];
+    }
+
+    // Partition them by bucket, both ways round, freeing each chunk once done. Each chunk writes to a handful of
+    // running positions rather than all over the rows, which keeps the writes in cache.
+    std::vector<std::uint64_t> partitioned(starts.back());
+    for (std::size_t chunk = 0; chunk < chunks.size(); chunk++) {
+        pool.Submit([&chunks, &starts, &partitioned, buckets, chunk]() {
+            std::vector<std::uint64_t> cursor(buckets);
+            for (std::size_t bucket = 0; bucket < buckets; bucket++) {
+                cursor[bucket] = starts[bucket * chunks.size() + chunk];
+            }
+            for (std::uint64_t edge : chunks[chunk]) {
+                const std::uint64_t from = edge >> 32;
+                const std::uint64_t to = edge & 0xffffffffull;
+                if (from != to) {
+                    partitioned[cursor[from / BucketVertices]++] = edge;
+                    partitioned[cursor[to / BucketVertices]++] = pack(to, from);
+                }
+            }
+            std::vector<std::uint64_t>().swap(chunks[chunk]);
+        });
+    }
+    pool.Wait();
+
+    // A bucket's entries are exactly its rows, so each bucket lays out, sorts and strips the duplicates from its own
+    // rows, which appear in both rows alike, keeping the row lengths.
+    std::vector<std::uint64_t> offsets(n + 1, 0);
+    std::vector<std::uint64_t> lengths(n, 0);
+    std::vector<VertexId> targets(partitioned.size());
+    forBuckets([&](std::size_t bucket, std::size_t begin, std::size_t end) {
+        const std::uint64_t first = starts[bucket * chunks.size()];
+        const std::uint64_t last = starts[(bucket + 1) * chunks.size()];
+        std::vector<std::uint64_t> cursor(end - begin + 1, 0);
+        cursor[0] = first;
+        for (std::uint64_t i = first; i < last; i++) {
+            cursor[(partitioned[i] >> 32) - begin + 1]++;
+        }
+        for (std::size_t v = begin; v < end; v++) {
+            cursor[v - begin + 1] += cursor[v - begin];
+            offsets[v] = cursor[v - begin];
+        }
+        for (std::uint64_t i = first; i < last; i++) {
+            targets[cursor[(partitioned[i] >> 32) - begin]++] = static_cast<VertexId>(partitioned[i] & 0xffffffffull);
+        }
+        for (std::size_t v = begin; v < end; v++) {
+            auto rowBegin = targets.begin() + offsets[v];
+            auto rowEnd = targets.begin() + cursor[v - begin];
+            std::sort(rowBegin, rowEnd);
+            lengths[v] = std::unique(rowBegin, rowEnd) - rowBegin;
+        }
+    });
+    offsets[n] = partitioned.size();
+    std::vector<std::uint64_t>().swap(partitioned);
+
+    std::vector<std::uint64_t> compact(n + 1, 0);
+    for (std::size_t v = 0; v < n; v++) {
+        compact[v + 1] = compact[v] + lengths[v];
+    }
+    std::vector<Neighbor> entries(compact[n]);
+    forBuckets([&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t v = begin; v < end; v++) {
+            for (std::uint64_t i = 0; i < lengths[v]; i++) {
+                entries[compact[v] + i] = { targets[offsets[v] + i], 1.0f };
+            }
+        }
+    });
+    std::vector<VertexId>().swap(targets);
+
+    graph.Topology.Assign(compact, entries);
+}
+
+void Generators::placeCircle(GeneratedGraph& graph, std::size_t n) {
+    const double radius = std::max(1.0, static_cast<double>(n) / (2.0 * std::numbers::pi));
+    graph.X.resize(n);
+    graph.Y.resize(n);
+    for (std::size_t v = 0; v < n; v++) {
+        const double angle = 2.0 * std::numbers::pi * static_cast<double>(v) / static_cast<double>(n);
+        graph.X[v] = static_cast<float>(radius * std::cos(angle));
+        graph.Y[v] = static_cast<float>(radius * std::sin(angle));
+    }
+}
+
+void Generators::placeGrid(GeneratedGraph& graph, std::size_t n, std::size_t columns) {
+    graph.X.resize(n);
+    graph.Y.resize(n);
+    for (std::size_t v = 0; v < n; v++) {
+        graph.X[v] = static_cast<float>(v % columns);
+        graph.Y[v] = static_cast<float>(v / columns);
+    }
+}
+
+void Generators::placeRandom(GeneratedGraph& graph, std::size_t n, std::uint64_t seed) {
+    // A stream of its own, so the layout does not shift with the edges drawn.
+    Stream random(~seed, 0);
+    const float side = std::sqrt(static_cast<float>(n));
+    graph.X.resize(n);
+    graph.Y.resize(n);
+    for (std::size_t v = 0; v < n; v++) {
+        graph.X[v] = static_cast<float>(random.Unit()) * side;
+        graph.Y[v] = static_cast<float>(random.Unit()) * side;
+    }
+}
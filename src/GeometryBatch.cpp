@@ -0,0 +1,106 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "pch.hpp"
+#include "GeometryBatch.hpp"
+#include "Profiler.hpp"
+
+GeometryBatch::GeometryBatch(std::size_t verticesPerPrimitive) : m_buffer(sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Dynamic) {
+    m_allDirty = false;
+    m_capacity = 0;
+    m_count = 0;
+    m_useBuffer = sf::VertexBuffer::isAvailable();
+    m_verticesPerPrimitive = verticesPerPrimitive;
+}
+
+void GeometryBatch::Draw(sf::RenderTarget *target, const Writer& write) {
+    if (m_count == 0) {
+        m_dirty.clear();
+        m_allDirty = false;
+        return;
+    }
+
+    // A full rebuild, or just the dirty primitives in order without duplicates.
+    if (m_allDirty) {
+        m_dirty.clear();
+        for (std::size_t i = 0; i < m_count; i++) {
+            write(i, &m_staging[i * m_verticesPerPrimitive]);
+        }
+    } else {
+        std::sort(m_dirty.begin(), m_dirty.end());
+        m_dirty.erase(std::unique(m_dirty.begin(), m_dirty.end()), m_dirty.end());
+        while (!m_dirty.empty() && m_dirty.back() >= m_count) {
+            m_dirty.pop_back();
+        }
+        for (std::size_t i : m_dirty) {
+            write(i, &m_staging[i * m_verticesPerPrimitive]);
+        }
+    }
+
+    // A new buffer has no contents so everything goes up, otherwise one upload per run of neighbouring primitives.
+    if (m_useBuffer) {
+        if (m_staging.size() > m_capacity) {
+            m_capacity = std::max(m_staging.size(), m_capacity * 2);
+            m_useBuffer = m_buffer.create(m_capacity);
+            m_allDirty = true;
+        }
+        if (m_useBuffer && m_allDirty) {
+            upload(0, m_count);
+        } else if (m_useBuffer) {
+            std::size_t first = 0;
+            for (std::size_t i = 1; i <= m_dirty.size(); i++) {
+                if (i == m_dirty.size() || m_dirty[i] != m_dirty[i - 1] + 1) {
+                    upload(m_dirty[first], m_dirty[i - 1] + 1);
+                    first = i;
+                }
+            }
+        }
+    }
+    m_dirty.clear();
+    m_allDirty = false;
+
+    // Without vertex buffers the staged copy is sent every frame, still in one call.
+    Profiler::CountDrawCall();
+    if (!m_useBuffer) {
+        target->draw(m_staging.data(), m_staging.size(), sf::PrimitiveType::Triangles);
+        return;
+    }
+    target->draw(m_buffer, 0, m_staging.size());
+}
+
+std::size_t GeometryBatch::GetCount(void) const {
+    return m_count;
+}
+
+void GeometryBatch::Invalidate(std::size_t index) {
+    if (m_allDirty) {
+        return;
+    }
+
+    // Edits piling up between draws collapse into a full rebuild rather than an ever growing list.
+    if (m_dirty.size() >= m_count) {
+        InvalidateAll();
+        return;
+    }
+    m_dirty.push_back(index);
+}
+
+void GeometryBatch::InvalidateAll(void) {
+    m_allDirty = true;
+    m_dirty.clear();
+}
+
+void GeometryBatch::Resize(std::size_t count) {
+    for (std::size_t i = m_count; i < count; i++) {
+        Invalidate(i);
+    }
+    m_count = count;
+    m_staging.resize(count * m_verticesPerPrimitive);
+}
+
+void GeometryBatch::upload(std::size_t first, std::size_t last) {
+    const std::size_t offset = first * m_verticesPerPrimitive;
+    m_buffer.update(m_staging.data() + offset, (last - first) * m_verticesPerPrimitive, static_cast<unsigned>(offset));
+}
@@ -5,244 +5,1209 @@
 
 #include "pch.hpp"
 #include "Graph.hpp"
+#include "Logger.hpp"
+#include "Profiler.hpp"
+#include "SpanningTrees.hpp"
 
-Graph::Graph(bool isDirected) {
+Graph::Graph(bool isDirected) : m_edgeBatch(EdgeVertices), m_edgeGrid(LongEdgeLength * 0.5f), m_incidentEdges(&m_incidencePool), m_vertexBatch(VertexVertices) {
     m_isDirected = isDirected;
+    m_topology = AdjacencyStore(isDirected);
     IsActive = false;
     Color = sf::Color::Black;
     Name = "";
+    TintComponents = false;
+    m_drawnColor = Color;
+    m_drawnComponents = 0;
+    m_boundsDirty = true;
+    m_historyBytes = 0;
+    m_isReplaying = false;
+    m_removals = 0;
+    m_revision = 0;
 }
 
-void Graph::AddVertex(std::string name, sf::Vector2f position) {
-    // Create a new vertex.
-    Vertex newVertex = { name, position, sf::CircleShape() };
-    newVertex.Sprite.setOutlineColor(Color);
-    newVertex.Sprite.setOutlineThickness(2.0f);
-    newVertex.VertexColor = 0;
-    std::cout << "Added vertex: " << name << " at position (" << position.x << ", " << position.y << ")" << std::endl;
+VertexId Graph::AddVertex(std::string name, sf::Vector2f position) {
+    LOG_DEBUG("Added vertex: " << name << " at position (" << position.x << ", " << position.y << ")");
 
-    // Add vertex to the list.
-    m_vertices.push_back(newVertex);
+    // Add vertex to the arrays, its id is its slot in them, the topology and the batch alike.
+    VertexId id = m_topology.AddVertex();
+    m_positions.push_back(position);
+    m_vertexColors.push_back(0);
+    m_vertexFlags.push_back(0);
+    m_vertexNames.push_back(m_names.Intern(name));
+    m_incidentEdges.emplace_back();
+    m_vertexHandles.push_back(allocateHandle(id));
+    m_grid.Insert(id, position);
+    m_vertexBatch.Resize(m_positions.size());
+    growBounds(position);
+    m_revision++;
+    record({ GraphFile::LogAddVertex, id, InvalidVertexId, 0.0f, position.x, position.y, name });
+    journal({ GraphChange::AddedVertex, id, InvalidVertexId, 0.0f, 0.0f, position, position, { std::move(name), position, false, false, 0 }, {} });
+    return id;
+}
 
-    // Keep adjacency matrix square and in-bounds
-    const std::size_t n = m_vertices.size();
+void Graph::AddEdge(VertexId vertex1, VertexId vertex2, float weight) {
+    LOG_DEBUG("Added edge from { " << m_positions[vertex1].x << ", " << m_positions[vertex1].y << " } to { " << m_positions[vertex2].x << ", " << m_positions[vertex2].y << " } with weight " << weight);
 
-    // Update adjacency matrix size.
-    AdjacencyMatrix.resize(n);
+    ClearHighlight();
+    m_revision++;
+    record({ GraphFile::LogAddEdge, vertex1, vertex2, weight, 0.0f, 0.0f, "" });
 
-    for (auto& row : AdjacencyMatrix) {
-        row.resize(n, 0.0f);
+    // Update the topology, an existing edge only has its weight changed.
+    const float oldWeight = m_topology.GetWeight(vertex1, vertex2);
+    if (!m_topology.AddEdge(vertex1, vertex2, weight)) {
+        std::size_t index = findEdge(vertex1, vertex2);
+        if (index < m_edgeWeights.size()) {
+            m_edgeWeights[index] = weight;
+        }
+        journal({ GraphChange::ChangedWeight, vertex1, vertex2, oldWeight, weight, {}, {}, {}, {} });
+        return;
     }
+    journal({ GraphChange::AddedEdge, vertex1, vertex2, 0.0f, weight, {}, {}, {}, {} });
+
+    // Add edge to the arrays.
+    std::uint32_t index = static_cast<std::uint32_t>(m_edgeFirst.size());
+    m_edgeFirst.push_back(vertex1);
+    m_edgeSecond.push_back(vertex2);
+    m_edgeWeights.push_back(weight);
+    m_incidentEdges[vertex1].push_back(index);
+    if (vertex2 != vertex1) {
+        m_incidentEdges[vertex2].push_back(index);
+    }
+    indexEdge(index);
+    m_edgeBatch.Resize(m_edgeFirst.size());
 }
 
-void Graph::AddEdge(Vertex& vertex1, Vertex& vertex2, float weight) {
-    // Create a new edge.
-    Edge newEdge = { &vertex1, &vertex2, weight, sf::RectangleShape() };
-    std::cout << "Added edge from { " << vertex1.Position.x << ", " << vertex1.Position.y << " } to { " << vertex2.Position.x << ", " << vertex2.Position.y << " } with weight " << weight << std::endl;
+void Graph::ApplyBipartite(const BipartiteResult& result) {
+    // Sides of bipartite components become colors 1 and 2, everything else is reset.
+    std::fill(m_vertexColors.begin(), m_vertexColors.end(), 0);
+    for (const BipartiteComponent& component : result.Components) {
+        for (VertexId id : component.Left) {
+            m_vertexColors[id] = 1;
+        }
+        for (VertexId id : component.Right) {
+            m_vertexColors[id] = 2;
+        }
+    }
+    m_vertexBatch.InvalidateAll();
+    m_revision++;
+
+    // Show the odd cycle on the canvas.
+    if (result.IsBipartite) {
+        ClearHighlight();
+    } else {
+        SetHighlight(result.OddCycle, true);
+    }
+}
 
-    // Update adjacency matrix.
-    AdjacencyMatrix[&vertex1 - &m_vertices[0]][&vertex2 - &m_vertices[0]] = weight;
-    if (!m_isDirected) {
-        AdjacencyMatrix[&vertex2 - &m_vertices[0]][&vertex1 - &m_vertices[0]] = weight;
+void Graph::ApplyColoring(const ColoringResult& result) {
+    for (VertexId id = 0; id < m_vertexColors.size(); id++) {
+        m_vertexColors[id] = result.Colors[id];
     }
+    m_vertexBatch.InvalidateAll();
+    m_revision++;
+    ClearHighlight();
+}
 
-    // Add edge to the list.
-    m_edges.push_back(newEdge);
+BipartiteResult Graph::CalculateBipartite(void) {
+    BipartiteResult result = Bipartite::Check(m_topology);
+    ApplyBipartite(result);
+    return result;
 }
 
-bool Graph::CalculateBipartite(void) {
-    for (int i = 0; i < m_vertices.size(); i++) {
-        for (int j = 0; j < m_vertices.size(); j++) {
-            if (AdjacencyMatrix[i][j] != 0) {
-                if (m_vertices[i].VertexColor == 0 && m_vertices[j].VertexColor == 0) {
-                    m_vertices[i].VertexColor = 1;
-                    m_vertices[j].VertexColor = 2;
-                } else if (m_vertices[i].VertexColor == 0 && m_vertices[j].VertexColor != 0) {
-                    m_vertices[i].VertexColor = (m_vertices[j].VertexColor == 1) ? 2 : 1;
-                } else if (m_vertices[i].VertexColor != 0 && m_vertices[j].VertexColor == 0){
-                    m_vertices[j].VertexColor = (m_vertices[i].VertexColor == 1) ? 2 : 1;
-                }
-            }
+BigUnsigned Graph::CalculateNumberOfSpanningTrees(void) {
+    return SpanningTrees::Count(m_topology);
+}
+
+bool Graph::CanRedo(void) const {
+    return !m_redo.empty();
+}
+
+bool Graph::CanUndo(void) const {
+    return !m_history.empty();
+}
+
+void Graph::ClearColoring(void) {
+    std::fill(m_vertexColors.begin(), m_vertexColors.end(), 0);
+    m_vertexBatch.InvalidateAll();
+    m_revision++;
+}
+
+void Graph::ClearHighlight(void) {
+    if (m_highlightedVertices.empty() && m_highlightedEdges.empty()) {
+        return;
+    }
+
+    m_revision++;
+    for (VertexId id : m_highlightedVertices) {
+        m_vertexBatch.Invalidate(id);
+    }
+    for (std::uint64_t key : m_highlightedEdges) {
+        invalidateEdges(key);
+    }
+    m_highlightedEdges.clear();
+    m_highlightedVertices.clear();
+}
+
+bool Graph::Compact(void) {
+    if (m_removals < std::max(CompactionRemovals, (m_positions.size() + m_edgeFirst.size()) / 4)) {
+        return false;
+    }
+
+    // Growth alone leaves at most half of a list empty, anything emptier lost entries to removals. The contents
+    // and the topology's version stay the same, so snapshots and caches remain valid.
+    PROFILE_ZONE("Graph::Compact");
+    m_removals = 0;
+    auto shrink = [](auto& list) {
+        if (list.capacity() > 2 * list.size()) {
+            list.shrink_to_fit();
         }
+    };
+    m_topology.ShrinkToFit();
+    for (std::pmr::vector<std::uint32_t>& incident : m_incidentEdges) {
+        shrink(incident);
+    }
+    shrink(m_incidentEdges);
+    shrink(m_edgeFirst);
+    shrink(m_edgeSecond);
+    shrink(m_edgeWeights);
+    shrink(m_positions);
+    shrink(m_vertexColors);
+    shrink(m_vertexFlags);
+    shrink(m_vertexHandles);
+    shrink(m_vertexNames);
+    return true;
+}
+
+void Graph::Draw(sf::RenderTarget *target, const sf::FloatRect& visible, float pixelSize) {
+    PROFILE_ZONE("Graph::Draw");
+    if (m_positions.empty()) {
+        return;
+    }
+
+    // The graph color is edited directly by the sidebar, a change rebuilds everything once.
+    if (Color != m_drawnColor) {
+        m_edgeBatch.InvalidateAll();
+        m_vertexBatch.InvalidateAll();
+        m_drawnColor = Color;
+    }
+
+    // Tints follow merges and splits of components, which can reach vertices far from the edit.
+    const std::uint64_t components = TintComponents ? m_topology.GetComponentVersion() : 0;
+    if (components != m_drawnComponents) {
+        m_vertexBatch.InvalidateAll();
+        m_drawnComponents = components;
+    }
+    if (m_boundsDirty) {
+        updateBounds();
+    }
+
+    // Grown by the vertex size so partly visible vertices count.
+    const float margin = VertexRadius + VertexOutline;
+    const sf::FloatRect area(visible.position - sf::Vector2f(margin, margin), visible.size + sf::Vector2f(2.0f * margin, 2.0f * margin));
+    const bool isCoarse = margin / pixelSize < CoarseRadius;
+
+    // With every vertex in view every edge is too, draw the cached batches, edges first so vertices cover their ends.
+    const sf::Vector2f boundsEnd = m_bounds.position + m_bounds.size;
+    const sf::Vector2f areaEnd = area.position + area.size;
+    const bool isInside = m_bounds.position.x >= area.position.x && m_bounds.position.y >= area.position.y && boundsEnd.x <= areaEnd.x && boundsEnd.y <= areaEnd.y;
+    if (isInside && !isCoarse) {
+        m_edgeBatch.Draw(target, [this](std::size_t index, sf::Vertex* vertices) {
+            buildEdge(index, vertices);
+        });
+        m_vertexBatch.Draw(target, [this](std::size_t index, sf::Vertex* vertices) {
+            buildVertex(static_cast<VertexId>(index), vertices);
+        });
+        return;
+    }
+
+    // Otherwise only what the indices find in view, the batches stay dirty until they are drawn again.
+    m_visibleVertices.clear();
+    m_grid.FindIn(area, m_visibleVertices);
+    collectEdges(visible, m_visibleEdges);
+    if (isCoarse) {
+        drawCoarse(target, pixelSize);
+    } else {
+        drawDetailed(target);
+    }
+}
+
+std::vector<std::vector<float>> Graph::GetAdjacencyMatrix(void) const {
+    return m_topology.GetDenseMatrix();
+}
+
+std::optional<Edge> Graph::GetEdgeAt(sf::Vector2f position) const {
+    // The candidates from the edge index, then the closest of them by distance to the segment.
+    std::vector<VertexId> indices;
+    collectEdges(sf::FloatRect(position - sf::Vector2f(VertexRadius, VertexRadius), sf::Vector2f(2.0f * VertexRadius, 2.0f * VertexRadius)), indices);
+    std::optional<Edge> closest;
+    float closestDistance = VertexRadius * VertexRadius;
+    for (VertexId index : indices) {
+        sf::Vector2f from = m_positions[m_edgeFirst[index]];
+        sf::Vector2f dir = m_positions[m_edgeSecond[index]] - from;
+        sf::Vector2f offset = position - from;
+        float length = dir.x * dir.x + dir.y * dir.y;
+        float t = length > 0.0f ? std::clamp((offset.x * dir.x + offset.y * dir.y) / length, 0.0f, 1.0f) : 0.0f;
+        offset -= dir * t;
+        float distance = offset.x * offset.x + offset.y * offset.y;
+        if (distance <= closestDistance) {
+            closest = edgeAt(index);
+            closestDistance = distance;
+        }
+    }
+
+    return closest;
+}
+
+float Graph::GetEdgeWeight(VertexId v1, VertexId v2) const {
+    return m_topology.GetWeight(v1, v2);
+}
+
+VertexHandle Graph::GetHandle(VertexId id) const {
+    return { m_vertexHandles[id], m_handles[m_vertexHandles[id]].Generation };
+}
+
+sf::Vector2f Graph::GetPosition(VertexId id) const {
+    return m_positions[id];
+}
+
+std::uint64_t Graph::GetRevision(void) const {
+    return m_revision;
+}
+
+std::shared_ptr<const AdjacencyStore> Graph::GetSnapshot(void) const {
+    if (!m_snapshot || m_snapshot->GetVersion() != m_topology.GetVersion()) {
+        // Build the lazy views before sharing, after that readers never write.
+        std::shared_ptr<AdjacencyStore> snapshot = std::make_shared<AdjacencyStore>(m_topology);
+        snapshot->GetCSR();
+        snapshot->GetSymmetricCSR();
+        snapshot->GetComponentCount();
+        m_snapshot = std::move(snapshot);
+    }
+
+    return m_snapshot;
+}
+
+const AdjacencyStore& Graph::GetTopology(void) const {
+    return m_topology;
+}
+
+VertexId Graph::GetVertexAt(sf::Vector2f position) const {
+    // The hit box is the bounding square of the vertex, outline included.
+    return m_grid.FindAt(position, VertexRadius + VertexOutline);
+}
+
+int Graph::GetVertexColor(VertexId id) const {
+    return m_vertexColors[id];
+}
+
+std::string_view Graph::GetVertexName(VertexId id) const {
+    return m_names.Get(m_vertexNames[id]);
+}
+
+void Graph::GetVerticesIn(const sf::FloatRect& rect, std::vector<VertexId>& ids) const {
+    m_grid.FindIn(rect, ids);
+}
+
+void Graph::Import(AdjacencyStore topology) {
+    // Imported graphs have no positions, start them on a square grid.
+    const std::size_t n = topology.GetVertexCount();
+    const std::size_t columns = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(n)))));
+    std::vector<sf::Vector2f> positions(n);
+    for (VertexId id = 0; id < n; id++) {
+        positions[id] = { (id % columns) * ImportSpacing, (id / columns) * ImportSpacing };
+    }
+    assign(std::move(topology), std::move(positions));
+    m_path.clear();
+}
+
+void Graph::Import(AdjacencyStore topology, const std::vector<float>& x, const std::vector<float>& y) {
+    const std::size_t n = topology.GetVertexCount();
+    std::vector<sf::Vector2f> positions(n);
+    for (VertexId id = 0; id < n; id++) {
+        positions[id] = { x[id] * ImportSpacing, y[id] * ImportSpacing };
+    }
+    assign(std::move(topology), std::move(positions));
+    m_path.clear();
+}
+
+bool Graph::Load(const std::filesystem::path& path, std::string& error) {
+    GraphFile file;
+    AdjacencyStore topology;
+    if (!file.Open(path, error) || !file.Load(topology, error)) {
+        return false;
     }
 
-    // Verify bipartiteness.
-    for (int i = 0; i < m_vertices.size(); i++) {
-        for (int j = 0; j < m_vertices.size(); j++) {
-            if (AdjacencyMatrix[i][j] != 0) {
-                if (m_vertices[i].VertexColor == m_vertices[j].VertexColor) {
-                    return false;
+    // Build everything in bulk from the mapping, the names are interned straight from it.
+    const std::size_t n = file.GetVertexCount();
+    std::vector<sf::Vector2f> positions(n);
+    for (VertexId id = 0; id < n; id++) {
+        GraphFile::VertexRecord saved = file.GetVertex(id);
+        positions[id] = { saved.X, saved.Y };
+    }
+    assign(std::move(topology), std::move(positions));
+    for (VertexId id = 0; id < n; id++) {
+        GraphFile::VertexRecord saved = file.GetVertex(id);
+        m_vertexColors[id] = saved.Color;
+        m_vertexNames[id] = m_names.Intern(saved.Name);
+    }
+    Color = sf::Color(file.GetColor());
+
+    // Edits since the last save, checked like any other input. Nothing is logged or journaled while they replay.
+    m_path.clear();
+    m_isReplaying = true;
+    for (const GraphFile::LogEntry& entry : file.GetLog()) {
+        switch (entry.Kind) {
+            case GraphFile::LogAddVertex:
+                AddVertex(entry.Name, { entry.X, entry.Y });
+                break;
+            case GraphFile::LogAddEdge:
+                if (entry.First < m_positions.size() && entry.Second < m_positions.size()) {
+                    AddEdge(entry.First, entry.Second, entry.Weight);
                 }
-            }
+                break;
+            case GraphFile::LogMoveVertex:
+                if (entry.First < m_positions.size()) {
+                    MoveVertex(entry.First, { entry.X, entry.Y });
+                }
+                break;
+            case GraphFile::LogRemoveVertex:
+                RemoveVertex(entry.First);
+                break;
+            case GraphFile::LogInsertVertex:
+                if (entry.First <= m_positions.size()) {
+                    insertVertex(entry.First, { entry.Name, { entry.X, entry.Y }, false, false, 0 });
+                }
+                break;
+            case GraphFile::LogRemoveEdge:
+                if (entry.First < m_positions.size() && entry.Second < m_positions.size()) {
+                    RemoveEdge(entry.First, entry.Second);
+                }
+                break;
         }
     }
+    m_isReplaying = false;
+    m_path = path;
 
-    // Reset the vertex colors for future calculations.
-    for (auto& vertex : m_vertices) {
-        vertex.VertexColor = 0;
+    return true;
+}
+
+bool Graph::IsLayoutRunning(void) const {
+    return m_layout != nullptr;
+}
+
+bool Graph::IsPinned(VertexId id) const {
+    return (m_vertexFlags[id] & PinnedFlag) != 0;
+}
+
+bool Graph::IsSelected(VertexId id) const {
+    return (m_vertexFlags[id] & SelectedFlag) != 0;
+}
+
+void Graph::MoveVertex(VertexId id, sf::Vector2f position) {
+    const sf::Vector2f from = m_positions[id];
+    placeVertex(id, position);
+    if (m_layout && id < m_layout->GetX().size()) {
+        m_layout->SetPosition(id, position.x, position.y);
+    }
+    m_revision++;
+    record({ GraphFile::LogMoveVertex, id, InvalidVertexId, 0.0f, position.x, position.y, "" });
+    journal({ GraphChange::MovedVertex, id, InvalidVertexId, 0.0f, 0.0f, from, position, {}, {} });
+}
+
+bool Graph::Redo(void) {
+    if (m_redo.empty()) {
+        return false;
     }
 
+    // Redone through the same calls that made the edit, so the file log and the geometry follow.
+    GraphChange change = std::move(m_redo.back());
+    m_redo.pop_back();
+    m_isReplaying = true;
+    switch (change.Type) {
+        case GraphChange::AddedVertex:
+            AddVertex(change.Data.Name, change.Data.Position);
+            m_vertexColors[change.Id] = change.Data.VertexColor;
+            break;
+        case GraphChange::AddedEdge:
+        case GraphChange::ChangedWeight:
+            AddEdge(change.Id, change.Other, change.NewWeight);
+            break;
+        case GraphChange::MovedVertex:
+            MoveVertex(change.Id, change.To);
+            break;
+        case GraphChange::RemovedEdge:
+            RemoveEdge(change.Id, change.Other);
+            break;
+        case GraphChange::RemovedVertex:
+            RemoveVertex(change.Id);
+            break;
+    }
+    m_isReplaying = false;
+    m_historyBytes += changeBytes(change);
+    m_history.push_back(std::move(change));
+
     return true;
 }
 
-int Graph::CalculateNumberOfSpanningTrees(void) {
-    // Create the Diagonal Matrix.
-    std::vector<int>  degreeCount;
-    for (std::size_t i = 0; i < AdjacencyMatrix.size(); i++) {
-        degreeCount.push_back(0);
-        for (std::size_t j = 0; j < AdjacencyMatrix.size(); j++) {
-            if (AdjacencyMatrix[i][j] != 0) {
-                degreeCount[i]++;
-            }
+bool Graph::RemoveEdge(VertexId v1, VertexId v2) {
+    std::size_t index = findEdge(v1, v2);
+    if (index >= m_edgeFirst.size()) {
+        return false;
+    }
+
+    const Edge edge = edgeAt(index);
+    ClearHighlight();
+    removeEdge(index);
+    m_removals++;
+    m_revision++;
+    record({ GraphFile::LogRemoveEdge, v1, v2, 0.0f, 0.0f, 0.0f, "" });
+    journal({ GraphChange::RemovedEdge, edge.Vertex1, edge.Vertex2, edge.Weight, 0.0f, {}, {}, {}, {} });
+    return true;
+}
+
+Vertex Graph::RemoveVertex(VertexId id) {
+    if (id >= m_positions.size()) {
+        return Vertex();
+    }
+    Vertex v = gatherVertex(id);
+
+    // The edges go into the history with the vertex, under the ids they have now.
+    GraphChange change = { GraphChange::RemovedVertex, id, InvalidVertexId, 0.0f, 0.0f, v.Position, v.Position, v, {} };
+    if (!m_isReplaying) {
+        change.Data.IsSelected = false;
+        change.Edges.reserve(m_incidentEdges[id].size());
+        for (std::uint32_t index : m_incidentEdges[id]) {
+            change.Edges.push_back(edgeAt(index));
         }
     }
 
-    std::vector<std::vector<float>> diagonalMatrix;
-    for (std::size_t i = 0; i < AdjacencyMatrix.size(); i++) {
-        diagonalMatrix.push_back(std::vector<float>(AdjacencyMatrix.size(), 0.0f));
-        diagonalMatrix[i][i] = static_cast<float>(degreeCount[i]);  
+    // Take out the edges one by one, then the vertex and its handle.
+    ClearHighlight();
+    m_removals += m_incidentEdges[id].size() + 1;
+    while (!m_incidentEdges[id].empty()) {
+        removeEdge(m_incidentEdges[id].back());
+    }
+    m_grid.Remove(id, v.Position);
+    HandleSlot& slot = m_handles[m_vertexHandles[id]];
+    slot.Id = InvalidVertexId;
+    slot.Generation++;
+    m_freeHandles.push_back(m_vertexHandles[id]);
+
+    // The last vertex fills the gap, so no other id changes.
+    const VertexId last = static_cast<VertexId>(m_positions.size() - 1);
+    if (id != last) {
+        relabelVertex(last, id);
     }
+    resizeVertices(last);
+    m_topology.PopVertex();
+    m_vertexBatch.Resize(m_positions.size());
+
+    m_revision++;
+    record({ GraphFile::LogRemoveVertex, id, InvalidVertexId, 0.0f, 0.0f, 0.0f, "" });
+    journal(std::move(change));
+    return v;
+}
+
+VertexId Graph::Resolve(VertexHandle handle) const {
+    if (handle.Slot >= m_handles.size() || m_handles[handle.Slot].Generation != handle.Generation) {
+        return InvalidVertexId;
+    }
+
+    return m_handles[handle.Slot].Id;
+}
+
+bool Graph::Save(const std::filesystem::path& path, std::string& error) {
+    bool isSaved = GraphFile::Save(path, m_topology, Color.toInteger(), [this](VertexId id) -> GraphFile::VertexRecord {
+        return { m_names.Get(m_vertexNames[id]), m_positions[id].x, m_positions[id].y, m_vertexColors[id] };
+    }, error);
+    if (isSaved) {
+        m_path = path;
+    }
+
+    return isSaved;
+}
 
-    // Create the Laplacian Matrix.
-    std::vector<std::vector<float>> laplacianMatrix;
-    for (std::size_t i = 0; i < AdjacencyMatrix.size(); i++) {
-        laplacianMatrix.push_back(std::vector<float>(AdjacencyMatrix.size(), 0.0f));
-        for (std::size_t j = 0; j < AdjacencyMatrix.size(); j++) {
-            laplacianMatrix[i][j] = diagonalMatrix[i][j] - AdjacencyMatrix[i][j];
+void Graph::SetHighlight(const std::vector<VertexId>& vertices, bool isClosed) {
+    ClearHighlight();
+    m_revision++;
+    for (std::size_t i = 0; i < vertices.size(); i++) {
+        m_highlightedVertices.insert(vertices[i]);
+        if (i + 1 < vertices.size()) {
+            m_highlightedEdges.insert(edgeKey(vertices[i], vertices[i + 1]));
+        } else if (isClosed) {
+            m_highlightedEdges.insert(edgeKey(vertices[i], vertices[0]));
         }
     }
 
-    // Convert L to L_k.
-    std::vector<std::vector<float>> minorMatrix;
-    for (std::size_t i = 0; i < laplacianMatrix.size() - 1; i++) {
-        minorMatrix.push_back(std::vector<float>());
-        for (std::size_t j = 0; j < laplacianMatrix.size() - 1; j++) {
-            minorMatrix[i].push_back(laplacianMatrix[i][j]);
-        }  
+    // Only the newly highlighted geometry is rebuilt.
+    for (VertexId id : m_highlightedVertices) {
+        m_vertexBatch.Invalidate(id);
+    }
+    for (std::uint64_t key : m_highlightedEdges) {
+        invalidateEdges(key);
     }
+}
 
-    // Calculate the determinant of L_k.
-    float determinant = 1;
-    int n = minorMatrix.size();
+void Graph::SetPinned(VertexId id, bool isPinned) {
+    setFlag(id, PinnedFlag, isPinned);
+    m_vertexBatch.Invalidate(id);
+    m_revision++;
+}
 
-    // Convert to upper triangular matrix.
-    for (int i = 0; i < n; i++) {
-        if (minorMatrix[i][i] == 0.0f) {
-            for (int j = i; j < n; j++) {
-                if (minorMatrix[j][i] != 0.0f) {
-                    std::swap(minorMatrix[i], minorMatrix[j]);
-                    determinant *= -1;
-                    break;
-                }
+void Graph::SetSelected(VertexId id, bool isSelected) {
+    setFlag(id, SelectedFlag, isSelected);
+    m_vertexBatch.Invalidate(id);
+    m_revision++;
+}
 
-                if (j == n - 1) {
-                    return 0;
-                }
+void Graph::StartLayout(void) {
+    if (!m_layout) {
+        m_layout = std::make_unique<ForceLayout>();
+    }
+    std::vector<float> x(m_positions.size());
+    std::vector<float> y(m_positions.size());
+    for (VertexId id = 0; id < m_positions.size(); id++) {
+        x[id] = m_positions[id].x;
+        y[id] = m_positions[id].y;
+    }
+    m_layout->Assign(m_topology, std::move(x), std::move(y));
+    m_layout->Heat();
+}
+
+bool Graph::StepLayout(std::size_t iterations, ThreadPool* pool) {
+    if (!m_layout) {
+        return false;
+    }
+
+    // Vertices added or removed meanwhile, the layout carries on from where they are now.
+    const std::size_t n = m_positions.size();
+    if (m_layout->GetVersion() != m_topology.GetVersion() || m_layout->GetX().size() != n) {
+        std::vector<float> x(n);
+        std::vector<float> y(n);
+        for (VertexId id = 0; id < n; id++) {
+            x[id] = m_positions[id].x;
+            y[id] = m_positions[id].y;
+        }
+        m_layout->Assign(m_topology, std::move(x), std::move(y));
+    }
+
+    // The selected vertex is held where the user put it.
+    for (VertexId id = 0; id < n; id++) {
+        m_layout->SetPinned(id, m_vertexFlags[id] != 0);
+    }
+    const bool isRunning = m_layout->Step(iterations, pool);
+
+    std::span<const float> x = m_layout->GetX();
+    std::span<const float> y = m_layout->GetY();
+    for (VertexId id = 0; id < n; id++) {
+        const sf::Vector2f position(x[id], y[id]);
+        if (position != m_positions[id]) {
+            placeVertex(id, position);
+        }
+    }
+    m_boundsDirty = true;
+    m_revision++;
+
+    if (!isRunning) {
+        StopLayout();
+    }
+
+    return isRunning;
+}
+
+void Graph::StopLayout(void) {
+    if (!m_layout) {
+        return;
+    }
+
+    m_layout.reset();
+    if (m_path.empty()) {
+        return;
+    }
+    // Written in batches, a file opened once per vertex would stall a large graph for seconds.
+    std::vector<GraphFile::LogEntry> entries;
+    entries.reserve(std::min(m_positions.size(), LayoutLogBatch));
+    for (VertexId id = 0; id < m_positions.size(); id++) {
+        const sf::Vector2f position = m_positions[id];
+        entries.push_back({ GraphFile::LogMoveVertex, id, InvalidVertexId, 0.0f, position.x, position.y, "" });
+        if (entries.size() == LayoutLogBatch || id + 1 == m_positions.size()) {
+            record(entries);
+            entries.clear();
+        }
+    }
+}
+
+bool Graph::Undo(void) {
+    if (m_history.empty()) {
+        return false;
+    }
+
+    // Each edit is reverted by the call that undoes it, never by restoring a copy of the graph.
+    GraphChange change = std::move(m_history.back());
+    m_history.pop_back();
+    m_historyBytes -= changeBytes(change);
+    m_isReplaying = true;
+    switch (change.Type) {
+        case GraphChange::AddedVertex:
+            RemoveVertex(change.Id);
+            break;
+        case GraphChange::AddedEdge:
+            RemoveEdge(change.Id, change.Other);
+            break;
+        case GraphChange::ChangedWeight:
+        case GraphChange::RemovedEdge:
+            AddEdge(change.Id, change.Other, change.OldWeight);
+            break;
+        case GraphChange::MovedVertex:
+            MoveVertex(change.Id, change.From);
+            break;
+        case GraphChange::RemovedVertex:
+            insertVertex(change.Id, change.Data);
+            for (const Edge& edge : change.Edges) {
+                AddEdge(edge.Vertex1, edge.Vertex2, edge.Weight);
             }
-        } 
+            break;
     }
+    m_isReplaying = false;
+    m_redo.push_back(std::move(change));
 
-    for (int i = 0; i < n; i++) {
-        for (int j = i + 1; j < n; j++) {
-            float factor = minorMatrix[j][i] / minorMatrix[i][i];
-            std::vector<float> tempRow = minorMatrix[i];
-            for (int k = 0; k < n; k++) {
-                tempRow[k] *= factor;
-                minorMatrix[j][k] = minorMatrix[j][k] - tempRow[k];
+    return true;
+}
+
+std::uint32_t Graph::allocateHandle(VertexId id) {
+    if (m_freeHandles.empty()) {
+        m_handles.push_back({ id, 0 });
+        return static_cast<std::uint32_t>(m_handles.size() - 1);
+    }
+
+    std::uint32_t slot = m_freeHandles.back();
+    m_freeHandles.pop_back();
+    m_handles[slot].Id = id;
+    return slot;
+}
+
+void Graph::assign(AdjacencyStore&& topology, std::vector<sf::Vector2f>&& positions) {
+    // A layout of the old graph means nothing for the new one.
+    m_layout.reset();
+
+    // The edge arrays come from the adjacency lists, an undirected edge is listed from both ends but kept once.
+    const std::size_t n = positions.size();
+    m_edgeFirst.clear();
+    m_edgeSecond.clear();
+    m_edgeWeights.clear();
+    m_edgeFirst.reserve(topology.GetEdgeCount());
+    m_edgeSecond.reserve(topology.GetEdgeCount());
+    m_edgeWeights.reserve(topology.GetEdgeCount());
+    for (VertexId v = 0; v < n; v++) {
+        for (const Neighbor& entry : topology.GetNeighbors(v)) {
+            if (topology.IsDirected() || v <= entry.Target) {
+                m_edgeFirst.push_back(v);
+                m_edgeSecond.push_back(entry.Target);
+                m_edgeWeights.push_back(entry.Weight);
             }
         }
     }
 
-    // Muliply diagonal elements to get determinant.
-    for (int i = 0; i < n; i++) {
-        determinant *= minorMatrix[i][i];
+    // The vertex arrays are filled in one go each, the old names are freed in one go with their arena.
+    m_isDirected = topology.IsDirected();
+    m_topology = std::move(topology);
+    m_positions = std::move(positions);
+    m_vertexColors.assign(n, 0);
+    m_vertexFlags.assign(n, 0);
+    m_vertexNames.assign(n, EmptyStringId);
+    m_names.Clear();
+    m_highlightedEdges.clear();
+    m_highlightedVertices.clear();
+    m_history.clear();
+    m_historyBytes = 0;
+    m_redo.clear();
+    m_removals = 0;
+    m_snapshot.reset();
+
+    // Every vertex is new, handles to the old ones stop resolving.
+    for (std::uint32_t slot = 0; slot < m_handles.size(); slot++) {
+        if (m_handles[slot].Id != InvalidVertexId) {
+            m_handles[slot].Id = InvalidVertexId;
+            m_handles[slot].Generation++;
+            m_freeHandles.push_back(slot);
+        }
     }
+    m_vertexHandles.resize(n);
+    for (VertexId id = 0; id < n; id++) {
+        m_vertexHandles[id] = allocateHandle(id);
+    }
+
+    reindex();
+    m_revision++;
+}
 
-    return std::round(determinant);
+std::size_t Graph::changeBytes(const GraphChange& change) {
+    return sizeof(GraphChange) + change.Data.Name.capacity() + change.Edges.capacity() * sizeof(Edge);
 }
 
-Vertex* Graph::GetVertexAtMouse(sf::RenderWindow *window) {
-    for (Vertex& v : m_vertices) {
-        sf::FloatRect hitbox = v.Sprite.getGlobalBounds();
-        sf::Vector2f mousePos = window->mapPixelToCoords(sf::Mouse::getPosition(*window));
-        if (hitbox.contains(mousePos)) {
-            return &v;
+void Graph::buildEdge(std::size_t index, sf::Vertex* vertices) const {
+    const VertexId first = m_edgeFirst[index];
+    const VertexId second = m_edgeSecond[index];
+    bool highlighted = m_highlightedEdges.count(edgeKey(first, second)) > 0;
+    sf::Color color = highlighted ? HighlightColor : Color;
+
+    // A quad along the edge, half the thickness to either side.
+    sf::Vector2f from = m_positions[first];
+    sf::Vector2f to = m_positions[second];
+    sf::Vector2f dir = to - from;
+    float length = std::sqrt(dir.x * dir.x + dir.y * dir.y);
+    sf::Vector2f normal;
+    if (length > 0.0f) {
+        normal = sf::Vector2f(-dir.y, dir.x) * (EdgeThickness * 0.5f / length);
+    }
+
+    const sf::Vector2f corners[EdgeVertices] = { from + normal, from - normal, to + normal, to + normal, from - normal, to - normal };
+    for (std::size_t i = 0; i < EdgeVertices; i++) {
+        vertices[i] = { corners[i], color };
+    }
+}
+
+void Graph::buildVertex(VertexId id, sf::Vertex* vertices) const {
+    // The unit circle, computed once.
+    static const std::vector<sf::Vector2f> circle = [] {
+        std::vector<sf::Vector2f> points(VertexSegments + 1);
+        for (std::size_t i = 0; i <= VertexSegments; i++) {
+            float angle = 2.0f * 3.14159265f * static_cast<float>(i) / VertexSegments;
+            points[i] = { std::cos(angle), std::sin(angle) };
+        }
+        return points;
+    }();
+
+    const sf::Vector2f position = m_positions[id];
+    const std::uint8_t flags = m_vertexFlags[id];
+    sf::Color fill = vertexFill(id);
+    sf::Color outline = (flags & SelectedFlag) ? sf::Color::Red : (flags & PinnedFlag) ? PinnedColor : Color;
+
+    // The outline disc first, the fill disc on top of it.
+    const float radii[2] = { VertexRadius + VertexOutline, VertexRadius };
+    const sf::Color colors[2] = { outline, fill };
+    std::size_t next = 0;
+    for (int disc = 0; disc < 2; disc++) {
+        for (std::size_t i = 0; i < VertexSegments; i++) {
+            vertices[next++] = { position, colors[disc] };
+            vertices[next++] = { position + circle[i] * radii[disc], colors[disc] };
+            vertices[next++] = { position + circle[i + 1] * radii[disc], colors[disc] };
         }
     }
-    
-    return nullptr;
 }
 
-void Graph::Draw(sf::RenderWindow *window) {
-    // Draw vertices.
-    for (Vertex &vertex : m_vertices) {
-        drawVertex(window, vertex);
+void Graph::collectEdges(const sf::FloatRect& rect, std::vector<VertexId>& indices) const {
+    // The bounding box of an edge against the rectangle, grown by the edge thickness.
+    const sf::Vector2f low = rect.position - sf::Vector2f(EdgeThickness, EdgeThickness);
+    const sf::Vector2f high = rect.position + rect.size + sf::Vector2f(EdgeThickness, EdgeThickness);
+    auto overlaps = [&](std::uint32_t index) {
+        sf::Vector2f from = m_positions[m_edgeFirst[index]];
+        sf::Vector2f to = m_positions[m_edgeSecond[index]];
+        return std::max(from.x, to.x) >= low.x && std::min(from.x, to.x) <= high.x && std::max(from.y, to.y) >= low.y && std::min(from.y, to.y) <= high.y;
+    };
+
+    // A short edge overlapping the rectangle has its midpoint within half its length of it.
+    const float reach = LongEdgeLength * 0.5f + EdgeThickness;
+    indices.clear();
+    m_edgeGrid.FindIn(sf::FloatRect(rect.position - sf::Vector2f(reach, reach), rect.size + sf::Vector2f(2.0f * reach, 2.0f * reach)), indices);
+    std::size_t kept = 0;
+    for (VertexId index : indices) {
+        if (overlaps(index)) {
+            indices[kept++] = index;
+        }
+    }
+    indices.resize(kept);
+
+    for (std::uint32_t index : m_longEdges) {
+        if (overlaps(index)) {
+            indices.push_back(index);
+        }
+    }
+}
+
+void Graph::drawCoarse(sf::RenderTarget *target, float pixelSize) {
+    // Edges whose ends share screen cells with an edge already drawn add nothing visible.
+    const float cell = BundleCell * pixelSize;
+    auto cellOf = [cell](sf::Vector2f position) {
+        std::uint32_t x = static_cast<std::uint32_t>(static_cast<std::int32_t>(std::floor(position.x / cell)));
+        std::uint32_t y = static_cast<std::uint32_t>(static_cast<std::int32_t>(std::floor(position.y / cell)));
+        return (static_cast<std::uint64_t>(x) << 32) | y;
+    };
+
+    m_bundles.clear();
+    m_frameVertices.clear();
+    m_frameVertices.setPrimitiveType(sf::PrimitiveType::Lines);
+    for (VertexId index : m_visibleEdges) {
+        const VertexId first = m_edgeFirst[index];
+        const VertexId second = m_edgeSecond[index];
+        sf::Vector2f from = m_positions[first];
+        sf::Vector2f to = m_positions[second];
+        bool highlighted = m_highlightedEdges.count(edgeKey(first, second)) > 0;
+        if (!highlighted) {
+            std::uint64_t a = cellOf(from);
+            std::uint64_t b = cellOf(to);
+            if (a == b) {
+                continue;
+            }
+            std::uint64_t bundle = std::min(a, b) * 0x9E3779B97F4A7C15ull ^ std::max(a, b);
+            if (!m_bundles.insert(bundle).second) {
+                continue;
+            }
+        }
+
+        sf::Color color = highlighted ? HighlightColor : Color;
+        m_frameVertices.append({ from, color });
+        m_frameVertices.append({ to, color });
     }
+    target->draw(m_frameVertices);
+    Profiler::CountDrawCall();
 
-    // Draw edges.
-    for (Edge &edge : m_edges) {
-        drawEdge(window, edge);
+    // No outlines at this size, one point per vertex.
+    m_frameVertices.clear();
+    m_frameVertices.setPrimitiveType(sf::PrimitiveType::Points);
+    for (VertexId id : m_visibleVertices) {
+        m_frameVertices.append({ m_positions[id], vertexFill(id) });
     }
+    target->draw(m_frameVertices);
+    Profiler::CountDrawCall();
 }
 
-std::vector<Vertex>& Graph::GetVertices(void){ 
-    return m_vertices; 
+void Graph::drawDetailed(sf::RenderTarget *target) {
+    // Built straight into one array, edges first so vertices cover their ends.
+    m_frameVertices.setPrimitiveType(sf::PrimitiveType::Triangles);
+    m_frameVertices.resize(m_visibleEdges.size() * EdgeVertices + m_visibleVertices.size() * VertexVertices);
+    std::size_t next = 0;
+    for (VertexId index : m_visibleEdges) {
+        buildEdge(index, &m_frameVertices[next]);
+        next += EdgeVertices;
+    }
+    for (VertexId id : m_visibleVertices) {
+        buildVertex(id, &m_frameVertices[next]);
+        next += VertexVertices;
+    }
+    target->draw(m_frameVertices);
+    Profiler::CountDrawCall();
 }
 
-Vertex Graph::RemoveVertex(int n) {
-    if (n >= 0 && n < m_vertices.size()) {
-        std::vector<Vertex>::iterator it = m_vertices.begin() + n;
-        Vertex v = *it;
-        // std::cout << "Removed vertex: { " << v.Position.x << ", " << v.Position.y << " }" << std::endl;
-        m_vertices.erase(it);
+std::uint64_t Graph::edgeKey(VertexId v1, VertexId v2) {
+    return (static_cast<std::uint64_t>(std::min(v1, v2)) << 32) | std::max(v1, v2);
+}
 
-        // Remove associated edges.
-        for (int i = m_edges.size() - 1; i >= 0; i--) {
-            Edge* edge = &m_edges[i];
-            if (edge->Vertex1 == &v || edge->Vertex2 == &v) {
-                m_edges.erase(m_edges.begin() + i); 
-            }
+Edge Graph::edgeAt(std::size_t index) const {
+    return { m_edgeFirst[index], m_edgeSecond[index], m_edgeWeights[index] };
+}
+
+std::size_t Graph::findEdge(VertexId v1, VertexId v2) const {
+    for (std::uint32_t index : m_incidentEdges[v1]) {
+        bool forward = m_edgeFirst[index] == v1 && m_edgeSecond[index] == v2;
+        bool backward = m_edgeFirst[index] == v2 && m_edgeSecond[index] == v1;
+        if (forward || (!m_isDirected && backward)) {
+            return index;
         }
+    }
 
-        // Adjust the adjacency matrix.
-        AdjacencyMatrix.erase(AdjacencyMatrix.begin() + n);
-        for (auto& row : AdjacencyMatrix) {
-            row.erase(row.begin() + n);
+    return m_edgeFirst.size();
+}
+
+Vertex Graph::gatherVertex(VertexId id) const {
+    const std::uint8_t flags = m_vertexFlags[id];
+    return { std::string(m_names.Get(m_vertexNames[id])), m_positions[id], (flags & SelectedFlag) != 0, (flags & PinnedFlag) != 0, m_vertexColors[id] };
+}
+
+void Graph::growBounds(sf::Vector2f position) {
+    if (m_boundsDirty) {
+        return;
+    }
+
+    sf::Vector2f low(std::min(m_bounds.position.x, position.x), std::min(m_bounds.position.y, position.y));
+    sf::Vector2f high(std::max(m_bounds.position.x + m_bounds.size.x, position.x), std::max(m_bounds.position.y + m_bounds.size.y, position.y));
+    m_bounds = sf::FloatRect(low, high - low);
+}
+
+void Graph::indexEdge(std::uint32_t index) {
+    sf::Vector2f from = m_positions[m_edgeFirst[index]];
+    sf::Vector2f to = m_positions[m_edgeSecond[index]];
+    sf::Vector2f dir = to - from;
+    if (dir.x * dir.x + dir.y * dir.y > LongEdgeLength * LongEdgeLength) {
+        m_longEdges.insert(index);
+    } else {
+        m_edgeGrid.Insert(index, (from + to) * 0.5f);
+    }
+}
+
+void Graph::insertVertex(VertexId id, const Vertex& vertex) {
+    ClearHighlight();
+
+    // Open a slot at the end and move the vertex at the id into it, the reverse of the move in RemoveVertex().
+    const VertexId last = static_cast<VertexId>(m_positions.size());
+    resizeVertices(last + 1);
+    m_topology.AddVertex();
+    m_vertexBatch.Resize(m_positions.size());
+    if (id != last) {
+        relabelVertex(id, last);
+    }
+
+    m_positions[id] = vertex.Position;
+    m_vertexColors[id] = vertex.VertexColor;
+    m_vertexFlags[id] = static_cast<std::uint8_t>((vertex.IsSelected ? SelectedFlag : 0) | (vertex.IsPinned ? PinnedFlag : 0));
+    m_vertexNames[id] = m_names.Intern(vertex.Name);
+    m_vertexHandles[id] = allocateHandle(id);
+    m_grid.Insert(id, vertex.Position);
+    m_vertexBatch.Invalidate(id);
+    growBounds(vertex.Position);
+    m_revision++;
+    record({ GraphFile::LogInsertVertex, id, InvalidVertexId, 0.0f, vertex.Position.x, vertex.Position.y, vertex.Name });
+}
+
+void Graph::invalidateEdges(std::uint64_t key) {
+    // Both directions of a directed pair share a key.
+    VertexId low = static_cast<VertexId>(key >> 32);
+    if (low >= m_incidentEdges.size()) {
+        return;
+    }
+    for (std::uint32_t index : m_incidentEdges[low]) {
+        if (edgeKey(m_edgeFirst[index], m_edgeSecond[index]) == key) {
+            m_edgeBatch.Invalidate(index);
+        }
+    }
+}
+
+void Graph::invalidateVertex(VertexId id) {
+    m_vertexBatch.Invalidate(id);
+    for (std::uint32_t index : m_incidentEdges[id]) {
+        m_edgeBatch.Invalidate(index);
+    }
+}
+
+void Graph::journal(GraphChange&& change) {
+    if (m_isReplaying) {
+        return;
+    }
+
+    // A new edit forks the history, what was undone can no longer be redone.
+    m_redo.clear();
+
+    // Moving the same vertex again extends the last move, so a drag undoes in one step.
+    if (change.Type == GraphChange::MovedVertex && !m_history.empty()) {
+        GraphChange& last = m_history.back();
+        if (last.Type == GraphChange::MovedVertex && last.Id == change.Id) {
+            last.To = change.To;
+            return;
         }
+    }
 
-        return v;
+    m_historyBytes += changeBytes(change);
+    m_history.push_back(std::move(change));
+    while (m_history.size() > 1 && (m_history.size() > HistoryLimit || m_historyBytes > HistoryBytes)) {
+        m_historyBytes -= changeBytes(m_history.front());
+        m_history.pop_front();
     }
+}
+
+void Graph::reindex(void) {
+    // The whole graph was replaced, so the index, the incidence lists and the batches start over.
+    m_grid.Clear();
+    m_edgeGrid.Clear();
+    m_longEdges.clear();
+
+    // The old lists go back to the pool in one release rather than one free each.
+    const std::size_t n = m_positions.size();
+    const std::size_t edges = m_edgeFirst.size();
+    m_incidentEdges.clear();
+    m_incidentEdges.shrink_to_fit();
+    m_incidencePool.release();
 
-    return Vertex();
+    // Counted first, so every list is allocated once at its final size.
+    std::vector<std::uint32_t> degrees(n, 0);
+    for (std::size_t index = 0; index < edges; index++) {
+        degrees[m_edgeFirst[index]]++;
+        if (m_edgeSecond[index] != m_edgeFirst[index]) {
+            degrees[m_edgeSecond[index]]++;
+        }
+    }
+    m_incidentEdges.resize(n);
+    for (VertexId id = 0; id < n; id++) {
+        m_incidentEdges[id].reserve(degrees[id]);
+        m_grid.Insert(id, m_positions[id]);
+    }
+    for (std::uint32_t index = 0; index < edges; index++) {
+        m_incidentEdges[m_edgeFirst[index]].push_back(index);
+        if (m_edgeSecond[index] != m_edgeFirst[index]) {
+            m_incidentEdges[m_edgeSecond[index]].push_back(index);
+        }
+        indexEdge(index);
+    }
+    m_boundsDirty = true;
+
+    m_edgeBatch.Resize(edges);
+    m_edgeBatch.InvalidateAll();
+    m_vertexBatch.Resize(n);
+    m_vertexBatch.InvalidateAll();
 }
 
-void Graph::drawEdge(sf::RenderWindow *window, Edge& edge) {
-    // Initialize the sprite.
-    edge.Sprite.setFillColor(Color);
+sf::Color Graph::paletteColor(int color) {
+    if (color <= static_cast<int>(Palette.size())) {
+        return Palette[color - 1];
+    }
 
-    Vertex& left = (edge.Vertex1->Position.x < edge.Vertex2->Position.x) ? *edge.Vertex1 : *edge.Vertex2;
-    Vertex& right = (edge.Vertex1->Position.x < edge.Vertex2->Position.x) ? *edge.Vertex2 : *edge.Vertex1;
-    sf::Vector2f dir = right.Position - left.Position;
-    float length = std::sqrt(dir.x * dir.x + dir.y * dir.y);
-    edge.Sprite.setSize({length, 2.0f});
-    edge.Sprite.setOrigin({0.0f, 0.0f});
-    edge.Sprite.setPosition(left.Position);
+    // Past the palette, hues a golden ratio apart, so consecutive colors land far apart on the wheel.
+    const float hue = std::fmod(static_cast<float>(color) * 0.618034f, 1.0f) * 6.0f;
+    const float value = 0.85f;
+    const float chroma = value * 0.65f;
+    const float second = chroma * (1.0f - std::fabs(std::fmod(hue, 2.0f) - 1.0f));
+    const float low = value - chroma;
+    const float rgb[6][3] = {
+        { chroma, second, 0 }, { second, chroma, 0 }, { 0, chroma, second }, { 0, second, chroma }, { second, 0, chroma }, { chroma, 0, second }
+    };
+    const float* sector = rgb[static_cast<int>(hue) % 6];
+    return sf::Color(static_cast<std::uint8_t>((sector[0] + low) * 255.0f), static_cast<std::uint8_t>((sector[1] + low) * 255.0f), static_cast<std::uint8_t>((sector[2] + low) * 255.0f));
+}
+
+void Graph::placeVertex(VertexId id, sf::Vector2f position) {
+    m_grid.Move(id, m_positions[id], position);
+    for (std::uint32_t index : m_incidentEdges[id]) {
+        unindexEdge(index);
+    }
+    m_positions[id] = position;
+    for (std::uint32_t index : m_incidentEdges[id]) {
+        indexEdge(index);
+    }
+    growBounds(position);
+    invalidateVertex(id);
+}
+
+void Graph::record(const GraphFile::LogEntry& entry) {
+    record(std::span<const GraphFile::LogEntry>(&entry, 1));
+}
+
+void Graph::record(std::span<const GraphFile::LogEntry> entries) {
+    if (m_path.empty()) {
+        return;
+    }
+
+    // A failed append only costs the edits on the next load, the graph in memory is still right.
+    std::string error;
+    if (!GraphFile::Append(m_path, entries, error)) {
+        LOG_WARNING("Cannot log edit to " << m_path << ": " << error);
+    }
+}
+
+void Graph::relabelVertex(VertexId from, VertexId to) {
+    // The topology has no way to rename, so the edges come out under the old id and go back under the new one.
+    std::pmr::vector<std::uint32_t>& incident = m_incidentEdges[from];
+    for (std::uint32_t index : incident) {
+        m_topology.RemoveEdge(m_edgeFirst[index], m_edgeSecond[index]);
+    }
+    for (std::uint32_t index : incident) {
+        if (m_edgeFirst[index] == from) {
+            m_edgeFirst[index] = to;
+        }
+        if (m_edgeSecond[index] == from) {
+            m_edgeSecond[index] = to;
+        }
+        m_topology.AddEdge(m_edgeFirst[index], m_edgeSecond[index], m_edgeWeights[index]);
+    }
+    m_incidentEdges[to] = std::move(incident);
+    m_incidentEdges[from].clear();
+
+    // The edges keep their indices and positions, only the vertex geometry moves to the new slot.
+    m_grid.Remove(from, m_positions[from]);
+    m_grid.Insert(to, m_positions[from]);
+    m_positions[to] = m_positions[from];
+    m_vertexColors[to] = m_vertexColors[from];
+    m_vertexFlags[to] = m_vertexFlags[from];
+    m_vertexNames[to] = m_vertexNames[from];
+    m_vertexHandles[to] = m_vertexHandles[from];
+    m_handles[m_vertexHandles[to]].Id = to;
+    m_vertexBatch.Invalidate(to);
+}
+
+void Graph::removeEdge(std::size_t index) {
+    const Edge edge = edgeAt(index);
+    const std::uint32_t removed = static_cast<std::uint32_t>(index);
+    const std::uint32_t last = static_cast<std::uint32_t>(m_edgeFirst.size() - 1);
+    m_topology.RemoveEdge(edge.Vertex1, edge.Vertex2);
+
+    // Drop the edge from the incidence lists of its ends in O(degree).
+    auto forget = [this](VertexId v, std::uint32_t target) {
+        std::pmr::vector<std::uint32_t>& list = m_incidentEdges[v];
+        std::pmr::vector<std::uint32_t>::iterator at = std::find(list.begin(), list.end(), target);
+        *at = list.back();
+        list.pop_back();
+    };
+    unindexEdge(removed);
+    forget(edge.Vertex1, removed);
+    if (edge.Vertex2 != edge.Vertex1) {
+        forget(edge.Vertex2, removed);
+    }
 
-    float angle = std::atan2(dir.y, dir.x);
-    edge.Sprite.setRotation(sf::radians(angle));
+    // The last edge fills the gap, so no other index changes.
+    if (removed != last) {
+        const Edge moved = edgeAt(last);
+        unindexEdge(last);
+        for (VertexId v : { moved.Vertex1, moved.Vertex2 }) {
+            std::pmr::vector<std::uint32_t>& list = m_incidentEdges[v];
+            std::replace(list.begin(), list.end(), last, removed);
+        }
+        m_edgeFirst[removed] = moved.Vertex1;
+        m_edgeSecond[removed] = moved.Vertex2;
+        m_edgeWeights[removed] = moved.Weight;
+        indexEdge(removed);
+        m_edgeBatch.Invalidate(removed);
+    }
+    m_edgeFirst.pop_back();
+    m_edgeSecond.pop_back();
+    m_edgeWeights.pop_back();
+    m_edgeBatch.Resize(m_edgeFirst.size());
+}
 
-    // Draw the sprite.
-    window->draw(edge.Sprite);
+void Graph::resizeVertices(std::size_t count) {
+    m_positions.resize(count);
+    m_vertexColors.resize(count, 0);
+    m_vertexFlags.resize(count, 0);
+    m_vertexNames.resize(count, EmptyStringId);
+    m_vertexHandles.resize(count, 0);
+    m_incidentEdges.resize(count);
 }
 
-void Graph::drawVertex(sf::RenderWindow *window, Vertex& vertex) {
-    // Initialize the sprite.
-    float radius = 10.0f;
-    vertex.Sprite.setRadius(radius);
-    vertex.Sprite.setOrigin({radius, radius});
-    vertex.Sprite.setFillColor(Color);
-    vertex.Sprite.setPosition(vertex.Position);
+void Graph::setFlag(VertexId id, VertexFlag flag, bool isSet) {
+    if (isSet) {
+        m_vertexFlags[id] |= flag;
+    } else {
+        m_vertexFlags[id] &= static_cast<std::uint8_t>(~flag);
+    }
+}
+
+void Graph::unindexEdge(std::uint32_t index) {
+    if (m_longEdges.erase(index) > 0) {
+        return;
+    }
 
-    // Draw the sprite.
-    window->draw(vertex.Sprite);
-}
\ No newline at end of file
+    sf::Vector2f from = m_positions[m_edgeFirst[index]];
+    sf::Vector2f to = m_positions[m_edgeSecond[index]];
+    m_edgeGrid.Remove(index, (from + to) * 0.5f);
+}
+
+void Graph::updateBounds(void) {
+    sf::Vector2f low = m_positions[0];
+    sf::Vector2f high = low;
+    for (sf::Vector2f position : m_positions) {
+        low = { std::min(low.x, position.x), std::min(low.y, position.y) };
+        high = { std::max(high.x, position.x), std::max(high.y, position.y) };
+    }
+    m_bounds = sf::FloatRect(low, high - low);
+    m_boundsDirty = false;
+}
+
+sf::Color Graph::vertexFill(VertexId id) const {
+    if (m_highlightedVertices.count(id) > 0) {
+        return HighlightColor;
+    }
+    const int color = m_vertexColors[id];
+    if (color > 0) {
+        return paletteColor(color);
+    }
+
+    // Components are tinted by their representative, so a tint only changes when the component does.
+    return TintComponents ? paletteColor(static_cast<int>(m_topology.GetComponent(id) % TintHues) + 1) : Color;
+}
@@ -0,0 +1,334 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "GraphFile.hpp"
+
+// Entries are written and mapped as is, they must have no padding.
+static_assert(sizeof(Neighbor) == 8, "Neighbor must be a packed target and weight.");
+
+GraphFile::GraphFile(void) {
+    m_header = nullptr;
+}
+
+bool GraphFile::Append(const std::filesystem::path& path, const LogEntry& entry, std::string& error) {
+    return Append(path, std::span<const LogEntry>(&entry, 1), error);
+}
+
+bool GraphFile::Append(const std::filesystem::path& path, std::span<const LogEntry> entries, std::string& error) {
+    // Only a saved file has a log to append to.
+    if (!std::filesystem::is_regular_file(path)) {
+        error = "file does not exist";
+        return false;
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    if (!file) {
+        error = "cannot open file";
+        return false;
+    }
+
+    for (const LogEntry& entry : entries) {
+        LogRecord record = { entry.Kind, entry.First, entry.Second, entry.Weight, entry.X, entry.Y, static_cast<std::uint32_t>(entry.Name.size()) };
+        file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        file.write(entry.Name.data(), static_cast<std::streamsize>(entry.Name.size()));
+    }
+    file.flush();
+    if (!file) {
+        error = "cannot write file";
+        return false;
+    }
+
+    return true;
+}
+
+std::uint32_t GraphFile::GetColor(void) const {
+    return m_header->Color;
+}
+
+std::size_t GraphFile::GetEdgeCount(void) const {
+    return static_cast<std::size_t>(m_header->EdgeCount);
+}
+
+std::span<const Neighbor> GraphFile::GetEntries(void) const {
+    return { section<Neighbor>(EntriesSection), static_cast<std::size_t>(m_header->EntryCount) };
+}
+
+std::vector<GraphFile::LogEntry> GraphFile::GetLog(void) const {
+    std::vector<LogEntry> log;
+    const std::byte* cursor = m_file.GetData() + m_header->LogOffset;
+    const std::byte* end = m_file.GetData() + m_file.GetSize();
+    while (static_cast<std::size_t>(end - cursor) >= sizeof(LogRecord)) {
+        // Records are not aligned, copy them out.
+        LogRecord record;
+        std::memcpy(&record, cursor, sizeof(record));
+        cursor += sizeof(record);
+        if (record.Kind < LogAddVertex || record.Kind > LogRemoveEdge || record.NameLength > static_cast<std::size_t>(end - cursor)) {
+            break;
+        }
+
+        LogEntry entry = { static_cast<LogKind>(record.Kind), record.First, record.Second, record.Weight, record.X, record.Y, std::string(reinterpret_cast<const char*>(cursor), record.NameLength) };
+        log.push_back(std::move(entry));
+        cursor += record.NameLength;
+    }
+
+    return log;
+}
+
+std::span<const std::uint64_t> GraphFile::GetOffsets(void) const {
+    return { section<std::uint64_t>(OffsetsSection), static_cast<std::size_t>(m_header->VertexCount + 1) };
+}
+
+GraphFile::VertexRecord GraphFile::GetVertex(VertexId id) const {
+    const float* positions = section<float>(PositionsSection);
+    const std::uint64_t* nameOffsets = section<std::uint64_t>(NameOffsetsSection);
+
+    // Keep a damaged name table inside the names section.
+    std::uint64_t end = std::min(nameOffsets[id + 1], m_header->NameBytes);
+    std::uint64_t begin = std::min(nameOffsets[id], end);
+    std::string_view name(section<char>(NamesSection) + begin, static_cast<std::size_t>(end - begin));
+
+    return { name, positions[2 * id], positions[2 * id + 1], section<std::int32_t>(ColorsSection)[id] };
+}
+
+std::size_t GraphFile::GetVertexCount(void) const {
+    return static_cast<std::size_t>(m_header->VertexCount);
+}
+
+bool GraphFile::IsDirected(void) const {
+    return (m_header->Flags & DirectedFlag) != 0;
+}
+
+bool GraphFile::Load(AdjacencyStore& topology, std::string& error) const {
+    // The store trusts its rows, so check them on the way in.
+    std::span<const std::uint64_t> offsets = GetOffsets();
+    std::span<const Neighbor> entries = GetEntries();
+    const std::size_t n = GetVertexCount();
+    if (offsets[0] != 0 || offsets[n] != entries.size()) {
+        error = "bad row offsets";
+        return false;
+    }
+    for (std::size_t v = 0; v < n; v++) {
+        if (offsets[v + 1] < offsets[v]) {
+            error = "bad row offsets";
+            return false;
+        }
+    }
+    for (const Neighbor& entry : entries) {
+        if (entry.Target >= n) {
+            error = "bad edge target";
+            return false;
+        }
+    }
+
+    topology = AdjacencyStore(IsDirected());
+    topology.Assign(offsets, entries);
+    if (topology.GetEdgeCount() != GetEdgeCount()) {
+        error = "edge count does not match the rows";
+        return false;
+    }
+
+    return true;
+}
+
+bool GraphFile::Open(const std::filesystem::path& path, std::string& error) {
+    m_header = nullptr;
+    if (!m_file.Open(path, error)) {
+        return false;
+    }
+
+    const std::size_t size = m_file.GetSize();
+    const Header* header = reinterpret_cast<const Header*>(m_file.GetData());
+    if (size < sizeof(Header) || std::memcmp(header->Magic, Magic, sizeof(Magic)) != 0) {
+        error = "not a graph file";
+        m_file.Close();
+        return false;
+    }
+    if (header->ByteOrder != ByteOrderMark) {
+        error = "graph file written with the other byte order";
+        m_file.Close();
+        return false;
+    }
+    if (header->Version != FormatVersion) {
+        error = "unsupported graph file version " + std::to_string(header->Version);
+        m_file.Close();
+        return false;
+    }
+
+    // Every element takes at least a byte, so larger counts are damage and the sizes below cannot overflow.
+    if (header->VertexCount >= size || header->EntryCount >= size || header->NameBytes >= size || header->LogOffset > size) {
+        error = "damaged graph file";
+        m_file.Close();
+        return false;
+    }
+    const std::uint64_t sizes[SectionCount] = {
+        (header->VertexCount + 1) * sizeof(std::uint64_t),
+        header->EntryCount * sizeof(Neighbor),
+        header->VertexCount * 2 * sizeof(float),
+        header->VertexCount * sizeof(std::int32_t),
+        (header->VertexCount + 1) * sizeof(std::uint64_t),
+        header->NameBytes
+    };
+    for (std::size_t i = 0; i < SectionCount; i++) {
+        if (header->Sections[i] % SectionAlignment != 0 || header->Sections[i] < sizeof(Header) || header->Sections[i] > header->LogOffset || sizes[i] > header->LogOffset - header->Sections[i]) {
+            error = "damaged graph file";
+            m_file.Close();
+            return false;
+        }
+    }
+
+    m_header = header;
+    return true;
+}
+
+bool GraphFile::Replay(const LogEntry& entry, AdjacencyStore& topology) {
+    const std::size_t n = topology.GetVertexCount();
+    switch (entry.Kind) {
+        case LogAddVertex:
+            topology.AddVertex();
+            return true;
+        case LogAddEdge:
+            if (entry.First >= n || entry.Second >= n) {
+                return false;
+            }
+            topology.AddEdge(entry.First, entry.Second, entry.Weight);
+            return true;
+        case LogMoveVertex:
+            return entry.First < n;
+        case LogRemoveVertex:
+            if (entry.First >= n) {
+                return false;
+            }
+            topology.RemoveVertex(entry.First);
+            return true;
+        case LogInsertVertex:
+            if (entry.First > n) {
+                return false;
+            }
+            topology.InsertVertex(entry.First);
+            return true;
+        case LogRemoveEdge:
+            if (entry.First >= n || entry.Second >= n) {
+                return false;
+            }
+            topology.RemoveEdge(entry.First, entry.Second);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool GraphFile::Save(const std::filesystem::path& path, const AdjacencyStore& topology, std::uint32_t color, const VertexSource& vertices, std::string& error) {
+    std::filesystem::path temporary = path;
+    temporary += ".tmp";
+
+    // A large buffer turns the many small writes below into a few big ones.
+    std::vector<char> buffer(1 << 20);
+    std::ofstream file;
+    file.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.open(temporary, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        error = "cannot create file";
+        return false;
+    }
+
+    const std::size_t n = topology.GetVertexCount();
+    Header header = {};
+    std::memcpy(header.Magic, Magic, sizeof(Magic));
+    header.Version = FormatVersion;
+    header.ByteOrder = ByteOrderMark;
+    header.VertexCount = n;
+    header.EdgeCount = topology.GetEdgeCount();
+    header.Color = color;
+    header.Flags = topology.IsDirected() ? DirectedFlag : 0;
+
+    // The header is rewritten last, once the section offsets are known.
+    std::uint64_t position = 0;
+    auto write = [&](const void* data, std::size_t size) {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        position += size;
+    };
+    auto align = [&]() {
+        static constexpr char zeros[SectionAlignment] = {};
+        write(zeros, (SectionAlignment - position % SectionAlignment) % SectionAlignment);
+    };
+    write(&header, sizeof(header));
+
+    // Row offsets, a running sum of the degrees, then the rows themselves straight from the adjacency lists.
+    align();
+    header.Sections[OffsetsSection] = position;
+    std::uint64_t offset = 0;
+    write(&offset, sizeof(offset));
+    for (VertexId v = 0; v < n; v++) {
+        offset += topology.GetDegree(v);
+        write(&offset, sizeof(offset));
+    }
+    header.EntryCount = offset;
+
+    align();
+    header.Sections[EntriesSection] = position;
+    for (VertexId v = 0; v < n; v++) {
+        const std::vector<Neighbor>& list = topology.GetNeighbors(v);
+        write(list.data(), list.size() * sizeof(Neighbor));
+    }
+
+    // Vertex attributes, one pass per section.
+    align();
+    header.Sections[PositionsSection] = position;
+    for (VertexId v = 0; v < n; v++) {
+        VertexRecord record = vertices(v);
+        const float xy[2] = { record.X, record.Y };
+        write(xy, sizeof(xy));
+    }
+
+    align();
+    header.Sections[ColorsSection] = position;
+    for (VertexId v = 0; v < n; v++) {
+        std::int32_t vertexColor = vertices(v).Color;
+        write(&vertexColor, sizeof(vertexColor));
+    }
+
+    align();
+    header.Sections[NameOffsetsSection] = position;
+    std::uint64_t nameOffset = 0;
+    write(&nameOffset, sizeof(nameOffset));
+    for (VertexId v = 0; v < n; v++) {
+        nameOffset += vertices(v).Name.size();
+        write(&nameOffset, sizeof(nameOffset));
+    }
+    header.NameBytes = nameOffset;
+
+    align();
+    header.Sections[NamesSection] = position;
+    for (VertexId v = 0; v < n; v++) {
+        std::string_view name = vertices(v).Name;
+        write(name.data(), name.size());
+    }
+
+    align();
+    header.LogOffset = position;
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+
+    std::error_code code;
+    if (!file) {
+        error = "cannot write file";
+        std::filesystem::remove(temporary, code);
+        return false;
+    }
+    std::filesystem::rename(temporary, path, code);
+    if (code) {
+        error = "cannot replace file: " + code.message();
+        std::filesystem::remove(temporary, code);
+        return false;
+    }
+
+    return true;
+}
+
+template <typename T>
+const T* GraphFile::section(Section section) const {
+    return reinterpret_cast<const T*>(m_file.GetData() + m_header->Sections[section]);
+}
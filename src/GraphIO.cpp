@@ -0,0 +1,520 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "GraphIO.hpp"
+#include "MappedFile.hpp"
+#include "Profiler.hpp"
+
+GraphIO::Format GraphIO::DetectFormat(const std::filesystem::path& path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+
+    if (extension == ".gr" || extension == ".col" || extension == ".dimacs") {
+        return Dimacs;
+    }
+    if (extension == ".mtx") {
+        return MatrixMarket;
+    }
+    if (extension == ".graphml") {
+        return GraphML;
+    }
+
+    return EdgeList;
+}
+
+bool GraphIO::Read(const std::filesystem::path& path, Format format, AdjacencyStore& topology, std::string& error, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("GraphIO::Read");
+
+    // Map the file instead of reading it, pages already parsed can be dropped by the system under pressure.
+    MappedFile file;
+    if (!file.Open(path, error)) {
+        return false;
+    }
+    const char* text = reinterpret_cast<const char*>(file.GetData());
+    const char* end = text + file.GetSize();
+
+    // A file can only make vertices in proportion to its size, short of isolated ids, so larger ids are mistakes.
+    Layout layout = { 0, 0, 0, std::min<std::size_t>(std::max(MinVertexLimit, file.GetSize()), InvalidVertexId), false, false, false, true, "" };
+    if (format == Dimacs && !readDimacsHeader(text, end, layout, error)) {
+        return false;
+    }
+    if (format == MatrixMarket && !readMatrixMarketHeader(text, end, layout, error)) {
+        return false;
+    }
+    if (format == GraphML) {
+        readGraphMLHeader(text, end, layout);
+    }
+    if (layout.VertexCount > layout.VertexLimit) {
+        error = "too many vertices";
+        return false;
+    }
+    topology.AddVertices(layout.VertexCount);
+
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<Chunk> chunks(threadCount * ChunksPerThread);
+
+    // GraphML names become ids in the order they are first seen.
+    std::unordered_map<std::string_view, VertexId> nodeIds;
+    auto idOf = [&](std::string_view name) {
+        auto [found, isNew] = nodeIds.try_emplace(name, static_cast<VertexId>(nodeIds.size()));
+        if (isNew) {
+            topology.AddVertex();
+        }
+        return found->second;
+    };
+
+    // Two passes over the mapping, the first checks the file and counts degrees so the second can fill every
+    // adjacency list without growing it.
+    std::vector<std::uint32_t> degrees;
+    auto append = [&](VertexId from, VertexId to, float weight, bool isCounting) {
+        if (!isCounting) {
+            topology.AppendEdge(from, to, weight);
+            return;
+        }
+        degrees[from]++;
+        if (!topology.IsDirected() && from != to) {
+            degrees[to]++;
+        }
+    };
+
+    for (int pass = 0; pass < 2; pass++) {
+        const bool isCounting = pass == 0;
+        std::size_t line = layout.BodyLine;
+        const char* cursor = text + layout.BodyOffset;
+        while (cursor < end) {
+            if (control) {
+                if (control->IsCancelled()) {
+                    error = "cancelled";
+                    return false;
+                }
+                control->SetProgress(static_cast<float>((pass + static_cast<double>(cursor - text) / (end - text)) / 2.0));
+            }
+
+            // Cut the next window of chunks, each ends on a line or, for GraphML, before a node or edge.
+            std::size_t count = 0;
+            while (count < chunks.size() && cursor < end) {
+                Chunk& chunk = chunks[count++];
+                chunk.Begin = cursor;
+                if (static_cast<std::size_t>(end - cursor) <= ChunkBytes) {
+                    cursor = end;
+                } else if (format == GraphML) {
+                    cursor = findElement(cursor + ChunkBytes, end);
+                } else {
+                    const void* newline = std::memchr(cursor + ChunkBytes, '\n', end - cursor - ChunkBytes);
+                    cursor = newline ? static_cast<const char*>(newline) + 1 : end;
+                }
+                chunk.End = cursor;
+            }
+
+            // Parse the window in parallel.
+            std::atomic<std::size_t> next = 0;
+            auto worker = [&]() {
+                for (std::size_t i = next++; i < count; i = next++) {
+                    Chunk& chunk = chunks[i];
+                    chunk.Edges.clear();
+                    chunk.Nodes.clear();
+                    chunk.NamedEdges.clear();
+                    chunk.VertexCount = 0;
+                    chunk.Lines = 0;
+                    chunk.Error.clear();
+                    chunk.ErrorLine = 0;
+                    if (format == GraphML) {
+                        parseElements(chunk, layout);
+                    } else {
+                        parseLines(chunk, layout, format);
+                    }
+                }
+            };
+            std::vector<std::thread> threads;
+            for (std::size_t i = 1; i < std::min(threadCount, count); i++) {
+                threads.emplace_back(worker);
+            }
+            worker();
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+
+            // Take the edges in file order, so the last weight of a repeated edge wins.
+            for (std::size_t i = 0; i < count; i++) {
+                Chunk& chunk = chunks[i];
+                if (!chunk.Error.empty()) {
+                    error = chunk.Error + " on line " + std::to_string(line + chunk.ErrorLine);
+                    return false;
+                }
+                line += chunk.Lines;
+
+                // Vertices only appear while counting, the second pass finds them all in place.
+                if (chunk.VertexCount > topology.GetVertexCount()) {
+                    topology.AddVertices(chunk.VertexCount - topology.GetVertexCount());
+                }
+                for (std::string_view node : chunk.Nodes) {
+                    idOf(node);
+                }
+                std::vector<VertexId> named(2 * chunk.NamedEdges.size());
+                for (std::size_t e = 0; e < chunk.NamedEdges.size(); e++) {
+                    named[2 * e] = idOf(chunk.NamedEdges[e].Source);
+                    named[2 * e + 1] = idOf(chunk.NamedEdges[e].Target);
+                }
+                if (topology.GetVertexCount() > layout.VertexLimit) {
+                    error = "too many vertices";
+                    return false;
+                }
+                if (isCounting) {
+                    degrees.resize(topology.GetVertexCount(), 0);
+                }
+
+                for (const ParsedEdge& edge : chunk.Edges) {
+                    append(edge.From, edge.To, edge.Weight, isCounting);
+                    if (layout.IsSymmetric && topology.IsDirected() && edge.From != edge.To) {
+                        append(edge.To, edge.From, layout.IsSkew ? -edge.Weight : edge.Weight, isCounting);
+                    }
+                }
+                for (std::size_t e = 0; e < chunk.NamedEdges.size(); e++) {
+                    append(named[2 * e], named[2 * e + 1], chunk.NamedEdges[e].Weight, isCounting);
+                }
+            }
+        }
+
+        if (isCounting) {
+            for (VertexId v = 0; v < degrees.size(); v++) {
+                topology.ReserveNeighbors(v, degrees[v]);
+            }
+            degrees = std::vector<std::uint32_t>();
+        }
+    }
+    topology.RemoveDuplicateEdges();
+    if (control) {
+        control->SetProgress(1.0f);
+    }
+
+    return true;
+}
+
+std::string_view GraphIO::attribute(const char* tag, const char* tagEnd, std::string_view name) {
+    std::string_view text(tag, tagEnd - tag);
+    for (std::size_t at = text.find(name); at != std::string_view::npos; at = text.find(name, at + 1)) {
+        // The name must stand on its own, followed by = and a quoted value.
+        char before = at > 0 ? text[at - 1] : '\0';
+        if (before != ' ' && before != '\t' && before != '\n' && before != '\r') {
+            continue;
+        }
+        std::size_t cursor = at + name.size();
+        while (cursor < text.size() && (text[cursor] == ' ' || text[cursor] == '\t')) {
+            cursor++;
+        }
+        if (cursor >= text.size() || text[cursor] != '=') {
+            continue;
+        }
+        cursor++;
+        while (cursor < text.size() && (text[cursor] == ' ' || text[cursor] == '\t')) {
+            cursor++;
+        }
+        if (cursor >= text.size() || (text[cursor] != '"' && text[cursor] != '\'')) {
+            continue;
+        }
+        std::size_t close = text.find(text[cursor], cursor + 1);
+        if (close == std::string_view::npos) {
+            return {};
+        }
+        return text.substr(cursor + 1, close - cursor - 1);
+    }
+
+    return {};
+}
+
+const char* GraphIO::findElement(const char* cursor, const char* end) {
+    while (cursor < end) {
+        const char* open = static_cast<const char*>(std::memchr(cursor, '<', end - cursor));
+        if (!open) {
+            return end;
+        }
+        if (end - open > 5 && (std::memcmp(open + 1, "node", 4) == 0 || std::memcmp(open + 1, "edge", 4) == 0)) {
+            char after = open[5];
+            if (after == ' ' || after == '\t' || after == '\n' || after == '\r' || after == '/' || after == '>') {
+                return open;
+            }
+        }
+        cursor = open + 1;
+    }
+
+    return end;
+}
+
+void GraphIO::parseElements(Chunk& chunk, const Layout& layout) {
+    auto fail = [&chunk](const char* at, const std::string& problem) {
+        chunk.Error = problem;
+        chunk.ErrorLine = std::count(chunk.Begin, at, '\n') + 1;
+    };
+
+    const char* end = chunk.End;
+    for (const char* cursor = findElement(chunk.Begin, end); cursor < end; cursor = findElement(cursor, end)) {
+        const char* tagEnd = static_cast<const char*>(std::memchr(cursor, '>', end - cursor));
+        if (!tagEnd) {
+            fail(cursor, "unterminated element");
+            return;
+        }
+
+        if (cursor[1] == 'n') {
+            std::string_view id = attribute(cursor, tagEnd, "id");
+            if (id.empty()) {
+                fail(cursor, "node without an id");
+                return;
+            }
+            chunk.Nodes.push_back(id);
+            cursor = tagEnd + 1;
+            continue;
+        }
+
+        NamedEdge edge = { attribute(cursor, tagEnd, "source"), attribute(cursor, tagEnd, "target"), 1.0f };
+        if (edge.Source.empty() || edge.Target.empty()) {
+            fail(cursor, "edge without a source or target");
+            return;
+        }
+
+        // An edge with a body may hold its weight in a data element.
+        const char* bodyEnd = tagEnd + 1;
+        if (tagEnd[-1] != '/') {
+            std::string_view rest(tagEnd + 1, end - tagEnd - 1);
+            std::size_t close = rest.find("</edge");
+            bodyEnd = close == std::string_view::npos ? end : tagEnd + 1 + close;
+            std::string_view body(tagEnd + 1, bodyEnd - tagEnd - 1);
+            for (std::size_t at = body.find("<data"); at != std::string_view::npos; at = body.find("<data", at + 1)) {
+                std::size_t dataEnd = body.find('>', at);
+                if (dataEnd == std::string_view::npos) {
+                    break;
+                }
+                if (attribute(body.data() + at, body.data() + dataEnd, "key") != layout.WeightKey) {
+                    continue;
+                }
+                const char* value = skipSpaces(body.data() + dataEnd + 1, bodyEnd);
+                while (value < bodyEnd && *value == '\n') {
+                    value = skipSpaces(value + 1, bodyEnd);
+                }
+                if (std::from_chars(value, bodyEnd, edge.Weight).ec != std::errc()) {
+                    fail(value, "bad weight");
+                    return;
+                }
+                break;
+            }
+        }
+        chunk.NamedEdges.push_back(edge);
+        cursor = bodyEnd;
+    }
+
+    chunk.Lines = std::count(chunk.Begin, chunk.End, '\n');
+}
+
+void GraphIO::parseLines(Chunk& chunk, const Layout& layout, Format format) {
+    const char* cursor = chunk.Begin;
+    const char* end = chunk.End;
+    while (cursor < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        chunk.Lines++;
+
+        // Skip blank lines, comments and, in DIMACS, every line but arcs and edges.
+        const char* token = skipSpaces(cursor, lineEnd);
+        cursor = lineEnd + 1;
+        if (token == lineEnd) {
+            continue;
+        }
+        if (format == Dimacs) {
+            if (*token != 'a' && *token != 'e') {
+                continue;
+            }
+            token = skipSpaces(token + 1, lineEnd);
+        } else if (*token == '%' || (format == EdgeList && *token == '#')) {
+            continue;
+        }
+
+        // Two ids and an optional weight.
+        ParsedEdge edge = { 0, 0, 1.0f };
+        std::from_chars_result parsed = std::from_chars(token, lineEnd, edge.From);
+        if (parsed.ec == std::errc()) {
+            parsed = std::from_chars(skipSpaces(parsed.ptr, lineEnd), lineEnd, edge.To);
+        }
+        if (parsed.ec != std::errc() || edge.From == InvalidVertexId || edge.To == InvalidVertexId) {
+            chunk.Error = "bad edge";
+            chunk.ErrorLine = chunk.Lines;
+            return;
+        }
+        token = skipSpaces(parsed.ptr, lineEnd);
+        if (layout.HasWeights && token < lineEnd) {
+            parsed = std::from_chars(token, lineEnd, edge.Weight);
+            if (parsed.ec != std::errc()) {
+                chunk.Error = "bad weight";
+                chunk.ErrorLine = chunk.Lines;
+                return;
+            }
+        }
+
+        if (layout.IsOneBased) {
+            if (edge.From == 0 || edge.To == 0) {
+                chunk.Error = "vertex id 0 in a 1 based format";
+                chunk.ErrorLine = chunk.Lines;
+                return;
+            }
+            edge.From--;
+            edge.To--;
+        }
+        if (layout.VertexCount > 0 && (edge.From >= layout.VertexCount || edge.To >= layout.VertexCount)) {
+            chunk.Error = "vertex id above the declared vertex count";
+            chunk.ErrorLine = chunk.Lines;
+            return;
+        }
+        if (edge.From >= layout.VertexLimit || edge.To >= layout.VertexLimit) {
+            chunk.Error = "vertex id too large";
+            chunk.ErrorLine = chunk.Lines;
+            return;
+        }
+
+        chunk.VertexCount = std::max<std::size_t>(chunk.VertexCount, std::max(edge.From, edge.To) + std::size_t(1));
+        chunk.Edges.push_back(edge);
+    }
+}
+
+bool GraphIO::readDimacsHeader(const char* begin, const char* end, Layout& layout, std::string& error) {
+    layout.IsOneBased = true;
+    const char* cursor = begin;
+    while (cursor < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        layout.BodyLine++;
+
+        const char* token = skipSpaces(cursor, lineEnd);
+        cursor = lineEnd + 1;
+        if (token < lineEnd && (*token == 'a' || *token == 'e')) {
+            error = "edge before the problem line on line " + std::to_string(layout.BodyLine);
+            return false;
+        }
+        if (token == lineEnd || *token != 'p') {
+            continue;
+        }
+
+        // "p <problem> <vertices> <edges>", the problem name is not needed.
+        token = skipSpaces(token + 1, lineEnd);
+        while (token < lineEnd && *token != ' ' && *token != '\t') {
+            token++;
+        }
+        token = skipSpaces(token, lineEnd);
+        if (std::from_chars(token, lineEnd, layout.VertexCount).ec != std::errc()) {
+            error = "bad problem line on line " + std::to_string(layout.BodyLine);
+            return false;
+        }
+        layout.BodyOffset = std::min(cursor, end) - begin;
+        return true;
+    }
+
+    error = "no problem line";
+    return false;
+}
+
+void GraphIO::readGraphMLHeader(const char* begin, const char* end, Layout& layout) {
+    const char* first = findElement(begin, end);
+    layout.BodyOffset = first - begin;
+    layout.BodyLine = std::count(begin, first, '\n');
+    layout.WeightKey = "weight";
+
+    // Keys are declared before the graph, look for an edge attribute named weight.
+    std::string_view prelude(begin, first - begin);
+    for (std::size_t at = prelude.find("<key"); at != std::string_view::npos; at = prelude.find("<key", at + 1)) {
+        std::size_t keyEnd = prelude.find('>', at);
+        if (keyEnd == std::string_view::npos) {
+            break;
+        }
+        const char* tag = begin + at;
+        const char* tagEnd = begin + keyEnd;
+        std::string_view target = attribute(tag, tagEnd, "for");
+        if (attribute(tag, tagEnd, "attr.name") == "weight" && (target == "edge" || target == "all")) {
+            layout.WeightKey = attribute(tag, tagEnd, "id");
+            break;
+        }
+    }
+}
+
+bool GraphIO::readMatrixMarketHeader(const char* begin, const char* end, Layout& layout, std::string& error) {
+    layout.IsOneBased = true;
+
+    // The banner, "%%MatrixMarket matrix coordinate <field> <symmetry>", case insensitive.
+    const char* lineEnd = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+    if (!lineEnd) {
+        lineEnd = end;
+    }
+    std::string banner(begin, lineEnd);
+    std::transform(banner.begin(), banner.end(), banner.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    std::vector<std::string> words;
+    for (std::size_t at = 0; at < banner.size();) {
+        std::size_t wordEnd = banner.find_first_of(" \t\r", at);
+        if (wordEnd == std::string::npos) {
+            wordEnd = banner.size();
+        }
+        if (wordEnd > at) {
+            words.push_back(banner.substr(at, wordEnd - at));
+        }
+        at = wordEnd + 1;
+    }
+    if (words.size() < 5 || words[0] != "%%matrixmarket" || words[1] != "matrix") {
+        error = "not a Matrix Market matrix";
+        return false;
+    }
+    if (words[2] != "coordinate") {
+        error = "only coordinate matrices can be read as graphs";
+        return false;
+    }
+    layout.HasWeights = words[3] != "pattern";
+    layout.IsSymmetric = words[4] != "general";
+    layout.IsSkew = words[4] == "skew-symmetric";
+
+    // Comments, then "rows columns entries".
+    const char* cursor = lineEnd + 1;
+    layout.BodyLine = 1;
+    while (cursor < end) {
+        lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        layout.BodyLine++;
+
+        const char* token = skipSpaces(cursor, lineEnd);
+        cursor = lineEnd + 1;
+        if (token == lineEnd || *token == '%') {
+            continue;
+        }
+
+        std::size_t rows = 0;
+        std::size_t columns = 0;
+        std::from_chars_result parsed = std::from_chars(token, lineEnd, rows);
+        if (parsed.ec == std::errc()) {
+            parsed = std::from_chars(skipSpaces(parsed.ptr, lineEnd), lineEnd, columns);
+        }
+        if (parsed.ec != std::errc()) {
+            error = "bad size line on line " + std::to_string(layout.BodyLine);
+            return false;
+        }
+        layout.VertexCount = std::max(rows, columns);
+        layout.BodyOffset = std::min(cursor, end) - begin;
+        return true;
+    }
+
+    error = "no size line";
+    return false;
+}
+
+const char* GraphIO::skipSpaces(const char* cursor, const char* end) {
+    while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) {
+        cursor++;
+    }
+
+    return cursor;
+}
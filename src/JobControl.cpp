@@ -0,0 +1,37 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "JobControl.hpp"
+
+JobControl::JobControl(void) {
+    m_cancelled = false;
+    m_deadline = 0;
+    m_progress = 0.0f;
+}
+
+void JobControl::Cancel(void) {
+    m_cancelled.store(true, std::memory_order_relaxed);
+}
+
+float JobControl::GetProgress(void) const {
+    return m_progress.load(std::memory_order_relaxed);
+}
+
+bool JobControl::IsCancelled(void) const {
+    if (m_cancelled.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    const std::chrono::steady_clock::rep deadline = m_deadline.load(std::memory_order_relaxed);
+    return deadline != 0 && std::chrono::steady_clock::now().time_since_epoch().count() >= deadline;
+}
+
+void JobControl::SetDeadline(std::chrono::steady_clock::time_point deadline) {
+    m_deadline.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+void JobControl::SetProgress(float progress) {
+    m_progress.store(progress, std::memory_order_relaxed);
+}
@@ -0,0 +1,85 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "JobScheduler.hpp"
+
+JobScheduler::JobScheduler(std::size_t threadCount) : m_pool(threadCount) {
+    m_nextId = 1;
+}
+
+JobScheduler::~JobScheduler() {
+    // The pool drains its queue when it is destroyed, cancelled jobs return quickly.
+    CancelAll();
+}
+
+void JobScheduler::Cancel(std::uint64_t id) {
+    for (JobInfo& job : m_jobs) {
+        if (job.Id == id) {
+            job.Control->Cancel();
+        }
+    }
+}
+
+void JobScheduler::CancelAll(void) {
+    for (JobInfo& job : m_jobs) {
+        job.Control->Cancel();
+    }
+}
+
+const std::vector<JobInfo>& JobScheduler::GetJobs(void) const {
+    return m_jobs;
+}
+
+const std::string& JobScheduler::GetLastError(void) const {
+    return m_lastError;
+}
+
+bool JobScheduler::IsBusy(void) const {
+    return !m_jobs.empty();
+}
+
+std::size_t JobScheduler::Poll(void) {
+    std::vector<std::pair<std::uint64_t, Completion>> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        finished.swap(m_finished);
+    }
+
+    for (auto& [id, completion] : finished) {
+        m_jobs.erase(std::remove_if(m_jobs.begin(), m_jobs.end(), [id](const JobInfo& job) { return job.Id == id; }), m_jobs.end());
+        if (completion) {
+            completion();
+        }
+    }
+
+    return finished.size();
+}
+
+std::uint64_t JobScheduler::Submit(std::string name, Work work) {
+    std::uint64_t id = m_nextId++;
+    std::shared_ptr<JobControl> control = std::make_shared<JobControl>();
+    m_jobs.push_back({ id, name, control });
+
+    m_pool.Submit([this, id, control, name = std::move(name), work = std::move(work)]() {
+        // A job that throws fails on its own, an escaping exception would end the process from the worker.
+        Completion completion;
+        try {
+            completion = work(*control);
+        } catch (const std::exception& exception) {
+            completion = [this, error = name + " failed: " + exception.what()]() {
+                m_lastError = error;
+            };
+        } catch (...) {
+            completion = [this, error = name + " failed"]() {
+                m_lastError = error;
+            };
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finished.emplace_back(id, std::move(completion));
+    });
+
+    return id;
+}
@@ -0,0 +1,140 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "Logger.hpp"
+
+namespace {
+    /// @brief A queued message.
+    typedef struct entry {
+        /// @brief The severity.
+        Logger::Level Level;
+
+        /// @brief The message.
+        std::string Message;
+    } Entry;
+
+    /// @brief The queue and its writer, stopped and drained when the program exits.
+    class Writer {
+        public:
+            /**
+             * @brief Creates the queue and starts the writer thread.
+             */
+            Writer(void) {
+                m_queued = 0;
+                m_written = 0;
+                m_stopping = false;
+                m_thread = std::thread(&Writer::run, this);
+            }
+
+            /**
+             * @brief Writes whatever is still queued and joins the writer thread.
+             */
+            ~Writer() {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stopping = true;
+                }
+                m_ready.notify_one();
+                m_thread.join();
+            }
+
+            /**
+             * @brief Block until every message queued so far has been written.
+             */
+            void Flush(void) {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                const std::uint64_t target = m_queued;
+                m_drained.wait(lock, [&]() { return m_written >= target; });
+            }
+
+            /**
+             * @brief Queue a message and wake the writer.
+             * @param level The severity.
+             * @param message The message.
+             */
+            void Push(Logger::Level level, std::string message) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_pending.push_back({ level, std::move(message) });
+                    m_queued++;
+                }
+                m_ready.notify_one();
+            }
+
+        private:
+            /**
+             * @brief The loop the writer thread runs, a batch at a time, until stopped with nothing left.
+             */
+            void run(void) {
+                static constexpr const char* Prefixes[] = { "[debug] ", "[info] ", "[warning] ", "[error] " };
+
+                std::vector<Entry> batch;
+                std::unique_lock<std::mutex> lock(m_mutex);
+                while (true) {
+                    m_ready.wait(lock, [&]() { return m_stopping || !m_pending.empty(); });
+                    if (m_pending.empty()) {
+                        return;
+                    }
+
+                    // Write outside the lock, producers only ever wait for the swap.
+                    batch.swap(m_pending);
+                    lock.unlock();
+                    for (const Entry& entry : batch) {
+                        std::ostream& stream = entry.Level >= Logger::Warning ? std::cerr : std::cout;
+                        stream << Prefixes[entry.Level] << entry.Message << '\n';
+                    }
+                    std::cout.flush();
+                    std::cerr.flush();
+                    const std::size_t count = batch.size();
+                    batch.clear();
+                    lock.lock();
+                    m_written += count;
+                    m_drained.notify_all();
+                }
+            }
+
+            /// @brief Signalled when a batch has been written.
+            std::condition_variable m_drained;
+
+            /// @brief Guards the queue and the counts.
+            std::mutex m_mutex;
+
+            /// @brief The messages waiting for the writer.
+            std::vector<Entry> m_pending;
+
+            /// @brief The number of messages ever queued.
+            std::uint64_t m_queued;
+
+            /// @brief Signalled when a message is queued or the writer should stop.
+            std::condition_variable m_ready;
+
+            /// @brief Set when the program is exiting.
+            bool m_stopping;
+
+            /// @brief The writer thread.
+            std::thread m_thread;
+
+            /// @brief The number of messages written.
+            std::uint64_t m_written;
+    };
+
+    /**
+     * @brief Get the writer, created on first use so the thread only exists once something is logged.
+     * @return The writer.
+     */
+    Writer& writer(void) {
+        static Writer s_writer;
+        return s_writer;
+    }
+}
+
+void Logger::Flush(void) {
+    writer().Flush();
+}
+
+void Logger::Write(Level level, std::string message) {
+    writer().Push(level, std::move(message));
+}
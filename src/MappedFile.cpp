@@ -0,0 +1,116 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(void) {
+    m_data = nullptr;
+    m_size = 0;
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+void MappedFile::Close(void) {
+    if (m_data) {
+#ifdef _WIN32
+        UnmapViewOfFile(m_data);
+#else
+        munmap(const_cast<std::byte*>(m_data), m_size);
+#endif
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+const std::byte* MappedFile::GetData(void) const {
+    return m_data;
+}
+
+std::size_t MappedFile::GetSize(void) const {
+    return m_size;
+}
+
+bool MappedFile::Open(const std::filesystem::path& path, std::string& error) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "cannot open file";
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        error = "cannot read file size";
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return true;
+    }
+
+    // The view keeps the mapping alive, both handles can go.
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        error = "cannot map file";
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!data) {
+        error = "cannot map file";
+        return false;
+    }
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        error = "cannot open file";
+        return false;
+    }
+    struct stat status;
+    if (fstat(file, &status) != 0) {
+        ::close(file);
+        error = "cannot read file size";
+        return false;
+    }
+    if (status.st_size == 0) {
+        ::close(file);
+        return true;
+    }
+
+    // The mapping holds its own reference to the file, the descriptor can go.
+    void* data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);
+    if (data == MAP_FAILED) {
+        error = "cannot map file";
+        return false;
+    }
+#endif
+
+    m_data = static_cast<const std::byte*>(data);
+#ifdef _WIN32
+    m_size = static_cast<std::size_t>(size.QuadPart);
+#else
+    m_size = static_cast<std::size_t>(status.st_size);
+#endif
+    return true;
+}
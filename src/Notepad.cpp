@@ -5,6 +5,8 @@
 
 #include "pch.hpp"
 #include "Notepad.hpp"
+#include "Logger.hpp"
+#include "Profiler.hpp"
 
 int Notepad::Start(void) {
     // Run the program as long as the window is open.
@@ -24,24 +26,34 @@ int Notepad::Start(void) {
                 return exit();
             default:
                 // Unknown state.
-                std::cerr << "Notepad in unknown state." << std::endl;
+                LOG_ERROR("Notepad in unknown state.");
                 return -1;
         
         }
     } 
 }
 
+void Notepad::clearSelection(void) {
+    for (VertexHandle handle : m_selectedVertices) {
+        VertexId vertex = m_activeGraph->Resolve(handle);
+        if (vertex != InvalidVertexId) {
+            m_activeGraph->SetSelected(vertex, false);
+        }
+    }
+    m_selectedVertices.clear();
+}
+
 bool Notepad::createWindow(void) {
     // Create the window.
     m_window = new sf::RenderWindow(sf::VideoMode({800, 600}), "Graph Theorist's Notepad");
     if (!m_window) {
-        std::cerr << "Failed to create SFML RenderWindow." << std::endl;
+        LOG_ERROR("Failed to create SFML RenderWindow.");
         return false;
     }
 
     // Initialize ImGui-SFML
     if (!ImGui::SFML::Init(*m_window)) {
-        std::cerr << "Failed to initialize ImGui-SFML." << std::endl;
+        LOG_ERROR("Failed to initialize ImGui-SFML.");
         return false;
     }
 
@@ -49,6 +61,12 @@ bool Notepad::createWindow(void) {
 }
 
 int Notepad::exit(void) {
+    // Stop the background jobs before anything they report to goes away.
+    delete m_jobs;
+    m_jobs = nullptr;
+    delete m_layoutPool;
+    m_layoutPool = nullptr;
+
     // Cleanup ImGui-SFML
     ImGui::SFML::Shutdown();
 
@@ -61,66 +79,99 @@ int Notepad::exit(void) {
     return 0;
 }
 
-void Notepad::handleAddEdge(sf::RenderWindow *window) {
+void Notepad::handleAddEdge(sf::Vector2f position) {
     if (m_selectedVertices.size() == 2) {
-        m_activeGraph->AddEdge(*m_selectedVertices[0], *m_selectedVertices[1], 1.0f);
-        m_selectedVertices[0]->Sprite.setOutlineColor(m_activeGraph->Color);
-        m_selectedVertices[1]->Sprite.setOutlineColor(m_activeGraph->Color);
-        m_selectedVertices.clear();
+        VertexId v1 = m_activeGraph->Resolve(m_selectedVertices[0]);
+        VertexId v2 = m_activeGraph->Resolve(m_selectedVertices[1]);
+        if (v1 != InvalidVertexId && v2 != InvalidVertexId) {
+            m_activeGraph->AddEdge(v1, v2, 1.0f);
+        }
+        clearSelection();
     } else {
-        Vertex* vertex = m_activeGraph->GetVertexAtMouse(m_window);
-        if (vertex) {
-            sf::Color outlineColor = m_activeGraph->Color == sf::Color::Red ? sf::Color::Black : sf::Color::Red;
-            vertex->Sprite.setOutlineColor(sf::Color::Red);
-            m_selectedVertices.push_back(vertex);
+        VertexId vertex = m_activeGraph->GetVertexAt(position);
+        if (vertex != InvalidVertexId) {
+            m_activeGraph->SetSelected(vertex, true);
+            m_selectedVertices.push_back(m_activeGraph->GetHandle(vertex));
         }
     }
 }
         
-void Notepad::handleAddVertex(sf::RenderWindow *window) {
-    bool vertexExists = false;
-    for (Vertex vertex : m_activeGraph->GetVertices()) {
-        Vertex *v = m_activeGraph->GetVertexAtMouse(m_window);
-        if (v == &vertex) {
-            vertexExists = true;
-            break;
-        }
-    }
-    if (!vertexExists) {
-        sf::Vector2i mousePos = sf::Mouse::getPosition(*m_window);
-        sf::Vector2f worldPos = m_window->mapPixelToCoords(mousePos);
+void Notepad::handleAddVertex(sf::Vector2f position) {
+    if (m_activeGraph->GetVertexAt(position) == InvalidVertexId) {
         std::string vertexName = "";
-        m_activeGraph->AddVertex(vertexName, worldPos);
+        m_activeGraph->AddVertex(vertexName, position);
     }
 }
 
-void Notepad::handleDelete(sf::RenderWindow *window) {
-    Vertex *vertex = m_activeGraph->GetVertexAtMouse(m_window);
-    int n = 0;
-    for (Vertex &v : m_activeGraph->GetVertices()) {
-        if (&v == vertex) {
-            m_activeGraph->RemoveVertex(n);
-            break;
-        } else {
-            n++;
+void Notepad::handleDelete(sf::Vector2f position) {
+    VertexId vertex = m_activeGraph->GetVertexAt(position);
+    if (vertex != InvalidVertexId) {
+        m_activeGraph->RemoveVertex(vertex);
+    } else if (std::optional<Edge> edge = m_activeGraph->GetEdgeAt(position)) {
+        m_activeGraph->RemoveEdge(edge->Vertex1, edge->Vertex2);
+    }
+}
+
+void Notepad::handleHistory(bool isRedo) {
+    clearSelection();
+    if (isRedo) {
+        m_activeGraph->Redo();
+    } else {
+        m_activeGraph->Undo();
+    }
+}
+
+void Notepad::handlePath(sf::Vector2f position) {
+    // The first click picks the source, the second the target, a click on nothing starts over.
+    VertexId vertex = m_activeGraph->GetVertexAt(position);
+    if (vertex == InvalidVertexId) {
+        clearSelection();
+        m_activeGraph->ClearHighlight();
+        return;
+    }
+    VertexId source = m_selectedVertices.empty() ? InvalidVertexId : m_activeGraph->Resolve(m_selectedVertices[0]);
+    if (source == InvalidVertexId) {
+        clearSelection();
+        m_activeGraph->SetSelected(vertex, true);
+        m_selectedVertices.push_back(m_activeGraph->GetHandle(vertex));
+    } else {
+        clearSelection();
+        Sidebar::StartShortestPath(*m_jobs, m_activeGraph, source, vertex);
+    }
+}
+
+void Notepad::handlePin(void) {
+    bool isPinned = true;
+    for (VertexHandle handle : m_selectedVertices) {
+        VertexId vertex = m_activeGraph->Resolve(handle);
+        if (vertex != InvalidVertexId && !m_activeGraph->IsPinned(vertex)) {
+            isPinned = false;
+        }
+    }
+    for (VertexHandle handle : m_selectedVertices) {
+        VertexId vertex = m_activeGraph->Resolve(handle);
+        if (vertex != InvalidVertexId) {
+            m_activeGraph->SetPinned(vertex, !isPinned);
         }
     }
 }
 
-void Notepad::handleSelect(sf::RenderWindow *window) {
-    if (m_selectedVertices.size() > 0) {
-        Vertex* vertex = m_activeGraph->GetVertexAtMouse(m_window);
-        if (vertex) {
-            m_selectedVertices[0]->Sprite.setOutlineColor(m_activeGraph->Color);
-            m_selectedVertices.clear();
+void Notepad::handleSelect(sf::Vector2f position) {
+    // A selected vertex that has since been removed counts as no selection.
+    VertexId selected = m_selectedVertices.empty() ? InvalidVertexId : m_activeGraph->Resolve(m_selectedVertices[0]);
+    if (selected != InvalidVertexId) {
+        VertexId vertex = m_activeGraph->GetVertexAt(position);
+        if (vertex != InvalidVertexId) {
+            clearSelection();
         } else {
-            m_selectedVertices[0]->Position = m_window->mapPixelToCoords(sf::Mouse::getPosition(*m_window));
+            m_activeGraph->MoveVertex(selected, position);
         }
     } else {
-        Vertex* vertex = m_activeGraph->GetVertexAtMouse(m_window);
-        if (vertex) {
-            m_selectedVertices.push_back(vertex);
-            vertex->Sprite.setOutlineColor(sf::Color::Red);
+        m_selectedVertices.clear();
+        VertexId vertex = m_activeGraph->GetVertexAt(position);
+        if (vertex != InvalidVertexId) {
+            m_selectedVertices.push_back(m_activeGraph->GetHandle(vertex));
+            m_activeGraph->SetSelected(vertex, true);
         }
     }
 }
@@ -131,6 +182,10 @@ bool Notepad::init(void) {
         return false;
     }
 
+    // Start the background job workers.
+    m_jobs = new JobScheduler();
+    m_layoutPool = new ThreadPool();
+
     // Create a default graph.
     Graph* defaultGraph = new Graph();
     defaultGraph->Name = "1";
@@ -143,76 +198,170 @@ bool Notepad::init(void) {
 }
 
 void Notepad::loop(void) {
+    // Block on input while nothing changes, running jobs keep the frames coming for their progress bars and
+    // running layouts for their next iterations.
+    bool isBusy = m_jobs->IsBusy();
+    for (Graph* graph : m_graphs) {
+        isBusy = isBusy || graph->IsLayoutRunning();
+    }
+    if (!isBusy && m_framesToDraw == 0) {
+        if (const std::optional<sf::Event> event = m_window->waitEvent(sf::milliseconds(IdleTimeoutMilliseconds))) {
+            handleEvent(*event);
+        }
+    }
+
+    // A frame starts once there is something to do, idle waits are not counted.
+    Profiler::BeginFrame();
+
     // Process events.
     processEvents();
+    if (Sidebar::HistoryStep != 0) {
+        handleHistory(Sidebar::HistoryStep > 0);
+        Sidebar::HistoryStep = 0;
+    }
+    if (Sidebar::TogglePin) {
+        handlePin();
+        Sidebar::TogglePin = false;
+    }
 
-    // Update active graph.
+    // Layouts move a bounded number of iterations per frame, so large ones animate without holding up input.
+    for (Graph* graph : m_graphs) {
+        if (graph->IsLayoutRunning()) {
+            graph->StepLayout(static_cast<std::size_t>(Sidebar::LayoutIterations), m_layoutPool);
+        }
+    }
+
+    // Hand finished background jobs their results.
+    if (m_jobs->Poll() > 0) {
+        m_framesToDraw = RedrawFrames;
+    }
+
+    // Removals leave slack in the lists, given back here once enough of them add up.
+    for (Graph* graph : m_graphs) {
+        graph->Compact();
+    }
+
+    // Update active graph, and redraw after any edit that did not come from an event.
+    std::uint64_t revision = 0;
     for (Graph* graph : m_graphs) {
         if (graph->IsActive) {
             m_activeGraph = graph;
-            break;
         }
+        revision += graph->GetRevision();
+    }
+    if (revision != m_drawnRevision) {
+        m_drawnRevision = revision;
+        m_framesToDraw = RedrawFrames;
+    }
+
+    if (m_frameLimit != Sidebar::FrameLimit) {
+        m_frameLimit = Sidebar::FrameLimit;
+        m_window->setFramerateLimit(static_cast<unsigned>(m_frameLimit));
     }
 
     // Render the screen.
-    render();
+    if (isBusy || m_framesToDraw > 0) {
+        render();
+        Profiler::EndFrame();
+        if (m_framesToDraw > 0) {
+            m_framesToDraw--;
+        }
+    }
 }
 
-void Notepad::processEvents(void) {
-    // check all the window's events that were triggered since the last iteration of the loop
-    while (const std::optional<sf::Event> event = m_window->pollEvent()) {
-        // "close requested" event: we close the window
-        if (event->is<sf::Event::Closed>()) {
-            m_state = EXITING;
-        }
+void Notepad::handleEvent(const sf::Event& event) {
+    // "close requested" event: we close the window
+    if (event.is<sf::Event::Closed>()) {
+        m_state = EXITING;
+    }
+
+    // Process ImGui-SFML events.
+    ImGui::SFML::ProcessEvent(*m_window, event);
+
+    // Hovering over the canvas changes nothing, unless the camera is being dragged.
+    if (!event.is<sf::Event::MouseMoved>() || ImGui::GetIO().WantCaptureMouse || sf::Mouse::isButtonPressed(sf::Mouse::Button::Right) || sf::Mouse::isButtonPressed(sf::Mouse::Button::Middle)) {
+        m_framesToDraw = RedrawFrames;
+    }
 
-        // Process ImGui-SFML events.
-        ImGui::SFML::ProcessEvent(*m_window, *event);
-
-        // Mouse click
-        // Ask ImGui if it wants the mouse
-        ImGuiIO& io = ImGui::GetIO();
-        if (!io.WantCaptureMouse) {
-            if (event->is<sf::Event::MouseButtonPressed>()) {
-                if (sf::Mouse::isButtonPressed(sf::Mouse::Button::Left)) {
-                    switch (Sidebar::Mode) {
-                        case Sidebar::AddVertex:
-                            handleAddVertex(m_window);
-                            break;
-                        case Sidebar::AddEdge:
-                            handleAddEdge(m_window);
-                            break;
-                        case Sidebar::Delete:
-                            handleDelete(m_window);
-                            break;
-                        case Sidebar::Select:
-                            handleSelect(m_window);
-                            break;
-                        default:
-                            break;
-                    }
+    // Mouse click
+    // Ask ImGui if it wants the mouse, a release always reaches the camera so a drag can't get stuck.
+    ImGuiIO& io = ImGui::GetIO();
+    if (!io.WantCaptureMouse || event.is<sf::Event::MouseButtonReleased>()) {
+        Canvas::HandleEvent(m_window, event);
+    }
+    // Ctrl+Z undoes, Ctrl+Shift+Z or Ctrl+Y redoes, P pins the selection, F3 shows the profiler.
+    if (!io.WantCaptureKeyboard) {
+        if (const auto* key = event.getIf<sf::Event::KeyPressed>()) {
+            if (key->control && key->code == sf::Keyboard::Key::Z) {
+                handleHistory(key->shift);
+            } else if (key->control && key->code == sf::Keyboard::Key::Y) {
+                handleHistory(true);
+            } else if (key->code == sf::Keyboard::Key::P) {
+                handlePin();
+            } else if (key->code == sf::Keyboard::Key::F3) {
+                Sidebar::ShowProfiler = !Sidebar::ShowProfiler;
+            }
+        }
+    }
+    if (!io.WantCaptureMouse) {
+        if (const auto* pressed = event.getIf<sf::Event::MouseButtonPressed>()) {
+            if (pressed->button == sf::Mouse::Button::Left) {
+                // Map the click into world coordinates once for the handlers.
+                sf::Vector2f position = Canvas::MapPixelToWorld(pressed->position);
+                switch (Sidebar::Mode) {
+                    case Sidebar::AddVertex:
+                        handleAddVertex(position);
+                        break;
+                    case Sidebar::AddEdge:
+                        handleAddEdge(position);
+                        break;
+                    case Sidebar::Delete:
+                        handleDelete(position);
+                        break;
+                    case Sidebar::Select:
+                        handleSelect(position);
+                        break;
+                    case Sidebar::ShortestPath:
+                        handlePath(position);
+                        break;
+                    default:
+                        break;
                 }
             }
         }
     }
 }
 
+void Notepad::processEvents(void) {
+    PROFILE_ZONE("Notepad::processEvents");
+
+    // check all the window's events that were triggered since the last iteration of the loop
+    while (const std::optional<sf::Event> event = m_window->pollEvent()) {
+        handleEvent(*event);
+    }
+}
+
 void Notepad::render(void) {
     // clear the window with black color
     m_window->clear(sf::Color::White);
 
-    // Draw graphs.
-    Sidebar::Draw(m_window, m_graphs, m_time.restart());
+    // Draw graphs, then the sidebar on top of them.
     Canvas::Draw(m_window, m_graphs);
+    Sidebar::Draw(m_window, m_graphs, *m_jobs, m_time.restart());
 
     // draw the previous frame.
     m_window->display();
 }
 
 Graph* Notepad::m_activeGraph = nullptr;
+std::uint64_t Notepad::m_drawnRevision = 0;
+int Notepad::m_frameLimit = -1;
+int Notepad::m_framesToDraw = Notepad::RedrawFrames;
 std::vector<Graph*> Notepad::m_graphs;
+JobScheduler* Notepad::m_jobs = nullptr;
+ThreadPool* Notepad::m_layoutPool = nullptr;
 Notepad::State Notepad::m_state = Notepad::INITIALIZING;
 sf::Clock Notepad::m_time;
 sf::RenderWindow *Notepad::m_window = nullptr;
 
-std::vector<Vertex*> Notepad::m_selectedVertices;
\ No newline at end of file
+std::vector<VertexHandle> Notepad::m_selectedVertices;
\ No newline at end of file
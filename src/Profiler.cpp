@@ -0,0 +1,210 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "Profiler.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    /// @brief The number of global allocations ever made, counted by the operator new below.
+    constinit std::atomic<std::uint64_t> s_allocations = 0;
+
+    /// @brief The number of bytes ever asked of the global operator new.
+    constinit std::atomic<std::uint64_t> s_allocatedBytes = 0;
+
+    /// @brief When the profiler started, zone times count from here.
+    const std::chrono::steady_clock::time_point s_start = std::chrono::steady_clock::now();
+}
+
+#ifdef NOTEPAD_PROFILING
+void* operator new(std::size_t size) {
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+#endif
+
+std::vector<Profiler::ThreadBuffer*> Profiler::m_buffers;
+std::mutex Profiler::m_buffersMutex;
+std::atomic<std::uint64_t> Profiler::m_drawCalls = 0;
+std::uint64_t Profiler::m_frameAllocations = 0;
+std::size_t Profiler::m_frameCount = 0;
+std::uint64_t Profiler::m_frameStart = 0;
+std::vector<float> Profiler::m_frameTimes;
+std::uint64_t Profiler::m_lastAllocations = 0;
+std::uint64_t Profiler::m_lastDrawCalls = 0;
+std::deque<Profiler::ZoneRecord> Profiler::m_trace;
+std::unordered_map<std::string_view, Profiler::ZoneHistory> Profiler::m_zones;
+
+Profiler::Zone::Zone(const char* name) {
+    m_name = name;
+    m_start = now();
+}
+
+Profiler::Zone::~Zone() {
+    ThreadBuffer& ring = buffer();
+    const std::uint64_t head = ring.Head.load(std::memory_order_relaxed);
+    if (head - ring.Tail.load(std::memory_order_acquire) >= ring.Records.size()) {
+        return;
+    }
+    ring.Records[head % ring.Records.size()] = { m_name, m_start, now(), ring.Thread };
+    ring.Head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::BeginFrame(void) {
+    m_frameStart = now();
+    m_frameAllocations = s_allocations.load(std::memory_order_relaxed);
+    m_drawCalls.store(0, std::memory_order_relaxed);
+}
+
+void Profiler::CountDrawCall(void) {
+    m_drawCalls.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Profiler::EndFrame(void) {
+    const float frameTime = static_cast<float>(now() - m_frameStart) * 1e-6f;
+    if (m_frameTimes.size() < FrameHistoryLength) {
+        m_frameTimes.push_back(frameTime);
+    } else {
+        m_frameTimes[m_frameCount % FrameHistoryLength] = frameTime;
+    }
+    m_frameCount++;
+    m_lastAllocations = s_allocations.load(std::memory_order_relaxed) - m_frameAllocations;
+    m_lastDrawCalls = m_drawCalls.load(std::memory_order_relaxed);
+
+    // Copy the list so threads registering now do not wait on the gathering below.
+    std::vector<ThreadBuffer*> buffers;
+    {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        buffers = m_buffers;
+    }
+
+    for (ThreadBuffer* ring : buffers) {
+        std::uint64_t tail = ring->Tail.load(std::memory_order_relaxed);
+        const std::uint64_t head = ring->Head.load(std::memory_order_acquire);
+        for (; tail < head; tail++) {
+            const ZoneRecord& record = ring->Records[tail % ring->Records.size()];
+            ZoneHistory& history = m_zones[record.Name];
+            const float time = static_cast<float>(record.End - record.Start) * 1e-6f;
+            if (history.Times.size() < ZoneHistoryLength) {
+                history.Times.push_back(time);
+            } else {
+                history.Times[history.Count % ZoneHistoryLength] = time;
+            }
+            history.Count++;
+            m_trace.push_back(record);
+        }
+        ring->Tail.store(tail, std::memory_order_release);
+    }
+    while (m_trace.size() > TraceLength) {
+        m_trace.pop_front();
+    }
+}
+
+std::uint64_t Profiler::GetAllocations(void) {
+    return m_lastAllocations;
+}
+
+void Profiler::GetAllocationTotals(std::uint64_t& count, std::uint64_t& bytes) {
+    count = s_allocations.load(std::memory_order_relaxed);
+    bytes = s_allocatedBytes.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Profiler::GetDrawCalls(void) {
+    return m_lastDrawCalls;
+}
+
+std::vector<float> Profiler::GetFrameTimes(void) {
+    // Unroll the ring so the oldest frame comes first.
+    std::vector<float> times;
+    times.reserve(m_frameTimes.size());
+    const std::size_t first = m_frameTimes.size() < FrameHistoryLength ? 0 : m_frameCount % FrameHistoryLength;
+    for (std::size_t i = 0; i < m_frameTimes.size(); i++) {
+        times.push_back(m_frameTimes[(first + i) % m_frameTimes.size()]);
+    }
+
+    return times;
+}
+
+std::vector<ZoneStats> Profiler::GetZones(void) {
+    std::vector<ZoneStats> zones;
+    std::vector<float> times;
+    for (const auto& [name, history] : m_zones) {
+        times = history.Times;
+        std::sort(times.begin(), times.end());
+        auto percentile = [&](double fraction) {
+            return static_cast<double>(times[std::min(times.size() - 1, static_cast<std::size_t>(fraction * times.size()))]);
+        };
+        zones.push_back({ name, times.size(), percentile(0.5), percentile(0.9), percentile(0.99), static_cast<double>(times.back()) });
+    }
+    std::sort(zones.begin(), zones.end(), [](const ZoneStats& a, const ZoneStats& b) { return a.Name < b.Name; });
+
+    return zones;
+}
+
+bool Profiler::WriteTrace(const std::filesystem::path& path, std::string& error) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        error = "cannot create file";
+        return false;
+    }
+
+    // Complete events, times in microseconds, one track per thread.
+    file << std::fixed;
+    file.precision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool isFirst = true;
+    for (const ZoneRecord& record : m_trace) {
+        file << (isFirst ? "\n" : ",\n");
+        isFirst = false;
+        file << "{\"name\":\"";
+        for (const char* c = record.Name; *c; c++) {
+            if (*c == '"' || *c == '\\') {
+                file << '\\';
+            }
+            file << *c;
+        }
+        file << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << record.Thread;
+        file << ",\"ts\":" << static_cast<double>(record.Start) * 1e-3 << ",\"dur\":" << static_cast<double>(record.End - record.Start) * 1e-3 << "}";
+    }
+    file << "\n]}\n";
+    file.close();
+    if (!file) {
+        error = "cannot write file";
+        return false;
+    }
+
+    return true;
+}
+
+Profiler::ThreadBuffer& Profiler::buffer(void) {
+    thread_local ThreadBuffer* t_buffer = nullptr;
+    if (!t_buffer) {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        t_buffer = new ThreadBuffer();
+        t_buffer->Thread = static_cast<std::uint32_t>(m_buffers.size());
+        m_buffers.push_back(t_buffer);
+    }
+
+    return *t_buffer;
+}
+
+std::uint64_t Profiler::now(void) {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_start).count());
+}
@@ -0,0 +1,457 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "ShortestPaths.hpp"
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
+
+#include <map>
+
+namespace {
+    /// @brief A 4-ary min heap of vertices keyed by distance, with decrease key.
+    class QuaternaryHeap {
+        public:
+            /**
+             * @brief Creates an empty heap.
+             * @param size The number of vertices, ids are below it.
+             */
+            QuaternaryHeap(std::size_t size) : m_position(size, Absent) {
+            }
+
+            /**
+             * @brief Is the heap empty?
+             * @return True if there is nothing to pop.
+             */
+            bool IsEmpty(void) const {
+                return m_items.empty();
+            }
+
+            /**
+             * @brief Take the vertex with the smallest key out.
+             * @return The vertex.
+             */
+            VertexId Pop(void) {
+                const VertexId top = m_items[0];
+                m_position[top] = Absent;
+                const VertexId last = m_items.back();
+                const float key = m_keys.back();
+                m_items.pop_back();
+                m_keys.pop_back();
+                if (!m_items.empty()) {
+                    siftDown(0, last, key);
+                }
+
+                return top;
+            }
+
+            /**
+             * @brief Insert a vertex, or lower its key if it is in the heap already.
+             * @param v The vertex.
+             * @param key The key, at most its current one.
+             */
+            void Update(VertexId v, float key) {
+                std::uint32_t index = m_position[v];
+                if (index == Absent) {
+                    index = static_cast<std::uint32_t>(m_items.size());
+                    m_items.push_back(v);
+                    m_keys.push_back(key);
+                }
+                siftUp(index, v, key);
+            }
+
+        private:
+            /**
+             * @brief Move the hole at an index down to where an item belongs and put it there.
+             * @param index The hole.
+             * @param item The item.
+             * @param key Its key.
+             */
+            void siftDown(std::size_t index, VertexId item, float key) {
+                const std::size_t size = m_items.size();
+                while (true) {
+                    const std::size_t first = 4 * index + 1;
+                    if (first >= size) {
+                        break;
+                    }
+                    std::size_t best = first;
+                    for (std::size_t child = first + 1; child < std::min(first + 4, size); child++) {
+                        if (m_keys[child] < m_keys[best]) {
+                            best = child;
+                        }
+                    }
+                    if (m_keys[best] >= key) {
+                        break;
+                    }
+                    place(index, m_items[best], m_keys[best]);
+                    index = best;
+                }
+                place(index, item, key);
+            }
+
+            /**
+             * @brief Move the hole at an index up to where an item belongs and put it there.
+             * @param index The hole.
+             * @param item The item.
+             * @param key Its key.
+             */
+            void siftUp(std::size_t index, VertexId item, float key) {
+                while (index > 0) {
+                    const std::size_t parent = (index - 1) / 4;
+                    if (m_keys[parent] <= key) {
+                        break;
+                    }
+                    place(index, m_items[parent], m_keys[parent]);
+                    index = parent;
+                }
+                place(index, item, key);
+            }
+
+            /**
+             * @brief Put an item at an index.
+             * @param index The index.
+             * @param item The item.
+             * @param key Its key.
+             */
+            void place(std::size_t index, VertexId item, float key) {
+                m_items[index] = item;
+                m_keys[index] = key;
+                m_position[item] = static_cast<std::uint32_t>(index);
+            }
+
+            /// @brief The vertex at every heap slot.
+            std::vector<VertexId> m_items;
+
+            /// @brief The key at every heap slot, apart from the items so a sift compares within few cache lines.
+            std::vector<float> m_keys;
+
+            /// @brief The heap slot of every vertex, Absent if it is not in the heap.
+            std::vector<std::uint32_t> m_position;
+
+            /// @brief The position of a vertex not in the heap.
+            static constexpr std::uint32_t Absent = std::numeric_limits<std::uint32_t>::max();
+    };
+
+    /**
+     * @brief Start a single source result, every vertex unreachable.
+     * @param topology The graph.
+     * @return The result, HasNegativeWeight set if any edge weight is negative.
+     */
+    PathResult emptyResult(const AdjacencyStore& topology) {
+        const AdjacencyStore::CSR& csr = topology.GetCSR();
+        PathResult result;
+        result.Distance.assign(topology.GetVertexCount(), std::numeric_limits<float>::infinity());
+        result.Parent.assign(topology.GetVertexCount(), InvalidVertexId);
+        result.HasNegativeWeight = std::any_of(csr.Entries.begin(), csr.Entries.end(), [](const Neighbor& entry) { return entry.Weight < 0.0f; });
+
+        return result;
+    }
+}
+
+std::vector<float> ShortestPaths::AllPairs(const AdjacencyStore& topology, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("ShortestPaths::AllPairs");
+    const std::size_t n = topology.GetVertexCount();
+    if (n > AllPairsLimit) {
+        return {};
+    }
+
+    // Padded to whole blocks, the padding has no edges so it never shortens anything.
+    const std::size_t blocks = (n + BlockSize - 1) / BlockSize;
+    const std::size_t stride = blocks * BlockSize;
+    std::vector<float> distances(stride * stride, std::numeric_limits<float>::infinity());
+    for (std::size_t i = 0; i < stride; i++) {
+        distances[i * stride + i] = 0.0f;
+    }
+    const AdjacencyStore::CSR& csr = topology.GetCSR();
+    for (VertexId v = 0; v < n; v++) {
+        for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+            float& cell = distances[v * stride + csr.Entries[e].Target];
+            cell = std::min(cell, csr.Entries[e].Weight);
+        }
+    }
+
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    std::unique_ptr<ThreadPool> pool;
+    if (threadCount > 1 && blocks > 2) {
+        pool = std::make_unique<ThreadPool>(threadCount);
+    }
+    float* matrix = distances.data();
+    for (std::size_t pivot = 0; pivot < blocks; pivot++) {
+        if (control) {
+            if (control->IsCancelled()) {
+                break;
+            }
+            control->SetProgress(static_cast<float>(pivot) / blocks);
+        }
+
+        // The pivot block depends only on itself, its row and column only on it, everything else on those.
+        relaxBlock(matrix, stride, pivot, pivot, pivot);
+        auto cross = [=](std::size_t other) {
+            relaxBlock(matrix, stride, pivot, other, pivot);
+            relaxBlock(matrix, stride, other, pivot, pivot);
+        };
+        auto rest = [=](std::size_t row) {
+            for (std::size_t column = 0; column < blocks; column++) {
+                if (column != pivot) {
+                    relaxBlock(matrix, stride, row, column, pivot);
+                }
+            }
+        };
+        for (int stage = 0; stage < 2; stage++) {
+            for (std::size_t other = 0; other < blocks; other++) {
+                if (other == pivot) {
+                    continue;
+                }
+                if (pool) {
+                    pool->Submit([&, other, stage]() {
+                        stage == 0 ? cross(other) : rest(other);
+                    });
+                } else {
+                    stage == 0 ? cross(other) : rest(other);
+                }
+            }
+            if (pool) {
+                pool->Wait();
+            }
+        }
+    }
+
+    // Back to n x n.
+    std::vector<float> result(n * n);
+    for (std::size_t i = 0; i < n; i++) {
+        std::copy_n(distances.begin() + i * stride, n, result.begin() + i * n);
+    }
+
+    return result;
+}
+
+PathResult ShortestPaths::DeltaStepping(const AdjacencyStore& topology, VertexId source, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("ShortestPaths::DeltaStepping");
+    const AdjacencyStore::CSR& csr = topology.GetCSR();
+    const std::size_t n = topology.GetVertexCount();
+    PathResult result = emptyResult(topology);
+    if (source >= n || result.HasNegativeWeight) {
+        return result;
+    }
+
+    // Buckets as wide as the mean weight, light edges stay within a bucket or reach the next.
+    double totalWeight = 0.0;
+    for (const Neighbor& entry : csr.Entries) {
+        totalWeight += entry.Weight;
+    }
+    const float delta = totalWeight > 0.0 ? static_cast<float>(totalWeight / csr.Entries.size()) : 1.0f;
+    auto bucketOf = [delta](float distance) {
+        return static_cast<std::size_t>(distance / delta);
+    };
+
+    std::unique_ptr<std::atomic<float>[]> distance(new std::atomic<float>[n]);
+    for (std::size_t v = 0; v < n; v++) {
+        distance[v].store(std::numeric_limits<float>::infinity(), std::memory_order_relaxed);
+    }
+    distance[source].store(0.0f, std::memory_order_relaxed);
+
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    std::unique_ptr<ThreadPool> pool;
+    if (threadCount > 1) {
+        pool = std::make_unique<ThreadPool>(threadCount);
+    }
+    std::vector<std::vector<VertexId>> improved(threadCount * 4);
+
+    // Relax the light or heavy edges of some vertices, keeping the targets whose distance went down.
+    auto relax = [&](const std::vector<VertexId>& vertices, bool isLight) {
+        auto chunk = [&](std::size_t begin, std::size_t end, std::vector<VertexId>& out) {
+            for (std::size_t i = begin; i < end; i++) {
+                const VertexId v = vertices[i];
+                const float base = distance[v].load(std::memory_order_relaxed);
+                for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+                    const float weight = csr.Entries[e].Weight;
+                    if ((weight <= delta) != isLight) {
+                        continue;
+                    }
+                    const VertexId u = csr.Entries[e].Target;
+                    const float candidate = base + weight;
+                    float current = distance[u].load(std::memory_order_relaxed);
+                    while (candidate < current) {
+                        if (distance[u].compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+                            out.push_back(u);
+                            break;
+                        }
+                    }
+                }
+            }
+        };
+        for (std::vector<VertexId>& out : improved) {
+            out.clear();
+        }
+        if (!pool || vertices.size() < ParallelThreshold) {
+            chunk(0, vertices.size(), improved[0]);
+            return;
+        }
+        const std::size_t chunks = improved.size();
+        for (std::size_t c = 0; c < chunks; c++) {
+            pool->Submit([&, c]() {
+                chunk(vertices.size() * c / chunks, vertices.size() * (c + 1) / chunks, improved[c]);
+            });
+        }
+        pool->Wait();
+    };
+
+    // Buckets by index, a vertex may sit in several, only the one matching its distance counts.
+    std::map<std::size_t, std::vector<VertexId>> buckets;
+    auto fill = [&]() {
+        for (const std::vector<VertexId>& out : improved) {
+            for (VertexId u : out) {
+                buckets[bucketOf(distance[u].load(std::memory_order_relaxed))].push_back(u);
+            }
+        }
+    };
+    buckets[0].push_back(source);
+
+    std::vector<std::uint32_t> phaseMark(n, 0);
+    std::vector<std::size_t> settledIn(n, std::numeric_limits<std::size_t>::max());
+    std::uint32_t phase = 0;
+    std::size_t settledCount = 0;
+    std::vector<VertexId> frontier;
+    std::vector<VertexId> settled;
+    while (!buckets.empty()) {
+        if (control) {
+            if (control->IsCancelled()) {
+                break;
+            }
+            control->SetProgress(static_cast<float>(settledCount) / n);
+        }
+
+        // Light edges until the bucket stays empty, they can refill it.
+        const std::size_t bucket = buckets.begin()->first;
+        settled.clear();
+        for (auto it = buckets.begin(); it != buckets.end() && it->first == bucket; it = buckets.begin()) {
+            std::vector<VertexId> entries = std::move(it->second);
+            buckets.erase(it);
+            phase++;
+            frontier.clear();
+            for (VertexId v : entries) {
+                if (phaseMark[v] != phase && bucketOf(distance[v].load(std::memory_order_relaxed)) == bucket) {
+                    phaseMark[v] = phase;
+                    frontier.push_back(v);
+                    if (settledIn[v] != bucket) {
+                        settledIn[v] = bucket;
+                        settled.push_back(v);
+                    }
+                }
+            }
+            relax(frontier, true);
+            fill();
+        }
+
+        // Heavy edges once, they only reach later buckets.
+        settledCount += settled.size();
+        relax(settled, false);
+        fill();
+    }
+
+    for (VertexId v = 0; v < n; v++) {
+        result.Distance[v] = distance[v].load(std::memory_order_relaxed);
+    }
+    treeFromDistances(topology, source, result);
+
+    return result;
+}
+
+PathResult ShortestPaths::Dijkstra(const AdjacencyStore& topology, VertexId source, JobControl* control) {
+    PROFILE_ZONE("ShortestPaths::Dijkstra");
+    const AdjacencyStore::CSR& csr = topology.GetCSR();
+    const std::size_t n = topology.GetVertexCount();
+    PathResult result = emptyResult(topology);
+    if (source >= n || result.HasNegativeWeight) {
+        return result;
+    }
+
+    QuaternaryHeap heap(n);
+    result.Distance[source] = 0.0f;
+    heap.Update(source, 0.0f);
+    std::size_t settled = 0;
+    while (!heap.IsEmpty()) {
+        const VertexId v = heap.Pop();
+        settled++;
+        if (control && settled % 4096 == 0) {
+            if (control->IsCancelled()) {
+                break;
+            }
+            control->SetProgress(static_cast<float>(settled) / n);
+        }
+
+        const float base = result.Distance[v];
+        for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+            const VertexId u = csr.Entries[e].Target;
+            const float candidate = base + csr.Entries[e].Weight;
+            if (candidate < result.Distance[u]) {
+                result.Distance[u] = candidate;
+                result.Parent[u] = v;
+                heap.Update(u, candidate);
+            }
+        }
+    }
+
+    return result;
+}
+
+std::vector<VertexId> ShortestPaths::Path(const PathResult& result, VertexId target) {
+    std::vector<VertexId> path;
+    if (target >= result.Distance.size() || result.Distance[target] == std::numeric_limits<float>::infinity()) {
+        return path;
+    }
+
+    for (VertexId v = target; v != InvalidVertexId; v = result.Parent[v]) {
+        path.push_back(v);
+    }
+    std::reverse(path.begin(), path.end());
+
+    return path;
+}
+
+PathResult ShortestPaths::SingleSource(const AdjacencyStore& topology, VertexId source, std::size_t maxThreads, JobControl* control) {
+    // Delta-stepping only pays for its phases once there are enough vertices to go around the threads.
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    if (threadCount > 1 && topology.GetVertexCount() >= DeltaSteppingThreshold) {
+        return DeltaStepping(topology, source, threadCount, control);
+    }
+
+    return Dijkstra(topology, source, control);
+}
+
+void ShortestPaths::relaxBlock(float* distances, std::size_t stride, std::size_t rowBlock, std::size_t columnBlock, std::size_t pivotBlock) {
+    const std::size_t rowStart = rowBlock * BlockSize;
+    const std::size_t columnStart = columnBlock * BlockSize;
+    for (std::size_t k = pivotBlock * BlockSize; k < (pivotBlock + 1) * BlockSize; k++) {
+        const float* pivotRow = distances + k * stride + columnStart;
+        for (std::size_t i = rowStart; i < rowStart + BlockSize; i++) {
+            const float through = distances[i * stride + k];
+            if (through == std::numeric_limits<float>::infinity()) {
+                continue;
+            }
+            float* row = distances + i * stride + columnStart;
+            for (std::size_t j = 0; j < BlockSize; j++) {
+                row[j] = std::min(row[j], through + pivotRow[j]);
+            }
+        }
+    }
+}
+
+void ShortestPaths::treeFromDistances(const AdjacencyStore& topology, VertexId source, PathResult& result) {
+    // An edge is tight if it ends exactly at its target's distance, a search along tight edges gives a tree.
+    const AdjacencyStore::CSR& csr = topology.GetCSR();
+    std::vector<VertexId> queue;
+    queue.push_back(source);
+    for (std::size_t head = 0; head < queue.size(); head++) {
+        const VertexId v = queue[head];
+        for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+            const VertexId u = csr.Entries[e].Target;
+            if (u != source && result.Parent[u] == InvalidVertexId && result.Distance[v] + csr.Entries[e].Weight == result.Distance[u]) {
+                result.Parent[u] = v;
+                queue.push_back(u);
+            }
+        }
+    }
+}
@@ -5,8 +5,15 @@
 
 #include "pch.hpp"
 #include "Sidebar.hpp"
-
-void Sidebar::Draw(sf::RenderWindow *window, std::vector<Graph*>& graphs, sf::Time deltaTime) {
+#include "Cliques.hpp"
+#include "Coloring.hpp"
+#include "GraphIO.hpp"
+#include "Profiler.hpp"
+#include "ShortestPaths.hpp"
+#include "SpanningTrees.hpp"
+
+void Sidebar::Draw(sf::RenderWindow *window, std::vector<Graph*>& graphs, JobScheduler& jobs, sf::Time deltaTime) {
+    PROFILE_ZONE("Sidebar::Draw");
     float panelWidth = 260.0f;
     auto size = window->getSize();
 
@@ -26,6 +33,24 @@ void Sidebar::Draw(sf::RenderWindow *window, std::vector<Graph*>& graphs, sf::Ti
     ImGui::RadioButton("Add Vertex", &Mode, Sidebar::AddVertex);
     ImGui::RadioButton("Add Edge", &Mode, Sidebar::AddEdge);
     ImGui::RadioButton("Delete", &Mode, Sidebar::Delete);
+    ImGui::RadioButton("Shortest Path", &Mode, Sidebar::ShortestPath);
+
+    // The notepad owns the selection, so it carries the step out.
+    ImGui::BeginDisabled(!currentActiveGraph || !currentActiveGraph->CanUndo());
+    if (ImGui::Button("Undo")) {
+        HistoryStep = -1;
+    }
+    ImGui::EndDisabled();
+    ImGui::SameLine();
+    ImGui::BeginDisabled(!currentActiveGraph || !currentActiveGraph->CanRedo());
+    if (ImGui::Button("Redo")) {
+        HistoryStep = 1;
+    }
+    ImGui::EndDisabled();
+
+    // Nothing is drawn while idle, this only caps busy periods.
+    ImGui::SliderInt("Frame cap", &FrameLimit, 0, 240, FrameLimit == 0 ? "Unlimited" : "%d fps");
+    ImGui::Checkbox("Profiler (F3)", &ShowProfiler);
 
     if (graphs.size() > 0) {
         ImGui::Separator();
@@ -90,44 +115,42 @@ void Sidebar::Draw(sf::RenderWindow *window, std::vector<Graph*>& graphs, sf::Ti
             ImGui::EndPopup();
         }
 
-        int n = static_cast<int>(graph->AdjacencyMatrix.size());
+        // Results of finished jobs.
+        for (const auto& [label, value] : m_results[graph]) {
+            ImGui::TextWrapped("%s: %s", label.c_str(), value.c_str());
+        }
+
+        int n = static_cast<int>(graph->GetTopology().GetVertexCount());
         if (n <= 0) {
             ImGui::PopID();
             continue;
         }
 
-        ImGui::Text("Adjacency Matrix (%d x %d)", n, n);
-
-        // unique ID per graph so ImGui doesn't confuse the tables
-        std::string tableId = "Table::" + std::to_string(idx);
-
-        if (ImGui::BeginTable(tableId.c_str(), n + 1, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
-
-            // Header row.
-            ImGui::TableNextRow();
-            ImGui::TableSetColumnIndex(0);
-            ImGui::Text(" ");
-
-            for (int col = 0; col < n; ++col) {
-                ImGui::TableSetColumnIndex(col + 1);
-                ImGui::Text("%d", col);
-            }
-
-            // Data rows.
-            for (int row = 0; row < n; ++row) {
-                ImGui::TableNextRow();
-
-                // Row label.
-                ImGui::TableSetColumnIndex(0);
-                ImGui::Text("%d", row);
-
-                for (int col = 0; col < n; ++col) {
-                    ImGui::TableSetColumnIndex(col + 1);
-                    ImGui::Text("%.0f", graph->AdjacencyMatrix[row][col]);
-                }
+        // The store keeps its components up to date as the graph is edited, so this is cheap every frame.
+        ImGui::Text("Components: %zu", graph->GetTopology().GetComponentCount());
+        ImGui::SameLine();
+        ImGui::Checkbox("Tint", &graph->TintComponents);
+
+        // Distances replace the edge weights once computed, the adjacency matrix stays up until then.
+        Distances& distances = m_distances[graph];
+        ImGui::Checkbox("Distances", &distances.IsShown);
+        const std::vector<float>* values = nullptr;
+        if (distances.IsShown) {
+            if (n > static_cast<int>(ShortestPaths::AllPairsLimit)) {
+                ImGui::Text("Distances need at most %zu vertices", ShortestPaths::AllPairsLimit);
+            } else if (distances.Version == graph->GetTopology().GetVersion() && distances.Values.size() == static_cast<std::size_t>(n) * n) {
+                values = &distances.Values;
+            } else {
+                startDistances(jobs, graph);
             }
+        }
+        ImGui::Text("%s Matrix (%d x %d)", values ? "Distance" : "Adjacency", n, n);
 
-            ImGui::EndTable();
+        // Big matrices are unreadable as text, show their structure instead.
+        if (n > MatrixTextLimit) {
+            drawHeatmap(graph, values);
+        } else {
+            drawMatrix(graph, values);
         }
         ImGui::PopID();
         ImGui::Separator();
@@ -147,24 +170,776 @@ void Sidebar::Draw(sf::RenderWindow *window, std::vector<Graph*>& graphs, sf::Ti
         graphs.push_back(newGraph);
     }
 
+    // Graph files, the active graph is saved and an opened file becomes a new graph.
+    ImGui::InputText("File", m_filePath, sizeof(m_filePath));
+    if (ImGui::Button("Save") && currentActiveGraph) {
+        std::string error;
+        if (currentActiveGraph->Save(m_filePath, error)) {
+            m_fileStatus = "Saved graph " + currentActiveGraph->Name + " to " + m_filePath;
+        } else {
+            m_fileStatus = "Cannot save " + std::string(m_filePath) + ": " + error;
+        }
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Open")) {
+        std::filesystem::path path = m_filePath;
+        if (path.extension() == ".gtn") {
+            Graph* loaded = new Graph();
+            std::string error;
+            if (loaded->Load(path, error)) {
+                loaded->Name = path.stem().string();
+                graphs.push_back(loaded);
+                m_fileStatus = "Opened " + path.string();
+            } else {
+                delete loaded;
+                m_fileStatus = "Cannot open " + path.string() + ": " + error;
+            }
+        } else {
+            // Text formats can be large, they are parsed in the background and become a graph once read.
+            std::vector<Graph*>* list = &graphs;
+            m_fileStatus.clear();
+            jobs.Submit("Import of " + path.filename().string(), [list, path](JobControl& control) -> JobScheduler::Completion {
+                auto topology = std::make_shared<AdjacencyStore>();
+                std::string error;
+                if (!GraphIO::Read(path, GraphIO::DetectFormat(path), *topology, error, jobThreads(), &control)) {
+                    return [path, error]() {
+                        m_fileStatus = "Cannot import " + path.string() + ": " + error;
+                    };
+                }
+                return [list, path, topology]() {
+                    Graph* imported = new Graph();
+                    imported->Import(std::move(*topology));
+                    imported->Name = path.stem().string();
+                    list->push_back(imported);
+                    m_fileStatus = "Imported " + path.string();
+                };
+            });
+        }
+    }
+    if (!m_fileStatus.empty()) {
+        ImGui::TextWrapped("%s", m_fileStatus.c_str());
+    }
+
+    // Generated graphs are built in the background and become a new graph once done.
+    const std::vector<Generators::Family>& families = Generators::GetFamilies();
+    if (ImGui::BeginCombo("Family", families[m_generatorFamily].Name)) {
+        for (int i = 0; i < static_cast<int>(families.size()); i++) {
+            if (ImGui::Selectable(families[i].Name, i == m_generatorFamily)) {
+                m_generatorFamily = i;
+                m_generatorValues.clear();
+            }
+        }
+        ImGui::EndCombo();
+    }
+    const Generators::Family& family = families[m_generatorFamily];
+    if (m_generatorValues.size() != family.Parameters.size()) {
+        m_generatorValues.clear();
+        for (const Generators::Parameter& parameter : family.Parameters) {
+            m_generatorValues.push_back(parameter.Default);
+        }
+    }
+    for (std::size_t i = 0; i < family.Parameters.size(); i++) {
+        ImGui::InputDouble(family.Parameters[i].Name, &m_generatorValues[i], 0.0, 0.0, family.Parameters[i].IsInteger ? "%.0f" : "%g");
+    }
+    ImGui::InputInt("Seed", &m_generatorSeed);
+    if (ImGui::Button("Generate")) {
+        startGenerator(jobs, graphs);
+    }
+    if (!m_generatorStatus.empty()) {
+        ImGui::TextWrapped("%s", m_generatorStatus.c_str());
+    }
+
     ImVec2 calcButtonSize(300.0f, 28.0f);
 
-    if (ImGui::Button("Calc Spanning Trees", calcButtonSize)) {
-        std::cout << "Number of spanning trees in Graph " << currentActiveGraph->Name << ": " << currentActiveGraph->CalculateNumberOfSpanningTrees() << "." << std::endl;
+    // Algorithms run on a snapshot in the background, their results come back through JobScheduler::Poll().
+    if (ImGui::Button("Calc Spanning Trees", calcButtonSize) && currentActiveGraph) {
+        Graph* graph = currentActiveGraph;
+        std::shared_ptr<const AdjacencyStore> snapshot = graph->GetSnapshot();
+        jobs.Submit("Spanning trees of graph " + graph->Name, [graph, snapshot](JobControl& control) -> JobScheduler::Completion {
+            BigUnsigned count = SpanningTrees::Count(*snapshot, jobThreads(), &control);
+            std::string value = control.IsCancelled() ? "cancelled" : count.ToString();
+            return [graph, value]() {
+                setResult(graph, "Spanning trees", value);
+            };
+        });
+    }
+
+    if (ImGui::Button("Calc Bipartite", calcButtonSize) && currentActiveGraph) {
+        Graph* graph = currentActiveGraph;
+        std::shared_ptr<const AdjacencyStore> snapshot = graph->GetSnapshot();
+        jobs.Submit("Bipartite check of graph " + graph->Name, [graph, snapshot](JobControl& control) -> JobScheduler::Completion {
+            auto result = std::make_shared<BipartiteResult>(Bipartite::Check(*snapshot, &control));
+            if (control.IsCancelled()) {
+                return [graph]() {
+                    setResult(graph, "Bipartite", "cancelled");
+                };
+            }
+            return [graph, snapshot, result]() {
+                std::string value = result->IsBipartite ? "yes" : "no, odd cycle of length " + std::to_string(result->OddCycle.size());
+
+                // Colors and the cycle only make sense for the ids the check saw.
+                if (graph->GetTopology().GetVersion() == snapshot->GetVersion()) {
+                    graph->ApplyBipartite(*result);
+                } else {
+                    value += " (graph edited since)";
+                }
+                setResult(graph, "Bipartite", value);
+            };
+        });
+    }
+
+    // The notepad steps running layouts a few iterations per frame.
+    if (currentActiveGraph) {
+        if (ImGui::Button(currentActiveGraph->IsLayoutRunning() ? "Stop Layout" : "Start Layout", calcButtonSize)) {
+            if (currentActiveGraph->IsLayoutRunning()) {
+                currentActiveGraph->StopLayout();
+            } else {
+                currentActiveGraph->StartLayout();
+            }
+        }
+        if (ImGui::Button("Pin/Unpin Selected (P)", calcButtonSize)) {
+            TogglePin = true;
+        }
+        ImGui::SliderInt("Layout steps", &LayoutIterations, 1, 50, "%d per frame");
     }
 
-    if (ImGui::Button("Calc Bipartite", calcButtonSize)) {
-        bool bipartite = currentActiveGraph->CalculateBipartite();
-        if (bipartite) {
-            std::cout << "Graph " << currentActiveGraph->Name << " is bipartite." << std::endl;
+    // Colorings fill the vertices from a palette, DSATUR for any size and the exact search for small graphs.
+    if (ImGui::Button("Color (DSATUR)", calcButtonSize)) {
+        startColoring(jobs, currentActiveGraph, false);
+    }
+    if (ImGui::Button("Calc Chromatic Number", calcButtonSize)) {
+        startColoring(jobs, currentActiveGraph, true);
+    }
+    if (ImGui::Button("Clear Colors", calcButtonSize) && currentActiveGraph) {
+        currentActiveGraph->ClearColoring();
+    }
+
+    // Dense graph actions run on packed adjacency rows, intersected and counted with the widest vector kernel.
+    if (ImGui::Button("Count Triangles", calcButtonSize)) {
+        Graph* graph = currentActiveGraph;
+        startDense(jobs, graph, "Triangles", [graph](const BitAdjacency& adjacency, JobControl& control) -> JobScheduler::Completion {
+            TriangleResult result = Cliques::Triangles(adjacency, jobThreads(), &control);
+            std::ostringstream value;
+            if (control.IsCancelled()) {
+                value << "cancelled";
+            } else {
+                value << result.Total << ", clustering " << result.AverageClustering << " on average, transitivity " << result.Transitivity;
+            }
+            return [graph, value = value.str()]() {
+                setResult(graph, "Triangles", value);
+            };
+        });
+    }
+    if (ImGui::Button("Common Neighbours", calcButtonSize) && currentActiveGraph) {
+        // Counted against every other vertex, the selection is the first vertex selected in any mode.
+        Graph* graph = currentActiveGraph;
+        VertexId selected = InvalidVertexId;
+        for (VertexId v = 0; v < graph->GetTopology().GetVertexCount() && selected == InvalidVertexId; v++) {
+            if (graph->IsSelected(v)) {
+                selected = v;
+            }
+        }
+        if (selected == InvalidVertexId) {
+            setResult(graph, "Common neighbours", "select a vertex first");
         } else {
-            std::cout << "Graph " << currentActiveGraph->Name << " is not bipartite." << std::endl;
+            startDense(jobs, graph, "Common neighbours", [graph, selected](const BitAdjacency& adjacency, JobControl&) -> JobScheduler::Completion {
+                std::vector<std::pair<std::size_t, VertexId>> counts;
+                for (VertexId v = 0; v < adjacency.GetVertexCount(); v++) {
+                    if (v != selected) {
+                        counts.emplace_back(adjacency.CommonNeighbors(selected, v), v);
+                    }
+                }
+                const std::size_t shown = std::min<std::size_t>(counts.size(), CommonNeighborsShown);
+                std::partial_sort(counts.begin(), counts.begin() + shown, counts.end(), [](const auto& a, const auto& b) {
+                    return a.first > b.first || (a.first == b.first && a.second < b.second);
+                });
+                std::ostringstream value;
+                value << "most with " << selected << ":";
+                for (std::size_t i = 0; i < shown; i++) {
+                    value << (i == 0 ? " " : ", ") << counts[i].second << " (" << counts[i].first << ")";
+                }
+                return [graph, value = value.str()]() {
+                    setResult(graph, "Common neighbours", value);
+                };
+            });
+        }
+    }
+    if (ImGui::Button("Find Max Clique", calcButtonSize)) {
+        Graph* graph = currentActiveGraph;
+        startDense(jobs, graph, "Max clique", [graph](const BitAdjacency& adjacency, JobControl& control) -> JobScheduler::Completion {
+            auto result = std::make_shared<CliqueResult>(Cliques::Maximum(adjacency, jobThreads(), &control));
+            const std::uint64_t version = adjacency.GetVersion();
+            return [graph, result, version]() {
+                std::string value = std::to_string(result->Vertices.size());
+                if (!result->IsExact) {
+                    value = "at least " + value + " (cancelled)";
+                }
+
+                // The clique is drawn as a closed walk through its vertices, for the ids the search saw.
+                if (graph->GetTopology().GetVersion() == version) {
+                    graph->SetHighlight(result->Vertices, result->Vertices.size() > 2);
+                } else {
+                    value += " (graph edited since)";
+                }
+                setResult(graph, "Max clique", value);
+            };
+        });
+    }
+    ImGui::TextDisabled("Bitset kernel: %s", BitAdjacency::GetKernelName());
+
+    // Spectral actions share one sparse Lanczos analysis per edit of the graph.
+    if (ImGui::Button("Spectral Analysis", calcButtonSize)) {
+        startSpectral(jobs, currentActiveGraph, false);
+    }
+    if (ImGui::Button("Spectral Bisection", calcButtonSize)) {
+        startSpectral(jobs, currentActiveGraph, true);
+    }
+
+    // Isomorphism across every open graph, by canonical hash.
+    if (ImGui::Button("Compare Graphs", calcButtonSize)) {
+        startCanonical(jobs, graphs);
+    }
+
+    // Running jobs, and the last one that failed.
+    if (!jobs.GetJobs().empty() || !jobs.GetLastError().empty()) {
+        ImGui::Separator();
+    }
+    if (!jobs.GetLastError().empty()) {
+        ImGui::TextWrapped("%s", jobs.GetLastError().c_str());
+    }
+    for (const JobInfo& job : jobs.GetJobs()) {
+        ImGui::PushID(static_cast<int>(job.Id));
+        ImGui::TextUnformatted(job.Name.c_str());
+        ImGui::ProgressBar(job.Control->GetProgress(), ImVec2(-70.0f, 0.0f));
+        ImGui::SameLine();
+        if (job.Control->IsCancelled()) {
+            ImGui::TextUnformatted("Stopping");
+        } else if (ImGui::Button("Cancel")) {
+            job.Control->Cancel();
         }
+        ImGui::PopID();
     }
 
     ImGui::End();
+
+    if (ShowProfiler) {
+        drawProfiler();
+    }
     ImGui::SFML::Render(*window);
 }
 
+void Sidebar::StartShortestPath(JobScheduler& jobs, Graph* graph, VertexId source, VertexId target) {
+    std::shared_ptr<const AdjacencyStore> snapshot = graph->GetSnapshot();
+    jobs.Submit("Shortest path in graph " + graph->Name, [graph, snapshot, source, target](JobControl& control) -> JobScheduler::Completion {
+        auto result = std::make_shared<PathResult>(ShortestPaths::SingleSource(*snapshot, source, jobThreads(), &control));
+        if (control.IsCancelled()) {
+            return [graph]() {
+                setResult(graph, "Shortest path", "cancelled");
+            };
+        }
+        return [graph, snapshot, result, source, target]() {
+            std::vector<VertexId> path = ShortestPaths::Path(*result, target);
+            std::ostringstream value;
+            value << source << " -> " << target << ": ";
+            if (result->HasNegativeWeight) {
+                value << "negative weights, see the distance matrix";
+            } else if (path.empty()) {
+                value << "no path";
+            } else {
+                value << "length " << result->Distance[target] << " over " << path.size() - 1 << " edges";
+            }
+
+            // The path only makes sense for the ids the search saw.
+            if (graph->GetTopology().GetVersion() == snapshot->GetVersion()) {
+                if (path.empty()) {
+                    graph->ClearHighlight();
+                } else {
+                    graph->SetHighlight(path, false);
+                }
+            } else {
+                value << " (graph edited since)";
+            }
+            setResult(graph, "Shortest path", value.str());
+        };
+    });
+}
+
+void Sidebar::drawHeatmap(Graph* graph, const std::vector<float>* distances) {
+    const AdjacencyStore& topology = graph->GetTopology();
+    const std::size_t n = topology.GetVertexCount();
+    Heatmap& heatmap = m_heatmaps[graph];
+
+    // Rebuild only after an edit or a color change.
+    if (heatmap.Texture.getSize().x == 0 || heatmap.Version != topology.GetVersion() || heatmap.Color != graph->Color || heatmap.IsDistance != (distances != nullptr)) {
+        const std::size_t cellsPerPixel = (n + HeatmapMaxSize - 1) / HeatmapMaxSize;
+        const std::size_t size = (n + cellsPerPixel - 1) / cellsPerPixel;
+        std::vector<std::uint8_t> pixels(size * size * 4);
+        auto blend = [&](std::size_t i, float t) {
+            pixels[i * 4 + 0] = static_cast<std::uint8_t>(255.0f + (graph->Color.r - 255.0f) * t);
+            pixels[i * 4 + 1] = static_cast<std::uint8_t>(255.0f + (graph->Color.g - 255.0f) * t);
+            pixels[i * 4 + 2] = static_cast<std::uint8_t>(255.0f + (graph->Color.b - 255.0f) * t);
+            pixels[i * 4 + 3] = 255;
+        };
+
+        if (distances) {
+            // The shortest distance per pixel, near in the graph color fading out with distance, white if unreachable.
+            std::vector<float> cells(size * size, std::numeric_limits<float>::infinity());
+            float largest = 0.0f;
+            for (std::size_t row = 0; row < n; row++) {
+                for (std::size_t col = 0; col < n; col++) {
+                    float distance = (*distances)[row * n + col];
+                    float& cell = cells[(row / cellsPerPixel) * size + col / cellsPerPixel];
+                    cell = std::min(cell, distance);
+                    if (distance != std::numeric_limits<float>::infinity()) {
+                        largest = std::max(largest, std::abs(distance));
+                    }
+                }
+            }
+            for (std::size_t i = 0; i < cells.size(); i++) {
+                float t = 0.0f;
+                if (cells[i] != std::numeric_limits<float>::infinity()) {
+                    t = largest > 0.0f ? 1.0f - 0.75f * std::clamp(cells[i] / largest, 0.0f, 1.0f) : 1.0f;
+                }
+                blend(i, t);
+            }
+        } else {
+            // The largest weight magnitude per pixel, one pass over the CSR entries.
+            const AdjacencyStore::CSR& csr = topology.GetCSR();
+            std::vector<float> cells(size * size, 0.0f);
+            float largest = 0.0f;
+            for (std::size_t row = 0; row < n; row++) {
+                for (std::size_t i = csr.Offsets[row]; i < csr.Offsets[row + 1]; i++) {
+                    float weight = std::abs(csr.Entries[i].Weight);
+                    float& cell = cells[(row / cellsPerPixel) * size + csr.Entries[i].Target / cellsPerPixel];
+                    cell = std::max(cell, weight);
+                    largest = std::max(largest, weight);
+                }
+            }
+
+            // White for no edge, blending into the graph color with the weight, faint edges stay visible.
+            for (std::size_t i = 0; i < cells.size(); i++) {
+                float t = 0.0f;
+                if (cells[i] > 0.0f) {
+                    t = 0.25f + 0.75f * cells[i] / largest;
+                }
+                blend(i, t);
+            }
+        }
+
+        sf::Vector2u extent(static_cast<unsigned>(size), static_cast<unsigned>(size));
+        if (heatmap.Texture.getSize() != extent && !heatmap.Texture.resize(extent)) {
+            return;
+        }
+        heatmap.Texture.update(pixels.data());
+        heatmap.Version = topology.GetVersion();
+        heatmap.Color = graph->Color;
+        heatmap.CellsPerPixel = cellsPerPixel;
+        heatmap.IsDistance = distances != nullptr;
+    }
+
+    // Square, as wide as the panel, with the cell under the mouse in a tooltip.
+    float width = ImGui::GetContentRegionAvail().x;
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImGui::Image(heatmap.Texture, sf::Vector2f(width, width));
+    if (ImGui::IsItemHovered()) {
+        ImVec2 mouse = ImGui::GetMousePos();
+        std::size_t row = std::min(n - 1, static_cast<std::size_t>((mouse.y - origin.y) / width * n));
+        std::size_t col = std::min(n - 1, static_cast<std::size_t>((mouse.x - origin.x) / width * n));
+        if (heatmap.CellsPerPixel == 1) {
+            float value = distances ? (*distances)[row * n + col] : topology.GetWeight(static_cast<VertexId>(row), static_cast<VertexId>(col));
+            ImGui::SetTooltip("%zu -> %zu: %g", row, col, value);
+        } else {
+            std::size_t rowStart = row / heatmap.CellsPerPixel * heatmap.CellsPerPixel;
+            std::size_t colStart = col / heatmap.CellsPerPixel * heatmap.CellsPerPixel;
+            ImGui::SetTooltip("rows %zu-%zu, columns %zu-%zu", rowStart, std::min(n, rowStart + heatmap.CellsPerPixel) - 1, colStart, std::min(n, colStart + heatmap.CellsPerPixel) - 1);
+        }
+    }
+}
+
+void Sidebar::drawMatrix(Graph* graph, const std::vector<float>* distances) {
+    const int n = static_cast<int>(graph->GetTopology().GetVertexCount());
+    const float cellWidth = ImGui::CalcTextSize("00000").x;
+    const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+    const float height = std::min((n + 1) * rowHeight + 2.0f * rowHeight, 12.0f * rowHeight);
+
+    // A scrolling child, the clipper skips rows out of view and the horizontal scroll gives the columns in view.
+    if (ImGui::BeginChild("Matrix", ImVec2(0.0f, height), ImGuiChildFlags_Borders, ImGuiWindowFlags_HorizontalScrollbar)) {
+        const float viewWidth = ImGui::GetContentRegionAvail().x;
+        const int firstColumn = std::clamp(static_cast<int>((ImGui::GetScrollX() - cellWidth) / cellWidth), 0, n);
+        const int lastColumn = std::min(n, firstColumn + static_cast<int>(viewWidth / cellWidth) + 2);
+
+        ImGuiListClipper clipper;
+        clipper.Begin(n + 1, rowHeight);
+        while (clipper.Step()) {
+            for (int line = clipper.DisplayStart; line < clipper.DisplayEnd; line++) {
+                // The first line is the column header, every other starts with its row label.
+                int row = line - 1;
+                if (row < 0) {
+                    ImGui::TextUnformatted(" ");
+                } else {
+                    ImGui::Text("%d", row);
+                }
+
+                for (int col = firstColumn; col < lastColumn; col++) {
+                    ImGui::SameLine(cellWidth * (col + 1));
+                    if (row < 0) {
+                        ImGui::Text("%d", col);
+                    } else if (!distances) {
+                        ImGui::Text("%.0f", graph->GetEdgeWeight(row, col));
+                    } else if (float distance = (*distances)[row * n + col]; distance == std::numeric_limits<float>::infinity()) {
+                        ImGui::TextUnformatted("-");
+                    } else {
+                        ImGui::Text("%g", distance);
+                    }
+                }
+
+                // Keep the full width scrollable.
+                ImGui::SameLine(cellWidth * (n + 1));
+                ImGui::Dummy(ImVec2(0.0f, 0.0f));
+            }
+        }
+    }
+    ImGui::EndChild();
+}
+
+void Sidebar::drawProfiler(void) {
+    ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(420.0f, 360.0f), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Profiler", &ShowProfiler)) {
+        ImGui::End();
+        return;
+    }
+
+    // Only drawn frames are timed, idle waits are not frames.
+    std::vector<float> frameTimes = Profiler::GetFrameTimes();
+    if (!frameTimes.empty()) {
+        std::vector<float> sorted = frameTimes;
+        std::sort(sorted.begin(), sorted.end());
+        ImGui::Text("Frame: %.2f ms median, %.2f ms p99", sorted[sorted.size() / 2], sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)]);
+        ImGui::PlotHistogram("##frames", frameTimes.data(), static_cast<int>(frameTimes.size()), 0, nullptr, 0.0f, std::max(sorted.back(), 16.7f), ImVec2(-1.0f, 60.0f));
+    }
+    ImGui::Text("Draw calls: %llu, allocations: %llu", static_cast<unsigned long long>(Profiler::GetDrawCalls()), static_cast<unsigned long long>(Profiler::GetAllocations()));
+
+    // Percentiles over each zone's recent runs, in milliseconds.
+    std::vector<ZoneStats> zones = Profiler::GetZones();
+    if (zones.empty()) {
+        ImGui::TextUnformatted("No zones recorded, built without NOTEPAD_PROFILING?");
+    } else if (ImGui::BeginTable("Zones", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+        ImGui::TableSetupColumn("Zone");
+        ImGui::TableSetupColumn("Runs");
+        ImGui::TableSetupColumn("p50");
+        ImGui::TableSetupColumn("p90");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableSetupColumn("Max");
+        ImGui::TableHeadersRow();
+        for (const ZoneStats& zone : zones) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(zone.Name.data(), zone.Name.data() + zone.Name.size());
+            ImGui::TableNextColumn();
+            ImGui::Text("%zu", zone.Count);
+            for (double time : { zone.Median, zone.P90, zone.P99, zone.Max }) {
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", time);
+            }
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Export trace")) {
+        std::string error;
+        if (Profiler::WriteTrace(TracePath, error)) {
+            m_traceStatus = std::string("Wrote ") + TracePath;
+        } else {
+            m_traceStatus = std::string("Cannot write ") + TracePath + ": " + error;
+        }
+    }
+    if (!m_traceStatus.empty()) {
+        ImGui::TextWrapped("%s", m_traceStatus.c_str());
+    }
+
+    ImGui::End();
+}
+
+void Sidebar::startColoring(JobScheduler& jobs, Graph* graph, bool isExact) {
+    if (!graph) {
+        return;
+    }
+
+    const std::string label = isExact ? "Chromatic number" : "Colors (DSATUR)";
+    std::shared_ptr<const AdjacencyStore> snapshot = graph->GetSnapshot();
+    jobs.Submit(label + " of graph " + graph->Name, [graph, snapshot, label, isExact](JobControl& control) -> JobScheduler::Completion {
+        auto result = std::make_shared<ColoringResult>(isExact ? Coloring::Exact(*snapshot, jobThreads(), &control) : Coloring::Dsatur(*snapshot, &control));
+        // A cancelled exact search still has the best coloring so far, unless DSATUR itself was cut short.
+        if (control.IsCancelled() && (!isExact || std::find(result->Colors.begin(), result->Colors.end(), 0) != result->Colors.end())) {
+            return [graph, label]() {
+                setResult(graph, label, "cancelled");
+            };
+        }
+        return [graph, snapshot, result, label, isExact]() {
+            std::string value = std::to_string(result->ColorCount);
+            if (isExact && !result->IsExact) {
+                value = "at most " + value + ", at least " + std::to_string(result->LowerBound);
+                if (snapshot->GetVertexCount() > Coloring::ExactLimit) {
+                    value += " (over " + std::to_string(Coloring::ExactLimit) + " vertices)";
+                }
+            }
+
+            // Colors only make sense for the ids the coloring saw.
+            if (graph->GetTopology().GetVersion() == snapshot->GetVersion()) {
+                graph->ApplyColoring(*result);
+            } else {
+                value += " (graph edited since)";
+            }
+            setResult(graph, label, value);
+        };
+    });
+}
+
+void Sidebar::startDense(JobScheduler& jobs, Graph* graph, const std::string& label, DenseWork work) {
+    if (!graph) {
+        return;
+    }
+
+    std::shared_ptr<const AdjacencyStore> snapshot = graph->GetSnapshot();
+    if (snapshot->GetVertexCount() > BitAdjacency::VertexLimit) {
+        setResult(graph, label, "needs at most " + std::to_string(BitAdjacency::VertexLimit) + " vertices");
+        return;
+    }
+
+    // The bitset is built once per topology version and shared by every dense action, an outdated one is dropped.
+    std::shared_ptr<const BitAdjacency> cached;
+    auto it = m_bitsets.find(graph);
+    if (it != m_bitsets.end()) {
+        if (it->second->GetVersion() == snapshot->GetVersion()) {
+            cached = it->second;
+        } else {
+            m_bitsets.erase(it);
+        }
+    }
+    jobs.Submit(label + " of graph " + graph->Name, [graph, snapshot, cached, work](JobControl& control) -> JobScheduler::Completion {
+        std::shared_ptr<const BitAdjacency> adjacency = cached;
+        if (!adjacency) {
+            auto built = std::make_shared<BitAdjacency>();
+            built->Assign(*snapshot);
+            adjacency = built;
+        }
+        JobScheduler::Completion completion = work(*adjacency, control);
+        return [graph, adjacency, completion]() {
+            if (graph->GetTopology().GetVersion() == adjacency->GetVersion()) {
+                m_bitsets[graph] = adjacency;
+            }
+            completion();
+        };
+    });
+}
+
+void Sidebar::startDistances(JobScheduler& jobs, Graph* graph) {
+    Distances& distances = m_distances[graph];
+    if (distances.IsPending) {
+        return;
+    }
+
+    distances.IsPending = true;
+    std::shared_ptr<const AdjacencyStore> snapshot = graph->GetSnapshot();
+    jobs.Submit("Distances in graph " + graph->Name, [graph, snapshot](JobControl& control) -> JobScheduler::Completion {
+        auto values = std::make_shared<std::vector<float>>(ShortestPaths::AllPairs(*snapshot, jobThreads(), &control));
+        const bool isCancelled = control.IsCancelled();
+        return [graph, snapshot, values, isCancelled]() {
+            // A cancelled matrix is hidden, it would otherwise be started again right away. An edited graph starts over.
+            Distances& distances = m_distances[graph];
+            distances.IsPending = false;
+            if (isCancelled) {
+                distances.IsShown = false;
+                return;
+            }
+            distances.Values = std::move(*values);
+            distances.Version = snapshot->GetVersion();
+        };
+    });
+}
+
+void Sidebar::startCanonical(JobScheduler& jobs, const std::vector<Graph*>& graphs) {
+    if (graphs.empty()) {
+        return;
+    }
+    std::vector<std::shared_ptr<const AdjacencyStore>> snapshots;
+    for (Graph* graph : graphs) {
+        snapshots.push_back(graph->GetSnapshot());
+    }
+    jobs.Submit("Canonical forms of " + std::to_string(graphs.size()) + " graphs", [graphs, snapshots](JobControl& control) -> JobScheduler::Completion {
+        auto forms = std::make_shared<const std::vector<CanonicalForm>>(Canonical::LabelAll(snapshots, jobThreads(), &control));
+        if (control.IsCancelled()) {
+            return [graphs]() {
+                for (Graph* graph : graphs) {
+                    setResult(graph, "Canonical form", "cancelled");
+                }
+            };
+        }
+        return [graphs, snapshots, forms]() {
+            for (std::size_t i = 0; i < graphs.size(); i++) {
+                const CanonicalForm& form = (*forms)[i];
+                std::string value = form.Hash.ToString();
+                if (!form.IsExact) {
+                    value += " (search cut short)";
+                }
+
+                // Equal hashes are confirmed on the edge lists, graphs met in an earlier comparison come from the cache.
+                std::string matches;
+                for (std::size_t j = 0; j < graphs.size(); j++) {
+                    if (j != i && (*forms)[j].Hash == form.Hash && Canonical::IsIsomorphic((*forms)[j], form)) {
+                        matches += (matches.empty() ? "" : ", ") + graphs[j]->Name;
+                    }
+                }
+                if (!matches.empty()) {
+                    value += ", isomorphic to " + matches;
+                }
+                const std::string* seen = m_canonical.Find(form.Hash);
+                if (seen && *seen != graphs[i]->Name) {
+                    value += ", seen before as " + *seen;
+                }
+                if (graphs[i]->GetTopology().GetVersion() != snapshots[i]->GetVersion()) {
+                    value += " (graph edited since)";
+                }
+                setResult(graphs[i], "Canonical form", value);
+            }
+            for (std::size_t i = 0; i < graphs.size(); i++) {
+                if ((*forms)[i].IsExact) {
+                    m_canonical.Insert((*forms)[i].Hash, graphs[i]->Name);
+                }
+            }
+        };
+    });
+}
+
+void Sidebar::startGenerator(JobScheduler& jobs, std::vector<Graph*>& graphs) {
+    const Generators::Family& family = Generators::GetFamilies()[m_generatorFamily];
+    const std::vector<double> values = m_generatorValues;
+    std::string error;
+    if (!Generators::Check(family, values, error)) {
+        m_generatorStatus = "Cannot generate " + std::string(family.Name) + ": " + error;
+        return;
+    }
+
+    std::vector<Graph*>* list = &graphs;
+    const std::string name = family.Name;
+    const std::uint64_t seed = static_cast<std::uint32_t>(m_generatorSeed);
+    m_generatorStatus.clear();
+    jobs.Submit("Generate " + name, [list, &family, values, seed, name](JobControl& control) -> JobScheduler::Completion {
+        auto generated = std::make_shared<GeneratedGraph>(family.Build(values, seed, jobThreads(), &control));
+        if (control.IsCancelled()) {
+            return [name]() {
+                m_generatorStatus = "Generation of " + name + " cancelled";
+            };
+        }
+        return [list, generated, name]() {
+            Graph* graph = new Graph();
+            graph->Import(std::move(generated->Topology), generated->X, generated->Y);
+            graph->Name = name + " " + std::to_string(list->size() + 1);
+            list->push_back(graph);
+            m_generatorStatus = "Generated " + graph->Name + " with " + std::to_string(graph->GetTopology().GetVertexCount()) + " vertices and " + std::to_string(graph->GetTopology().GetEdgeCount()) + " edges";
+        };
+    });
+}
+
+void Sidebar::startSpectral(JobScheduler& jobs, Graph* graph, bool isBisection) {
+    if (!graph) {
+        return;
+    }
+
+    // Shown the same way computed or cached, the cut is only colored for the ids the analysis saw.
+    auto show = [graph, isBisection](const SpectralResult& result) {
+        auto list = [](const std::vector<double>& spectrum) {
+            std::ostringstream text;
+            for (std::size_t i = 0; i < spectrum.size(); i++) {
+                if (spectrum.size() > 2 * SpectrumShown && i == SpectrumShown) {
+                    text << ", ...";
+                    i = spectrum.size() - SpectrumShown;
+                }
+                text << (i == 0 ? "" : ", ") << spectrum[i];
+            }
+            return text.str();
+        };
+        std::ostringstream value;
+        value << "algebraic connectivity " << result.AlgebraicConnectivity << ", Laplacian radius " << result.LaplacianRadius << ", spectral radius " << result.SpectralRadius;
+        if (!result.LaplacianSpectrum.empty()) {
+            value << ", Laplacian spectrum " << list(result.LaplacianSpectrum) << ", adjacency spectrum " << list(result.AdjacencySpectrum);
+        }
+        if (!result.IsConverged) {
+            value << " (not converged in " << result.Iterations << " steps)";
+        }
+        if (graph->GetTopology().GetVersion() != result.Version) {
+            value << " (graph edited since)";
+        } else if (isBisection && !result.Fiedler.empty()) {
+            // The two sides of the sign cut take the first two palette colors.
+            ColoringResult cut = { std::vector<int>(result.Fiedler.size()), 2, 0, false };
+            for (VertexId v = 0; v < result.Fiedler.size(); v++) {
+                cut.Colors[v] = result.Fiedler[v] >= 0.0f ? 1 : 2;
+            }
+            graph->ApplyColoring(cut);
+        }
+        setResult(graph, "Spectrum", value.str());
+    };
+
+    // The analysis is kept per topology version, asking again for an unchanged graph shows it right away.
+    auto it = m_spectra.find(graph);
+    if (it != m_spectra.end()) {
+        if (it->second->Version == graph->GetTopology().GetVersion()) {
+            show(*it->second);
+            return;
+        }
+        m_spectra.erase(it);
+    }
+    std::shared_ptr<const AdjacencyStore> snapshot = graph->GetSnapshot();
+    jobs.Submit("Spectrum of graph " + graph->Name, [graph, snapshot, show](JobControl& control) -> JobScheduler::Completion {
+        auto result = std::make_shared<const SpectralResult>(Spectral::Analyze(*snapshot, jobThreads(), &control));
+        if (control.IsCancelled()) {
+            return [graph]() {
+                setResult(graph, "Spectrum", "cancelled");
+            };
+        }
+        return [graph, result, show]() {
+            if (graph->GetTopology().GetVersion() == result->Version) {
+                m_spectra[graph] = result;
+            }
+            show(*result);
+        };
+    });
+}
+
+std::size_t Sidebar::jobThreads(void) {
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 1;
+}
+
+void Sidebar::setResult(const Graph* graph, const std::string& label, const std::string& value) {
+    std::vector<std::pair<std::string, std::string>>& results = m_results[graph];
+    for (auto& result : results) {
+        if (result.first == label) {
+            result.second = value;
+            return;
+        }
+    }
+    results.emplace_back(label, value);
+}
+
 int Sidebar::Mode = Sidebar::Select;
-Graph* Sidebar::currentActiveGraph = nullptr;
\ No newline at end of file
+int Sidebar::FrameLimit = 60;
+int Sidebar::HistoryStep = 0;
+int Sidebar::LayoutIterations = 4;
+bool Sidebar::ShowProfiler = false;
+bool Sidebar::TogglePin = false;
+Graph* Sidebar::currentActiveGraph = nullptr;
+std::unordered_map<const Graph*, std::shared_ptr<const BitAdjacency>> Sidebar::m_bitsets;
+CanonicalCache Sidebar::m_canonical;
+std::unordered_map<const Graph*, Sidebar::Distances> Sidebar::m_distances;
+char Sidebar::m_filePath[256] = "graph.gtn";
+std::string Sidebar::m_fileStatus;
+int Sidebar::m_generatorFamily = 0;
+int Sidebar::m_generatorSeed = 1;
+std::string Sidebar::m_generatorStatus;
+std::vector<double> Sidebar::m_generatorValues;
+std::unordered_map<const Graph*, Sidebar::Heatmap> Sidebar::m_heatmaps;
+std::unordered_map<const Graph*, std::vector<std::pair<std::string, std::string>>> Sidebar::m_results;
+std::unordered_map<const Graph*, std::shared_ptr<const SpectralResult>> Sidebar::m_spectra;
+std::string Sidebar::m_traceStatus;
\ No newline at end of file
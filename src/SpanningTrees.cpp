@@ -0,0 +1,690 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "SpanningTrees.hpp"
+#include "Profiler.hpp"
+
+// The row kernels below are built for AVX2 and FMA by themselves and picked at startup when the processor has both.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NOTEPAD_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace {
+    /// @brief An UpdateRow() implementation.
+    typedef void (*UpdateKernel)(double*, const double*, double, std::size_t);
+
+    /// @brief A ReduceRow() implementation.
+    typedef void (*ReduceKernel)(double*, std::size_t, double, double);
+
+    /**
+     * @brief Reduce an exact integer held in a double into [0, prime).
+     * @param value The value, below 2^53 in magnitude.
+     * @param prime The prime modulus.
+     * @param inverse 1 / prime.
+     * @return The reduced value.
+     */
+    double reduce(double value, double prime, double inverse) {
+        double reduced = value - std::floor(value * inverse) * prime;
+        if (reduced < 0.0) {
+            reduced += prime;
+        }
+        if (reduced >= prime) {
+            reduced -= prime;
+        }
+
+        return reduced;
+    }
+
+    /**
+     * @brief Subtract a multiple of the pivot row, exact while every product and sum stays below 2^53.
+     */
+    void updateRowScalar(double* row, const double* pivotRow, double factor, std::size_t count) {
+        for (std::size_t c = 0; c < count; c++) {
+            row[c] -= factor * pivotRow[c];
+        }
+    }
+
+    /**
+     * @brief Reduce a row into [0, prime) an entry at a time.
+     */
+    void reduceRowScalar(double* row, std::size_t count, double prime, double inverse) {
+        for (std::size_t c = 0; c < count; c++) {
+            row[c] = reduce(row[c], prime, inverse);
+        }
+    }
+
+#ifdef NOTEPAD_X86_KERNELS
+    /**
+     * @brief Subtract a multiple of the pivot row four entries at a time, the fused multiply-add rounds only once
+     * and so stays exact.
+     */
+    __attribute__((target("avx2,fma"))) void updateRowAvx2(double* row, const double* pivotRow, double factor, std::size_t count) {
+        const __m256d scale = _mm256_set1_pd(factor);
+        std::size_t c = 0;
+        for (; c + 4 <= count; c += 4) {
+            _mm256_storeu_pd(row + c, _mm256_fnmadd_pd(scale, _mm256_loadu_pd(pivotRow + c), _mm256_loadu_pd(row + c)));
+        }
+        for (; c < count; c++) {
+            row[c] -= factor * pivotRow[c];
+        }
+    }
+
+    /**
+     * @brief Reduce a row into [0, prime) four entries at a time, the quotient off by at most one either way.
+     */
+    __attribute__((target("avx2,fma"))) void reduceRowAvx2(double* row, std::size_t count, double prime, double inverse) {
+        const __m256d modulus = _mm256_set1_pd(prime);
+        const __m256d scale = _mm256_set1_pd(inverse);
+        const __m256d zero = _mm256_setzero_pd();
+        std::size_t c = 0;
+        for (; c + 4 <= count; c += 4) {
+            const __m256d value = _mm256_loadu_pd(row + c);
+            __m256d reduced = _mm256_fnmadd_pd(_mm256_floor_pd(_mm256_mul_pd(value, scale)), modulus, value);
+            reduced = _mm256_add_pd(reduced, _mm256_and_pd(_mm256_cmp_pd(reduced, zero, _CMP_LT_OQ), modulus));
+            reduced = _mm256_sub_pd(reduced, _mm256_and_pd(_mm256_cmp_pd(reduced, modulus, _CMP_GE_OQ), modulus));
+            _mm256_storeu_pd(row + c, reduced);
+        }
+        for (; c < count; c++) {
+            row[c] = reduce(row[c], prime, inverse);
+        }
+    }
+#endif
+
+    /// @brief The row kernels picked for this processor.
+    typedef struct rowKernels {
+        /// @brief Subtracts factor times the pivot row from a row.
+        UpdateKernel UpdateRow;
+
+        /// @brief Reduces a row into [0, prime).
+        ReduceKernel ReduceRow;
+    } RowKernels;
+
+    /**
+     * @brief Pick the fastest row kernels the processor runs.
+     * @return The kernels.
+     */
+    RowKernels chooseKernels(void) {
+#ifdef NOTEPAD_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return RowKernels { updateRowAvx2, reduceRowAvx2 };
+        }
+#endif
+        return RowKernels { updateRowScalar, reduceRowScalar };
+    }
+
+    /// @brief The kernels picked, once, before main() runs.
+    const RowKernels kernels = chooseKernels();
+}
+
+BigUnsigned SpanningTrees::Count(const AdjacencyStore& topology, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("SpanningTrees::Count");
+    if (topology.GetVertexCount() == 0) {
+        return BigUnsigned(0);
+    }
+
+    // A disconnected graph has no spanning tree, the store tracks its components so this skips the O(n²) minor.
+    if (topology.GetComponentCount() > 1) {
+        return BigUnsigned(0);
+    }
+
+    // Build the reduced Laplacian.
+    Minor minor;
+    bool connected = topology.IsDirected() ? buildDirectedMinor(topology, minor) : buildUndirectedMinor(topology, minor);
+    if (!connected) {
+        return BigUnsigned(0);
+    }
+
+    // A tree, or a single vertex, is its own only spanning tree.
+    if (minor.Size == 0) {
+        return BigUnsigned(1);
+    }
+
+    // The product of the primes has to exceed the largest possible determinant.
+    const double neededBits = hadamardBits(minor) + 1.0;
+
+    std::mutex mutex;
+    std::vector<std::uint32_t> primes;
+    std::vector<std::uint32_t> residues;
+    std::uint32_t nextPrime = PrimeLimit;
+    double doneBits = 0.0;
+    double pendingBits = 0.0;
+
+    // Each worker takes the next prime until the finished and in flight primes cover the bound.
+    auto worker = [&]() {
+        std::vector<double> scratch;
+        while (true) {
+            std::uint32_t prime;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (doneBits + pendingBits >= neededBits || (control && control->IsCancelled())) {
+                    return;
+                }
+                prime = previousPrime(nextPrime);
+                if (prime == 0) {
+                    return;
+                }
+                nextPrime = prime;
+                pendingBits += std::log2(prime);
+            }
+
+            std::uint32_t determinant = 0;
+            bool usable;
+            if (minor.IsBanded) {
+                usable = determinantBanded(minor, prime, scratch, determinant, control);
+            } else if (minor.IsSymmetric) {
+                usable = determinantBlocked(minor, prime, scratch, determinant, control);
+            } else {
+                usable = determinantDense(minor, prime, scratch, determinant, control);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            pendingBits -= std::log2(prime);
+            if (usable) {
+                primes.push_back(prime);
+                residues.push_back(determinant);
+                doneBits += std::log2(prime);
+                if (control) {
+                    control->SetProgress(static_cast<float>(std::min(1.0, doneBits / neededBits)));
+                }
+            }
+        }
+    };
+
+    // Never start more threads than there are primes to go around.
+    std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min(threadCount, static_cast<std::size_t>(neededBits / (std::log2(PrimeLimit) - 1.0)) + 1);
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    if (control && control->IsCancelled()) {
+        return BigUnsigned(0);
+    }
+
+    return reconstruct(primes, residues);
+}
+
+bool SpanningTrees::buildDirectedMinor(const AdjacencyStore& topology, Minor& minor) {
+    const AdjacencyStore::CSR& csr = topology.GetCSR();
+    const std::size_t n = topology.GetVertexCount();
+    const VertexId root = static_cast<VertexId>(n - 1);
+
+    // Transpose the rows so reachability can be walked backwards from the root.
+    std::vector<std::size_t> inOffsets(n + 1, 0);
+    for (const Neighbor& entry : csr.Entries) {
+        inOffsets[entry.Target + 1]++;
+    }
+    for (std::size_t v = 0; v < n; v++) {
+        inOffsets[v + 1] += inOffsets[v];
+    }
+    std::vector<VertexId> inSources(csr.Entries.size());
+    std::vector<std::size_t> cursor(inOffsets.begin(), inOffsets.end() - 1);
+    for (VertexId v = 0; v < n; v++) {
+        for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+            inSources[cursor[csr.Entries[e].Target]++] = v;
+        }
+    }
+
+    // Every vertex has to reach the root.
+    std::vector<bool> reached(n, false);
+    std::vector<VertexId> queue = { root };
+    reached[root] = true;
+    for (std::size_t head = 0; head < queue.size(); head++) {
+        VertexId v = queue[head];
+        for (std::size_t e = inOffsets[v]; e < inOffsets[v + 1]; e++) {
+            if (!reached[inSources[e]]) {
+                reached[inSources[e]] = true;
+                queue.push_back(inSources[e]);
+            }
+        }
+    }
+    if (queue.size() != n) {
+        return false;
+    }
+
+    // Out degree Laplacian with the root's row and column removed.
+    minor.Size = n - 1;
+    minor.Diagonal.assign(minor.Size, 0);
+    minor.Offsets.assign(1, 0);
+    minor.Columns.clear();
+    minor.Bandwidth = minor.Size;
+    minor.IsBanded = false;
+    minor.IsSymmetric = false;
+    for (VertexId v = 0; v < minor.Size; v++) {
+        for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+            VertexId target = csr.Entries[e].Target;
+            if (target == v) {
+                continue;
+            }
+            minor.Diagonal[v]++;
+            if (target != root) {
+                minor.Columns.push_back(target);
+            }
+        }
+        minor.Offsets.push_back(minor.Columns.size());
+    }
+
+    return true;
+}
+
+bool SpanningTrees::buildUndirectedMinor(const AdjacencyStore& topology, Minor& minor) {
+    const AdjacencyStore::CSR& csr = topology.GetCSR();
+    const std::size_t n = topology.GetVertexCount();
+
+    // Degrees without self loops.
+    std::vector<std::uint32_t> degree(n, 0);
+    for (VertexId v = 0; v < n; v++) {
+        for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+            if (csr.Entries[e].Target != v) {
+                degree[v]++;
+            }
+        }
+    }
+
+    // The graph has to be connected.
+    std::vector<bool> reached(n, false);
+    std::vector<VertexId> queue = { 0 };
+    reached[0] = true;
+    for (std::size_t head = 0; head < queue.size(); head++) {
+        VertexId v = queue[head];
+        for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+            if (!reached[csr.Entries[e].Target]) {
+                reached[csr.Entries[e].Target] = true;
+                queue.push_back(csr.Entries[e].Target);
+            }
+        }
+    }
+    if (queue.size() != n) {
+        return false;
+    }
+
+    // Peel leaves until only the 2-core is left, a leaf's edge is in every spanning tree.
+    std::vector<bool> removed(n, false);
+    queue.clear();
+    for (VertexId v = 0; v < n; v++) {
+        if (degree[v] == 1) {
+            queue.push_back(v);
+        }
+    }
+    for (std::size_t head = 0; head < queue.size(); head++) {
+        VertexId v = queue[head];
+        // The last vertex of a tree drops to degree 0 and stays.
+        if (degree[v] != 1) {
+            continue;
+        }
+        removed[v] = true;
+        degree[v] = 0;
+        for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+            VertexId u = csr.Entries[e].Target;
+            if (u != v && !removed[u] && --degree[u] == 1) {
+                queue.push_back(u);
+            }
+        }
+    }
+
+    // Reverse Cuthill-McKee order of the core, starting from a pseudo-peripheral vertex.
+    VertexId start = InvalidVertexId;
+    for (VertexId v = 0; v < n; v++) {
+        if (!removed[v] && (start == InvalidVertexId || degree[v] < degree[start])) {
+            start = v;
+        }
+    }
+
+    std::vector<VertexId> order;
+    std::vector<std::uint32_t> level(n, 0);
+    std::vector<VertexId> candidates;
+    for (int pass = 0; pass < 3; pass++) {
+        // Breadth first levels, neighbours visited in increasing degree.
+        order.assign(1, start);
+        std::fill(reached.begin(), reached.end(), false);
+        reached[start] = true;
+        level[start] = 0;
+        for (std::size_t head = 0; head < order.size(); head++) {
+            VertexId v = order[head];
+            candidates.clear();
+            for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+                VertexId u = csr.Entries[e].Target;
+                if (!removed[u] && !reached[u]) {
+                    reached[u] = true;
+                    level[u] = level[v] + 1;
+                    candidates.push_back(u);
+                }
+            }
+            std::sort(candidates.begin(), candidates.end(), [&](VertexId a, VertexId b) {
+                return degree[a] < degree[b];
+            });
+            order.insert(order.end(), candidates.begin(), candidates.end());
+        }
+
+        // Restart from the lowest degree vertex of the deepest level.
+        VertexId farthest = order.back();
+        for (std::size_t i = order.size(); i-- > 0 && level[order[i]] == level[order.back()];) {
+            if (degree[order[i]] < degree[farthest]) {
+                farthest = order[i];
+            }
+        }
+        if (farthest == start || level[farthest] == 0) {
+            break;
+        }
+        start = farthest;
+    }
+    std::reverse(order.begin(), order.end());
+
+    // Drop the last vertex of the order as the root, the rest are the minor's rows.
+    minor.Size = order.size() - 1;
+    std::vector<std::uint32_t> position(n, std::numeric_limits<std::uint32_t>::max());
+    for (std::size_t i = 0; i < minor.Size; i++) {
+        position[order[i]] = static_cast<std::uint32_t>(i);
+    }
+
+    minor.Diagonal.assign(minor.Size, 0);
+    minor.Offsets.assign(1, 0);
+    minor.Columns.clear();
+    minor.Bandwidth = 0;
+    for (std::size_t i = 0; i < minor.Size; i++) {
+        VertexId v = order[i];
+        minor.Diagonal[i] = degree[v];
+        for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+            VertexId u = csr.Entries[e].Target;
+            if (u == v || removed[u] || position[u] == std::numeric_limits<std::uint32_t>::max()) {
+                continue;
+            }
+            minor.Columns.push_back(position[u]);
+            std::size_t distance = position[u] > i ? position[u] - i : i - position[u];
+            minor.Bandwidth = std::max(minor.Bandwidth, distance);
+        }
+        minor.Offsets.push_back(minor.Columns.size());
+    }
+
+    // Banded elimination costs n·b² against n³/3 dense.
+    const double size = static_cast<double>(minor.Size);
+    const double band = static_cast<double>(minor.Bandwidth);
+    minor.IsBanded = 3.0 * band * band < size * size;
+    minor.IsSymmetric = true;
+
+    return true;
+}
+
+bool SpanningTrees::determinantBanded(const Minor& minor, std::uint32_t prime, std::vector<double>& scratch, std::uint32_t& determinant, const JobControl* control) {
+    const std::size_t n = minor.Size;
+    const std::size_t band = minor.Bandwidth;
+    const std::size_t width = 2 * band + 1;
+    const double p = static_cast<double>(prime);
+    const double inverse = 1.0 / p;
+    const std::size_t reduceEvery = static_cast<std::size_t>(9007199254740992.0 / (p * p)) - 1;
+
+    // Row r keeps columns r - band to r + band, entry (r, c) lives at r * width + c - r + band.
+    scratch.assign(n * width, 0.0);
+    for (std::size_t r = 0; r < n; r++) {
+        scratch[r * width + band] = static_cast<double>(minor.Diagonal[r] % prime);
+        for (std::size_t e = minor.Offsets[r]; e < minor.Offsets[r + 1]; e++) {
+            scratch[r * width + minor.Columns[e] - r + band] = p - 1.0;
+        }
+    }
+
+    std::uint64_t result = 1;
+    std::size_t sinceReduce = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        if (control && i % BlockSize == 0 && control->IsCancelled()) {
+            return false;
+        }
+        const std::size_t last = std::min(n - 1, i + band);
+        double* pivotRow = &scratch[i * width + band];
+
+        // The pivot row is reduced once, right before it is used.
+        kernels.ReduceRow(pivotRow, last - i + 1, p, inverse);
+        std::uint32_t pivot = static_cast<std::uint32_t>(pivotRow[0]);
+        if (pivot == 0) {
+            return false;
+        }
+        result = result * pivot % prime;
+        std::uint64_t pivotInverse = inverseMod(pivot, prime);
+
+        // Rank one update of the rows below, inside the band, without reducing.
+        for (std::size_t j = i + 1; j <= last; j++) {
+            double* row = &scratch[j * width + band - (j - i)];
+            std::uint64_t below = static_cast<std::uint64_t>(reduce(row[0], p, inverse));
+            if (below == 0) {
+                continue;
+            }
+            const double factor = static_cast<double>(below * pivotInverse % prime);
+            kernels.UpdateRow(row + 1, pivotRow + 1, factor, last - i);
+        }
+
+        // Pull the active window back into range before the doubles lose exactness.
+        if (++sinceReduce == reduceEvery) {
+            for (std::size_t j = i + 1; j <= last; j++) {
+                const std::size_t first = j - std::min(j, band);
+                kernels.ReduceRow(&scratch[j * width + first - j + band], std::min(n - 1, j + band) - first + 1, p, inverse);
+            }
+            sinceReduce = 0;
+        }
+    }
+
+    determinant = static_cast<std::uint32_t>(result);
+    return true;
+}
+
+bool SpanningTrees::determinantBlocked(const Minor& minor, std::uint32_t prime, std::vector<double>& scratch, std::uint32_t& determinant, const JobControl* control) {
+    const std::size_t n = minor.Size;
+    const double p = static_cast<double>(prime);
+    const double inverse = 1.0 / p;
+    const std::size_t reduceEvery = static_cast<std::size_t>(9007199254740992.0 / (p * p)) - 1;
+
+    // Row major n x n, entries are kept in [0, p) until the updates start.
+    scratch.assign(n * n, 0.0);
+    for (std::size_t r = 0; r < n; r++) {
+        scratch[r * n + r] = static_cast<double>(minor.Diagonal[r] % prime);
+        for (std::size_t e = minor.Offsets[r]; e < minor.Offsets[r + 1]; e++) {
+            scratch[r * n + minor.Columns[e]] = p - 1.0;
+        }
+    }
+
+    std::uint64_t result = 1;
+    std::size_t sinceReduce = 0;
+    for (std::size_t blockStart = 0; blockStart < n; blockStart += BlockSize) {
+        const std::size_t blockEnd = std::min(n, blockStart + BlockSize);
+        if (control && control->IsCancelled()) {
+            return false;
+        }
+
+        // Factor the panel, only the block's own columns and rows are updated right away.
+        for (std::size_t i = blockStart; i < blockEnd; i++) {
+            double* pivotRow = &scratch[i * n];
+            kernels.ReduceRow(pivotRow + i, n - i, p, inverse);
+            std::uint32_t pivot = static_cast<std::uint32_t>(pivotRow[i]);
+            if (pivot == 0) {
+                return false;
+            }
+            result = result * pivot % prime;
+            std::uint64_t pivotInverse = inverseMod(pivot, prime);
+
+            // The reduced multiplier replaces the eliminated entry for the trailing update below.
+            for (std::size_t j = i + 1; j < n; j++) {
+                double* row = &scratch[j * n];
+                std::uint64_t below = static_cast<std::uint64_t>(reduce(row[i], p, inverse));
+                const double factor = static_cast<double>(below * pivotInverse % prime);
+                row[i] = factor;
+                if (factor == 0.0) {
+                    continue;
+                }
+                const std::size_t last = j < blockEnd ? n : blockEnd;
+                kernels.UpdateRow(row + i + 1, pivotRow + i + 1, factor, last - i - 1);
+            }
+        }
+
+        // Trailing update, each row stays in cache while every pivot row of the block is applied to it.
+        for (std::size_t j = blockEnd; j < n; j++) {
+            double* row = &scratch[j * n];
+            for (std::size_t i = blockStart; i < blockEnd; i++) {
+                const double factor = row[i];
+                if (factor == 0.0) {
+                    continue;
+                }
+                kernels.UpdateRow(row + blockEnd, &scratch[i * n + blockEnd], factor, n - blockEnd);
+            }
+        }
+
+        // Pull the trailing matrix back into range before the doubles lose exactness.
+        sinceReduce += blockEnd - blockStart;
+        if (sinceReduce + BlockSize >= reduceEvery) {
+            for (std::size_t j = blockEnd; j < n; j++) {
+                kernels.ReduceRow(&scratch[j * n + blockEnd], n - blockEnd, p, inverse);
+            }
+            sinceReduce = 0;
+        }
+    }
+
+    determinant = static_cast<std::uint32_t>(result);
+    return true;
+}
+
+bool SpanningTrees::determinantDense(const Minor& minor, std::uint32_t prime, std::vector<double>& scratch, std::uint32_t& determinant, const JobControl* control) {
+    const std::size_t n = minor.Size;
+    const double p = static_cast<double>(prime);
+    const double inverse = 1.0 / p;
+    const std::size_t reduceEvery = static_cast<std::size_t>(9007199254740992.0 / (p * p)) - 1;
+
+    // Row major n x n, entries are kept in [0, p) until the updates start.
+    scratch.assign(n * n, 0.0);
+    for (std::size_t r = 0; r < n; r++) {
+        scratch[r * n + r] = static_cast<double>(minor.Diagonal[r] % prime);
+        for (std::size_t e = minor.Offsets[r]; e < minor.Offsets[r + 1]; e++) {
+            scratch[r * n + minor.Columns[e]] = p - 1.0;
+        }
+    }
+
+    std::uint64_t result = 1;
+    std::size_t sinceReduce = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        if (control && i % BlockSize == 0 && control->IsCancelled()) {
+            return false;
+        }
+
+        // Find a pivot in the reduced column.
+        std::size_t pivotIndex = n;
+        for (std::size_t j = i; j < n; j++) {
+            double& entry = scratch[j * n + i];
+            entry = reduce(entry, p, inverse);
+            if (pivotIndex == n && entry != 0.0) {
+                pivotIndex = j;
+            }
+        }
+        if (pivotIndex == n) {
+            determinant = 0;
+            return true;
+        }
+        if (pivotIndex != i) {
+            std::swap_ranges(scratch.begin() + i * n + i, scratch.begin() + i * n + n, scratch.begin() + pivotIndex * n + i);
+            result = (prime - result) % prime;
+        }
+
+        double* pivotRow = &scratch[i * n];
+        kernels.ReduceRow(pivotRow + i + 1, n - i - 1, p, inverse);
+        std::uint32_t pivot = static_cast<std::uint32_t>(pivotRow[i]);
+        result = result * pivot % prime;
+        std::uint64_t pivotInverse = inverseMod(pivot, prime);
+
+        // Rank one update of the trailing rows.
+        for (std::size_t j = i + 1; j < n; j++) {
+            double* row = &scratch[j * n];
+            std::uint64_t below = static_cast<std::uint64_t>(row[i]);
+            if (below == 0) {
+                continue;
+            }
+            const double factor = static_cast<double>(below * pivotInverse % prime);
+            kernels.UpdateRow(row + i + 1, pivotRow + i + 1, factor, n - i - 1);
+        }
+
+        // Pull the trailing matrix back into range before the doubles lose exactness.
+        if (++sinceReduce == reduceEvery) {
+            for (std::size_t j = i + 1; j < n; j++) {
+                kernels.ReduceRow(&scratch[j * n + i + 1], n - i - 1, p, inverse);
+            }
+            sinceReduce = 0;
+        }
+    }
+
+    determinant = static_cast<std::uint32_t>(result);
+    return true;
+}
+
+double SpanningTrees::hadamardBits(const Minor& minor) {
+    double bits = 0.0;
+    for (std::size_t r = 0; r < minor.Size; r++) {
+        double diagonal = static_cast<double>(minor.Diagonal[r]);
+        double offDiagonal = static_cast<double>(minor.Offsets[r + 1] - minor.Offsets[r]);
+        bits += 0.5 * std::log2(std::max(1.0, diagonal * diagonal + offDiagonal));
+    }
+
+    return bits;
+}
+
+std::uint32_t SpanningTrees::inverseMod(std::uint64_t value, std::uint32_t prime) {
+    // Extended Euclid.
+    std::int64_t a = static_cast<std::int64_t>(value % prime);
+    std::int64_t b = prime;
+    std::int64_t x = 1;
+    std::int64_t y = 0;
+    while (b != 0) {
+        std::int64_t q = a / b;
+        std::int64_t remainder = a - q * b;
+        a = b;
+        b = remainder;
+        std::int64_t coefficient = x - q * y;
+        x = y;
+        y = coefficient;
+    }
+
+    return static_cast<std::uint32_t>((x % prime + prime) % prime);
+}
+
+std::uint32_t SpanningTrees::previousPrime(std::uint32_t value) {
+    for (std::uint32_t candidate = value - 1; candidate >= 2; candidate--) {
+        bool prime = candidate == 2 || candidate % 2 != 0;
+        for (std::uint32_t d = 3; prime && d * d <= candidate; d += 2) {
+            prime = candidate % d != 0;
+        }
+        if (prime) {
+            return candidate;
+        }
+    }
+
+    return 0;
+}
+
+BigUnsigned SpanningTrees::reconstruct(const std::vector<std::uint32_t>& primes, const std::vector<std::uint32_t>& residues) {
+    // Mixed radix digits, value = d0 + d1·p0 + d2·p0·p1 + ...
+    const std::size_t k = primes.size();
+    std::vector<std::uint32_t> digits(k);
+    for (std::size_t i = 0; i < k; i++) {
+        const std::uint64_t p = primes[i];
+        std::uint64_t partial = 0;
+        std::uint64_t radix = 1;
+        for (std::size_t j = 0; j < i; j++) {
+            partial = (partial + digits[j] * radix) % p;
+            radix = radix * (primes[j] % p) % p;
+        }
+        std::uint64_t difference = (residues[i] + p - partial) % p;
+        digits[i] = static_cast<std::uint32_t>(difference * inverseMod(radix, primes[i]) % p);
+    }
+
+    // Horner's rule from the most significant digit down.
+    BigUnsigned value(0);
+    for (std::size_t i = k; i-- > 0;) {
+        value.MulSmall(primes[i]);
+        value.AddSmall(digits[i]);
+    }
+
+    return value;
+}
@@ -0,0 +1,125 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "pch.hpp"
+#include "SpatialGrid.hpp"
+
+SpatialGrid::SpatialGrid(float cellSize) {
+    m_cellSize = cellSize;
+}
+
+void SpatialGrid::Clear(void) {
+    m_cells.clear();
+}
+
+VertexId SpatialGrid::FindAt(sf::Vector2f point, float halfExtent) const {
+    VertexId closest = InvalidVertexId;
+    float closestDistance = std::numeric_limits<float>::max();
+
+    // Only the cells a hit box around the point can overlap.
+    for (std::int32_t y = cellOf(point.y - halfExtent); y <= cellOf(point.y + halfExtent); y++) {
+        for (std::int32_t x = cellOf(point.x - halfExtent); x <= cellOf(point.x + halfExtent); x++) {
+            auto cell = m_cells.find(keyOf(x, y));
+            if (cell == m_cells.end()) {
+                continue;
+            }
+            for (const Entry& entry : cell->second) {
+                sf::Vector2f offset = entry.Position - point;
+                if (std::abs(offset.x) > halfExtent || std::abs(offset.y) > halfExtent) {
+                    continue;
+                }
+                float distance = offset.x * offset.x + offset.y * offset.y;
+                if (distance < closestDistance) {
+                    closest = entry.Id;
+                    closestDistance = distance;
+                }
+            }
+        }
+    }
+
+    return closest;
+}
+
+void SpatialGrid::FindIn(const sf::FloatRect& rect, std::vector<VertexId>& ids) const {
+    const std::int32_t left = cellOf(rect.position.x);
+    const std::int32_t top = cellOf(rect.position.y);
+    const std::int32_t right = cellOf(rect.position.x + rect.size.x);
+    const std::int32_t bottom = cellOf(rect.position.y + rect.size.y);
+
+    auto collect = [&](const std::vector<Entry>& entries) {
+        for (const Entry& entry : entries) {
+            if (rect.contains(entry.Position)) {
+                ids.push_back(entry.Id);
+            }
+        }
+    };
+
+    // A rectangle covering more cells than are occupied is cheaper to answer by walking the occupied ones.
+    const double covered = (static_cast<double>(right) - left + 1) * (static_cast<double>(bottom) - top + 1);
+    if (covered > static_cast<double>(m_cells.size())) {
+        for (const auto& [key, entries] : m_cells) {
+            collect(entries);
+        }
+        return;
+    }
+
+    for (std::int32_t y = top; y <= bottom; y++) {
+        for (std::int32_t x = left; x <= right; x++) {
+            auto cell = m_cells.find(keyOf(x, y));
+            if (cell != m_cells.end()) {
+                collect(cell->second);
+            }
+        }
+    }
+}
+
+void SpatialGrid::Insert(VertexId id, sf::Vector2f position) {
+    m_cells[keyOf(cellOf(position.x), cellOf(position.y))].push_back({ id, position });
+}
+
+void SpatialGrid::Move(VertexId id, sf::Vector2f from, sf::Vector2f to) {
+    // Staying inside the same cell only updates the stored position.
+    std::uint64_t fromKey = keyOf(cellOf(from.x), cellOf(from.y));
+    std::uint64_t toKey = keyOf(cellOf(to.x), cellOf(to.y));
+    if (fromKey == toKey) {
+        for (Entry& entry : m_cells[fromKey]) {
+            if (entry.Id == id) {
+                entry.Position = to;
+                return;
+            }
+        }
+    }
+
+    Remove(id, from);
+    Insert(id, to);
+}
+
+void SpatialGrid::Remove(VertexId id, sf::Vector2f position) {
+    auto cell = m_cells.find(keyOf(cellOf(position.x), cellOf(position.y)));
+    if (cell == m_cells.end()) {
+        return;
+    }
+
+    // Swap and pop, the order inside a cell does not matter.
+    std::vector<Entry>& entries = cell->second;
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].Id == id) {
+            entries[i] = entries.back();
+            entries.pop_back();
+            break;
+        }
+    }
+    if (entries.empty()) {
+        m_cells.erase(cell);
+    }
+}
+
+std::int32_t SpatialGrid::cellOf(float coordinate) const {
+    return static_cast<std::int32_t>(std::floor(coordinate / m_cellSize));
+}
+
+std::uint64_t SpatialGrid::keyOf(std::int32_t x, std::int32_t y) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+}
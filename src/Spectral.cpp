@@ -0,0 +1,481 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "Spectral.hpp"
+#include "Profiler.hpp"
+
+namespace {
+    /**
+     * @brief A fixed pseudo random entry of the Lanczos start vector, so the second pass sees the same one.
+     * @param index The entry.
+     * @return A value in [-1, 1).
+     */
+    double startValue(std::size_t index) {
+        // SplitMix64 of the index.
+        std::uint64_t z = index * 0x9e3779b97f4a7c15ull + 0x632be59bd9b4e019ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        z ^= z >> 31;
+        return static_cast<double>(z >> 11) * (2.0 / 9007199254740992.0) - 1.0;
+    }
+
+    /**
+     * @brief Get the Euclidean norm of a vector.
+     * @param x The vector.
+     * @return The norm.
+     */
+    double norm(const std::vector<double>& x) {
+        double sum = 0.0;
+        for (double value : x) {
+            sum += value * value;
+        }
+        return std::sqrt(sum);
+    }
+}
+
+SpectralResult Spectral::Analyze(const AdjacencyStore& topology, std::size_t maxThreads, JobControl* control) {
+    PROFILE_ZONE("Spectral::Analyze");
+    SpectralResult result = { 0.0, {}, 0.0, 0.0, {}, {}, 0, true, topology.GetVersion() };
+    const std::size_t n = topology.GetVertexCount();
+    if (n == 0) {
+        return result;
+    }
+
+    // Every neighbour once, a directed store lists an edge both ways in the symmetric view.
+    Operator op;
+    const AdjacencyStore::CSR& csr = topology.GetSymmetricCSR();
+    op.Offsets.assign(n + 1, 0);
+    op.Columns.reserve(csr.Entries.size());
+    op.Diagonal.assign(n, 0.0);
+    std::vector<VertexId> seen(n, InvalidVertexId);
+    for (VertexId v = 0; v < n; v++) {
+        for (std::size_t e = csr.Offsets[v]; e < csr.Offsets[v + 1]; e++) {
+            const VertexId u = csr.Entries[e].Target;
+            if (u != v && seen[u] != v) {
+                seen[u] = v;
+                op.Columns.push_back(u);
+            }
+        }
+        op.Offsets[v + 1] = op.Columns.size();
+        op.Diagonal[v] = static_cast<double>(op.Offsets[v + 1] - op.Offsets[v]);
+    }
+    op.OffDiagonal = -1.0;
+
+    const std::size_t threadCount = maxThreads > 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    std::unique_ptr<ThreadPool> pool;
+    if (threadCount > 1 && n >= 2 * ChunkRows) {
+        pool = std::make_unique<ThreadPool>(threadCount);
+    }
+    op.Pool = pool.get();
+    const bool isFull = n <= FullSpectrumLimit;
+    const bool isConnected = topology.GetComponentCount() == 1;
+
+    // The Laplacian, kept off its constant null vector when connected, so the lowest Ritz value is the second eigenvalue.
+    if (n > 1) {
+        op.IsDeflated = isConnected;
+        LanczosResult laplacian = lanczos(op, true, isConnected, control, 0.0f, 0.5f);
+        result.Iterations += laplacian.Steps;
+        result.IsConverged = laplacian.IsConverged;
+        result.LaplacianRadius = laplacian.Highest;
+        if (isConnected) {
+            result.AlgebraicConnectivity = std::max(0.0, laplacian.Lowest);
+            result.Fiedler.assign(laplacian.Vector.begin(), laplacian.Vector.end());
+        } else {
+            // Any vector constant on every component is in the null space, the largest component against the rest.
+            VertexId largest = 0;
+            for (VertexId v = 1; v < n; v++) {
+                if (topology.GetComponentSize(v) > topology.GetComponentSize(largest)) {
+                    largest = v;
+                }
+            }
+            const VertexId component = topology.GetComponent(largest);
+            const double inside = 1.0 / static_cast<double>(topology.GetComponentSize(largest));
+            const double outside = -1.0 / static_cast<double>(n - topology.GetComponentSize(largest));
+            const double scale = 1.0 / std::sqrt(inside + -outside);
+            result.Fiedler.resize(n);
+            for (VertexId v = 0; v < n; v++) {
+                result.Fiedler[v] = static_cast<float>((topology.GetComponent(v) == component ? inside : outside) * scale);
+            }
+        }
+
+        // Eigenvectors have no sign of their own, this one starts non negative so reruns agree.
+        if (!result.Fiedler.empty() && result.Fiedler[0] < 0.0f) {
+            for (float& value : result.Fiedler) {
+                value = -value;
+            }
+        }
+    }
+    if (isFull) {
+        op.IsDeflated = false;
+        result.LaplacianSpectrum = denseSpectrum(op);
+        result.LaplacianRadius = result.LaplacianSpectrum.back();
+        if (isConnected && n > 1) {
+            result.AlgebraicConnectivity = std::max(0.0, result.LaplacianSpectrum[1]);
+        }
+    }
+    if (control && control->IsCancelled()) {
+        result.IsConverged = false;
+        return result;
+    }
+
+    // The adjacency matrix shares the pattern, only its entries change.
+    op.Diagonal.assign(n, 0.0);
+    op.OffDiagonal = 1.0;
+    op.IsDeflated = false;
+    if (isFull) {
+        result.AdjacencySpectrum = denseSpectrum(op);
+        result.SpectralRadius = result.AdjacencySpectrum.back();
+    } else {
+        LanczosResult adjacency = lanczos(op, false, false, control, 0.5f, 0.5f);
+        result.Iterations += adjacency.Steps;
+        result.IsConverged = result.IsConverged && adjacency.IsConverged;
+        result.SpectralRadius = adjacency.Highest;
+    }
+
+    return result;
+}
+
+double Spectral::apply(const Operator& op, const std::vector<double>& x, std::vector<double>& y) {
+    return sweep(op, [&op, &x, &y](std::size_t begin, std::size_t end) {
+        double product = 0.0;
+        for (std::size_t v = begin; v < end; v++) {
+            double sum = 0.0;
+            for (std::size_t e = op.Offsets[v]; e < op.Offsets[v + 1]; e++) {
+                sum += x[op.Columns[e]];
+            }
+            y[v] = op.Diagonal[v] * x[v] + op.OffDiagonal * sum;
+            product += x[v] * y[v];
+        }
+        return product;
+    });
+}
+
+std::vector<double> Spectral::denseSpectrum(const Operator& op) {
+    PROFILE_ZONE("Spectral::denseSpectrum");
+    const std::size_t n = op.Diagonal.size();
+    std::vector<double> a(n * n, 0.0);
+    for (std::size_t v = 0; v < n; v++) {
+        a[v * n + v] = op.Diagonal[v];
+        for (std::size_t e = op.Offsets[v]; e < op.Offsets[v + 1]; e++) {
+            a[v * n + op.Columns[e]] = op.OffDiagonal;
+        }
+    }
+
+    // Householder reflections zero each column below the subdiagonal, leaving a similar tridiagonal matrix.
+    std::vector<double> diagonal(n);
+    std::vector<double> offDiagonal(n > 0 ? n - 1 : 0);
+    std::vector<double> reflector(n);
+    std::vector<double> product(n);
+    for (std::size_t k = 0; k + 2 < n; k++) {
+        diagonal[k] = a[k * n + k];
+        double length = 0.0;
+        for (std::size_t i = k + 1; i < n; i++) {
+            length += a[i * n + k] * a[i * n + k];
+        }
+        length = std::sqrt(length);
+        if (length == 0.0) {
+            offDiagonal[k] = 0.0;
+            continue;
+        }
+        const double alpha = a[(k + 1) * n + k] > 0.0 ? -length : length;
+        double reflectorLength = 0.0;
+        for (std::size_t i = k + 1; i < n; i++) {
+            reflector[i] = a[i * n + k] - (i == k + 1 ? alpha : 0.0);
+            reflectorLength += reflector[i] * reflector[i];
+        }
+        reflectorLength = std::sqrt(reflectorLength);
+        for (std::size_t i = k + 1; i < n; i++) {
+            reflector[i] /= reflectorLength;
+        }
+        offDiagonal[k] = alpha;
+
+        // With H = I - 2vv', H B H = B - 2(vq' + qv') for p = Bv and q = p - (v'p)v.
+        double vp = 0.0;
+        for (std::size_t i = k + 1; i < n; i++) {
+            double sum = 0.0;
+            for (std::size_t j = k + 1; j < n; j++) {
+                sum += a[i * n + j] * reflector[j];
+            }
+            product[i] = sum;
+            vp += reflector[i] * sum;
+        }
+        for (std::size_t i = k + 1; i < n; i++) {
+            product[i] -= vp * reflector[i];
+        }
+        for (std::size_t i = k + 1; i < n; i++) {
+            for (std::size_t j = k + 1; j < n; j++) {
+                a[i * n + j] -= 2.0 * (reflector[i] * product[j] + product[i] * reflector[j]);
+            }
+        }
+    }
+    if (n >= 2) {
+        diagonal[n - 2] = a[(n - 2) * n + n - 2];
+        offDiagonal[n - 2] = a[(n - 1) * n + n - 2];
+    }
+    diagonal[n - 1] = a[(n - 1) * n + n - 1];
+
+    std::vector<double> spectrum(n);
+    for (std::size_t i = 0; i < n; i++) {
+        spectrum[i] = tridiagonalEigenvalue(diagonal, offDiagonal, i);
+    }
+
+    return spectrum;
+}
+
+double Spectral::sweep(const Operator& op, const std::function<double(std::size_t begin, std::size_t end)>& body) {
+    const std::size_t n = op.Diagonal.size();
+    const std::size_t chunks = (n + ChunkRows - 1) / ChunkRows;
+    if (chunks <= 1) {
+        return body(0, n);
+    }
+
+    std::vector<double> partials(chunks, 0.0);
+    for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+        const std::size_t begin = chunk * ChunkRows;
+        const std::size_t end = std::min(n, begin + ChunkRows);
+        if (op.Pool) {
+            op.Pool->Submit([&body, &partials, chunk, begin, end]() {
+                partials[chunk] = body(begin, end);
+            });
+        } else {
+            partials[chunk] = body(begin, end);
+        }
+    }
+    if (op.Pool) {
+        op.Pool->Wait();
+    }
+
+    double sum = 0.0;
+    for (double partial : partials) {
+        sum += partial;
+    }
+    return sum;
+}
+
+double Spectral::tridiagonalEigenvalue(const std::vector<double>& diagonal, const std::vector<double>& offDiagonal, std::size_t index) {
+    // Gershgorin discs bound the spectrum.
+    const std::size_t k = diagonal.size();
+    double low = std::numeric_limits<double>::max();
+    double high = std::numeric_limits<double>::lowest();
+    for (std::size_t i = 0; i < k; i++) {
+        const double radius = (i > 0 ? std::fabs(offDiagonal[i - 1]) : 0.0) + (i + 1 < k ? std::fabs(offDiagonal[i]) : 0.0);
+        low = std::min(low, diagonal[i] - radius);
+        high = std::max(high, diagonal[i] + radius);
+    }
+
+    // The signs of the LDL' pivots of T - xI count the eigenvalues below x.
+    const double tiny = std::numeric_limits<double>::min();
+    const double epsilon = std::numeric_limits<double>::epsilon();
+    while (high - low > 2.0 * epsilon * std::max(std::fabs(low), std::fabs(high)) + tiny) {
+        const double middle = 0.5 * (low + high);
+        if (middle <= low || middle >= high) {
+            break;
+        }
+        std::size_t below = 0;
+        double pivot = 1.0;
+        for (std::size_t i = 0; i < k; i++) {
+            pivot = diagonal[i] - middle - (i > 0 ? offDiagonal[i - 1] * offDiagonal[i - 1] / pivot : 0.0);
+            if (pivot == 0.0) {
+                pivot = -tiny;
+            }
+            if (pivot < 0.0) {
+                below++;
+            }
+        }
+        if (below > index) {
+            high = middle;
+        } else {
+            low = middle;
+        }
+    }
+
+    return 0.5 * (low + high);
+}
+
+std::vector<double> Spectral::tridiagonalEigenvector(const std::vector<double>& diagonal, const std::vector<double>& offDiagonal, double eigenvalue, bool isLowest) {
+    // Shifted just past the end of the spectrum T - sI is definite, so elimination needs no pivoting.
+    const std::size_t k = diagonal.size();
+    double width = 0.0;
+    for (std::size_t i = 0; i < k; i++) {
+        width = std::max(width, std::fabs(diagonal[i]) + (i > 0 ? std::fabs(offDiagonal[i - 1]) : 0.0) + (i + 1 < k ? std::fabs(offDiagonal[i]) : 0.0));
+    }
+    const double shift = eigenvalue + (isLowest ? -1.0 : 1.0) * 1e-10 * std::max(width, 1.0);
+
+    std::vector<double> x(k);
+    for (std::size_t i = 0; i < k; i++) {
+        x[i] = startValue(i);
+    }
+    std::vector<double> pivots(k);
+    for (std::size_t i = 0; i < k; i++) {
+        pivots[i] = diagonal[i] - shift - (i > 0 ? offDiagonal[i - 1] * offDiagonal[i - 1] / pivots[i - 1] : 0.0);
+    }
+    for (int iteration = 0; iteration < 3; iteration++) {
+        // Forward elimination then back substitution of (T - sI) y = x.
+        for (std::size_t i = 1; i < k; i++) {
+            x[i] -= offDiagonal[i - 1] / pivots[i - 1] * x[i - 1];
+        }
+        x[k - 1] /= pivots[k - 1];
+        for (std::size_t i = k - 1; i-- > 0;) {
+            x[i] = (x[i] - offDiagonal[i] * x[i + 1]) / pivots[i];
+        }
+        const double length = norm(x);
+        for (double& value : x) {
+            value /= length;
+        }
+    }
+
+    return x;
+}
+
+Spectral::LanczosResult Spectral::lanczos(const Operator& op, bool wantLowest, bool wantVector, JobControl* control, float progress, float share) {
+    PROFILE_ZONE("Spectral::lanczos");
+    const std::size_t n = op.Diagonal.size();
+    LanczosResult result = { 0.0, 0.0, {}, 0, false };
+
+    // Gershgorin bounds the spectrum's width, which residuals are measured against.
+    double width = 1.0;
+    for (std::size_t v = 0; v < n; v++) {
+        width = std::max(width, std::fabs(op.Diagonal[v]) + static_cast<double>(op.Offsets[v + 1] - op.Offsets[v]));
+    }
+
+    // Rounding lets the constant vector creep back into a deflated basis, it is taken out again every step.
+    const double size = static_cast<double>(n);
+    auto deflate = [&op, size](std::vector<double>& x) {
+        if (!op.IsDeflated) {
+            return;
+        }
+        const double mean = sweep(op, [&x](std::size_t begin, std::size_t end) {
+            double sum = 0.0;
+            for (std::size_t v = begin; v < end; v++) {
+                sum += x[v];
+            }
+            return sum;
+        }) / size;
+        sweep(op, [&x, mean](std::size_t begin, std::size_t end) {
+            for (std::size_t v = begin; v < end; v++) {
+                x[v] -= mean;
+            }
+            return 0.0;
+        });
+    };
+    auto length = [&op](const std::vector<double>& x) {
+        return std::sqrt(sweep(op, [&x](std::size_t begin, std::size_t end) {
+            double sum = 0.0;
+            for (std::size_t v = begin; v < end; v++) {
+                sum += x[v] * x[v];
+            }
+            return sum;
+        }));
+    };
+    auto scale = [&op](std::vector<double>& x, double factor) {
+        sweep(op, [&x, factor](std::size_t begin, std::size_t end) {
+            for (std::size_t v = begin; v < end; v++) {
+                x[v] *= factor;
+            }
+            return 0.0;
+        });
+    };
+    auto start = [&](std::vector<double>& x) {
+        for (std::size_t v = 0; v < n; v++) {
+            x[v] = startValue(v);
+        }
+        deflate(x);
+        scale(x, 1.0 / length(x));
+    };
+
+    // First pass, only the last two basis vectors are kept while T grows by a row a step.
+    std::vector<double> previous(n, 0.0);
+    std::vector<double> current(n);
+    std::vector<double> next(n);
+    std::vector<double> alphas;
+    std::vector<double> betas;
+    std::vector<double> ritz;
+    start(current);
+    double beta = 0.0;
+    for (std::size_t step = 0; step < MaxSteps; step++) {
+        const double alpha = apply(op, current, next);
+        sweep(op, [&, alpha, beta](std::size_t begin, std::size_t end) {
+            for (std::size_t v = begin; v < end; v++) {
+                next[v] -= alpha * current[v] + beta * previous[v];
+            }
+            return 0.0;
+        });
+        deflate(next);
+        alphas.push_back(alpha);
+        beta = length(next);
+        result.Steps = step + 1;
+
+        // A breakdown means the basis spans an invariant subspace, its Ritz values are exact.
+        const bool isBreakdown = beta <= 1e-12 * width;
+        if (isBreakdown || (step + 1) % CheckInterval == 0 || step + 1 == MaxSteps) {
+            result.Lowest = tridiagonalEigenvalue(alphas, betas, 0);
+            result.Highest = tridiagonalEigenvalue(alphas, betas, alphas.size() - 1);
+            const std::vector<double> low = tridiagonalEigenvector(alphas, betas, result.Lowest, true);
+            const std::vector<double> high = tridiagonalEigenvector(alphas, betas, result.Highest, false);
+            ritz = wantLowest ? low : high;
+
+            // The residual of a Ritz pair is the next beta times the last entry of its eigenvector of T.
+            const double tolerance = Tolerance * width;
+            result.IsConverged = isBreakdown || (beta * std::fabs(low.back()) <= tolerance && beta * std::fabs(high.back()) <= tolerance);
+            if (result.IsConverged) {
+                break;
+            }
+        }
+        if (control) {
+            if (control->IsCancelled()) {
+                return result;
+            }
+            control->SetProgress(progress + share * static_cast<float>(step + 1) / MaxSteps);
+        }
+
+        betas.push_back(beta);
+        std::swap(previous, current);
+        std::swap(current, next);
+        scale(current, 1.0 / beta);
+    }
+    if (!wantVector) {
+        return result;
+    }
+
+    // Second pass, the same recurrence with the same coefficients adds up the Ritz vector one basis vector at a time.
+    result.Vector.assign(n, 0.0);
+    std::fill(previous.begin(), previous.end(), 0.0);
+    start(current);
+    for (std::size_t j = 0; j < ritz.size(); j++) {
+        const double weight = ritz[j];
+        sweep(op, [&result, &current, weight](std::size_t begin, std::size_t end) {
+            for (std::size_t v = begin; v < end; v++) {
+                result.Vector[v] += weight * current[v];
+            }
+            return 0.0;
+        });
+        if (j + 1 == ritz.size()) {
+            break;
+        }
+        if (control && control->IsCancelled()) {
+            result.IsConverged = false;
+            return result;
+        }
+
+        apply(op, current, next);
+        const double alpha = alphas[j];
+        const double lastBeta = j > 0 ? betas[j - 1] : 0.0;
+        const double nextBeta = betas[j];
+        sweep(op, [&, alpha, lastBeta, nextBeta](std::size_t begin, std::size_t end) {
+            for (std::size_t v = begin; v < end; v++) {
+                next[v] = (next[v] - alpha * current[v] - lastBeta * previous[v]) / nextBeta;
+            }
+            return 0.0;
+        });
+        deflate(next);
+        std::swap(previous, current);
+        std::swap(current, next);
+    }
+    deflate(result.Vector);
+    scale(result.Vector, 1.0 / length(result.Vector));
+
+    return result;
+}
@@ -0,0 +1,44 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "StringPool.hpp"
+
+StringPool::StringPool(void) : m_arena(BlockBytes) {
+    m_strings.push_back(std::string_view());
+    m_ids.emplace(std::string_view(), EmptyStringId);
+}
+
+void StringPool::Clear(void) {
+    // The views point into the arena, so they go before it does.
+    m_ids.clear();
+    m_strings.clear();
+    m_arena.release();
+    m_strings.push_back(std::string_view());
+    m_ids.emplace(std::string_view(), EmptyStringId);
+}
+
+std::string_view StringPool::Get(StringId id) const {
+    return m_strings[id];
+}
+
+std::size_t StringPool::GetCount(void) const {
+    return m_strings.size();
+}
+
+StringId StringPool::Intern(std::string_view text) {
+    std::unordered_map<std::string_view, StringId>::const_iterator found = m_ids.find(text);
+    if (found != m_ids.end()) {
+        return found->second;
+    }
+
+    // Unaligned, the characters are only ever read as bytes.
+    char* characters = static_cast<char*>(m_arena.allocate(text.size(), 1));
+    std::memcpy(characters, text.data(), text.size());
+    const StringId id = static_cast<StringId>(m_strings.size());
+    m_strings.emplace_back(characters, text.size());
+    m_ids.emplace(m_strings.back(), id);
+    return id;
+}
@@ -0,0 +1,137 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "ThreadPool.hpp"
+
+namespace {
+    /// @brief The pool the current thread works for, if any.
+    thread_local const ThreadPool* t_pool = nullptr;
+
+    /// @brief The index of the current thread in its pool.
+    thread_local std::size_t t_index = 0;
+}
+
+ThreadPool::ThreadPool(std::size_t threadCount) {
+    m_nextQueue = 0;
+    m_pending = 0;
+    m_queued = 0;
+    m_stopping = false;
+
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (std::size_t i = 0; i < threadCount; i++) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+    for (std::size_t i = 0; i < threadCount; i++) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_taskReady.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+std::size_t ThreadPool::GetThreadCount(void) const {
+    return m_workers.size();
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    // Counted first, under the sleep mutex, so the count never drops below zero and a worker about to sleep can't miss it.
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending++;
+        m_queued++;
+    }
+
+    // A worker keeps its own tasks close, outside threads deal them round robin.
+    std::size_t index = t_pool == this ? t_index : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->Mutex);
+        m_queues[index]->Tasks.push_back(std::move(task));
+    }
+    m_taskReady.notify_one();
+}
+
+void ThreadPool::Wait(void) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_pending == 0; });
+    if (m_error) {
+        std::exception_ptr error = std::move(m_error);
+        m_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+bool ThreadPool::take(std::size_t index, std::function<void()>& task) {
+    // Newest own task first, it is the most likely to still be in cache.
+    {
+        Queue& own = *m_queues[index];
+        std::lock_guard<std::mutex> lock(own.Mutex);
+        if (!own.Tasks.empty()) {
+            task = std::move(own.Tasks.back());
+            own.Tasks.pop_back();
+            m_queued--;
+            return true;
+        }
+    }
+
+    // Then the oldest task of the next worker that has one.
+    for (std::size_t offset = 1; offset < m_queues.size(); offset++) {
+        Queue& victim = *m_queues[(index + offset) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(victim.Mutex);
+        if (!victim.Tasks.empty()) {
+            task = std::move(victim.Tasks.front());
+            victim.Tasks.pop_front();
+            m_queued--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::workerLoop(std::size_t index) {
+    t_pool = this;
+    t_index = index;
+
+    while (true) {
+        std::function<void()> task;
+        if (!take(index, task)) {
+            // Drain every deque before honouring a stop.
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskReady.wait(lock, [this]() { return m_stopping || m_queued > 0; });
+            if (m_queued == 0) {
+                return;
+            }
+            continue;
+        }
+
+        // An exception escaping the worker would end the process, the caller of Wait() gets it instead.
+        std::exception_ptr error;
+        try {
+            task();
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (error && !m_error) {
+            m_error = std::move(error);
+        }
+        if (--m_pending == 0) {
+            m_idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,17 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "corepch.hpp"
+#include "Batch.hpp"
+
+/**
+ * @brief Main entry point for the batch analysis tool.
+ * @param argc The number of command line arguments.
+ * @param argv The command line arguments.
+ * @return int Exit code, see Batch::Run.
+ */
+int main(int argc, char **argv) {
+    return Batch::Run(argc, argv);
+}
@@ -0,0 +1,17 @@
+/* Graph Theorist's Notepad
+    Copyright (c) 2025 Nicholas Bellinger
+    Licensed under the "Graph Theorist's Notepad, Nicholas Bellinger, Non-Commercial License 1.0".
+    See the LICENSE file in the project root for full details. */
+
+#include "pch.hpp"
+#include "Bench.hpp"
+
+/**
+ * @brief Main entry point for the benchmark suite.
+ * @param argc The number of command line arguments.
+ * @param argv The command line arguments.
+ * @return int Exit code, see Bench::Run.
+ */
+int main(int argc, char **argv) {
+    return Bench::Run(argc, argv);
+}